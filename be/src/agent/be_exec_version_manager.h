@@ -66,11 +66,16 @@ private:
  *    e. change shuffle serialize/deserialize way 
  *    f. shrink some function's nullable mode.
  *    g. do local merge of remote runtime filter
+ * 4: start from doris 2.1.x
+ *    a. percentile aggregate function serializes a single compact state for all quantiles.
+ *    b. multi_distinct_count serializes its set sorted and delta encoded.
 */
-constexpr inline int BeExecVersionManager::max_be_exec_version = 3;
+constexpr inline int BeExecVersionManager::max_be_exec_version = 4;
 constexpr inline int BeExecVersionManager::min_be_exec_version = 0;
 
 /// functional
 constexpr inline int USE_NEW_SERDE = 3; // release on DORIS version 2.1
+constexpr inline int COMPACT_PERCENTILE_STATE = 4;
+constexpr inline int COMPACT_UNIQ_EXACT_STATE = 4;
 
 } // namespace doris
@@ -37,24 +37,8 @@ std::unique_ptr<BaseDeltaWriter> CloudTabletsChannel::create_delta_writer(
     return std::make_unique<CloudDeltaWriter>(_engine, request, _profile, _load_id);
 }
 
-Status CloudTabletsChannel::add_batch(const PTabletWriterAddBlockRequest& request,
-                                      PTabletWriterAddBlockResult* response) {
-    // FIXME(plat1ko): Too many duplicate code with `TabletsChannel`
-    SCOPED_TIMER(_add_batch_timer);
-    int64_t cur_seq = 0;
-    _add_batch_number_counter->update(1);
-
-    auto status = _get_current_seq(cur_seq, request);
-    if (UNLIKELY(!status.ok())) {
-        return status;
-    }
-
-    if (request.packet_seq() < cur_seq) {
-        LOG(INFO) << "packet has already recept before, expect_seq=" << cur_seq
-                  << ", recept_seq=" << request.packet_seq();
-        return Status::OK();
-    }
-
+Status CloudTabletsChannel::_write_packet(const PTabletWriterAddBlockRequest& request,
+                                          PTabletWriterAddBlockResult* response) {
     std::unordered_map<int64_t, std::vector<uint32_t>> tablet_to_rowidxs;
     _build_tablet_to_rowidxs(request, &tablet_to_rowidxs);
 
@@ -70,7 +54,7 @@ Status CloudTabletsChannel::add_batch(const PTabletWriterAddBlockRequest& reques
         RETURN_IF_ERROR(_init_writers_by_partition_ids(partition_ids));
     }
 
-    return _write_block_data(request, cur_seq, tablet_to_rowidxs, response);
+    return _write_block_data(request, tablet_to_rowidxs, response);
 }
 
 Status CloudTabletsChannel::_init_writers_by_partition_ids(
@@ -102,6 +86,8 @@ Status CloudTabletsChannel::close(LoadChannel* parent, const PTabletWriterAddBlo
         *finished = (_num_remaining_senders == 0);
         return _close_status;
     }
+    // The packets of the sender are all written before its eos, unless one of them is lost.
+    RETURN_IF_ERROR(_packet_sequencer.close_sender(sender_id));
 
     LOG(INFO) << "close tablets channel: " << _key << ", sender id: " << sender_id
               << ", backend id: " << req.backend_id();
@@ -34,13 +34,13 @@ public:
 
     std::unique_ptr<BaseDeltaWriter> create_delta_writer(const WriteRequest& request) override;
 
-    Status add_batch(const PTabletWriterAddBlockRequest& request,
-                     PTabletWriterAddBlockResult* response) override;
-
     Status close(LoadChannel* parent, const PTabletWriterAddBlockRequest& req,
                  PTabletWriterAddBlockResult* res, bool* finished) override;
 
 private:
+    Status _write_packet(const PTabletWriterAddBlockRequest& request,
+                         PTabletWriterAddBlockResult* response) override;
+
     Status _init_writers_by_partition_ids(const std::unordered_set<int64_t>& partition_ids);
 
     CloudStorageEngine& _engine;
@@ -102,6 +102,13 @@ DEFINE_Double(soft_mem_limit_frac, "0.9");
 // memory greater than 16 GB.
 DEFINE_mInt64(mmap_threshold, "134217728"); // bytes
 
+DEFINE_Bool(enable_query_buffer_pool, "false");
+DEFINE_Int64(query_buffer_pool_min_bytes, "1048576");
+DEFINE_mInt64(query_buffer_pool_max_bytes, "1073741824");
+DEFINE_mDouble(query_buffer_pool_limit_ratio, "0.2");
+DEFINE_mBool(query_buffer_pool_use_huge_page, "false");
+DEFINE_mInt32(query_buffer_pool_stale_sweep_time_sec, "60");
+
 // When hash table capacity is greater than 2^double_grow_degree(default 2G), grow when 75% of the capacity is satisfied.
 // Increase can reduce the number of hash table resize, but may waste more memory.
 DEFINE_mInt32(hash_table_double_grow_degree, "31");
@@ -365,6 +372,12 @@ DEFINE_mBool(enable_vertical_segment_writer, "true");
 // In ordered data compaction, min segment size for input rowset
 DEFINE_mInt32(ordered_data_compaction_min_segment_size, "10485760");
 
+// Whether cumulative compaction copies the encoded pages of small segments with ordered keys
+// into larger segments, instead of merging their rows
+DEFINE_mBool(enable_segment_stitching_compaction, "false");
+// In segment stitching compaction, max dest segment file size
+DEFINE_mInt64(segment_stitching_max_segment_size, "268435456");
+
 // This config can be set to limit thread number in compaction thread pool.
 DEFINE_mInt32(max_base_compaction_threads, "4");
 DEFINE_mInt32(max_cumu_compaction_threads, "-1");
@@ -441,6 +454,9 @@ DEFINE_mBool(enable_compaction_priority_scheduling, "true");
 DEFINE_mInt32(low_priority_compaction_task_num_per_disk, "1");
 DEFINE_mDouble(low_priority_tablet_version_num_ratio, "0.7");
 
+DEFINE_mBool(enable_read_amplification_compaction_scheduling, "false");
+DEFINE_mInt32(tablet_read_stats_half_life_sec, "600");
+
 // Thread count to do tablet meta checkpoint, -1 means use the data directories count.
 DEFINE_Int32(max_meta_checkpoint_threads, "-1");
 
@@ -495,6 +511,7 @@ DEFINE_mInt64(streaming_load_max_mb, "10240");
 // Therefore, it is necessary to limit the maximum number of
 // such data when using stream load to prevent excessive memory consumption.
 DEFINE_mInt64(streaming_load_json_max_mb, "100");
+DEFINE_mBool(enable_load_direct_typed_columns, "false");
 // the alive time of a TabletsChannel.
 // If the channel does not receive any data till this time,
 // the channel will be removed.
@@ -504,6 +521,7 @@ DEFINE_mInt32(streaming_load_rpc_max_alive_time_sec, "1200");
 DEFINE_Int32(tablet_writer_open_rpc_timeout_sec, "60");
 // You can ignore brpc error '[E1011]The server is overcrowded' when writing data.
 DEFINE_mBool(tablet_writer_ignore_eovercrowded, "true");
+DEFINE_mInt32(tablet_writer_add_block_max_in_flight, "1");
 DEFINE_mBool(exchange_sink_ignore_eovercrowded, "true");
 DEFINE_mInt32(slave_replica_writer_rpc_timeout_sec, "60");
 // Whether to enable stream load record function, the default is false.
@@ -596,6 +614,9 @@ DEFINE_mInt64(write_buffer_size, "209715200");
 DEFINE_mInt64(write_buffer_size_for_agg, "419430400");
 // max parallel flush task per memtable writer
 DEFINE_mInt32(memtable_flush_running_count_limit, "2");
+DEFINE_mBool(enable_load_shared_write_buffer, "false");
+DEFINE_mInt64(load_shared_write_buffer_bytes, "1073741824");
+DEFINE_mInt64(load_shared_write_buffer_batch_flush_bytes, "8388608");
 
 DEFINE_Int32(load_process_max_memory_limit_percent, "50"); // 50%
 
@@ -872,6 +893,8 @@ DEFINE_mInt32(jsonb_type_length_soft_limit_bytes, "1048576");
 DEFINE_Validator(jsonb_type_length_soft_limit_bytes,
                  [](const int config) -> bool { return config > 0 && config <= 2147483643; });
 
+DEFINE_mBool(enable_jsonb_container_index, "false");
+
 // Threshold of reading a small file into memory
 DEFINE_mInt32(in_memory_file_size, "1048576"); // 1MB
 
@@ -883,6 +906,10 @@ DEFINE_mInt32(parquet_header_max_size_mb, "1");
 DEFINE_mInt32(parquet_rowgroup_max_buffer_mb, "128");
 // Max buffer size for parquet chunk column
 DEFINE_mInt32(parquet_column_max_buffer_mb, "8");
+DEFINE_mBool(enable_parquet_dict_filter, "true");
+DEFINE_mBool(enable_parquet_bloom_filter, "true");
+DEFINE_mBool(enable_parquet_prefetch, "false");
+DEFINE_mInt64(parquet_prefetch_budget_bytes, "16777216");
 DEFINE_mDouble(max_amplified_read_ratio, "0.8");
 DEFINE_mInt32(merged_oss_min_io_size, "1048576");
 DEFINE_mInt32(merged_hdfs_min_io_size, "8192");
@@ -975,6 +1002,9 @@ DEFINE_Bool(enable_fuzzy_mode, "false");
 DEFINE_Bool(enable_debug_points, "false");
 
 DEFINE_Int32(pipeline_executor_size, "0");
+DEFINE_Bool(enable_numa_aware_scheduling, "false");
+DEFINE_mBool(numa_interleave_shared_hash_table, "false");
+DEFINE_mBool(numa_interleave_page_cache, "false");
 DEFINE_Bool(enable_workload_group_for_scan, "false");
 DEFINE_mInt64(workload_group_scan_task_wait_timeout_ms, "10000");
 
@@ -1002,9 +1032,14 @@ DEFINE_Validator(file_cache_min_file_segment_size, [](const int64_t config) -> b
     return config >= 4096 && config <= 268435456 &&
            config <= config::file_cache_max_file_segment_size;
 });
+DEFINE_Int64(file_cache_slab_file_size, "1073741824"); // 1GB
 DEFINE_Bool(clear_file_cache, "false");
 DEFINE_Bool(enable_file_cache_query_limit, "false");
 DEFINE_mInt32(file_cache_wait_sec_after_fail, "0"); // // zero for no waiting and retrying
+DEFINE_mBool(enable_file_cache_write_behind, "true");
+DEFINE_Int32(file_cache_write_behind_thread_num, "8");
+DEFINE_Int32(file_cache_write_behind_queue_size, "256");
+DEFINE_mInt64(file_cache_write_behind_max_bytes, "268435456");
 
 DEFINE_mInt32(index_cache_entry_stay_time_after_lookup_s, "1800");
 DEFINE_mInt32(inverted_index_cache_stale_sweep_time_sec, "600");
@@ -1037,6 +1072,10 @@ DEFINE_Int32(num_broadcast_buffer, "32");
 
 // max depth of expression tree allowed.
 DEFINE_Int32(max_depth_of_expr_tree, "600");
+DEFINE_mDouble(selective_branch_evaluation_max_density, "0.7");
+DEFINE_mBool(enable_adaptive_conjunct_order, "false");
+DEFINE_mDouble(dictionary_function_evaluation_max_ratio, "0.1");
+DEFINE_mBool(enable_common_subexpr_elimination, "false");
 
 // Report a tablet as bad when io errors occurs more than this value.
 DEFINE_mInt64(max_tablet_io_errors, "-1");
@@ -1070,6 +1109,8 @@ DEFINE_Bool(enable_set_in_bitmap_value, "false");
 DEFINE_Int64(max_hdfs_file_handle_cache_num, "20000");
 DEFINE_Int32(max_hdfs_file_handle_cache_time_sec, "3600");
 DEFINE_Int64(max_external_file_meta_cache_num, "20000");
+DEFINE_String(iceberg_delete_file_cache_limit, "2%");
+DEFINE_mInt32(iceberg_delete_file_cache_stale_sweep_time_sec, "3600");
 // Apply delete pred in cumu compaction
 DEFINE_mBool(enable_delete_when_cumu_compaction, "false");
 
@@ -1114,6 +1155,7 @@ DEFINE_Int32(fe_expire_duration_seconds, "60");
 DEFINE_Int32(grace_shutdown_wait_seconds, "120");
 
 DEFINE_Int16(bitmap_serialize_version, "1");
+DEFINE_mInt64(frozen_bitmap_min_bytes, "4096");
 
 // group commit config
 DEFINE_String(group_commit_wal_path, "");
@@ -1131,6 +1173,8 @@ DEFINE_mInt32(group_commit_queue_mem_limit, "67108864");
 // group_commit_wal_max_disk_limit=1024 or group_commit_wal_max_disk_limit=10% can be automatically identified.
 DEFINE_String(group_commit_wal_max_disk_limit, "10%");
 DEFINE_Bool(group_commit_wait_replay_wal_finish, "false");
+DEFINE_Bool(group_commit_enable_shared_wal, "false");
+DEFINE_mInt64(group_commit_shared_wal_segment_bytes, "67108864");
 
 DEFINE_mInt32(scan_thread_nice_value, "0");
 DEFINE_mInt32(tablet_schema_cache_recycle_interval, "3600");
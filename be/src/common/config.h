@@ -143,6 +143,22 @@ DECLARE_Double(soft_mem_limit_frac);
 // memory greater than 16 GB.
 DECLARE_mInt64(mmap_threshold); // bytes
 
+// If true, each query owns a buffer pool that keeps large power-of-two buffers freed by
+// `Allocator` (PODArray, hash tables, etc.) and hands them out again instead of mmap/munmap,
+// avoiding page faults and TLB shootdowns when operators allocate big blocks repeatedly.
+// Not mutable, the allocation path of a buffer must not change between alloc and free.
+DECLARE_Bool(enable_query_buffer_pool);
+// Power-of-two allocations at least this large go through mmap and the query buffer pool.
+DECLARE_Int64(query_buffer_pool_min_bytes);
+// Max bytes retained by one query buffer pool, also limited by
+// query mem limit * query_buffer_pool_limit_ratio.
+DECLARE_mInt64(query_buffer_pool_max_bytes);
+DECLARE_mDouble(query_buffer_pool_limit_ratio);
+// madvise(MADV_HUGEPAGE) for the buffers managed by query buffer pool.
+DECLARE_mBool(query_buffer_pool_use_huge_page);
+// Buffers not reused for this many seconds are released by the stale cache prune of memory GC.
+DECLARE_mInt32(query_buffer_pool_stale_sweep_time_sec);
+
 // When hash table capacity is greater than 2^double_grow_degree(default 2G), grow when 75% of the capacity is satisfied.
 // Increase can reduce the number of hash table resize, but may waste more memory.
 DECLARE_mInt32(hash_table_double_grow_degree);
@@ -413,6 +429,12 @@ DECLARE_mBool(enable_vertical_segment_writer);
 // In ordered data compaction, min segment size for input rowset
 DECLARE_mInt32(ordered_data_compaction_min_segment_size);
 
+// Whether cumulative compaction copies the encoded pages of small segments with ordered keys
+// into larger segments, instead of merging their rows
+DECLARE_mBool(enable_segment_stitching_compaction);
+// In segment stitching compaction, max dest segment file size
+DECLARE_mInt64(segment_stitching_max_segment_size);
+
 // This config can be set to limit thread number in compaction thread pool.
 DECLARE_mInt32(max_base_compaction_threads);
 DECLARE_mInt32(max_cumu_compaction_threads);
@@ -484,6 +506,12 @@ DECLARE_mBool(enable_compaction_priority_scheduling);
 DECLARE_mInt32(low_priority_compaction_task_num_per_disk);
 DECLARE_mDouble(low_priority_tablet_version_num_ratio);
 
+// Whether the tablets of all disks are compacted in the order of the read amplification
+// a compaction removes per byte it rewrites, instead of the highest score of every disk.
+DECLARE_mBool(enable_read_amplification_compaction_scheduling);
+// Half life of the query statistics of a tablet used by the scheduling above, in seconds.
+DECLARE_mInt32(tablet_read_stats_half_life_sec);
+
 // Thread count to do tablet meta checkpoint, -1 means use the data directories count.
 DECLARE_Int32(max_meta_checkpoint_threads);
 
@@ -544,6 +572,10 @@ DECLARE_mInt64(streaming_load_max_mb);
 // Therefore, it is necessary to limit the maximum number of
 // such data when using stream load to prevent excessive memory consumption.
 DECLARE_mInt64(streaming_load_json_max_mb);
+// Whether a load whose columns are read from a typed file, e.g. parquet or arrow, with the types
+// of the dest columns moves the columns to the output block, skipping the cast to the input
+// types and the conversion by the dest exprs.
+DECLARE_mBool(enable_load_direct_typed_columns);
 // the alive time of a TabletsChannel.
 // If the channel does not receive any data till this time,
 // the channel will be removed.
@@ -553,6 +585,9 @@ DECLARE_mInt32(streaming_load_rpc_max_alive_time_sec);
 DECLARE_Int32(tablet_writer_open_rpc_timeout_sec);
 // You can ignore brpc error '[E1011]The server is overcrowded' when writing data.
 DECLARE_mBool(tablet_writer_ignore_eovercrowded);
+// Max number of add_block rpcs a node channel of a load keeps in flight to one BE. The receiver
+// applies the packets of a sender in order. 1 sends the next packet after the last one returns.
+DECLARE_mInt32(tablet_writer_add_block_max_in_flight);
 DECLARE_mBool(exchange_sink_ignore_eovercrowded);
 DECLARE_mInt32(slave_replica_writer_rpc_timeout_sec);
 // Whether to enable stream load record function, the default is false.
@@ -647,6 +682,15 @@ DECLARE_mInt64(write_buffer_size);
 DECLARE_mInt64(write_buffer_size_for_agg);
 // max parallel flush task per memtable writer
 DECLARE_mInt32(memtable_flush_running_count_limit);
+// Whether the memtables of all tablets of a load on a BE make up one write buffer, that flushes
+// its largest memtables first when it exceeds load_shared_write_buffer_bytes. Reduces the tiny
+// segments written by loads to many tablets. The memtable memory limiter then flushes the
+// largest memtables first as well.
+DECLARE_mBool(enable_load_shared_write_buffer);
+// size of the write buffer of a load, default 1GB
+DECLARE_mInt64(load_shared_write_buffer_bytes);
+// memtables smaller than this flushed by the write buffer of a load share flush tasks
+DECLARE_mInt64(load_shared_write_buffer_batch_flush_bytes);
 
 DECLARE_Int32(load_process_max_memory_limit_percent); // 50%
 
@@ -920,6 +964,10 @@ DECLARE_String(rpc_load_balancer);
 DECLARE_mInt32(string_type_length_soft_limit_bytes);
 
 DECLARE_mInt32(jsonb_type_length_soft_limit_bytes);
+// Whether to write an index into JSONB objects and arrays of at least 16 elements, which makes
+// key and position lookups O(log n) and O(1). Documents holding an index are written with
+// version 2, which older BEs can not read, so only enable it once all BEs are upgraded.
+DECLARE_mBool(enable_jsonb_container_index);
 
 // Threshold fo reading a small file into memory
 DECLARE_mInt32(in_memory_file_size);
@@ -932,6 +980,17 @@ DECLARE_mInt32(parquet_header_max_size_mb);
 DECLARE_mInt32(parquet_rowgroup_max_buffer_mb);
 // Max buffer size for parquet chunk column
 DECLARE_mInt32(parquet_column_max_buffer_mb);
+// Whether to skip the parquet row groups whose dictionary pages hold none of the values of an
+// IN or EQ predicate
+DECLARE_mBool(enable_parquet_dict_filter);
+// Whether to skip the parquet row groups whose bloom filters hold none of the values of an
+// IN or EQ predicate
+DECLARE_mBool(enable_parquet_bloom_filter);
+// Whether to read the column chunks of the coming row groups of a remote parquet file ahead of
+// the decoder, and the footer of the next parquet file of a scanner
+DECLARE_mBool(enable_parquet_prefetch);
+// Max memory of the row groups read ahead by a parquet reader
+DECLARE_mInt64(parquet_prefetch_budget_bytes);
 // Merge small IO, the max amplified read ratio
 DECLARE_mDouble(max_amplified_read_ratio);
 // Equivalent min size of each IO that can reach the maximum storage speed limit
@@ -1022,6 +1081,16 @@ DECLARE_Bool(enable_fuzzy_mode);
 DECLARE_Bool(enable_debug_points);
 
 DECLARE_Int32(pipeline_executor_size);
+// If true and the machine has more than one NUMA node, pipeline executor threads are split
+// into one group per NUMA node and bound to the cores of that node, tasks prefer to stay and
+// be stolen within the same node.
+DECLARE_Bool(enable_numa_aware_scheduling);
+// Interleave the memory of shared broadcast hash tables over all NUMA nodes, so that the
+// probe tasks on every node see the same memory latency.
+DECLARE_mBool(numa_interleave_shared_hash_table);
+// Allocate the pages inserted into StoragePageCache from a memory arena interleaved over all
+// NUMA nodes.
+DECLARE_mBool(numa_interleave_page_cache);
 
 // Temp config. True to use optimization for bitmap_index apply predicate except leaf node of the and node.
 // Will remove after fully test.
@@ -1032,13 +1101,29 @@ DECLARE_Bool(enable_file_cache);
 // format: [{"path":"/path/to/file_cache","total_size":21474836480,"query_limit":10737418240}]
 // format: [{"path":"/path/to/file_cache","total_size":21474836480,"query_limit":10737418240},{"path":"/path/to/file_cache2","total_size":21474836480,"query_limit":10737418240}]
 // format: [{"path":"/path/to/file_cache","total_size":21474836480,"query_limit":10737418240,"normal_percent":85, "disposable_percent":10, "index_percent":5}]
+// "storage":"slab" keeps the blocks of a path in the slots of a few preallocated slab files
+// instead of a file per block, "direct_io":true reads and writes the slab files with O_DIRECT.
+// Switching the storage of a path drops the blocks cached in the other one.
+// format: [{"path":"/path/to/file_cache","total_size":21474836480,"query_limit":10737418240,"storage":"slab","direct_io":true}]
 DECLARE_String(file_cache_path);
 DECLARE_Int64(file_cache_min_file_segment_size);
 DECLARE_Int64(file_cache_max_file_segment_size);
+// The max size of a slab file of the slab storage of the file cache. The slots of the slab
+// storage are of file_cache_max_file_segment_size.
+DECLARE_Int64(file_cache_slab_file_size);
 DECLARE_Bool(clear_file_cache);
 DECLARE_Bool(enable_file_cache_query_limit);
 // only for debug, will be removed after finding out the root cause
 DECLARE_mInt32(file_cache_wait_sec_after_fail); // zero for no waiting and retrying
+// Whether to write the blocks read from remote storage into the file cache in the background,
+// so that a query does not wait for the local disk
+DECLARE_mBool(enable_file_cache_write_behind);
+DECLARE_Int32(file_cache_write_behind_thread_num);
+// Max blocks waiting to be written into the file cache, the blocks beyond it are not cached
+DECLARE_Int32(file_cache_write_behind_queue_size);
+// Max bytes of the blocks waiting to be written into the file cache, the blocks beyond it are
+// not cached
+DECLARE_mInt64(file_cache_write_behind_max_bytes);
 
 // inverted index searcher cache
 // cache entry stay time after lookup
@@ -1072,6 +1157,21 @@ DECLARE_Int32(num_broadcast_buffer);
 
 // max depth of expression tree allowed.
 DECLARE_Int32(max_depth_of_expr_tree);
+// CASE, IF, COALESCE and IFNULL evaluate a non trivial branch only on the rows that select it,
+// and conjuncts only on the rows that passed the previous ones, unless more than this ratio of
+// the rows of the block is selected, in which case the whole block is evaluated instead of
+// copying the selected rows out. 0 disables it.
+DECLARE_mDouble(selective_branch_evaluation_max_density);
+// Evaluate the conjuncts of an operator in increasing order of cost / (1 - selectivity), as
+// observed on the previous blocks.
+DECLARE_mBool(enable_adaptive_conjunct_order);
+// Deterministic string functions such as upper, substring, regexp_extract or get_json_string
+// are evaluated once per distinct value of their string argument and the results gathered back,
+// when the block has at most this ratio of distinct values. 0 disables it.
+DECLARE_mDouble(dictionary_function_evaluation_max_ratio);
+// Identical deterministic subexpressions of the conjuncts and projections of an operator are
+// evaluated once per block, the other occurrences reuse the result.
+DECLARE_mBool(enable_common_subexpr_elimination);
 
 // Report a tablet as bad when io errors occurs more than this value.
 DECLARE_mInt64(max_tablet_io_errors);
@@ -1109,6 +1209,10 @@ DECLARE_Int32(max_hdfs_file_handle_cache_time_sec);
 
 // max number of meta info of external files, such as parquet footer
 DECLARE_Int64(max_external_file_meta_cache_num);
+// memory limit of the rows of iceberg delete files cached across queries
+DECLARE_String(iceberg_delete_file_cache_limit);
+// cache entry that have not been visited for a certain period of time can be cleaned up by GC thread
+DECLARE_mInt32(iceberg_delete_file_cache_stale_sweep_time_sec);
 // Apply delete pred in cumu compaction
 DECLARE_mBool(enable_delete_when_cumu_compaction);
 
@@ -1179,6 +1283,9 @@ DECLARE_Int32(grace_shutdown_wait_seconds);
 
 // BitmapValue serialize version.
 DECLARE_Int16(bitmap_serialize_version);
+// Serialized roaring bitmaps not smaller than this are read as frozen views over the serialized
+// bytes instead of being decoded, -1 means always decode.
+DECLARE_mInt64(frozen_bitmap_min_bytes);
 
 // group commit config
 DECLARE_String(group_commit_wal_path);
@@ -1196,6 +1303,11 @@ DECLARE_mInt32(group_commit_queue_mem_limit);
 // group_commit_wal_max_disk_limit=1024 or group_commit_wal_max_disk_limit=10% can be automatically identified.
 DECLARE_mString(group_commit_wal_max_disk_limit);
 DECLARE_Bool(group_commit_wait_replay_wal_finish);
+// Whether the group commit wals of a wal dir are appended to one log shared by all the loads,
+// fsynced by a single thread for all of them, instead of being written to a file per wal.
+DECLARE_Bool(group_commit_enable_shared_wal);
+// Size(bytes) preallocated for each segment of the shared wal log.
+DECLARE_mInt64(group_commit_shared_wal_segment_bytes);
 
 // The configuration item is used to lower the priority of the scanner thread,
 // typically employed to ensure CPU scheduling for write operations.
@@ -227,6 +227,10 @@ Status CompactionAction::_handle_run_status_compaction(HttpRequest* req, std::st
     }
 }
 
+Status CompactionAction::_handle_show_schedule(HttpRequest* req, std::string* json_result) {
+    return _engine.compaction_scheduler().get_status_json(json_result);
+}
+
 Status CompactionAction::_execute_compaction_callback(TabletSharedPtr tablet,
                                                       const std::string& compaction_type) {
     MonotonicStopWatch timer;
@@ -305,6 +309,14 @@ void CompactionAction::handle(HttpRequest* req) {
         } else {
             HttpChannel::send_reply(req, HttpStatus::OK, json_result);
         }
+    } else if (_type == CompactionActionType::SHOW_SCHEDULE) {
+        std::string json_result;
+        Status st = _handle_show_schedule(req, &json_result);
+        if (!st.ok()) {
+            HttpChannel::send_reply(req, HttpStatus::OK, st.to_json());
+        } else {
+            HttpChannel::send_reply(req, HttpStatus::OK, json_result);
+        }
     } else {
         std::string json_result;
         Status st = _handle_run_status_compaction(req, &json_result);
@@ -34,6 +34,7 @@ enum class CompactionActionType {
     SHOW_INFO = 1,
     RUN_COMPACTION = 2,
     RUN_COMPACTION_STATUS = 3,
+    SHOW_SCHEDULE = 4,
 };
 
 const std::string PARAM_COMPACTION_TYPE = "compact_type";
@@ -65,6 +66,9 @@ private:
     /// fetch compaction running status
     Status _handle_run_status_compaction(HttpRequest* req, std::string* json_result);
 
+    /// fetch the decisions of the compaction scheduler
+    Status _handle_show_schedule(HttpRequest* req, std::string* json_result);
+
 private:
     StorageEngine& _engine;
     CompactionActionType _type;
@@ -30,6 +30,7 @@
 #include <utility>
 
 #include "io/cache/block/block_file_cache_fwd.h"
+#include "io/cache/block/block_file_cache_slab_storage.h"
 #include "io/cache/block/block_file_cache_settings.h"
 #include "vec/common/hex.h"
 #include "vec/common/sip_hash.h"
@@ -46,6 +47,17 @@ IFileCache::IFileCache(const std::string& cache_base_path, const FileCacheSettin
           _max_query_cache_size(cache_settings.max_query_cache_size) {
     _cur_size_metrics =
             std::make_shared<bvar::Status<size_t>>(_cache_base_path.c_str(), "cur_size", 0);
+    if (cache_settings.storage == FileCacheStorage::SLAB) {
+        _slab_storage = std::make_unique<SlabFileStorage>(
+                _cache_base_path, _total_size, _max_file_segment_size,
+                cache_settings.slab_file_size, cache_settings.slab_direct_io);
+    }
+}
+
+IFileCache::~IFileCache() = default;
+
+size_t IFileCache::reserved_size(size_t size) const {
+    return _slab_storage ? _slab_storage->slot_size() : size;
 }
 
 std::string IFileCache::Key::to_string() const {
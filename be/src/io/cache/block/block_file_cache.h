@@ -45,6 +45,7 @@
 namespace doris {
 namespace io {
 class FileBlock;
+class SlabFileStorage;
 
 using FileBlockSPtr = std::shared_ptr<FileBlock>;
 using FileBlocks = std::list<FileBlockSPtr>;
@@ -104,7 +105,7 @@ public:
 
     IFileCache(const std::string& cache_base_path, const FileCacheSettings& cache_settings);
 
-    virtual ~IFileCache() = default;
+    virtual ~IFileCache();
 
     /// Restore cache from local filesystem.
     virtual Status initialize() = 0;
@@ -124,6 +125,12 @@ public:
 
     const std::string& get_base_path() const { return _cache_base_path; }
 
+    // The storage of the blocks in slab files, null if a block is a file of its own.
+    SlabFileStorage* slab_storage() const { return _slab_storage.get(); }
+
+    // The space a block of size bytes takes in the cache, a whole slot of the slab storage.
+    size_t reserved_size(size_t size) const;
+
     /**
      * Given an `offset` and `size` representing [offset, offset + size) bytes interval,
      * return list of cached non-overlapping non-empty
@@ -159,6 +166,7 @@ protected:
     size_t _total_size = 0;
     size_t _max_file_segment_size = 0;
     size_t _max_query_cache_size = 0;
+    std::unique_ptr<SlabFileStorage> _slab_storage;
     // metrics
     std::shared_ptr<bvar::Status<size_t>> _cur_size_metrics;
 
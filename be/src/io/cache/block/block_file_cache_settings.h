@@ -27,6 +27,14 @@
 namespace doris {
 namespace io {
 
+// How the blocks of a file cache are stored on the local disk.
+enum class FileCacheStorage {
+    // a file per block, under a directory per key
+    FILE,
+    // the fixed size slots of a few preallocated slab files, see SlabFileStorage
+    SLAB,
+};
+
 struct FileCacheSettings {
     size_t total_size {0};
     size_t disposable_queue_size {0};
@@ -37,6 +45,11 @@ struct FileCacheSettings {
     size_t query_queue_elements {0};
     size_t max_file_segment_size {0};
     size_t max_query_cache_size {0};
+    FileCacheStorage storage {FileCacheStorage::FILE};
+    // the max size of a slab file
+    size_t slab_file_size {0};
+    // read and write the slab files with O_DIRECT
+    bool slab_direct_io {false};
 };
 
 } // namespace io
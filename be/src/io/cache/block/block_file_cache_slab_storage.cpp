@@ -0,0 +1,456 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "io/cache/block/block_file_cache_slab_storage.h"
+
+// IWYU pragma: no_include <bthread/errno.h>
+#include <errno.h> // IWYU pragma: keep
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <glog/logging.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+#include <utility>
+
+#include "common/compiler_util.h" // IWYU pragma: keep
+#include "gutil/macros.h"
+#include "io/fs/err_utils.h"
+#include "util/doris_metrics.h"
+
+namespace fs = std::filesystem;
+
+namespace doris {
+namespace io {
+
+static_assert(sizeof(SlabFileStorage::SlotRecord) == 32);
+
+static bool is_aligned(size_t value) {
+    return value % SlabFileStorage::DIRECT_IO_ALIGNMENT == 0;
+}
+
+static size_t align_up(size_t value) {
+    return (value + SlabFileStorage::DIRECT_IO_ALIGNMENT - 1) /
+           SlabFileStorage::DIRECT_IO_ALIGNMENT * SlabFileStorage::DIRECT_IO_ALIGNMENT;
+}
+
+static Status pread_fully(int fd, char* to, size_t size, size_t offset, const std::string& path) {
+    while (size != 0) {
+        auto res = ::pread(fd, to, size, offset);
+        if (UNLIKELY(-1 == res && errno != EINTR)) {
+            return localfs_error(errno, fmt::format("failed to read {}", path));
+        }
+        if (UNLIKELY(res == 0)) {
+            return Status::InternalError("cannot read from {}: unexpected EOF", path);
+        }
+        if (res > 0) {
+            to += res;
+            offset += res;
+            size -= res;
+        }
+    }
+    return Status::OK();
+}
+
+static Status pwrite_fully(int fd, const char* from, size_t size, size_t offset,
+                           const std::string& path) {
+    while (size != 0) {
+        auto res = ::pwrite(fd, from, size, offset);
+        if (UNLIKELY(-1 == res && errno != EINTR)) {
+            return localfs_error(errno, fmt::format("failed to write {}", path));
+        }
+        if (res > 0) {
+            from += res;
+            offset += res;
+            size -= res;
+        }
+    }
+    return Status::OK();
+}
+
+SlabFileStorage::SlabFileStorage(std::string dir, size_t capacity, size_t slot_size,
+                                 size_t slab_file_size, bool direct_io)
+        : _dir(std::move(dir)),
+          _slot_size(slot_size),
+          _slots_per_slab(std::max<size_t>(slab_file_size / slot_size, 1)),
+          _num_slots(capacity / slot_size),
+          _direct_io(direct_io) {}
+
+SlabFileStorage::~SlabFileStorage() {
+    for (int fd : _slab_fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (_index_fd >= 0) {
+        ::close(_index_fd);
+    }
+}
+
+std::string SlabFileStorage::slab_path(size_t slab) const {
+    return fs::path(_dir) / fmt::format("slab_{}", slab);
+}
+
+std::string SlabFileStorage::index_path() const {
+    return fs::path(_dir) / "slab_index";
+}
+
+Status SlabFileStorage::open(const RestoreFunc& restore) {
+    if (_num_slots == 0) {
+        return Status::InvalidArgument("the capacity of {} is less than a slot of {} bytes", _dir,
+                                       _slot_size);
+    }
+    if (_direct_io && !is_aligned(_slot_size)) {
+        return Status::InvalidArgument("the slot size {} of {} is not aligned to {} for direct io",
+                                       _slot_size, _dir, DIRECT_IO_ALIGNMENT);
+    }
+    std::error_code ec;
+    fs::create_directories(_dir, ec);
+    if (ec) {
+        return Status::IOError("cannot create {}: {}", _dir, std::strerror(ec.value()));
+    }
+
+    size_t num_slabs = (_num_slots + _slots_per_slab - 1) / _slots_per_slab;
+    _slab_fds.assign(num_slabs, -1);
+    for (size_t slab = 0; slab < num_slabs; ++slab) {
+        size_t slots = std::min(_slots_per_slab, _num_slots - slab * _slots_per_slab);
+        RETURN_IF_ERROR(open_slab(slab, slots * _slot_size));
+    }
+    // the slab files left by a larger capacity
+    for (size_t slab = num_slabs; fs::exists(slab_path(slab), ec); ++slab) {
+        fs::remove(slab_path(slab), ec);
+        if (ec) {
+            LOG(WARNING) << "failed to remove " << slab_path(slab) << ": " << ec.message();
+            break;
+        }
+    }
+    return open_index(restore);
+}
+
+Status SlabFileStorage::open_slab(size_t slab, size_t size) {
+    auto path = slab_path(slab);
+    int flags = O_RDWR | O_CREAT | O_CLOEXEC;
+    if (_direct_io) {
+        flags |= O_DIRECT;
+    }
+    int fd = -1;
+    RETRY_ON_EINTR(fd, ::open(path.c_str(), flags, 0666));
+    if (fd < 0) {
+        return localfs_error(errno, fmt::format("failed to open {}", path));
+    }
+    _slab_fds[slab] = fd;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return localfs_error(errno, fmt::format("failed to stat {}", path));
+    }
+    size_t file_size = st.st_size;
+    if (file_size == size) {
+        return Status::OK();
+    }
+    if (file_size > size && ftruncate(fd, size) != 0) {
+        return localfs_error(errno, fmt::format("failed to truncate {}", path));
+    }
+    // Allocate the whole file at once, so that it is contiguous on disk and the writes of the
+    // cache never run out of space.
+    int res = posix_fallocate(fd, 0, size);
+    if (res != 0) {
+        return localfs_error(res, fmt::format("failed to preallocate {} bytes for {}", size, path));
+    }
+    return Status::OK();
+}
+
+Status SlabFileStorage::open_index(const RestoreFunc& restore) {
+    auto path = index_path();
+    int fd = -1;
+    RETRY_ON_EINTR(fd, ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666));
+    if (fd < 0) {
+        return localfs_error(errno, fmt::format("failed to open {}", path));
+    }
+    _index_fd = fd;
+
+    IndexHeader expected;
+    expected.magic = INDEX_MAGIC;
+    expected.slot_size = _slot_size;
+    expected.slots_per_slab = _slots_per_slab;
+    expected.num_slots = _num_slots;
+    size_t index_size = sizeof(IndexHeader) + _num_slots * sizeof(SlotRecord);
+
+    std::vector<SlotRecord> records(_num_slots);
+    IndexHeader header;
+    struct stat st;
+    bool valid = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == index_size &&
+                 pread_fully(fd, reinterpret_cast<char*>(&header), sizeof(header), 0, path).ok() &&
+                 memcmp(&header, &expected, sizeof(header)) == 0 &&
+                 pread_fully(fd, reinterpret_cast<char*>(records.data()),
+                             _num_slots * sizeof(SlotRecord), sizeof(IndexHeader), path)
+                         .ok();
+    bool need_sync = !valid;
+    if (!valid) {
+        // A new cache, or the slots are laid out differently, the cached blocks are dropped.
+        LOG(INFO) << "Reset the slab index " << path;
+        records.assign(_num_slots, SlotRecord());
+        if (ftruncate(fd, 0) != 0 || ftruncate(fd, index_size) != 0) {
+            return localfs_error(errno, fmt::format("failed to truncate {}", path));
+        }
+        RETURN_IF_ERROR(pwrite_fully(fd, reinterpret_cast<const char*>(&expected),
+                                     sizeof(expected), 0, path));
+    }
+
+    _recorded.assign(_num_slots, false);
+    for (uint32_t slot = 0; slot < _num_slots; ++slot) {
+        const auto& record = records[slot];
+        if (record.size == 0) {
+            continue;
+        }
+        // the ttl blocks are not kept by the lru cache
+        bool valid_record = record.size <= _slot_size &&
+                            record.cache_type < static_cast<uint32_t>(CacheType::TTL);
+        if (valid_record &&
+            restore(slot, IFileCache::Key(uint128_t(record.key_low, record.key_high)),
+                    record.offset, record.size, static_cast<CacheType>(record.cache_type))) {
+            _recorded[slot] = true;
+        } else {
+            RETURN_IF_ERROR(write_record(slot, SlotRecord()));
+            need_sync = true;
+        }
+    }
+    // The restored blocks may be released while restoring, so the free slots are taken after,
+    // with the cleared records synced.
+    {
+        std::lock_guard lock(_mutex);
+        need_sync |= !_released_slots.empty();
+        _released_slots.clear();
+    }
+    if (need_sync) {
+        RETURN_IF_ERROR(sync_index());
+    }
+    _free_slots.clear();
+    for (uint32_t slot = _num_slots; slot-- > 0;) {
+        if (!_recorded[slot]) {
+            _free_slots.push_back(slot);
+        }
+    }
+    LOG(INFO) << fmt::format("Open slab storage {}, slots={}, slot size={}, free slots={}", _dir,
+                             _num_slots, _slot_size, _free_slots.size());
+    return Status::OK();
+}
+
+Status SlabFileStorage::write_record(uint32_t slot, const SlotRecord& record) {
+    return pwrite_fully(_index_fd, reinterpret_cast<const char*>(&record), sizeof(record),
+                        sizeof(IndexHeader) + slot * sizeof(SlotRecord), index_path());
+}
+
+Status SlabFileStorage::sync_index() {
+    int res = 0;
+    RETRY_ON_EINTR(res, fdatasync(_index_fd));
+    if (res != 0) {
+        return localfs_error(errno, fmt::format("failed to sync {}", index_path()));
+    }
+    return Status::OK();
+}
+
+bool SlabFileStorage::allocate(uint32_t* slot) {
+    std::lock_guard lock(_mutex);
+    if (_free_slots.empty() && !_released_slots.empty()) {
+        // The cleared records of the released slots have to be on disk before the slots are
+        // written again, otherwise after a crash a stale record would restore its key with the
+        // data of another block. The released slots are synced in a batch.
+        Status st = sync_index();
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to reuse the released slots of " << _dir << ": "
+                         << st.to_string();
+            return false;
+        }
+        _free_slots.insert(_free_slots.end(), _released_slots.rbegin(), _released_slots.rend());
+        _released_slots.clear();
+    }
+    if (_free_slots.empty()) {
+        return false;
+    }
+    *slot = _free_slots.back();
+    _free_slots.pop_back();
+    return true;
+}
+
+void SlabFileStorage::release(uint32_t slot) {
+    std::lock_guard lock(_mutex);
+    if (_recorded[slot]) {
+        Status st = write_record(slot, SlotRecord());
+        if (!st.ok()) {
+            // The slot is kept out of use, otherwise the record would restore another block.
+            LOG(WARNING) << "failed to release slot " << slot << " of " << _dir << ": "
+                         << st.to_string();
+            return;
+        }
+        _recorded[slot] = false;
+        _released_slots.push_back(slot);
+        return;
+    }
+    _free_slots.push_back(slot);
+}
+
+Status SlabFileStorage::commit(uint32_t slot, const IFileCache::Key& key, size_t offset,
+                               size_t size, CacheType cache_type) {
+    DCHECK_LE(size, _slot_size);
+    SlotRecord record;
+    record.key_low = key.key.low;
+    record.key_high = key.key.high;
+    record.offset = offset;
+    record.size = size;
+    record.cache_type = cache_type;
+    bool recorded = false;
+    {
+        std::lock_guard lock(_mutex);
+        recorded = _recorded[slot];
+    }
+    if (!recorded) {
+        // The data of the block have to be on disk before its record, otherwise after a crash
+        // the record could restore the key with the stale data of the slot, or with the zeros
+        // of a preallocated extent that is not marked written yet. Neither a direct write nor
+        // sync_file_range() persists the extent state or flushes the cache of the device, so
+        // the slab file is synced.
+        size_t file_offset = 0;
+        int fd = fd_of(slot, &file_offset);
+        int res = 0;
+        RETRY_ON_EINTR(res, fdatasync(fd));
+        if (res != 0) {
+            return localfs_error(errno, fmt::format("failed to sync slot {} of {}", slot,
+                                                    slab_path(slot / _slots_per_slab)));
+        }
+    }
+    std::lock_guard lock(_mutex);
+    RETURN_IF_ERROR(write_record(slot, record));
+    _recorded[slot] = true;
+    return Status::OK();
+}
+
+size_t SlabFileStorage::num_free_slots() const {
+    std::lock_guard lock(_mutex);
+    return _free_slots.size() + _released_slots.size();
+}
+
+int SlabFileStorage::fd_of(uint32_t slot, size_t* file_offset) const {
+    DCHECK_LT(slot, _num_slots);
+    *file_offset = (slot % _slots_per_slab) * _slot_size;
+    return _slab_fds[slot / _slots_per_slab];
+}
+
+Status SlabFileStorage::write(uint32_t slot, size_t offset, Slice data) {
+    DCHECK_LE(offset + data.size, _slot_size);
+    DCHECK(!_direct_io || (is_aligned(offset) && is_aligned(data.size) &&
+                           is_aligned(reinterpret_cast<uintptr_t>(data.data))));
+    size_t file_offset = 0;
+    int fd = fd_of(slot, &file_offset);
+    RETURN_IF_ERROR(pwrite_fully(fd, data.data, data.size, file_offset + offset,
+                                 slab_path(slot / _slots_per_slab)));
+    DorisMetrics::instance()->local_bytes_written_total->increment(data.size);
+    return Status::OK();
+}
+
+Status SlabFileStorage::read(uint32_t slot, size_t offset, Slice buffer) {
+    DCHECK_LE(offset + buffer.size, _slot_size);
+    size_t file_offset = 0;
+    int fd = fd_of(slot, &file_offset);
+    file_offset += offset;
+    if (!_direct_io || (is_aligned(file_offset) && is_aligned(buffer.size) &&
+                        is_aligned(reinterpret_cast<uintptr_t>(buffer.data)))) {
+        RETURN_IF_ERROR(pread_fully(fd, buffer.data, buffer.size, file_offset,
+                                    slab_path(slot / _slots_per_slab)));
+    } else {
+        // The slots are aligned, so the aligned range does not leave the slot.
+        size_t begin = file_offset / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+        size_t end = align_up(file_offset + buffer.size);
+        char* aligned = nullptr;
+        if (posix_memalign(reinterpret_cast<void**>(&aligned), DIRECT_IO_ALIGNMENT, end - begin) !=
+            0) {
+            return Status::MemoryAllocFailed("failed to allocate {} bytes to read {}",
+                                             end - begin, _dir);
+        }
+        std::unique_ptr<char, decltype(&free)> guard(aligned, &free);
+        RETURN_IF_ERROR(
+                pread_fully(fd, aligned, end - begin, begin, slab_path(slot / _slots_per_slab)));
+        memcpy(buffer.data, aligned + (file_offset - begin), buffer.size);
+    }
+    DorisMetrics::instance()->local_bytes_read_total->increment(buffer.size);
+    return Status::OK();
+}
+
+SlabSlotWriter::SlabSlotWriter(SlabFileStorage* storage, uint32_t slot)
+        : _storage(storage), _slot(slot) {}
+
+SlabSlotWriter::~SlabSlotWriter() {
+    free(_buffer);
+}
+
+Status SlabSlotWriter::append(Slice data) {
+    if (!_storage->direct_io()) {
+        RETURN_IF_ERROR(_storage->write(_slot, _written, data));
+        _written += data.size;
+        _bytes_appended += data.size;
+        return Status::OK();
+    }
+    if (_buffer == nullptr) {
+        _buffer_size = std::min(WRITE_BUFFER_SIZE, _storage->slot_size());
+        if (posix_memalign(reinterpret_cast<void**>(&_buffer),
+                           SlabFileStorage::DIRECT_IO_ALIGNMENT, _buffer_size) != 0) {
+            _buffer = nullptr;
+            return Status::MemoryAllocFailed("failed to allocate {} bytes to write slot {}",
+                                             _buffer_size, _slot);
+        }
+    }
+    const char* from = data.data;
+    size_t remaining = data.size;
+    while (remaining > 0) {
+        size_t size = std::min(remaining, _buffer_size - _buffered);
+        memcpy(_buffer + _buffered, from, size);
+        _buffered += size;
+        _bytes_appended += size;
+        from += size;
+        remaining -= size;
+        if (_buffered == _buffer_size) {
+            RETURN_IF_ERROR(flush(_buffer_size));
+        }
+    }
+    return Status::OK();
+}
+
+Status SlabSlotWriter::flush(size_t size) {
+    RETURN_IF_ERROR(_storage->write(_slot, _written, Slice(_buffer, size)));
+    _written += size;
+    _buffered = 0;
+    return Status::OK();
+}
+
+Status SlabSlotWriter::close() {
+    if (_buffered > 0) {
+        size_t size = align_up(_buffered);
+        memset(_buffer + _buffered, 0, size - _buffered);
+        RETURN_IF_ERROR(flush(size));
+    }
+    return Status::OK();
+}
+
+} // namespace io
+} // namespace doris
@@ -0,0 +1,186 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "io/cache/block/block_file_cache.h"
+#include "util/slice.h"
+
+namespace doris {
+namespace io {
+
+/**
+ * Stores the blocks of a file cache in a few large preallocated slab files instead of a file per
+ * block. A slab file is split into slots of a fixed size, each holding one block, so a cached
+ * read is a pread of an opened slab file and there are no files to create, remove or list.
+ *
+ * The blocks in the slots are recorded in an index file, which is read at startup to restore
+ * the cache. Unlike a file of the file layout, a slot is reused by other blocks, so a record
+ * must never reach the disk without the data it points to: the slab file is synced before a
+ * block is recorded, and a released slot is reused only after its cleared record is synced.
+ *
+ * dir / slab_<n>: the slab files
+ * dir / slab_index: a header and a record per slot
+ */
+class SlabFileStorage {
+public:
+    // The alignment of the offsets, sizes and buffers of direct IO.
+    static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+    // The record of a slot in the index file. A free slot has size 0.
+    struct SlotRecord {
+        uint64_t key_low = 0;
+        uint64_t key_high = 0;
+        uint64_t offset = 0;
+        uint32_t size = 0;
+        uint32_t cache_type = 0;
+    };
+
+    // Called for the recorded blocks at open, returns false to drop the block.
+    using RestoreFunc = std::function<bool(uint32_t slot, const IFileCache::Key& key,
+                                           size_t offset, size_t size, CacheType cache_type)>;
+
+    /**
+     * dir: the directory of the slab and index files
+     * capacity: the bytes of all slots, rounded down to whole slots
+     * slot_size: the max size of a block
+     * slab_file_size: the max size of a slab file, rounded down to whole slots
+     * direct_io: read and write the slab files with O_DIRECT
+     */
+    SlabFileStorage(std::string dir, size_t capacity, size_t slot_size, size_t slab_file_size,
+                    bool direct_io);
+
+    ~SlabFileStorage();
+
+    // Creates and preallocates the slab files, and restores the recorded blocks.
+    Status open(const RestoreFunc& restore);
+
+    // Takes a free slot, returns false if all slots are in use.
+    bool allocate(uint32_t* slot);
+
+    // Unrecords the block in the slot and makes the slot free. The slot is reused once the
+    // index is synced, which allocate() does for the released slots in a batch.
+    void release(uint32_t slot);
+
+    // Records the block written into the slot. It is called again when the cache type changes.
+    Status commit(uint32_t slot, const IFileCache::Key& key, size_t offset, size_t size,
+                  CacheType cache_type);
+
+    // Writes data at offset of the slot. With direct IO, the offset, the size and the data
+    // must be aligned to DIRECT_IO_ALIGNMENT.
+    Status write(uint32_t slot, size_t offset, Slice data);
+
+    // Reads buffer.size bytes at offset of the slot.
+    Status read(uint32_t slot, size_t offset, Slice buffer);
+
+    size_t slot_size() const { return _slot_size; }
+
+    size_t num_slots() const { return _num_slots; }
+
+    size_t num_free_slots() const;
+
+    bool direct_io() const { return _direct_io; }
+
+    SlabFileStorage& operator=(const SlabFileStorage&) = delete;
+    SlabFileStorage(const SlabFileStorage&) = delete;
+
+private:
+    struct IndexHeader {
+        uint64_t magic = 0;
+        uint64_t slot_size = 0;
+        uint64_t slots_per_slab = 0;
+        uint64_t num_slots = 0;
+    };
+
+    static constexpr uint64_t INDEX_MAGIC = 0x31424c5344524f44; // "DORDSLB1"
+
+    std::string slab_path(size_t slab) const;
+
+    std::string index_path() const;
+
+    Status open_slab(size_t slab, size_t size);
+
+    Status open_index(const RestoreFunc& restore);
+
+    Status write_record(uint32_t slot, const SlotRecord& record);
+
+    Status sync_index();
+
+    int fd_of(uint32_t slot, size_t* file_offset) const;
+
+    const std::string _dir;
+    const size_t _slot_size;
+    const size_t _slots_per_slab;
+    const size_t _num_slots;
+    const bool _direct_io;
+
+    std::vector<int> _slab_fds;
+    int _index_fd = -1;
+
+    mutable std::mutex _mutex;
+    // the free slots, taken from the back
+    std::vector<uint32_t> _free_slots;
+    // the released slots whose cleared records are not synced yet
+    std::vector<uint32_t> _released_slots;
+    // whether the block in the slot is recorded in the index file
+    std::vector<bool> _recorded;
+};
+
+/**
+ * Writes a block into its slot sequentially. With direct IO, the data are staged in an aligned
+ * buffer and written in aligned chunks, the tail padded to the alignment.
+ */
+class SlabSlotWriter {
+public:
+    SlabSlotWriter(SlabFileStorage* storage, uint32_t slot);
+
+    ~SlabSlotWriter();
+
+    Status append(Slice data);
+
+    // Writes the staged data.
+    Status close();
+
+    size_t bytes_appended() const { return _bytes_appended; }
+
+private:
+    static constexpr size_t WRITE_BUFFER_SIZE = 1024 * 1024;
+
+    Status flush(size_t size);
+
+    SlabFileStorage* _storage = nullptr;
+    const uint32_t _slot;
+    size_t _bytes_appended = 0;
+    // the bytes written into the slot
+    size_t _written = 0;
+
+    char* _buffer = nullptr;
+    size_t _buffer_size = 0;
+    size_t _buffered = 0;
+};
+
+} // namespace io
+} // namespace doris
@@ -21,6 +21,7 @@
 #include "io/cache/block/block_file_segment.h"
 
 #include <glog/logging.h>
+#include <string.h>
 // IWYU pragma: no_include <bits/chrono.h>
 #include <chrono> // IWYU pragma: keep
 #include <sstream>
@@ -28,6 +29,7 @@
 #include <thread>
 
 #include "common/status.h"
+#include "io/cache/block/block_file_cache_slab_storage.h"
 #include "io/fs/file_reader.h"
 #include "io/fs/file_writer.h"
 #include "io/fs/local_file_system.h"
@@ -137,6 +139,11 @@ void FileBlock::reset_downloader_impl(std::lock_guard<std::mutex>& segment_lock)
         _download_state = State::EMPTY;
         _downloader_id.clear();
         _cache_writer.reset();
+        _slot_writer.reset();
+        // the data of a failed write behind is dropped together with the reset, so that no
+        // reader takes the partially written file for it
+        _handed_over_data.reset();
+        _has_handed_over_data = false;
     }
 }
 
@@ -157,17 +164,24 @@ bool FileBlock::is_downloader_impl(std::lock_guard<std::mutex>& /* segment_lock
 Status FileBlock::append(Slice data) {
     DCHECK(data.size != 0) << "Writing zero size is not allowed";
     Status st = Status::OK();
-    if (!_cache_writer) {
-        auto download_path = get_path_in_local_cache();
-        FileWriterOptions not_sync {.sync_file_data = false};
-        st = global_local_filesystem()->create_file(download_path, &_cache_writer, &not_sync);
-        if (!st) {
-            _cache_writer.reset();
-            return st;
+    if (_slot >= 0) {
+        if (!_slot_writer) {
+            _slot_writer = std::make_unique<SlabSlotWriter>(_cache->slab_storage(), _slot);
+        }
+        RETURN_IF_ERROR(_slot_writer->append(data));
+    } else {
+        if (!_cache_writer) {
+            auto download_path = get_path_in_local_cache();
+            FileWriterOptions not_sync {.sync_file_data = false};
+            st = global_local_filesystem()->create_file(download_path, &_cache_writer, &not_sync);
+            if (!st) {
+                _cache_writer.reset();
+                return st;
+            }
         }
-    }
 
-    RETURN_IF_ERROR(_cache_writer->append(data));
+        RETURN_IF_ERROR(_cache_writer->append(data));
+    }
 
     std::lock_guard download_lock(_download_mutex);
 
@@ -181,6 +195,27 @@ std::string FileBlock::get_path_in_local_cache() const {
 
 Status FileBlock::read_at(Slice buffer, size_t read_offset) {
     Status st = Status::OK();
+    if (_has_handed_over_data) {
+        std::shared_ptr<const char> data;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            data = _handed_over_data;
+        }
+        if (data != nullptr) {
+            DCHECK_LE(read_offset + buffer.size, range().size());
+            memcpy(buffer.data, data.get() + read_offset, buffer.size);
+            return st;
+        }
+    }
+    if (state() != State::DOWNLOADED) {
+        // the handed over data is gone while the segment is not written, the reader fails over
+        // to the remote file
+        return Status::InternalError("File cache segment {} is not downloaded",
+                                     range().to_string());
+    }
+    if (_slot >= 0) {
+        return _cache->slab_storage()->read(_slot, read_offset, buffer);
+    }
     std::shared_ptr<FileReader> reader;
     if (!(reader = _cache_reader.lock())) {
         std::lock_guard<std::mutex> lock(_mutex);
@@ -202,7 +237,14 @@ bool FileBlock::change_cache_type(CacheType new_type) {
     if (new_type == _cache_type) {
         return true;
     }
-    if (_download_state == State::DOWNLOADED) {
+    if (_download_state == State::DOWNLOADED && _slot >= 0) {
+        Status st = _cache->slab_storage()->commit(_slot, key(), offset(), _downloaded_size,
+                                                   new_type);
+        if (!st.ok()) {
+            LOG(ERROR) << "change cache type failed due to " << st.to_string();
+            return false;
+        }
+    } else if (_download_state == State::DOWNLOADED) {
         std::error_code ec;
         std::filesystem::rename(get_path_in_local_cache(),
                                 _cache->get_path_in_local_cache(key(), offset(), new_type), ec);
@@ -235,6 +277,29 @@ Status FileBlock::finalize_write() {
     return Status::OK();
 }
 
+void FileBlock::hand_over_download(std::shared_ptr<const char> data) {
+    std::lock_guard segment_lock(_mutex);
+    DCHECK(is_downloader_impl(segment_lock));
+    _handed_over_data = std::move(data);
+    _has_handed_over_data = true;
+    // Nobody is the downloader until the background writer takes over, so that the holder of
+    // the handing thread leaves the segment DOWNLOADING.
+    _downloader_id = WRITE_BEHIND_DOWNLOADER;
+    _cv.notify_all();
+}
+
+void FileBlock::take_over_download() {
+    std::lock_guard segment_lock(_mutex);
+    DCHECK_EQ(_downloader_id, WRITE_BEHIND_DOWNLOADER);
+    _downloader_id = get_caller_id();
+}
+
+void FileBlock::release_handed_over_data() {
+    std::lock_guard segment_lock(_mutex);
+    _handed_over_data.reset();
+    _has_handed_over_data = false;
+}
+
 FileBlock::State FileBlock::wait() {
     std::unique_lock segment_lock(_mutex);
 
@@ -242,7 +307,8 @@ FileBlock::State FileBlock::wait() {
         return _download_state;
     }
 
-    if (_download_state == State::DOWNLOADING) {
+    // the handed over data can be read while it is written
+    if (_download_state == State::DOWNLOADING && _handed_over_data == nullptr) {
         DCHECK(!_downloader_id.empty());
         DCHECK(_downloader_id != get_caller_id());
 
@@ -261,6 +327,12 @@ Status FileBlock::set_downloaded(std::lock_guard<std::mutex>& /* segment_lock */
         RETURN_IF_ERROR(_cache_writer->close());
         _cache_writer.reset();
     }
+    if (_slot_writer) {
+        RETURN_IF_ERROR(_slot_writer->close());
+        RETURN_IF_ERROR(_cache->slab_storage()->commit(_slot, _file_key, offset(),
+                                                       _downloaded_size, _cache_type));
+        _slot_writer.reset();
+    }
 
     _download_state = State::DOWNLOADED;
     _is_downloaded = true;
@@ -22,6 +22,7 @@
 
 #include <fmt/format.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include <atomic>
 #include <condition_variable>
@@ -41,6 +42,7 @@ namespace io {
 
 class FileBlock;
 class FileReader;
+class SlabSlotWriter;
 
 using FileBlockSPtr = std::shared_ptr<FileBlock>;
 using FileBlocks = std::list<FileBlockSPtr>;
@@ -115,6 +117,19 @@ public:
     // finish write, release the file writer
     Status finalize_write();
 
+    // The downloader hands the fetched data of the segment to a background writer. Until the
+    // write lands, the segment stays DOWNLOADING and read_at() serves the data from memory.
+    void hand_over_download(std::shared_ptr<const char> data);
+
+    // The background writer becomes the downloader of a handed over segment.
+    void take_over_download();
+
+    // Drops the handed over data after the background write finished. The data of a failed
+    // write is dropped when the segment is reset.
+    void release_handed_over_data();
+
+    bool has_handed_over_data() const { return _has_handed_over_data.load(); }
+
     // set downloader if state == EMPTY
     std::string get_or_set_downloader();
 
@@ -148,6 +163,9 @@ public:
     FileBlock(const FileBlock&) = delete;
 
 private:
+    // the downloader of a segment handed over to the background writer
+    static constexpr const char* WRITE_BEHIND_DOWNLOADER = "write_behind";
+
     size_t get_downloaded_size(std::lock_guard<std::mutex>& segment_lock) const;
     std::string get_info_for_log_impl(std::lock_guard<std::mutex>& segment_lock) const;
     bool has_finalized_state() const;
@@ -168,6 +186,14 @@ private:
     LocalWriterPtr _cache_writer;
     LocalReaderPtr _cache_reader;
 
+    // the slot of the block in the slab storage of the cache, -1 if the block is a file
+    int64_t _slot = -1;
+    std::unique_ptr<SlabSlotWriter> _slot_writer;
+
+    // the data handed over to the background writer, protected by _mutex
+    std::shared_ptr<const char> _handed_over_data;
+    std::atomic<bool> _has_handed_over_data {false};
+
     size_t _downloaded_size = 0;
 
     /// global locking order rule:
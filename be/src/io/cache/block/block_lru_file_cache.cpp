@@ -29,6 +29,7 @@
 
 #include "common/compiler_util.h" // IWYU pragma: keep
 // IWYU pragma: no_include <bits/chrono.h>
+#include <cctype>
 #include <chrono> // IWYU pragma: keep
 #include <cstring>
 #include <filesystem>
@@ -42,6 +43,7 @@
 #include "common/status.h"
 #include "io/cache/block/block_file_cache.h"
 #include "io/cache/block/block_file_cache_fwd.h"
+#include "io/cache/block/block_file_cache_slab_storage.h"
 #include "io/fs/file_reader.h"
 #include "io/fs/file_system.h"
 #include "io/fs/file_writer.h"
@@ -121,7 +123,9 @@ Status LRUFileCache::initialize() {
     watch.start();
     std::lock_guard cache_lock(_mutex);
     if (!_is_initialized) {
-        if (fs::exists(_cache_base_path)) {
+        if (_slab_storage) {
+            RETURN_IF_ERROR(load_slab_info_into_memory(cache_lock));
+        } else if (fs::exists(_cache_base_path)) {
             RETURN_IF_ERROR(load_cache_info_into_memory(cache_lock));
         } else {
             std::error_code ec;
@@ -154,7 +158,8 @@ void LRUFileCache::use_cell(const FileBlockCell& cell, FileBlocks& result, bool
                             std::lock_guard<std::mutex>& cache_lock) {
     auto file_block = cell.file_block;
     auto& queue = get_queue(cell.cache_type);
-    DCHECK(!(file_block->is_downloaded() &&
+    DCHECK(_slab_storage ||
+           !(file_block->is_downloaded() &&
              fs::file_size(get_path_in_local_cache(file_block->key(), file_block->offset(),
                                                    cell.cache_type)) == 0))
             << "Cannot have zero size downloaded file segments. Current file segment: "
@@ -208,7 +213,7 @@ FileBlocks LRUFileCache::get_impl(const Key& key, const CacheContext& context,
 
         /// Note: it is guaranteed that there is no concurrency with files deletion,
         /// because cache files are deleted only inside IFileCache and under cache lock.
-        if (fs::exists(key_path)) {
+        if (!_slab_storage && fs::exists(key_path)) {
             std::error_code ec;
             fs::remove_all(key_path, ec);
             if (ec) {
@@ -287,7 +292,7 @@ FileBlocks LRUFileCache::split_range_into_cells(const Key& key, const CacheConte
     while (current_pos < end_pos_non_included) {
         current_size = std::min(remaining_size, _max_file_segment_size);
         remaining_size -= current_size;
-        state = try_reserve(key, context, current_pos, current_size, cache_lock)
+        state = try_reserve(key, context, current_pos, reserved_size(current_size), cache_lock)
                         ? state
                         : FileBlock::State::SKIP_CACHE;
         if (UNLIKELY(state == FileBlock::State::SKIP_CACHE)) {
@@ -414,7 +419,17 @@ LRUFileCache::FileBlockCell* LRUFileCache::add_cell(const Key& key, const CacheC
             << ".\nCurrent cache structure: " << dump_structure_unlocked(key, cache_lock);
 
     auto& offsets = _files[key];
-    if (offsets.empty()) {
+    int64_t slot = -1;
+    if (_slab_storage) {
+        /// The downloaded blocks are restored into the slots they are in.
+        uint32_t free_slot = 0;
+        if (state == FileBlock::State::EMPTY && _slab_storage->allocate(&free_slot)) {
+            slot = free_slot;
+        } else if (state == FileBlock::State::EMPTY) {
+            LOG(WARNING) << "no free slot in " << _cache_base_path;
+            state = FileBlock::State::SKIP_CACHE;
+        }
+    } else if (offsets.empty()) {
         auto key_path = get_path_in_local_cache(key);
         if (!fs::exists(key_path)) {
             std::error_code ec;
@@ -430,10 +445,11 @@ LRUFileCache::FileBlockCell* LRUFileCache::add_cell(const Key& key, const CacheC
     FileBlockCell cell(
             std::make_shared<FileBlock>(offset, size, key, this, state, context.cache_type),
             context.cache_type, cache_lock);
+    cell.file_block->_slot = slot;
     auto& queue = get_queue(context.cache_type);
-    cell.queue_iterator = queue.add(key, offset, size, cache_lock);
+    cell.queue_iterator = queue.add(key, offset, cell.size(), cache_lock);
+    _cur_cache_size += cell.size();
     auto [it, inserted] = offsets.insert({offset, std::move(cell)});
-    _cur_cache_size += size;
 
     DCHECK(inserted) << "Failed to insert into cache key: " << key.to_string()
                      << ", offset: " << offset << ", size: " << size;
@@ -762,26 +778,35 @@ void LRUFileCache::remove(FileBlockSPtr file_block, std::lock_guard<std::mutex>&
         auto& queue = get_queue(file_block->cache_type());
         queue.remove(*cell->queue_iterator, cache_lock);
     }
-    _cur_cache_size -= file_block->range().size();
+    _cur_cache_size -= cell->size();
     auto& offsets = _files[file_block->key()];
     offsets.erase(file_block->offset());
 
-    auto cache_file_path = get_path_in_local_cache(key, offset, type);
-    if (std::filesystem::exists(cache_file_path)) {
-        std::error_code ec;
-        std::filesystem::remove(cache_file_path, ec);
-        if (ec) {
-            LOG(ERROR) << ec.message();
+    if (_slab_storage) {
+        if (file_block->_slot >= 0) {
+            _slab_storage->release(file_block->_slot);
+            file_block->_slot = -1;
+        }
+    } else {
+        auto cache_file_path = get_path_in_local_cache(key, offset, type);
+        if (std::filesystem::exists(cache_file_path)) {
+            std::error_code ec;
+            std::filesystem::remove(cache_file_path, ec);
+            if (ec) {
+                LOG(ERROR) << ec.message();
+            }
         }
     }
     _num_removed_segments++;
     if (offsets.empty()) {
         auto key_path = get_path_in_local_cache(key);
         _files.erase(key);
-        std::error_code ec;
-        std::filesystem::remove_all(key_path, ec);
-        if (ec) {
-            LOG(ERROR) << ec.message();
+        if (!_slab_storage) {
+            std::error_code ec;
+            std::filesystem::remove_all(key_path, ec);
+            if (ec) {
+                LOG(ERROR) << ec.message();
+            }
         }
     }
 }
@@ -927,6 +952,56 @@ Status LRUFileCache::load_cache_info_into_memory(std::lock_guard<std::mutex>& ca
                       }
                   });
 
+    shuffle_queue_entries(queue_entries, cache_lock);
+    return st;
+}
+
+Status LRUFileCache::load_slab_info_into_memory(std::lock_guard<std::mutex>& cache_lock) {
+    /// The blocks left by the file layout are dropped. Only the directories named as its key
+    /// prefixes (version 2.0) or keys (version 1.0) are removed.
+    const size_t key_length = Key().to_string().size();
+    auto is_file_layout_dir = [key_length](const std::string& name) {
+        return (name.size() == KEY_PREFIX_LENGTH || name.size() == key_length) &&
+               std::all_of(name.begin(), name.end(),
+                           [](unsigned char c) { return std::isxdigit(c); });
+    };
+    std::vector<fs::path> file_layout_dirs;
+    std::error_code ec;
+    for (fs::directory_iterator it {_cache_base_path, ec}; !ec && it != fs::directory_iterator();
+         it.increment(ec)) {
+        if (it->is_directory() && is_file_layout_dir(it->path().filename().native())) {
+            file_layout_dirs.push_back(it->path());
+        }
+    }
+    for (const auto& dir : file_layout_dirs) {
+        LOG(INFO) << "Remove the blocks of the file layout in " << dir.native();
+        fs::remove_all(dir, ec);
+        if (ec) {
+            LOG(WARNING) << ec.message();
+        }
+    }
+
+    std::vector<std::pair<Key, size_t>> queue_entries;
+    RETURN_IF_ERROR(_slab_storage->open([&](uint32_t slot, const Key& key, size_t offset,
+                                            size_t size, CacheType cache_type) {
+        CacheContext context;
+        context.query_id = TUniqueId();
+        context.cache_type = cache_type;
+        if (get_cell(key, offset, cache_lock) != nullptr ||
+            !try_reserve(key, context, offset, reserved_size(size), cache_lock)) {
+            return false;
+        }
+        auto* cell = add_cell(key, context, offset, size, FileBlock::State::DOWNLOADED, cache_lock);
+        cell->file_block->_slot = slot;
+        queue_entries.emplace_back(key, offset);
+        return true;
+    }));
+    shuffle_queue_entries(queue_entries, cache_lock);
+    return Status::OK();
+}
+
+void LRUFileCache::shuffle_queue_entries(std::vector<std::pair<Key, size_t>>& queue_entries,
+                                         std::lock_guard<std::mutex>& cache_lock) {
     /// Shuffle cells to have random order in LRUQueue as at startup all cells have the same priority.
     auto rng = std::default_random_engine(
             static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
@@ -938,7 +1013,6 @@ Status LRUFileCache::load_cache_info_into_memory(std::lock_guard<std::mutex>& ca
             queue.move_to_end(*cell->queue_iterator, cache_lock);
         }
     }
-    return st;
 }
 
 Status LRUFileCache::write_file_cache_version() const {
@@ -1016,7 +1090,7 @@ void LRUFileCache::change_cache_type(const IFileCache::Key& key, size_t offset,
             cur_queue.remove(*cell.queue_iterator, cache_lock);
             auto& new_queue = get_queue(new_type);
             cell.queue_iterator =
-                    new_queue.add(key, offset, cell.file_block->range().size(), cache_lock);
+                    new_queue.add(key, offset, cell.size(), cache_lock);
         }
     }
 }
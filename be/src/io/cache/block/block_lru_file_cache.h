@@ -91,7 +91,10 @@ private:
         /// getorSet(), but cache users always hold it via FileBlocksHolder.
         bool releasable() const { return file_block.unique(); }
 
-        size_t size() const { return file_block->_segment_range.size(); }
+        /// The space the block takes in the cache, a whole slot of a slab storage.
+        size_t size() const {
+            return file_block->_cache->reserved_size(file_block->_segment_range.size());
+        }
 
         FileBlockCell(FileBlockSPtr file_block, CacheType cache_type,
                       std::lock_guard<std::mutex>& cache_lock);
@@ -165,6 +168,11 @@ private:
 
     Status load_cache_info_into_memory(std::lock_guard<std::mutex>& cache_lock);
 
+    Status load_slab_info_into_memory(std::lock_guard<std::mutex>& cache_lock);
+
+    void shuffle_queue_entries(std::vector<std::pair<Key, size_t>>& queue_entries,
+                               std::lock_guard<std::mutex>& cache_lock);
+
     Status write_file_cache_version() const;
 
     std::string read_file_cache_version() const;
@@ -17,12 +17,14 @@
 
 #include "io/cache/block/cached_remote_file_reader.h"
 
+#include <bvar/reducer.h>
 #include <fmt/format.h>
 #include <gen_cpp/Types_types.h>
 #include <glog/logging.h>
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <list>
 #include <vector>
 
@@ -33,13 +35,22 @@
 #include "io/cache/block/block_file_segment.h"
 #include "io/fs/file_reader.h"
 #include "io/io_common.h"
+#include "runtime/exec_env.h"
+#include "runtime/thread_context.h"
 #include "util/bit_util.h"
 #include "util/doris_metrics.h"
 #include "util/runtime_profile.h"
+#include "util/threadpool.h"
 
 namespace doris {
 namespace io {
 
+bvar::Adder<uint64_t> file_cache_write_behind_bytes("file_cache_write_behind", "bytes");
+bvar::Adder<uint64_t> file_cache_write_behind_dropped("file_cache_write_behind", "dropped_blocks");
+bvar::Adder<uint64_t> file_cache_write_behind_failed("file_cache_write_behind", "failed_blocks");
+// the bytes of the segments handed over to the background writers and not written yet
+std::atomic<int64_t> file_cache_write_behind_pending_bytes {0};
+
 CachedRemoteFileReader::CachedRemoteFileReader(FileReaderSPtr remote_file_reader,
                                                const FileReaderOptions& opts)
         : _remote_file_reader(std::move(remote_file_reader)) {
@@ -138,19 +149,27 @@ Status CachedRemoteFileReader::_read_from_cache(size_t offset, Slice result, siz
         empty_start = empty_segments.front()->range().left;
         empty_end = empty_segments.back()->range().right;
         size_t size = empty_end - empty_start + 1;
-        std::unique_ptr<char[]> buffer(new char[size]);
+        // shared with the background writers of the segments
+        std::shared_ptr<char[]> buffer(new char[size]);
         {
             SCOPED_RAW_TIMER(&stats.remote_read_timer);
             RETURN_IF_ERROR(_remote_file_reader->read_at(empty_start, Slice(buffer.get(), size),
                                                          &size, io_ctx));
         }
+        bool write_behind = config::enable_file_cache_write_behind &&
+                            ExecEnv::GetInstance()->file_cache_write_thread_pool() != nullptr;
         for (auto& segment : empty_segments) {
             if (segment->state() == FileBlock::State::SKIP_CACHE) {
                 continue;
             }
-            SCOPED_RAW_TIMER(&stats.local_write_timer);
             char* cur_ptr = buffer.get() + segment->range().left - empty_start;
             size_t segment_size = segment->range().size();
+            if (write_behind) {
+                _write_behind(segment, std::shared_ptr<const char>(buffer, cur_ptr));
+                stats.bytes_write_into_file_cache += segment_size;
+                continue;
+            }
+            SCOPED_RAW_TIMER(&stats.local_write_timer);
             RETURN_IF_ERROR(segment->append(Slice(cur_ptr, segment_size)));
             RETURN_IF_ERROR(segment->finalize_write());
             stats.bytes_write_into_file_cache += segment_size;
@@ -195,7 +214,9 @@ Status CachedRemoteFileReader::_read_from_cache(size_t offset, Slice result, siz
                     SCOPED_RAW_TIMER(&stats.remote_read_timer);
                     segment_state = segment->wait();
                 }
-                if (segment_state == FileBlock::State::DOWNLOADED) {
+                // the downloader may have handed the data to a background writer
+                if (segment_state == FileBlock::State::DOWNLOADED ||
+                    segment->has_handed_over_data()) {
                     break;
                 }
                 if (segment_state != FileBlock::State::DOWNLOADING) {
@@ -227,6 +248,51 @@ Status CachedRemoteFileReader::_read_from_cache(size_t offset, Slice result, siz
     return Status::OK();
 }
 
+void CachedRemoteFileReader::_write_behind(const FileBlockSPtr& segment,
+                                           std::shared_ptr<const char> data) {
+    int64_t segment_size = segment->range().size();
+    if (file_cache_write_behind_pending_bytes.fetch_add(segment_size) + segment_size >
+        config::file_cache_write_behind_max_bytes) {
+        // the writers are too far behind, leave the segment uncached instead of waiting
+        file_cache_write_behind_pending_bytes.fetch_sub(segment_size);
+        file_cache_write_behind_dropped << 1;
+        return;
+    }
+    segment->hand_over_download(data);
+    // The holder of the writer completes the segment, which is reset and removed from the cache
+    // along with the handed over data if it is not written.
+    auto holder = std::make_shared<FileBlocksHolder>(FileBlocks {segment});
+    // the buffer is allocated by the query, which is credited when the writer frees it
+    auto mem_tracker = thread_context()->thread_mem_tracker_mgr->limiter_mem_tracker();
+    Status st = ExecEnv::GetInstance()->file_cache_write_thread_pool()->submit_func(
+            [holder, data, segment_size, mem_tracker]() mutable {
+                SCOPED_ATTACH_TASK(mem_tracker);
+                const FileBlockSPtr& segment = holder->file_segments.front();
+                segment->take_over_download();
+                Status st = segment->append(Slice(data.get(), segment_size));
+                if (st.ok()) {
+                    st = segment->finalize_write();
+                }
+                if (st.ok()) {
+                    file_cache_write_behind_bytes << segment_size;
+                    segment->release_handed_over_data();
+                } else {
+                    LOG(WARNING) << "Failed to write file cache segment "
+                                 << segment->get_path_in_local_cache() << ": " << st.to_string();
+                    file_cache_write_behind_failed << 1;
+                }
+                holder.reset();
+                data.reset();
+                file_cache_write_behind_pending_bytes.fetch_sub(segment_size);
+            });
+    if (!st.ok()) {
+        // the queue is full, the segment is reset once the holder is released
+        segment->take_over_download();
+        file_cache_write_behind_pending_bytes.fetch_sub(segment_size);
+        file_cache_write_behind_dropped << 1;
+    }
+}
+
 Status CachedRemoteFileReader::read_at_impl(size_t offset, Slice result, size_t* bytes_read,
                                             const IOContext* io_ctx) {
     DCHECK(!closed());
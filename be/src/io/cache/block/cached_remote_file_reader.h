@@ -61,6 +61,9 @@ protected:
 private:
     std::pair<size_t, size_t> _align_size(size_t offset, size_t size) const;
 
+    // Writes the data of a segment this thread downloaded into the cache in the background.
+    void _write_behind(const FileBlockSPtr& segment, std::shared_ptr<const char> data);
+
     bool _is_doris_table;
     FileReaderSPtr _remote_file_reader;
     IFileCache::Key _cache_key;
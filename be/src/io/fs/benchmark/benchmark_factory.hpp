@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "io/fs/benchmark/file_cache_benchmark.hpp"
 #include "io/fs/benchmark/hdfs_benchmark.hpp"
 #include "io/fs/benchmark/s3_benchmark.hpp"
 
@@ -73,6 +74,16 @@ Status BenchmarkFactory::getBm(const std::string fs_type, const std::string op_t
                     "unknown params: fs_type: {}, op_type: {}, iterations: {}", fs_type, op_type,
                     iterations);
         }
+    } else if (fs_type == "file_cache") {
+        if (op_type == "create_write") {
+            *bm = new FileCacheWriteBenchmark(threads, iterations, file_size, conf_map);
+        } else if (op_type == "open_read") {
+            *bm = new FileCacheReadBenchmark(threads, iterations, file_size, conf_map);
+        } else {
+            return Status::Error<ErrorCode::INVALID_ARGUMENT>(
+                    "unknown params: fs_type: {}, op_type: {}, iterations: {}", fs_type, op_type,
+                    iterations);
+        }
     }
     return Status::OK();
 }
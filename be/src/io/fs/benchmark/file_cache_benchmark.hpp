@@ -0,0 +1,179 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/config.h"
+#include "io/cache/block/block_file_cache.h"
+#include "io/cache/block/block_file_cache_settings.h"
+#include "io/cache/block/block_file_segment.h"
+#include "io/cache/block/block_lru_file_cache.h"
+#include "io/fs/benchmark/base_benchmark.h"
+#include "util/slice.h"
+
+namespace doris::io {
+
+// Compares the storages of the block file cache on a local disk, with the conf:
+//   base_dir: the path of the file cache
+//   storage: file (default) or slab
+//   direct_io: true to read and write the slab files with O_DIRECT
+//   total_size: the capacity of the file cache, 10GB by default
+// Each thread caches a file of file_size bytes, split into blocks of
+// file_cache_max_file_segment_size.
+class FileCacheBaseBenchmark : public BaseBenchmark {
+public:
+    FileCacheBaseBenchmark(const std::string& name, int threads, int iterations, size_t file_size,
+                           const std::map<std::string, std::string>& conf_map)
+            : BaseBenchmark(name, threads, iterations, file_size, conf_map) {
+        if (_file_size <= 0) {
+            _file_size = 64 * 1024 * 1024; // default 64MB
+        }
+    }
+    virtual ~FileCacheBaseBenchmark() = default;
+
+    // The threads share the cache.
+    Status init() override {
+        std::lock_guard lock(_init_mutex);
+        if (_cache != nullptr) {
+            return Status::OK();
+        }
+        FileCacheSettings settings;
+        settings.total_size =
+                _conf_map.contains("total_size") ? std::stol(_conf_map["total_size"]) : 10 * GB;
+        settings.max_file_segment_size = config::file_cache_max_file_segment_size;
+        settings.query_queue_size = settings.total_size;
+        settings.query_queue_elements =
+                std::max(settings.total_size / settings.max_file_segment_size,
+                         REMOTE_FS_OBJECTS_CACHE_DEFAULT_ELEMENTS);
+        settings.storage = _conf_map["storage"] == "slab" ? FileCacheStorage::SLAB
+                                                          : FileCacheStorage::FILE;
+        settings.slab_file_size = config::file_cache_slab_file_size;
+        settings.slab_direct_io = _conf_map["direct_io"] == "true";
+        IFileCache::init();
+        auto cache = std::make_unique<LRUFileCache>(_conf_map["base_dir"], settings);
+        RETURN_IF_ERROR(cache->initialize());
+        _cache = std::move(cache);
+        bm_log("file cache {}, storage: {}, direct_io: {}", _conf_map["base_dir"],
+               _conf_map["storage"], settings.slab_direct_io);
+        return Status::OK();
+    }
+
+protected:
+    // Downloads the empty blocks of the file, returns the bytes written.
+    Status download(const IFileCache::Key& key, size_t* bytes_written) {
+        CacheContext context;
+        context.cache_type = CacheType::NORMAL;
+        std::vector<char> data(config::file_cache_max_file_segment_size, 'x');
+        *bytes_written = 0;
+        auto holder = _cache->get_or_set(key, 0, _file_size, context);
+        for (auto& block : holder.file_segments) {
+            if (block->state() != FileBlock::State::EMPTY ||
+                block->get_or_set_downloader() != FileBlock::get_caller_id()) {
+                continue;
+            }
+            RETURN_IF_ERROR(block->append(Slice(data.data(), block->range().size())));
+            RETURN_IF_ERROR(block->finalize_write());
+            *bytes_written += block->range().size();
+        }
+        return Status::OK();
+    }
+
+    std::mutex _init_mutex;
+    std::unique_ptr<IFileCache> _cache;
+};
+
+// Writes a new file into the cache in each iteration, evicting the old ones once it is full.
+class FileCacheWriteBenchmark : public FileCacheBaseBenchmark {
+public:
+    FileCacheWriteBenchmark(int threads, int iterations, size_t file_size,
+                            const std::map<std::string, std::string>& conf_map)
+            : FileCacheBaseBenchmark("FileCacheWriteBenchmark", threads, iterations, file_size,
+                                     conf_map) {}
+    virtual ~FileCacheWriteBenchmark() = default;
+
+    Status run(benchmark::State& state) override {
+        auto key = IFileCache::hash(fmt::format("{}_{}", get_file_path(state), _round++));
+        size_t bytes_written = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        Status st = download(key, &bytes_written);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed_seconds =
+                std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+        state.SetIterationTime(elapsed_seconds.count());
+        state.counters["WriteRate(B/S)"] =
+                benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
+        state.counters["WriteTotal(B)"] = bytes_written;
+        state.counters["WriteTime(S)"] = elapsed_seconds.count();
+        return st;
+    }
+
+private:
+    std::atomic<int64_t> _round = 0;
+};
+
+// Reads the cached file of the thread by buffer_size, it is cached before the first iteration.
+class FileCacheReadBenchmark : public FileCacheBaseBenchmark {
+public:
+    FileCacheReadBenchmark(int threads, int iterations, size_t file_size,
+                           const std::map<std::string, std::string>& conf_map)
+            : FileCacheBaseBenchmark("FileCacheReadBenchmark", threads, iterations, file_size,
+                                     conf_map) {}
+    virtual ~FileCacheReadBenchmark() = default;
+
+    Status run(benchmark::State& state) override {
+        auto key = IFileCache::hash(get_file_path(state));
+        size_t bytes_written = 0;
+        RETURN_IF_ERROR(download(key, &bytes_written));
+
+        size_t buffer_size =
+                _conf_map.contains("buffer_size") ? std::stol(_conf_map["buffer_size"]) : 1000000L;
+        std::vector<char> buffer(buffer_size);
+        CacheContext context;
+        context.cache_type = CacheType::NORMAL;
+        size_t bytes_read = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        auto holder = _cache->get_or_set(key, 0, _file_size, context);
+        for (auto& block : holder.file_segments) {
+            if (block->state() != FileBlock::State::DOWNLOADED) {
+                return Status::InternalError("block {} is evicted, the cache is too small",
+                                             block->range().to_string());
+            }
+            for (size_t offset = 0; offset < block->range().size(); offset += buffer_size) {
+                size_t size = std::min(buffer_size, block->range().size() - offset);
+                RETURN_IF_ERROR(block->read_at(Slice(buffer.data(), size), offset));
+                bytes_read += size;
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed_seconds =
+                std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+        state.SetIterationTime(elapsed_seconds.count());
+        state.counters["ReadRate(B/S)"] =
+                benchmark::Counter(bytes_read, benchmark::Counter::kIsRate);
+        state.counters["ReadTotal(B)"] = bytes_read;
+        state.counters["ReadTime(S)"] = elapsed_seconds.count();
+        return Status::OK();
+    }
+};
+
+} // namespace doris::io
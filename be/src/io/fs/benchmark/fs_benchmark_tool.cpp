@@ -24,7 +24,7 @@
 #include "util/cpu_info.h"
 #include "util/threadpool.h"
 
-DEFINE_string(fs_type, "hdfs", "Supported File System: s3, hdfs");
+DEFINE_string(fs_type, "hdfs", "Supported File System: s3, hdfs, file_cache");
 DEFINE_string(operation, "create_write",
               "Supported Operations: create_write, open_read, open, rename, delete, exists");
 DEFINE_string(threads, "1", "Number of threads");
@@ -45,6 +45,7 @@ std::string get_usage(const std::string& progname) {
     ss << "\nfs_type:\n";
     ss << "     hdfs\n";
     ss << "     s3\n";
+    ss << "     file_cache: the local file cache, storage=file|slab in the conf\n";
     ss << "\nop_type:\n";
     ss << "     read\n";
     ss << "     write\n";
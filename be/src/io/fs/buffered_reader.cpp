@@ -23,13 +23,16 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 
 #include "common/compiler_util.h" // IWYU pragma: keep
 #include "common/config.h"
 #include "common/status.h"
 #include "runtime/exec_env.h"
+#include "runtime/thread_context.h"
 #include "util/runtime_profile.h"
 #include "util/threadpool.h"
+#include "util/time.h"
 
 namespace doris {
 namespace io {
@@ -744,6 +747,265 @@ Status InMemoryFileReader::read_at_impl(size_t offset, Slice result, size_t* byt
     return Status::OK();
 }
 
+struct RowGroupPrefetcher::Group {
+    std::vector<PrefetchRange> ranges;
+    // offset of every range in data
+    std::vector<size_t> data_offsets;
+    size_t bytes = 0;
+    std::unique_ptr<char[]> data;
+    bool issued = false;
+    // the fields below are guarded by the lock of the prefetcher
+    bool done = false;
+    Status status;
+    int64_t read_ns = 0;
+};
+
+namespace {
+// Serves the ranges of a prefetched row group from memory.
+class PrefetchedGroupReader : public io::FileReader {
+public:
+    PrefetchedGroupReader(io::FileReaderSPtr reader, std::shared_ptr<const void> holder,
+                          const std::vector<PrefetchRange>* ranges,
+                          const std::vector<size_t>* data_offsets, const char* data)
+            : _reader(std::move(reader)),
+              _holder(std::move(holder)),
+              _ranges(ranges),
+              _data_offsets(data_offsets),
+              _data(data) {}
+
+    ~PrefetchedGroupReader() override = default;
+
+    Status close() override {
+        _closed = true;
+        return Status::OK();
+    }
+
+    const io::Path& path() const override { return _reader->path(); }
+
+    size_t size() const override { return _reader->size(); }
+
+    bool closed() const override { return _closed; }
+
+    std::shared_ptr<io::FileSystem> fs() const override { return _reader->fs(); }
+
+protected:
+    Status read_at_impl(size_t offset, Slice result, size_t* bytes_read,
+                        const IOContext* io_ctx) override {
+        auto it = std::upper_bound(
+                _ranges->begin(), _ranges->end(), offset,
+                [](size_t off, const PrefetchRange& range) { return off < range.start_offset; });
+        if (it != _ranges->begin()) {
+            --it;
+            if (offset + result.size <= it->end_offset) {
+                size_t data_offset =
+                        (*_data_offsets)[it - _ranges->begin()] + offset - it->start_offset;
+                memcpy(result.data, _data + data_offset, result.size);
+                *bytes_read = result.size;
+                return Status::OK();
+            }
+        }
+        return _reader->read_at(offset, result, bytes_read, io_ctx);
+    }
+
+private:
+    io::FileReaderSPtr _reader;
+    // keeps the prefetched data alive
+    std::shared_ptr<const void> _holder;
+    const std::vector<PrefetchRange>* _ranges;
+    const std::vector<size_t>* _data_offsets;
+    const char* _data;
+    bool _closed = false;
+};
+} // namespace
+
+RowGroupPrefetcher::RowGroupPrefetcher(RuntimeProfile* profile, io::FileReaderSPtr reader,
+                                       size_t memory_budget, const IOContext* io_ctx)
+        : _profile(profile),
+          _reader(std::move(reader)),
+          _memory_budget(memory_budget),
+          _io_ctx(io_ctx),
+          _mem_tracker(thread_context()->thread_mem_tracker_mgr->limiter_mem_tracker()) {
+    if (_profile != nullptr) {
+        const char* prefetch_profile = "RowGroupPrefetch";
+        ADD_TIMER_WITH_LEVEL(_profile, prefetch_profile, 1);
+        _wait_time = ADD_CHILD_TIMER_WITH_LEVEL(_profile, "WaitTime", prefetch_profile, 1);
+        _prefetch_time =
+                ADD_CHILD_TIMER_WITH_LEVEL(_profile, "PrefetchTime", prefetch_profile, 1);
+        _prefetch_bytes = ADD_CHILD_COUNTER_WITH_LEVEL(_profile, "PrefetchBytes", TUnit::BYTES,
+                                                       prefetch_profile, 1);
+        _prefetch_groups = ADD_CHILD_COUNTER_WITH_LEVEL(_profile, "PrefetchGroups", TUnit::UNIT,
+                                                        prefetch_profile, 1);
+        _max_lookahead = ADD_CHILD_COUNTER_WITH_LEVEL(_profile, "MaxLookahead", TUnit::UNIT,
+                                                      prefetch_profile, 1);
+    }
+}
+
+RowGroupPrefetcher::~RowGroupPrefetcher() {
+    close();
+}
+
+void RowGroupPrefetcher::close() {
+    std::unique_lock l(_lock);
+    if (_closed) {
+        return;
+    }
+    _closed = true;
+    _cv.wait(l, [this]() { return _in_flight == 0; });
+    _groups.clear();
+    _current.reset();
+    if (_profile != nullptr) {
+        COUNTER_UPDATE(_wait_time, _statistics.wait_time);
+        COUNTER_UPDATE(_prefetch_time, _statistics.prefetch_time);
+        COUNTER_UPDATE(_prefetch_bytes, _statistics.prefetch_bytes);
+        COUNTER_UPDATE(_prefetch_groups, _statistics.prefetch_groups);
+        if (_max_lookahead->value() < _statistics.max_lookahead) {
+            _max_lookahead->set(_statistics.max_lookahead);
+        }
+    }
+}
+
+void RowGroupPrefetcher::add_group(std::vector<PrefetchRange> ranges) {
+    auto group = std::make_shared<Group>();
+    group->ranges = std::move(ranges);
+    std::sort(group->ranges.begin(), group->ranges.end(),
+              [](const PrefetchRange& a, const PrefetchRange& b) {
+                  return a.start_offset < b.start_offset;
+              });
+    for (const auto& range : group->ranges) {
+        group->data_offsets.push_back(group->bytes);
+        group->bytes += range.end_offset - range.start_offset;
+    }
+    std::lock_guard l(_lock);
+    _groups.emplace_back(std::move(group));
+}
+
+void RowGroupPrefetcher::start() {
+    std::lock_guard l(_lock);
+    _prefetch();
+}
+
+size_t RowGroupPrefetcher::_lookahead() const {
+    if (_bandwidth <= 0 || _decode_ns <= 0 || _groups.empty()) {
+        return 1;
+    }
+    // time to read the next row group over the time to decode one
+    double read_ns = _groups.front()->bytes / _bandwidth;
+    return std::clamp<size_t>(static_cast<size_t>(std::ceil(read_ns / _decode_ns)), 1,
+                              MAX_LOOKAHEAD);
+}
+
+void RowGroupPrefetcher::_prefetch() {
+    size_t lookahead = _lookahead();
+    size_t ahead = 0;
+    for (auto& group : _groups) {
+        if (ahead >= lookahead) {
+            break;
+        }
+        if (group->issued) {
+            ++ahead;
+            continue;
+        }
+        if (group->bytes == 0 || group->bytes > _memory_budget) {
+            // read by the decoder directly
+            continue;
+        }
+        if (_issued_bytes + group->bytes > _memory_budget) {
+            break;
+        }
+        group->issued = true;
+        Status st = ExecEnv::GetInstance()->buffered_reader_prefetch_thread_pool()->submit_func(
+                [this, group, mem_tracker = _mem_tracker]() mutable {
+                    // the group may be released here, once the prefetcher is closed
+                    SCOPED_ATTACH_TASK(mem_tracker);
+                    _read_group(group);
+                    group.reset();
+                });
+        if (!st.ok()) {
+            group->issued = false;
+            break;
+        }
+        _issued_bytes += group->bytes;
+        ++_in_flight;
+        ++ahead;
+    }
+    _statistics.max_lookahead = std::max<int64_t>(_statistics.max_lookahead, ahead);
+}
+
+// runs in the prefetch thread pool
+void RowGroupPrefetcher::_read_group(const std::shared_ptr<Group>& group) {
+    Status st;
+    int64_t read_ns = 0;
+    {
+        SCOPED_RAW_TIMER(&read_ns);
+        group->data.reset(new char[group->bytes]);
+        for (size_t i = 0; i < group->ranges.size() && st.ok(); ++i) {
+            const auto& range = group->ranges[i];
+            size_t to_read = range.end_offset - range.start_offset;
+            size_t bytes_read = 0;
+            st = _reader->read_at(range.start_offset,
+                                  Slice(group->data.get() + group->data_offsets[i], to_read),
+                                  &bytes_read, _io_ctx);
+            if (st.ok() && bytes_read != to_read) {
+                st = Status::InternalError("Short read of {} at {}, expect {} but read {}",
+                                           _reader->path().native(), range.start_offset,
+                                           to_read, bytes_read);
+            }
+        }
+    }
+    std::lock_guard l(_lock);
+    group->status = st;
+    group->read_ns = read_ns;
+    group->done = true;
+    if (st.ok()) {
+        double bandwidth = static_cast<double>(group->bytes) / std::max<int64_t>(read_ns, 1);
+        _bandwidth = _bandwidth <= 0 ? bandwidth : (_bandwidth + bandwidth) / 2;
+        _statistics.prefetch_bytes += group->bytes;
+        _statistics.prefetch_groups++;
+    }
+    _statistics.prefetch_time += read_ns;
+    --_in_flight;
+    _cv.notify_all();
+}
+
+Status RowGroupPrefetcher::next_group(io::FileReaderSPtr* group_reader) {
+    *group_reader = nullptr;
+    int64_t now = MonotonicNanos();
+    std::unique_lock l(_lock);
+    if (_current != nullptr) {
+        _issued_bytes -= _current->bytes;
+        _current.reset();
+        if (_last_take_ns > 0) {
+            double decode_ns = now - _last_take_ns;
+            _decode_ns = _decode_ns <= 0 ? decode_ns : (_decode_ns + decode_ns) / 2;
+        }
+    }
+    _last_take_ns = 0;
+    if (_groups.empty()) {
+        return Status::OK();
+    }
+    std::shared_ptr<Group> group = _groups.front();
+    _groups.pop_front();
+    _prefetch();
+    if (!group->issued) {
+        return Status::OK();
+    }
+    {
+        SCOPED_RAW_TIMER(&_statistics.wait_time);
+        _cv.wait(l, [&group]() { return group->done; });
+    }
+    _current = group;
+    if (!group->status.ok()) {
+        // the decoder reads the row group by itself, and gets the error if it happens again
+        LOG(WARNING) << "Failed to prefetch row group of " << _reader->path().native() << ": "
+                     << group->status.to_string();
+        return Status::OK();
+    }
+    _last_take_ns = MonotonicNanos();
+    *group_reader = std::make_shared<PrefetchedGroupReader>(
+            _reader, group, &group->ranges, &group->data_offsets, group->data.get());
+    return Status::OK();
+}
+
 BufferedFileStreamReader::BufferedFileStreamReader(io::FileReaderSPtr file, uint64_t offset,
                                                    uint64_t length, size_t max_buf_size)
         : _file(file),
@@ -21,6 +21,7 @@
 #include <stdint.h>
 
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -40,6 +41,7 @@
 #include "vec/common/typeid_cast.h"
 
 namespace doris {
+class MemTrackerLimiter;
 namespace io {
 
 class FileSystem;
@@ -462,6 +464,89 @@ private:
     bool _closed = false;
 };
 
+/**
+ * Reads the column ranges of the coming row groups of a parquet file ahead of the decoder in the
+ * prefetch thread pool, so that a scan on remote storage does not stall for a round trip at every
+ * row group boundary.
+ *
+ * The row groups are added in the order they are read. next_group() returns a reader which serves
+ * the ranges of the next row group from memory, and reads out of them through the underlying
+ * reader. The row groups read ahead and the one being decoded take at most memory_budget bytes.
+ * The number of row groups read ahead is the time to read one at the measured bandwidth over the
+ * time the decoder takes on one, so that the next row group is ready when the decoder needs it.
+ * The buffers are charged to the mem tracker of the thread that creates the prefetcher, the
+ * query one in a scanner, although they are allocated in the thread pool.
+ */
+class RowGroupPrefetcher {
+public:
+    struct Statistics {
+        int64_t wait_time = 0;
+        int64_t prefetch_time = 0;
+        int64_t prefetch_bytes = 0;
+        int64_t prefetch_groups = 0;
+        int64_t max_lookahead = 0;
+    };
+
+    static constexpr size_t MAX_LOOKAHEAD = 16;
+
+    RowGroupPrefetcher(RuntimeProfile* profile, io::FileReaderSPtr reader, size_t memory_budget,
+                       const IOContext* io_ctx = nullptr);
+
+    ~RowGroupPrefetcher();
+
+    // Adds the column ranges of a row group.
+    void add_group(std::vector<PrefetchRange> ranges);
+
+    // Starts to read the first row groups.
+    void start();
+
+    // Gets the reader of the next added row group, waiting for its ranges being read. The reader
+    // is null if the row group is not prefetched, e.g. it takes more memory than the budget.
+    Status next_group(io::FileReaderSPtr* group_reader);
+
+    // Waits for the reads in flight.
+    void close();
+
+    const Statistics& statistics() const { return _statistics; }
+
+private:
+    struct Group;
+
+    // Issues the reads of the row groups within the lookahead and the memory budget.
+    void _prefetch();
+    size_t _lookahead() const;
+    void _read_group(const std::shared_ptr<Group>& group);
+
+    RuntimeProfile::Counter* _wait_time = nullptr;
+    RuntimeProfile::Counter* _prefetch_time = nullptr;
+    RuntimeProfile::Counter* _prefetch_bytes = nullptr;
+    RuntimeProfile::Counter* _prefetch_groups = nullptr;
+    RuntimeProfile::Counter* _max_lookahead = nullptr;
+
+    RuntimeProfile* _profile = nullptr;
+    io::FileReaderSPtr _reader;
+    const size_t _memory_budget;
+    const IOContext* _io_ctx = nullptr;
+    std::shared_ptr<MemTrackerLimiter> _mem_tracker;
+
+    std::mutex _lock;
+    std::condition_variable _cv;
+    std::deque<std::shared_ptr<Group>> _groups;
+    // the row group being decoded
+    std::shared_ptr<Group> _current;
+    // memory of the row groups read ahead and the one being decoded
+    size_t _issued_bytes = 0;
+    int _in_flight = 0;
+    // bytes read per nanosecond by the prefetch reads
+    double _bandwidth = 0;
+    // nanoseconds the decoder takes on a row group
+    double _decode_ns = 0;
+    int64_t _last_take_ns = 0;
+    bool _closed = false;
+
+    Statistics _statistics;
+};
+
 /**
  * Load all the needed data in underlying buffer, so the caller does not need to prepare the data container.
  */
@@ -1278,8 +1278,10 @@ void BaseTablet::calc_compaction_output_rowset_delete_bitmap(
         const DeleteBitmap& input_delete_bitmap, DeleteBitmap* output_rowset_delete_bitmap) {
     RowLocation src;
     RowLocation dst;
+    dst.rowset_id = rowid_conversion.get_dst_rowset_id();
     for (auto& rowset : input_rowsets) {
         src.rowset_id = rowset->rowset_id();
+        std::list<std::pair<RowLocation, RowLocation>>* locations = nullptr;
         for (uint32_t seg_id = 0; seg_id < rowset->num_segments(); ++seg_id) {
             src.segment_id = seg_id;
             DeleteBitmap subset_map(tablet_id());
@@ -1289,24 +1291,37 @@ void BaseTablet::calc_compaction_output_rowset_delete_bitmap(
             for (auto iter = subset_map.delete_bitmap.begin();
                  iter != subset_map.delete_bitmap.end(); ++iter) {
                 auto cur_version = std::get<2>(iter->first);
-                for (auto index = iter->second.begin(); index != iter->second.end(); ++index) {
-                    src.row_id = *index;
-                    if (rowid_conversion.get(src, &dst) != 0) {
-                        VLOG_CRITICAL << "Can't find rowid, may be deleted by the delete_handler, "
-                                      << " src loaction: |" << src.rowset_id << "|"
-                                      << src.segment_id << "|" << src.row_id
-                                      << " version: " << cur_version;
-                        missed_rows->insert(src);
-                        continue;
-                    }
+                // the converted row ids of every destination segment, added to the output
+                // bitmap all at once
+                std::map<uint32_t, std::vector<uint32_t>> dst_rowids;
+                auto found = [&](uint32_t src_rowid, uint32_t dst_segment_id, uint32_t dst_rowid) {
+                    src.row_id = src_rowid;
+                    dst.segment_id = dst_segment_id;
+                    dst.row_id = dst_rowid;
                     VLOG_DEBUG << "calc_compaction_output_rowset_delete_bitmap dst location: |"
                                << dst.rowset_id << "|" << dst.segment_id << "|" << dst.row_id
                                << " src location: |" << src.rowset_id << "|" << src.segment_id
                                << "|" << src.row_id << " start version: " << start_version
                                << "end version" << end_version;
-                    (*location_map)[rowset].emplace_back(src, dst);
-                    output_rowset_delete_bitmap->add({dst.rowset_id, dst.segment_id, cur_version},
-                                                     dst.row_id);
+                    if (locations == nullptr) {
+                        locations = &(*location_map)[rowset];
+                    }
+                    locations->emplace_back(src, dst);
+                    dst_rowids[dst_segment_id].push_back(dst_rowid);
+                };
+                auto missed = [&](uint32_t src_rowid) {
+                    src.row_id = src_rowid;
+                    VLOG_CRITICAL << "Can't find rowid, may be deleted by the delete_handler, "
+                                  << " src loaction: |" << src.rowset_id << "|" << src.segment_id
+                                  << "|" << src.row_id << " version: " << cur_version;
+                    missed_rows->insert(src);
+                };
+                rowid_conversion.convert(rowset->rowset_id(), seg_id, iter->second, found, missed);
+                for (auto& [dst_segment_id, rowids] : dst_rowids) {
+                    roaring::Roaring bitmap;
+                    bitmap.addMany(rowids.size(), rowids.data());
+                    output_rowset_delete_bitmap->merge(
+                            {dst.rowset_id, dst_segment_id, cur_version}, bitmap);
                 }
             }
         }
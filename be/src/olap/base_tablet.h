@@ -26,6 +26,7 @@
 #include "olap/rowset/segment_v2/segment.h"
 #include "olap/tablet_fwd.h"
 #include "olap/tablet_meta.h"
+#include "olap/tablet_read_stats.h"
 #include "olap/version_graph.h"
 #include "util/metrics.h"
 
@@ -281,6 +282,8 @@ public:
     IntCounter* query_scan_bytes = nullptr;
     IntCounter* query_scan_rows = nullptr;
     IntCounter* query_scan_count = nullptr;
+    // used to schedule compaction by the read amplification of the tablet
+    TabletReadStats read_stats;
     IntCounter* flush_bytes = nullptr;
     IntCounter* flush_finish_count = nullptr;
     std::atomic<int64_t> published_count = 0;
@@ -39,6 +39,7 @@
 #include "common/status.h"
 #include "common/sync_point.h"
 #include "io/fs/file_system.h"
+#include "io/fs/file_writer.h"
 #include "io/fs/remote_file_system.h"
 #include "olap/cumulative_compaction_policy.h"
 #include "olap/cumulative_compaction_time_series_policy.h"
@@ -52,6 +53,7 @@
 #include "olap/rowset/rowset_writer_context.h"
 #include "olap/rowset/segment_v2/inverted_index_compaction.h"
 #include "olap/rowset/segment_v2/inverted_index_compound_directory.h"
+#include "olap/rowset/segment_v2/segment_stitcher.h"
 #include "olap/storage_engine.h"
 #include "olap/storage_policy.h"
 #include "olap/tablet.h"
@@ -282,15 +284,20 @@ Status CompactionMixin::do_compact_ordered_rowsets() {
 }
 
 void CompactionMixin::build_basic_info() {
+    // called again when the compaction falls back to merge the rows of the input rowsets
+    _input_rowsets_size = 0;
+    _input_index_size = 0;
+    _input_row_num = 0;
+    _input_num_segments = 0;
     for (auto& rowset : _input_rowsets) {
         _input_rowsets_size += rowset->data_disk_size();
         _input_index_size += rowset->index_disk_size();
         _input_row_num += rowset->num_rows();
         _input_num_segments += rowset->num_segments();
     }
-    COUNTER_UPDATE(_input_rowsets_data_size_counter, _input_rowsets_size);
-    COUNTER_UPDATE(_input_row_num_counter, _input_row_num);
-    COUNTER_UPDATE(_input_segments_num_counter, _input_num_segments);
+    COUNTER_SET(_input_rowsets_data_size_counter, _input_rowsets_size);
+    COUNTER_SET(_input_row_num_counter, _input_row_num);
+    COUNTER_SET(_input_segments_num_counter, _input_num_segments);
 
     _output_version =
             Version(_input_rowsets.front()->start_version(), _input_rowsets.back()->end_version());
@@ -345,6 +352,122 @@ bool CompactionMixin::handle_ordered_data_compaction() {
     return st.ok();
 }
 
+bool CompactionMixin::handle_stitched_data_compaction() {
+    if (!config::enable_segment_stitching_compaction ||
+        compaction_type() != ReaderType::READER_CUMULATIVE_COMPACTION) {
+        return false;
+    }
+    if (_tablet->keys_type() == KeysType::UNIQUE_KEYS &&
+        _tablet->enable_unique_key_merge_on_write()) {
+        return false;
+    }
+    // The segments are stitched in version order, so the keys of every segment must sort after
+    // the keys of the segments before it. Equal keys of other key types have to be merged.
+    bool allow_equal_keys = _tablet->keys_type() == KeysType::DUP_KEYS;
+    bool has_pre_max_key = false;
+    std::string pre_max_key;
+    for (auto& rowset : _input_rowsets) {
+        if (rowset->rowset_meta()->has_delete_predicate()) {
+            return false;
+        }
+        std::vector<KeyBoundsPB> key_bounds;
+        if (!rowset->get_segments_key_bounds(&key_bounds).ok() ||
+            key_bounds.size() != rowset->num_segments()) {
+            return false;
+        }
+        for (const auto& key_bound : key_bounds) {
+            if (has_pre_max_key && (key_bound.min_key() < pre_max_key ||
+                                    (!allow_equal_keys && key_bound.min_key() == pre_max_key))) {
+                return false;
+            }
+            pre_max_key = key_bound.max_key();
+            has_pre_max_key = true;
+        }
+    }
+
+    auto st = do_compact_stitched_rowsets();
+    if (!st.ok()) {
+        LOG(INFO) << "fall back to merge rows of stitched data " << compaction_name()
+                  << ", tablet=" << _tablet->tablet_id() << ", output_version=" << _output_version
+                  << ", reason=" << st;
+        return false;
+    }
+    return true;
+}
+
+Status CompactionMixin::do_compact_stitched_rowsets() {
+    build_basic_info();
+    RETURN_IF_ERROR(segment_v2::SegmentStitcher::check_schema(*_cur_tablet_schema));
+    RowsetWriterContext ctx;
+    RETURN_IF_ERROR(construct_output_rowset_writer(ctx));
+
+    LOG(INFO) << "start to do stitched data compaction, tablet=" << _tablet->tablet_id()
+              << ", output_version=" << _output_version;
+    // copy the pages of consecutive input segments into output segments of up to
+    // segment_stitching_max_segment_size bytes
+    uint32_t segment_id = 0;
+    io::FileWriterPtr file_writer;
+    std::unique_ptr<segment_v2::SegmentStitcher> stitcher;
+    KeyBoundsPB key_bounds;
+    uint64_t stitched_size = 0;
+    auto finish_segment = [&]() -> Status {
+        uint64_t segment_size = 0;
+        uint64_t index_size = 0;
+        RETURN_IF_ERROR(stitcher->finalize(&segment_size, &index_size));
+        RETURN_IF_ERROR(file_writer->close());
+        SegmentStatistics segstat;
+        segstat.row_num = stitcher->num_rows();
+        segstat.data_size = segment_size;
+        segstat.index_size = index_size;
+        segstat.key_bounds = key_bounds;
+        RETURN_IF_ERROR(_output_rs_writer->add_segment(segment_id++, segstat, nullptr));
+        stitcher.reset();
+        file_writer.reset();
+        stitched_size = 0;
+        return Status::OK();
+    };
+    for (auto& rowset : _input_rowsets) {
+        auto* beta_rowset = static_cast<BetaRowset*>(rowset.get());
+        std::vector<segment_v2::SegmentSharedPtr> segments;
+        RETURN_IF_ERROR(beta_rowset->load_segments(&segments));
+        std::vector<size_t> segments_size;
+        RETURN_IF_ERROR(beta_rowset->get_segments_size(&segments_size));
+        std::vector<KeyBoundsPB> segments_key_bounds;
+        RETURN_IF_ERROR(rowset->get_segments_key_bounds(&segments_key_bounds));
+        for (size_t i = 0; i < segments.size(); ++i) {
+            if (segments[i]->num_rows() == 0) {
+                continue;
+            }
+            if (stitcher != nullptr &&
+                (stitched_size + segments_size[i] > config::segment_stitching_max_segment_size ||
+                 uint64_t(stitcher->num_rows()) + segments[i]->num_rows() >
+                         ctx.max_rows_per_segment)) {
+                RETURN_IF_ERROR(finish_segment());
+            }
+            if (stitcher == nullptr) {
+                RETURN_IF_ERROR(_output_rs_writer->create_file_writer(segment_id, file_writer));
+                stitcher = std::make_unique<segment_v2::SegmentStitcher>(
+                        _cur_tablet_schema, file_writer.get(), segment_id);
+                key_bounds.set_min_key(segments_key_bounds[i].min_key());
+            }
+            RETURN_IF_ERROR(stitcher->add_segment(segments[i]));
+            key_bounds.set_max_key(segments_key_bounds[i].max_key());
+            stitched_size += segments_size[i];
+        }
+    }
+    if (stitcher != nullptr) {
+        RETURN_IF_ERROR(finish_segment());
+    }
+
+    RETURN_NOT_OK_STATUS_WITH_WARN(_output_rs_writer->build(_output_rowset),
+                                   fmt::format("rowset writer build failed. output_version: {}",
+                                               _output_version.to_string()));
+    COUNTER_UPDATE(_output_rowset_data_size_counter, _output_rowset->data_disk_size());
+    COUNTER_UPDATE(_output_row_num_counter, _output_rowset->num_rows());
+    COUNTER_UPDATE(_output_segments_num_counter, _output_rowset->num_segments());
+    return Status::OK();
+}
+
 Status CompactionMixin::execute_compact() {
     uint32_t checksum_before;
     uint32_t checksum_after;
@@ -387,7 +510,7 @@ Status CompactionMixin::execute_compact() {
 Status CompactionMixin::execute_compact_impl(int64_t permits) {
     OlapStopWatch watch;
 
-    if (handle_ordered_data_compaction()) {
+    if (handle_ordered_data_compaction() || handle_stitched_data_compaction()) {
         RETURN_IF_ERROR(modify_rowsets());
         LOG(INFO) << "succeed to do ordered data " << compaction_name()
                   << ". tablet=" << _tablet->tablet_id() << ", output_version=" << _output_version
@@ -151,6 +151,10 @@ private:
 
     Status do_compact_ordered_rowsets();
 
+    bool handle_stitched_data_compaction();
+
+    Status do_compact_stitched_rowsets();
+
     Status do_inverted_index_compaction();
 
     bool _check_if_includes_input_rowsets(const RowsetIdUnorderedSet& commit_rowset_ids_set) const;
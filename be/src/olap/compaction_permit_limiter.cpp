@@ -48,6 +48,12 @@ void CompactionPermitLimiter::request(int64_t permits) {
     DorisMetrics::instance()->compaction_used_permits->set_value(_used_permits);
 }
 
+bool CompactionPermitLimiter::has_budget(int64_t permits, int64_t pending_permits) const {
+    int64_t used_permits = _used_permits + pending_permits;
+    return used_permits == 0 ||
+           used_permits + permits <= config::total_permits_for_compaction_score;
+}
+
 void CompactionPermitLimiter::release(int64_t permits) {
     std::unique_lock<std::mutex> lock(_permits_mutex);
     _used_permits -= permits;
@@ -42,6 +42,10 @@ public:
 
     int64_t usage() const { return _used_permits; }
 
+    // Whether "permits" could be requested without waiting, once the tasks about to be submitted
+    // got their "pending_permits" as well.
+    bool has_budget(int64_t permits, int64_t pending_permits = 0) const;
+
 private:
     // sum of "permits" held by executing compaction tasks currently
     std::atomic<int64_t> _used_permits;
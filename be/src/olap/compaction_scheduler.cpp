@@ -0,0 +1,160 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/compaction_scheduler.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <algorithm>
+#include <shared_mutex>
+
+#include "common/config.h"
+#include "olap/data_dir.h"
+#include "olap/tablet.h"
+#include "util/time.h"
+
+namespace doris {
+
+// the candidates of a round shown by the http api
+static constexpr size_t MAX_RECORDED_CANDIDATES = 100;
+
+CompactionCandidate CompactionScheduler::make_candidate(const TabletSharedPtr& tablet,
+                                                        CompactionType compaction_type,
+                                                        uint32_t compaction_score) {
+    CompactionCandidate candidate;
+    candidate.tablet = tablet;
+    candidate.tablet_id = tablet->tablet_id();
+    candidate.data_dir = tablet->data_dir()->path();
+    candidate.compaction_score = compaction_score;
+    candidate.version_count = tablet->version_count();
+    candidate.read_stats = tablet->read_stats.get();
+    {
+        std::shared_lock rlock(tablet->get_header_lock());
+        int64_t cumulative_point = tablet->cumulative_layer_point();
+        for (const auto& [version, rowset] : tablet->rowset_map()) {
+            bool in_cumulative_layer = version.first >= cumulative_point;
+            if (in_cumulative_layer == (compaction_type == CompactionType::CUMULATIVE_COMPACTION)) {
+                candidate.input_bytes += rowset->data_disk_size();
+            }
+        }
+    }
+    compute_priority(&candidate);
+    return candidate;
+}
+
+void CompactionScheduler::compute_priority(CompactionCandidate* candidate) {
+    double urgent_version_count =
+            config::max_tablet_version_num * config::low_priority_tablet_version_num_ratio;
+    candidate->urgent = candidate->version_count >= urgent_version_count;
+    const auto& read_stats = candidate->read_stats;
+    if (read_stats.queries <= 0 || read_stats.segments_per_query <= 0 ||
+        candidate->compaction_score <= 1) {
+        candidate->priority = 0;
+        return;
+    }
+    double removed_ratio = std::min(
+            1.0, (candidate->compaction_score - 1) / read_stats.segments_per_query);
+    double saved_ns = read_stats.queries * read_stats.read_ns_per_query * removed_ratio;
+    candidate->priority = saved_ns / std::max<int64_t>(candidate->input_bytes, 1);
+}
+
+void CompactionScheduler::rank(std::vector<CompactionCandidate>* candidates) {
+    std::sort(candidates->begin(), candidates->end(),
+              [](const CompactionCandidate& a, const CompactionCandidate& b) {
+                  if (a.urgent != b.urgent) {
+                      return a.urgent;
+                  }
+                  if (a.priority != b.priority) {
+                      return a.priority > b.priority;
+                  }
+                  return a.compaction_score > b.compaction_score;
+              });
+}
+
+void CompactionScheduler::record_round(CompactionType compaction_type,
+                                       const std::vector<CompactionCandidate>& candidates) {
+    Round round;
+    round.time_ms = UnixMillis();
+    size_t num = std::min(candidates.size(), MAX_RECORDED_CANDIDATES);
+    round.candidates.assign(candidates.begin(), candidates.begin() + num);
+    for (auto& candidate : round.candidates) {
+        // the tablets should not be kept alive by the records
+        candidate.tablet.reset();
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (compaction_type == CompactionType::BASE_COMPACTION) {
+        _base_round = std::move(round);
+    } else {
+        _cumu_round = std::move(round);
+    }
+}
+
+Status CompactionScheduler::get_status_json(std::string* result) {
+    rapidjson::Document root;
+    root.SetObject();
+    auto& allocator = root.GetAllocator();
+    auto add_round = [&](const char* name, const Round& round) {
+        rapidjson::Value round_obj(rapidjson::kObjectType);
+        rapidjson::Value time;
+        std::string time_str = round.time_ms == 0 ? "" : ToStringFromUnixMillis(round.time_ms);
+        time.SetString(time_str.c_str(), time_str.length(), allocator);
+        round_obj.AddMember("time", time, allocator);
+        rapidjson::Value arr(rapidjson::kArrayType);
+        for (const auto& candidate : round.candidates) {
+            rapidjson::Value obj(rapidjson::kObjectType);
+            obj.AddMember("tablet_id", candidate.tablet_id, allocator);
+            rapidjson::Value data_dir;
+            data_dir.SetString(candidate.data_dir.c_str(), candidate.data_dir.length(),
+                               allocator);
+            obj.AddMember("data_dir", data_dir, allocator);
+            obj.AddMember("compaction_score", candidate.compaction_score, allocator);
+            obj.AddMember("version_count", candidate.version_count, allocator);
+            obj.AddMember("input_bytes", candidate.input_bytes, allocator);
+            obj.AddMember("queries", candidate.read_stats.queries, allocator);
+            obj.AddMember("segments_per_query", candidate.read_stats.segments_per_query,
+                          allocator);
+            obj.AddMember("read_ms_per_query", candidate.read_stats.read_ns_per_query / 1000000,
+                          allocator);
+            obj.AddMember("urgent", candidate.urgent, allocator);
+            obj.AddMember("priority", candidate.priority, allocator);
+            rapidjson::Value decision;
+            decision.SetString(candidate.decision.c_str(), candidate.decision.length(),
+                               allocator);
+            obj.AddMember("decision", decision, allocator);
+            arr.PushBack(obj, allocator);
+        }
+        round_obj.AddMember("candidates", arr, allocator);
+        root.AddMember(rapidjson::StringRef(name), round_obj, allocator);
+    };
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        root.AddMember("enabled", config::enable_read_amplification_compaction_scheduling,
+                       allocator);
+        add_round("CumulativeCompaction", _cumu_round);
+        add_round("BaseCompaction", _base_round);
+    }
+
+    rapidjson::StringBuffer strbuf;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(strbuf);
+    root.Accept(writer);
+    *result = std::string(strbuf.GetString());
+    return Status::OK();
+}
+
+} // namespace doris
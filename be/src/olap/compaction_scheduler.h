@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "olap/olap_common.h"
+#include "olap/tablet_fwd.h"
+#include "olap/tablet_read_stats.h"
+
+namespace doris {
+
+// A tablet which can do compaction, with what the compaction costs and what it saves the queries.
+struct CompactionCandidate {
+    TabletSharedPtr tablet;
+    int64_t tablet_id = 0;
+    std::string data_dir;
+    uint32_t compaction_score = 0;
+    int64_t version_count = 0;
+    // size of the rowsets in the compacted layer of the tablet
+    int64_t input_bytes = 0;
+    TabletReadStats::Snapshot read_stats;
+    // the tablet has so many versions that loads will fail soon
+    bool urgent = false;
+    // query time the compaction saves in a half life of the read stats, per input byte
+    double priority = 0;
+    std::string decision;
+};
+
+// Orders the compaction candidates of all data dirs by the read amplification their compaction
+// removes per byte it rewrites, so that the hot tablets are compacted first. The decisions of the
+// latest round of every compaction type are kept to be shown by /api/compaction/schedule.
+//
+// A query pays read_ns_per_query for segments_per_query segments, and a compaction of a tablet
+// with compaction score N merges N segments into one. The compaction is assumed to save the
+// queries the part of their read time the N - 1 removed segments took.
+class CompactionScheduler {
+public:
+    static CompactionCandidate make_candidate(const TabletSharedPtr& tablet,
+                                              CompactionType compaction_type,
+                                              uint32_t compaction_score);
+
+    static void compute_priority(CompactionCandidate* candidate);
+
+    // Sorts the candidates, the ones to compact first at the front.
+    static void rank(std::vector<CompactionCandidate>* candidates);
+
+    void record_round(CompactionType compaction_type,
+                      const std::vector<CompactionCandidate>& candidates);
+
+    Status get_status_json(std::string* result);
+
+private:
+    struct Round {
+        int64_t time_ms = 0;
+        std::vector<CompactionCandidate> candidates;
+    };
+
+    std::mutex _mutex;
+    Round _cumu_round;
+    Round _base_round;
+};
+
+} // namespace doris
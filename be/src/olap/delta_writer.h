@@ -96,6 +96,8 @@ public:
 
     int64_t total_received_rows() const { return _memtable_writer->total_received_rows(); }
 
+    const std::shared_ptr<MemTableWriter>& memtable_writer() const { return _memtable_writer; }
+
     int64_t num_rows_filtered() const;
 
 protected:
@@ -17,11 +17,13 @@
 
 #include "olap/memtable_flush_executor.h"
 
+#include <bvar/bvar.h>
 #include <gen_cpp/olap_file.pb.h>
 
 #include <algorithm>
 #include <cstddef>
 #include <ostream>
+#include <unordered_map>
 
 #include "common/config.h"
 #include "common/logging.h"
@@ -41,6 +43,9 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(flush_thread_pool_queue_size, MetricUnit::NOU
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(flush_thread_pool_thread_num, MetricUnit::NOUNIT);
 
 bvar::Adder<int64_t> g_flush_task_num("memtable_flush_task_num");
+bvar::Adder<int64_t> g_flush_batched_memtable_num("memtable_flush_batched_memtable_num");
+// distribution of the disk size of the segments flushed from memtables
+bvar::LatencyRecorder g_flush_segment_bytes("memtable_flush_segment_bytes");
 
 class MemtableFlushTask final : public Runnable {
 public:
@@ -66,6 +71,63 @@ private:
     int64_t _submit_task_time;
 };
 
+class MemtableBatchFlushTask final : public Runnable {
+public:
+    explicit MemtableBatchFlushTask(std::vector<MemTableFlushBatch::Entry> entries)
+            : _entries(std::move(entries)) {
+        g_flush_task_num << 1;
+    }
+
+    ~MemtableBatchFlushTask() override { g_flush_task_num << -1; }
+
+    void run() override {
+        for (auto& entry : _entries) {
+            entry.flush_token->_flush_memtable(std::move(entry.memtable), entry.segment_id,
+                                               entry.submit_task_time);
+        }
+        _entries.clear();
+    }
+
+    std::vector<MemTableFlushBatch::Entry>& entries() { return _entries; }
+
+private:
+    std::vector<MemTableFlushBatch::Entry> _entries;
+};
+
+MemTableFlushBatch::~MemTableFlushBatch() {
+    _fail(_entries, Status::InternalError("memtable flush batch is not submitted"));
+}
+
+Status MemTableFlushBatch::submit() {
+    std::unordered_map<ThreadPool*, std::vector<Entry>> pool_entries;
+    for (auto& entry : _entries) {
+        pool_entries[entry.flush_token->_thread_pool].push_back(std::move(entry));
+    }
+    _entries.clear();
+    Status status;
+    for (auto& [pool, entries] : pool_entries) {
+        size_t num_entries = entries.size();
+        auto task = std::make_shared<MemtableBatchFlushTask>(std::move(entries));
+        Status st = pool->submit(task);
+        if (st.ok()) {
+            g_flush_batched_memtable_num << num_entries;
+        } else {
+            _fail(task->entries(), st);
+            status = st;
+        }
+    }
+    return status;
+}
+
+void MemTableFlushBatch::_fail(std::vector<Entry>& entries, const Status& st) {
+    for (auto& entry : entries) {
+        entry.flush_token->_set_flush_status(st);
+        entry.memtable.reset();
+        entry.flush_token->_stats.flush_running_count--;
+    }
+    entries.clear();
+}
+
 std::ostream& operator<<(std::ostream& os, const FlushStatistic& stat) {
     os << "(flush time(ms)=" << stat.flush_time_ns / NANOS_PER_MILLIS
        << ", flush wait time(ms)=" << stat.flush_wait_time_ns / NANOS_PER_MILLIS
@@ -76,7 +138,7 @@ std::ostream& operator<<(std::ostream& os, const FlushStatistic& stat) {
     return os;
 }
 
-Status FlushToken::submit(std::unique_ptr<MemTable> mem_table) {
+Status FlushToken::submit(std::unique_ptr<MemTable> mem_table, MemTableFlushBatch* batch) {
     {
         std::shared_lock rdlk(_flush_status_lock);
         DBUG_EXECUTE_IF("FlushToken.submit_flush_error", {
@@ -91,6 +153,12 @@ Status FlushToken::submit(std::unique_ptr<MemTable> mem_table) {
         return Status::OK();
     }
     int64_t submit_task_time = MonotonicNanos();
+    if (batch != nullptr) {
+        _stats.flush_running_count++;
+        batch->_entries.push_back({this, std::move(mem_table),
+                                   _rowset_writer->allocate_segment_id(), submit_task_time});
+        return Status::OK();
+    }
     auto task = std::make_shared<MemtableFlushTask>(
             this, std::move(mem_table), _rowset_writer->allocate_segment_id(), submit_task_time);
     Status ret = _thread_pool->submit(std::move(task));
@@ -100,6 +168,13 @@ Status FlushToken::submit(std::unique_ptr<MemTable> mem_table) {
     return ret;
 }
 
+void FlushToken::_set_flush_status(const Status& st) {
+    std::lock_guard wrlk(_flush_status_lock);
+    if (_flush_status.ok()) {
+        _flush_status = st;
+    }
+}
+
 // NOTE: FlushToken's submit/cancel/wait run in one thread,
 // so we don't need to make them mutually exclusive, std::atomic is enough.
 void FlushToken::_wait_running_task_finish() {
@@ -198,6 +273,7 @@ void FlushToken::_flush_memtable(std::unique_ptr<MemTable> memtable_ptr, int32_t
     _stats.flush_finish_count++;
     _stats.flush_size_bytes += memtable_ptr->memory_usage();
     _stats.flush_disk_size_bytes += flush_size;
+    g_flush_segment_bytes << flush_size;
 }
 
 void MemTableFlushExecutor::init(int num_disk) {
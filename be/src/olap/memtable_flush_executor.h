@@ -31,6 +31,7 @@
 namespace doris {
 
 class DataDir;
+class FlushToken;
 class MemTable;
 class RowsetWriter;
 
@@ -47,6 +48,36 @@ struct FlushStatistic {
 
 std::ostream& operator<<(std::ostream& os, const FlushStatistic& stat);
 
+// Memtables of several tablets that are flushed one after another by a single flush task,
+// so that a load writing to many tablets does not schedule a task for each tiny memtable.
+// Memtables are added by FlushToken::submit(), and the batch must be submitted before it is
+// destructed, otherwise the flush tokens of its memtables fail.
+class MemTableFlushBatch {
+public:
+    MemTableFlushBatch() = default;
+    ~MemTableFlushBatch();
+
+    size_t size() const { return _entries.size(); }
+
+    // submit one task per thread pool of the flush tokens
+    Status submit();
+
+private:
+    friend class FlushToken;
+    friend class MemtableBatchFlushTask;
+
+    struct Entry {
+        FlushToken* flush_token;
+        std::unique_ptr<MemTable> memtable;
+        int32_t segment_id;
+        int64_t submit_task_time;
+    };
+
+    static void _fail(std::vector<Entry>& entries, const Status& st);
+
+    std::vector<Entry> _entries;
+};
+
 // A thin wrapper of ThreadPoolToken to submit task.
 // For a tablet, there may be multiple memtables, which will be flushed to disk
 // one by one in the order of generation.
@@ -59,7 +90,8 @@ public:
     explicit FlushToken(ThreadPool* thread_pool)
             : _flush_status(Status::OK()), _thread_pool(thread_pool) {}
 
-    Status submit(std::unique_ptr<MemTable> mem_table);
+    // Submit the memtable to the thread pool, or add it to `batch` when it is not null.
+    Status submit(std::unique_ptr<MemTable> mem_table, MemTableFlushBatch* batch = nullptr);
 
     // error has happens, so we cancel this token
     // And remove all tasks in the queue.
@@ -82,6 +114,10 @@ private:
 
 private:
     friend class MemtableFlushTask;
+    friend class MemtableBatchFlushTask;
+    friend class MemTableFlushBatch;
+
+    void _set_flush_status(const Status& st);
 
     void _flush_memtable(std::unique_ptr<MemTable> memtable_ptr, int32_t segment_id,
                          int64_t submit_task_time);
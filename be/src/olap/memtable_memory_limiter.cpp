@@ -19,6 +19,9 @@
 
 #include <bvar/bvar.h>
 
+#include <algorithm>
+#include <utility>
+
 #include "common/config.h"
 #include "olap/memtable_writer.h"
 #include "util/doris_metrics.h"
@@ -160,7 +163,22 @@ void MemTableMemoryLimiter::_flush_active_memtables(int64_t need_flush) {
     int64_t mem_flushed = 0;
     int64_t num_flushed = 0;
     int64_t avg_mem = _active_mem_usage / _active_writers.size();
-    for (auto writer : _active_writers) {
+    std::vector<std::pair<int64_t, std::weak_ptr<MemTableWriter>>> writers;
+    writers.reserve(_active_writers.size());
+    for (const auto& writer : _active_writers) {
+        writers.emplace_back(0, writer);
+    }
+    if (config::enable_load_shared_write_buffer) {
+        // flush the largest memtables first, to write fewer and larger segments
+        for (auto& [mem_usage, writer] : writers) {
+            if (auto w = writer.lock()) {
+                mem_usage = w->active_memtable_mem_consumption();
+            }
+        }
+        std::sort(writers.begin(), writers.end(),
+                  [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+    }
+    for (const auto& [_, writer] : writers) {
         int64_t mem = _flush_memtable(writer, avg_mem);
         mem_flushed += mem;
         num_flushed += (mem > 0);
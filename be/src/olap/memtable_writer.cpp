@@ -17,6 +17,7 @@
 
 #include "olap/memtable_writer.h"
 
+#include <bvar/bvar.h>
 #include <fmt/format.h>
 
 #include <filesystem>
@@ -49,6 +50,9 @@
 namespace doris {
 using namespace ErrorCode;
 
+// distribution of the number of segments a load writes to a tablet
+bvar::LatencyRecorder g_load_tablet_segment_num("load_tablet_segment_num");
+
 MemTableWriter::MemTableWriter(const WriteRequest& req) : _req(req) {}
 
 MemTableWriter::~MemTableWriter() {
@@ -138,17 +142,17 @@ Status MemTableWriter::write(const vectorized::Block* block, const std::vector<u
     return Status::OK();
 }
 
-Status MemTableWriter::_flush_memtable_async() {
+Status MemTableWriter::_flush_memtable_async(MemTableFlushBatch* batch) {
     DCHECK(_flush_token != nullptr);
     std::unique_ptr<MemTable> memtable;
     {
         std::lock_guard<SpinLock> l(_mem_table_ptr_lock);
         memtable = std::move(_mem_table);
     }
-    return _flush_token->submit(std::move(memtable));
+    return _flush_token->submit(std::move(memtable), batch);
 }
 
-Status MemTableWriter::flush_async() {
+Status MemTableWriter::flush_async(MemTableFlushBatch* batch) {
     std::lock_guard<std::mutex> l(_lock);
     if (!_is_init || _is_closed) {
         // This writer is uninitialized or closed before flushing, do nothing.
@@ -165,7 +169,7 @@ Status MemTableWriter::flush_async() {
     VLOG_NOTICE << "flush memtable to reduce mem consumption. memtable size: "
                 << _mem_table->memory_usage() << ", tablet: " << _req.tablet_id
                 << ", load id: " << print_id(_req.load_id);
-    auto s = _flush_memtable_async();
+    auto s = _flush_memtable_async(batch);
     _reset_mem_table();
     return s;
 }
@@ -280,6 +284,7 @@ Status MemTableWriter::_do_close_wait() {
                      << ", total received rows: " << _total_received_rows;
         return Status::InternalError("rows number written by delta writer dosen't match");
     }
+    g_load_tablet_segment_num << _flush_token->get_stats().flush_finish_count;
 
     // const FlushStatistic& stat = _flush_token->get_stats();
     // print slow log if wait more than 1s
@@ -45,6 +45,7 @@ namespace doris {
 
 class FlushToken;
 class MemTable;
+class MemTableFlushBatch;
 class MemTracker;
 class StorageEngine;
 class TupleDescriptor;
@@ -98,7 +99,8 @@ public:
 
     // Submit current memtable to flush queue, and return without waiting.
     // This is currently for reducing mem consumption of this memtable writer.
-    Status flush_async();
+    // The memtable is added to `batch` instead when it is not null.
+    Status flush_async(MemTableFlushBatch* batch = nullptr);
 
     // Wait all memtable in flush queue to be flushed
     Status wait_flush();
@@ -113,7 +115,7 @@ public:
 
 private:
     // push a full memtable to flush executor
-    Status _flush_memtable_async();
+    Status _flush_memtable_async(MemTableFlushBatch* batch = nullptr);
 
     void _reset_mem_table();
 
@@ -52,6 +52,7 @@
 #include "io/fs/path.h"
 #include "olap/cold_data_compaction.h"
 #include "olap/compaction_permit_limiter.h"
+#include "olap/compaction_scheduler.h"
 #include "olap/cumulative_compaction_policy.h"
 #include "olap/cumulative_compaction_time_series_policy.h"
 #include "olap/data_dir.h"
@@ -826,6 +827,8 @@ std::vector<TabletSharedPtr> StorageEngine::_generate_compaction_tasks(
         copied_cumu_map = _tablet_submitted_cumu_compaction;
         copied_base_map = _tablet_submitted_base_compaction;
     }
+    std::vector<CompactionCandidate> candidates;
+    std::map<DataDir*, int> free_slots;
     for (auto data_dir : data_dirs) {
         bool need_pick_tablet = true;
         // We need to reserve at least one Slot for cumulative compaction.
@@ -854,6 +857,34 @@ std::vector<TabletSharedPtr> StorageEngine::_generate_compaction_tasks(
             }
         }
 
+        if (config::enable_read_amplification_compaction_scheduling) {
+            if (data_dir->reach_capacity_limit(0)) {
+                continue;
+            }
+            // The same as above, the last slot is kept for cumulative compaction.
+            int slots = thread_per_disk - count;
+            if (compaction_type == CompactionType::BASE_COMPACTION &&
+                copied_cumu_map[data_dir].empty()) {
+                slots -= 1;
+            }
+            free_slots[data_dir] = need_pick_tablet ? slots : 0;
+            auto tablets = _tablet_manager->find_tablets_to_compaction(
+                    compaction_type, data_dir,
+                    compaction_type == CompactionType::CUMULATIVE_COMPACTION
+                            ? copied_cumu_map[data_dir]
+                            : copied_base_map[data_dir],
+                    _cumulative_compaction_policies);
+            for (auto& [tablet, score] : tablets) {
+                if (tablet->tablet_meta()->tablet_schema()->disable_auto_compaction()) {
+                    continue;
+                }
+                max_compaction_score = std::max(max_compaction_score, score);
+                candidates.push_back(
+                        CompactionScheduler::make_candidate(tablet, compaction_type, score));
+            }
+            continue;
+        }
+
         // Even if need_pick_tablet is false, we still need to call find_best_tablet_to_compaction(),
         // So that we can update the max_compaction_score metric.
         if (!data_dir->reach_capacity_limit(0)) {
@@ -880,6 +911,11 @@ std::vector<TabletSharedPtr> StorageEngine::_generate_compaction_tasks(
         }
     }
 
+    if (config::enable_read_amplification_compaction_scheduling) {
+        tablets_compaction = _pick_compaction_tasks_by_read_amplification(compaction_type,
+                                                                          candidates, free_slots);
+    }
+
     if (max_compaction_score > 0) {
         if (compaction_type == CompactionType::BASE_COMPACTION) {
             DorisMetrics::instance()->tablet_base_max_compaction_score->set_value(
@@ -892,6 +928,35 @@ std::vector<TabletSharedPtr> StorageEngine::_generate_compaction_tasks(
     return tablets_compaction;
 }
 
+std::vector<TabletSharedPtr> StorageEngine::_pick_compaction_tasks_by_read_amplification(
+        CompactionType compaction_type, std::vector<CompactionCandidate>& candidates,
+        std::map<DataDir*, int>& free_slots) {
+    CompactionScheduler::rank(&candidates);
+    std::vector<TabletSharedPtr> tablets_compaction;
+    int64_t pending_permits = 0;
+    bool out_of_permits = false;
+    for (auto& candidate : candidates) {
+        int& slots = free_slots[candidate.tablet->data_dir()];
+        if (out_of_permits) {
+            // The candidates behind one without permits wait as well, otherwise the small
+            // compactions could keep the permits from the large one forever.
+            candidate.decision = "waiting for permits";
+        } else if (slots <= 0) {
+            candidate.decision = "no free slot on the disk";
+        } else if (!_permit_limiter.has_budget(candidate.compaction_score, pending_permits)) {
+            out_of_permits = true;
+            candidate.decision = "waiting for permits";
+        } else {
+            --slots;
+            pending_permits += candidate.compaction_score;
+            candidate.decision = "scheduled";
+            tablets_compaction.push_back(candidate.tablet);
+        }
+    }
+    _compaction_scheduler.record_round(compaction_type, candidates);
+    return tablets_compaction;
+}
+
 void StorageEngine::_update_cumulative_compaction_policy() {
     if (_cumulative_compaction_policies.empty()) {
         _cumulative_compaction_policies[CUMULATIVE_SIZE_BASED_POLICY] =
@@ -56,6 +56,10 @@ static std::string CACHE_QUERY_LIMIT_SIZE = "query_limit";
 static std::string CACHE_NORMAL_PERCENT = "normal_percent";
 static std::string CACHE_DISPOSABLE_PERCENT = "disposable_percent";
 static std::string CACHE_INDEX_PERCENT = "index_percent";
+static std::string CACHE_STORAGE = "storage";
+static std::string CACHE_STORAGE_FILE = "file";
+static std::string CACHE_STORAGE_SLAB = "slab";
+static std::string CACHE_DIRECT_IO = "direct_io";
 
 // TODO: should be a general util method
 // static std::string to_upper(const std::string& str) {
@@ -268,8 +272,30 @@ Status parse_conf_cache_paths(const std::string& config_path, std::vector<CacheP
             return Status::InvalidArgument("The sum of cache percent config must equal 100.");
         }
 
+        io::FileCacheStorage storage = io::FileCacheStorage::FILE;
+        if (map.HasMember(CACHE_STORAGE.c_str())) {
+            auto& value = map.FindMember(CACHE_STORAGE.c_str())->value;
+            if (value.IsString() && value.GetString() == CACHE_STORAGE_SLAB) {
+                storage = io::FileCacheStorage::SLAB;
+            } else if (!value.IsString() || value.GetString() != CACHE_STORAGE_FILE) {
+                return Status::InvalidArgument("storage should be file or slab");
+            }
+        }
+        bool direct_io = false;
+        if (map.HasMember(CACHE_DIRECT_IO.c_str())) {
+            auto& value = map.FindMember(CACHE_DIRECT_IO.c_str())->value;
+            if (value.IsBool()) {
+                direct_io = value.GetBool();
+            } else {
+                return Status::InvalidArgument("direct_io should be bool");
+            }
+        }
+        if (direct_io && storage != io::FileCacheStorage::SLAB) {
+            return Status::InvalidArgument("direct_io is only supported by the slab storage");
+        }
+
         paths.emplace_back(std::move(path), total_size, query_limit_bytes, normal_percent,
-                           disposable_percent, index_percent);
+                           disposable_percent, index_percent, storage, direct_io);
     }
     if (paths.empty()) {
         return Status::InvalidArgument("fail to parse storage_root_path config. value={}",
@@ -283,6 +309,9 @@ io::FileCacheSettings CachePath::init_settings() const {
     settings.total_size = total_bytes;
     settings.max_file_segment_size = config::file_cache_max_file_segment_size;
     settings.max_query_cache_size = query_limit_bytes;
+    settings.storage = storage;
+    settings.slab_file_size = config::file_cache_slab_file_size;
+    settings.slab_direct_io = direct_io;
     size_t per_size = settings.total_size / 100;
     settings.disposable_queue_size = per_size * disposable_percent;
     settings.disposable_queue_elements =
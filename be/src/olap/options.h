@@ -53,13 +53,16 @@ struct CachePath {
     io::FileCacheSettings init_settings() const;
 
     CachePath(std::string path, int64_t total_bytes, int64_t query_limit_bytes,
-              size_t normal_percent, size_t disposable_percent, size_t index_percent)
+              size_t normal_percent, size_t disposable_percent, size_t index_percent,
+              io::FileCacheStorage storage = io::FileCacheStorage::FILE, bool direct_io = false)
             : path(std::move(path)),
               total_bytes(total_bytes),
               query_limit_bytes(query_limit_bytes),
               normal_percent(normal_percent),
               disposable_percent(disposable_percent),
-              index_percent(index_percent) {}
+              index_percent(index_percent),
+              storage(storage),
+              direct_io(direct_io) {}
 
     std::string path;
     int64_t total_bytes = 0;
@@ -67,6 +70,9 @@ struct CachePath {
     size_t normal_percent = 85;
     size_t disposable_percent = 10;
     size_t index_percent = 5;
+    io::FileCacheStorage storage = io::FileCacheStorage::FILE;
+    // read and write the slab files with O_DIRECT
+    bool direct_io = false;
 };
 
 Status parse_conf_cache_paths(const std::string& config_path, std::vector<CachePath>& path);
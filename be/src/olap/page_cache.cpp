@@ -21,7 +21,9 @@
 
 #include <ostream>
 
+#include "common/config.h"
 #include "runtime/exec_env.h"
+#include "util/numa_util.h"
 
 namespace doris {
 StoragePageCache* StoragePageCache::create_global_cache(size_t capacity,
@@ -52,6 +54,10 @@ StoragePageCache::StoragePageCache(size_t capacity, int32_t index_cache_percenta
     _pk_index_page_cache = std::make_unique<PKIndexPageCache>(pk_index_cache_capacity, num_shards);
 }
 
+bool StoragePageCache::numa_interleave_pages() {
+    return config::numa_interleave_page_cache && NumaUtil::is_numa_machine();
+}
+
 bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle,
                               segment_v2::PageTypePB page_type) {
     auto cache = _get_page_cache(page_type);
@@ -76,7 +82,7 @@ void StoragePageCache::insert(const CacheKey& key, DataPage* data, PageCacheHand
     }
 
     auto cache = _get_page_cache(page_type);
-    auto lru_handle = cache->insert(key.encode(), data, data->capacity(), deleter, priority);
+    auto lru_handle = cache->insert(key.encode(), data, data->charge(), deleter, priority);
     *handle = PageCacheHandle(cache, lru_handle);
 }
 
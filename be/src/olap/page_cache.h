@@ -28,6 +28,7 @@
 
 #include "olap/lru_cache.h"
 #include "runtime/memory/lru_cache_policy.h"
+#include "util/numa_util.h"
 #include "util/slice.h"
 #include "vec/common/allocator.h"
 #include "vec/common/allocator_fwd.h"
@@ -41,8 +42,22 @@ class PageBase : private TAllocator {
 public:
     PageBase() : _data(nullptr), _size(0), _capacity(0) {}
 
-    PageBase(size_t b) : _size(b), _capacity(b) {
-        _data = reinterpret_cast<char*>(TAllocator::alloc(_capacity, ALLOCATOR_ALIGNMENT_16));
+    // An interleaved page is allocated from NumaInterleavedArena, see
+    // StoragePageCache::numa_interleave_pages().
+    PageBase(size_t b, bool interleaved = false)
+            : _size(b), _capacity(b), _interleaved(interleaved) {
+        if (_interleaved) {
+            TAllocator::memory_check(charge());
+            TAllocator::consume_memory(charge());
+            _data = reinterpret_cast<char*>(NumaInterleavedArena::instance()->alloc(_capacity));
+            if (_data == nullptr) {
+                TAllocator::release_memory(charge());
+                TAllocator::throw_bad_alloc(
+                        fmt::format("Cannot allocate numa interleaved page {}.", _capacity));
+            }
+        } else {
+            _data = reinterpret_cast<char*>(TAllocator::alloc(_capacity, ALLOCATOR_ALIGNMENT_16));
+        }
     }
 
     PageBase(const PageBase&) = delete;
@@ -51,13 +66,23 @@ public:
     ~PageBase() {
         if (_data != nullptr) {
             DCHECK(_capacity != 0 && _size != 0);
-            TAllocator::free(_data, _capacity);
+            if (_interleaved) {
+                NumaInterleavedArena::instance()->free(_data, _capacity);
+                TAllocator::release_memory(charge());
+            } else {
+                TAllocator::free(_data, _capacity);
+            }
         }
     }
 
     char* data() { return _data; }
     size_t size() { return _size; }
     size_t capacity() { return _capacity; }
+    bool interleaved() const { return _interleaved; }
+    // The memory taken by the page, an interleaved page takes a whole block of the arena.
+    size_t charge() const {
+        return _interleaved ? NumaInterleavedArena::block_size(_capacity) : _capacity;
+    }
 
     void reset_size(size_t n) {
         DCHECK(n <= _capacity);
@@ -69,6 +94,7 @@ private:
     // Effective size, smaller than capacity, such as data page remove checksum suffix.
     size_t _size;
     size_t _capacity = 0;
+    bool _interleaved = false;
 };
 
 using DataPage = PageBase<Allocator<false>>;
@@ -138,6 +164,10 @@ public:
     StoragePageCache(size_t capacity, int32_t index_cache_percentage,
                      int64_t pk_index_cache_capacity, uint32_t num_shards);
 
+    // Whether the pages read to be inserted into the cache are allocated interleaved over all
+    // NUMA nodes, they are read by scanners on every node.
+    static bool numa_interleave_pages();
+
     // Lookup the given page in the cache.
     //
     // If the page is found, the cache entry will be written into handle.
@@ -17,7 +17,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <roaring/roaring.hh>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "olap/olap_common.h"
@@ -25,6 +29,144 @@
 
 namespace doris {
 
+// The destination locations of the rows of one source segment.
+//
+// The rows of a source segment are added in the order of their row ids, and rows next to each
+// other in the source segment mostly stay next to each other in the destination, so the rows
+// are kept as runs of consecutive rows which take a few bytes for millions of rows. If the
+// rows of the segment are interleaved with the ones of other segments so much that the runs
+// take more memory than a location per row, the segment switches to a location per row.
+class SegmentRowIdConversion {
+public:
+    explicit SegmentRowIdConversion(uint32_t num_rows) : _num_rows(num_rows) {}
+
+    void add(uint32_t src_rowid, uint32_t dst_segment_id, uint32_t dst_rowid) {
+        DCHECK_LT(src_rowid, _num_rows);
+        if (_is_dense) {
+            _dense_map[src_rowid] = {dst_segment_id, dst_rowid};
+            return;
+        }
+        if (!_runs.empty()) {
+            Run& last = _runs.back();
+            if (src_rowid == last.src_rowid + last.num_rows &&
+                dst_segment_id == last.dst_segment_id &&
+                dst_rowid == last.dst_rowid + last.num_rows) {
+                ++last.num_rows;
+                return;
+            }
+        }
+        Run run {src_rowid, dst_segment_id, dst_rowid, 1};
+        if (_runs.empty() || src_rowid > _runs.back().src_rowid) {
+            _runs.push_back(run);
+        } else {
+            // rows added out of order, keep the runs ordered by source row id
+            _runs.insert(_upper_bound(src_rowid), run);
+        }
+        if (_runs.size() * sizeof(Run) > _num_rows * sizeof(std::pair<uint32_t, uint32_t>)) {
+            _to_dense();
+        }
+    }
+
+    // return false if the source row does not exist in the destination
+    bool get(uint32_t src_rowid, uint32_t* dst_segment_id, uint32_t* dst_rowid) const {
+        if (src_rowid >= _num_rows) {
+            return false;
+        }
+        if (_is_dense) {
+            std::tie(*dst_segment_id, *dst_rowid) = _dense_map[src_rowid];
+            return *dst_segment_id != UINT32_MAX || *dst_rowid != UINT32_MAX;
+        }
+        auto iter = _upper_bound(src_rowid);
+        if (iter == _runs.begin()) {
+            return false;
+        }
+        --iter;
+        if (src_rowid >= iter->src_rowid + iter->num_rows) {
+            return false;
+        }
+        *dst_segment_id = iter->dst_segment_id;
+        *dst_rowid = iter->dst_rowid + (src_rowid - iter->src_rowid);
+        return true;
+    }
+
+    // Converts the source row ids in one pass over the bitmap and the runs, instead of looking
+    // up every row id. found(src_rowid, dst_segment_id, dst_rowid) is called for the rows in the
+    // destination and missed(src_rowid) for the others, in the order of the source row ids.
+    template <typename Found, typename Missed>
+    void convert(const roaring::Roaring& src_rowids, Found&& found, Missed&& missed) const {
+        if (_is_dense) {
+            for (uint32_t src_rowid : src_rowids) {
+                if (src_rowid < _num_rows && (_dense_map[src_rowid].first != UINT32_MAX ||
+                                              _dense_map[src_rowid].second != UINT32_MAX)) {
+                    found(src_rowid, _dense_map[src_rowid].first, _dense_map[src_rowid].second);
+                } else {
+                    missed(src_rowid);
+                }
+            }
+            return;
+        }
+        size_t run_idx = 0;
+        for (uint32_t src_rowid : src_rowids) {
+            while (run_idx < _runs.size() &&
+                   _runs[run_idx].src_rowid + _runs[run_idx].num_rows <= src_rowid) {
+                ++run_idx;
+            }
+            if (run_idx < _runs.size() && src_rowid >= _runs[run_idx].src_rowid) {
+                const Run& run = _runs[run_idx];
+                found(src_rowid, run.dst_segment_id, run.dst_rowid + (src_rowid - run.src_rowid));
+            } else {
+                missed(src_rowid);
+            }
+        }
+    }
+
+    // a location per row, <UINT32_MAX, UINT32_MAX> for the rows not in the destination
+    std::vector<std::pair<uint32_t, uint32_t>> to_vector() const {
+        if (_is_dense) {
+            return _dense_map;
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> rowid_map(
+                _num_rows, std::pair<uint32_t, uint32_t>(UINT32_MAX, UINT32_MAX));
+        for (const Run& run : _runs) {
+            for (uint32_t i = 0; i < run.num_rows; ++i) {
+                rowid_map[run.src_rowid + i] = {run.dst_segment_id, run.dst_rowid + i};
+            }
+        }
+        return rowid_map;
+    }
+
+    size_t mem_size() const {
+        return _runs.capacity() * sizeof(Run) +
+               _dense_map.capacity() * sizeof(std::pair<uint32_t, uint32_t>);
+    }
+
+private:
+    struct Run {
+        uint32_t src_rowid;
+        uint32_t dst_segment_id;
+        uint32_t dst_rowid;
+        uint32_t num_rows;
+    };
+
+    std::vector<Run>::const_iterator _upper_bound(uint32_t src_rowid) const {
+        return std::upper_bound(
+                _runs.begin(), _runs.end(), src_rowid,
+                [](uint32_t rowid, const Run& run) { return rowid < run.src_rowid; });
+    }
+
+    void _to_dense() {
+        _dense_map = to_vector();
+        _is_dense = true;
+        std::vector<Run>().swap(_runs);
+    }
+
+    uint32_t _num_rows;
+    bool _is_dense = false;
+    // ordered by src_rowid, not overlapped
+    std::vector<Run> _runs;
+    std::vector<std::pair<uint32_t, uint32_t>> _dense_map;
+};
+
 // For unique key merge on write table, we should update delete bitmap
 // of destination rowset when compaction finished.
 // Through the row id correspondence between the source rowset and the
@@ -35,37 +177,42 @@ public:
     RowIdConversion() = default;
     ~RowIdConversion() = default;
 
-    // resize segment rowid map to its rows num
+    // init the rowid map of the segments with their rows num
     void init_segment_map(const RowsetId& src_rowset_id, const std::vector<uint32_t>& num_rows) {
         for (size_t i = 0; i < num_rows.size(); i++) {
             uint32_t id = _segments_rowid_map.size();
             _segment_to_id_map.emplace(std::pair<RowsetId, uint32_t> {src_rowset_id, i}, id);
             _id_to_segment_map.emplace_back(src_rowset_id, i);
-            _segments_rowid_map.emplace_back(std::vector<std::pair<uint32_t, uint32_t>>(
-                    num_rows[i], std::pair<uint32_t, uint32_t>(UINT32_MAX, UINT32_MAX)));
+            _segments_rowid_map.emplace_back(num_rows[i]);
         }
     }
 
     // set dst rowset id
     void set_dst_rowset_id(const RowsetId& dst_rowset_id) { _dst_rowst_id = dst_rowset_id; }
-    const RowsetId get_dst_rowset_id() { return _dst_rowst_id; }
+    const RowsetId get_dst_rowset_id() const { return _dst_rowst_id; }
 
     // add row id to the map
     void add(const std::vector<RowLocation>& rss_row_ids,
              const std::vector<uint32_t>& dst_segments_num_row) {
+        // the rows of a segment come in batches, look up the segment once for a batch
+        const RowLocation* last_item = nullptr;
+        uint32_t id = 0;
         for (auto& item : rss_row_ids) {
             if (item.row_id == -1) {
                 continue;
             }
-            uint32_t id = _segment_to_id_map.at(
-                    std::pair<RowsetId, uint32_t> {item.rowset_id, item.segment_id});
+            if (last_item == nullptr || item.segment_id != last_item->segment_id ||
+                item.rowset_id != last_item->rowset_id) {
+                id = _segment_to_id_map.at(
+                        std::pair<RowsetId, uint32_t> {item.rowset_id, item.segment_id});
+                last_item = &item;
+            }
             if (_cur_dst_segment_id < dst_segments_num_row.size() &&
                 _cur_dst_segment_rowid >= dst_segments_num_row[_cur_dst_segment_id]) {
                 _cur_dst_segment_id++;
                 _cur_dst_segment_rowid = 0;
             }
-            _segments_rowid_map[id][item.row_id] =
-                    std::pair<uint32_t, uint32_t> {_cur_dst_segment_id, _cur_dst_segment_rowid++};
+            _segments_rowid_map[id].add(item.row_id, _cur_dst_segment_id, _cur_dst_segment_rowid++);
         }
     }
 
@@ -76,12 +223,9 @@ public:
         if (iter == _segment_to_id_map.end()) {
             return -1;
         }
-        const auto& rowid_map = _segments_rowid_map[iter->second];
-        if (src.row_id >= rowid_map.size()) {
-            return -1;
-        }
-        auto& [dst_segment_id, dst_rowid] = rowid_map[src.row_id];
-        if (dst_segment_id == UINT32_MAX && dst_rowid == UINT32_MAX) {
+        uint32_t dst_segment_id = 0;
+        uint32_t dst_rowid = 0;
+        if (!_segments_rowid_map[iter->second].get(src.row_id, &dst_segment_id, &dst_rowid)) {
             return -1;
         }
 
@@ -91,9 +235,34 @@ public:
         return 0;
     }
 
-    const std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& get_rowid_conversion_map()
-            const {
-        return _segments_rowid_map;
+    // Converts the row ids of a source segment in one pass, see SegmentRowIdConversion::convert.
+    // All the row ids are missed if the segment is not a source segment.
+    template <typename Found, typename Missed>
+    void convert(const RowsetId& src_rowset_id, uint32_t src_segment_id,
+                 const roaring::Roaring& src_rowids, Found&& found, Missed&& missed) const {
+        auto iter = _segment_to_id_map.find({src_rowset_id, src_segment_id});
+        if (iter == _segment_to_id_map.end()) {
+            for (uint32_t src_rowid : src_rowids) {
+                missed(src_rowid);
+            }
+            return;
+        }
+        _segments_rowid_map[iter->second].convert(src_rowids, std::forward<Found>(found),
+                                                  std::forward<Missed>(missed));
+    }
+
+    // The first level vector: index indicates src segment.
+    // The second level vector: index indicates row id of source segment,
+    // value indicates row id of destination segment.
+    // <UINT32_MAX, UINT32_MAX> indicates current row not exist.
+    // It takes a location per source row, build it only when it is really needed.
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> get_rowid_conversion_map() const {
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> rowid_map;
+        rowid_map.reserve(_segments_rowid_map.size());
+        for (const auto& segment_rowid_map : _segments_rowid_map) {
+            rowid_map.push_back(segment_rowid_map.to_vector());
+        }
+        return rowid_map;
     }
 
     const std::map<std::pair<RowsetId, uint32_t>, uint32_t>& get_src_segment_to_id_map() {
@@ -109,12 +278,17 @@ public:
         return _segment_to_id_map.at(segment);
     }
 
+    size_t mem_size() const {
+        size_t mem_size = 0;
+        for (const auto& segment_rowid_map : _segments_rowid_map) {
+            mem_size += segment_rowid_map.mem_size();
+        }
+        return mem_size;
+    }
+
 private:
-    // the first level vector: index indicates src segment.
-    // the second level vector: index indicates row id of source segment,
-    // value indicates row id of destination segment.
-    // <UINT32_MAX, UINT32_MAX> indicates current row not exist.
-    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> _segments_rowid_map;
+    // index indicates src segment.
+    std::vector<SegmentRowIdConversion> _segments_rowid_map;
 
     // Map source segment to 0 to n
     std::map<std::pair<RowsetId, uint32_t>, uint32_t> _segment_to_id_map;
@@ -28,7 +28,18 @@ void BlockSplitBloomFilter::add_hash(uint64_t hash) {
     DCHECK(_num_bytes >= BYTES_PER_BLOCK);
     const uint32_t bucket_index =
             static_cast<uint32_t>(hash >> 32) & (_num_bytes / BYTES_PER_BLOCK - 1);
-    uint32_t key = static_cast<uint32_t>(hash);
+    _add_to_block(bucket_index, static_cast<uint32_t>(hash));
+}
+
+bool BlockSplitBloomFilter::test_hash(uint64_t hash) const {
+    // most significant 32 bit mod block size as block index(BTW:block size is
+    // power of 2)
+    const uint32_t bucket_index =
+            static_cast<uint32_t>((hash >> 32) & (_num_bytes / BYTES_PER_BLOCK - 1));
+    return _test_block(bucket_index, static_cast<uint32_t>(hash));
+}
+
+void BlockSplitBloomFilter::_add_to_block(uint32_t bucket_index, uint32_t key) {
     uint32_t* bitset32 = reinterpret_cast<uint32_t*>(_data);
 
     // Calculate mask for bucket.
@@ -40,12 +51,7 @@ void BlockSplitBloomFilter::add_hash(uint64_t hash) {
     }
 }
 
-bool BlockSplitBloomFilter::test_hash(uint64_t hash) const {
-    // most significant 32 bit mod block size as block index(BTW:block size is
-    // power of 2)
-    const uint32_t bucket_index =
-            static_cast<uint32_t>((hash >> 32) & (_num_bytes / BYTES_PER_BLOCK - 1));
-    uint32_t key = static_cast<uint32_t>(hash);
+bool BlockSplitBloomFilter::_test_block(uint32_t bucket_index, uint32_t key) const {
     uint32_t* bitset32 = reinterpret_cast<uint32_t*>(_data);
 
     // Calculate masks for bucket.
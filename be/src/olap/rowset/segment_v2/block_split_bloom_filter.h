@@ -36,7 +36,10 @@ public:
     bool test_hash(uint64_t hash) const override;
     bool contains(const BloomFilter&) const override { return true; }
 
-private:
+protected:
+    void _add_to_block(uint32_t bucket_index, uint32_t key);
+    bool _test_block(uint32_t bucket_index, uint32_t key) const;
+
     // Bytes in a tiny Bloom filter block.
     static constexpr int BYTES_PER_BLOCK = 32;
     // The number of bits to set in a tiny Bloom filter block
@@ -50,7 +53,6 @@ private:
         uint32_t item[BITS_SET_PER_BLOCK];
     };
 
-private:
     void _set_masks(uint32_t key, BlockMask& block_mask) const {
         for (int i = 0; i < BITS_SET_PER_BLOCK; ++i) {
             block_mask.item[i] = key * SALT[i];
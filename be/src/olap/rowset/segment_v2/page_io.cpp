@@ -144,7 +144,8 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
     }
 
     // hold compressed page at first, reset to decompressed page later
-    std::unique_ptr<DataPage> page = std::make_unique<DataPage>(page_size);
+    bool interleaved = opts.use_page_cache && cache && StoragePageCache::numa_interleave_pages();
+    std::unique_ptr<DataPage> page = std::make_unique<DataPage>(page_size, interleaved);
     Slice page_slice(page->data(), page_size);
     {
         SCOPED_RAW_TIMER(&opts.stats->io_ns);
@@ -182,8 +183,8 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
                     opts.file_reader->path().native());
         }
         SCOPED_RAW_TIMER(&opts.stats->decompress_ns);
-        std::unique_ptr<DataPage> decompressed_page =
-                std::make_unique<DataPage>(footer->uncompressed_size() + footer_size + 4);
+        std::unique_ptr<DataPage> decompressed_page = std::make_unique<DataPage>(
+                footer->uncompressed_size() + footer_size + 4, interleaved);
 
         // decompress page body
         Slice compressed_body(page_slice.data, body_size);
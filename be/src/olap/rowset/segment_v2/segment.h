@@ -145,6 +145,9 @@ public:
 
     io::FileReaderSPtr file_reader() { return _file_reader; }
 
+    // The footer is not kept after the segment is opened, it is read from the file again.
+    Status read_footer(SegmentFooterPB* footer) { return _parse_footer(footer); }
+
     int64_t meta_mem_usage() const { return _meta_mem_usage; }
 
     void remove_from_segment_cache() const;
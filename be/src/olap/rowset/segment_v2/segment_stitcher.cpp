@@ -0,0 +1,608 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/segment_stitcher.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/config.h"
+#include "io/fs/file_reader.h"
+#include "io/fs/file_writer.h"
+#include "olap/iterators.h"
+#include "olap/key_coder.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/column_writer.h"
+#include "olap/rowset/segment_v2/encoding_info.h"
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
+#include "olap/rowset/segment_v2/indexed_column_writer.h"
+#include "olap/rowset/segment_v2/ordinal_page_index.h"
+#include "olap/rowset/segment_v2/page_io.h"
+#include "olap/rowset/segment_v2/page_pointer.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/short_key_index.h"
+#include "olap/types.h"
+#include "olap/wrapper_field.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/faststring.h"
+#include "util/key_util.h"
+#include "vec/columns/column_string.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_factory.hpp"
+#include "vec/olap/olap_data_convertor.h"
+
+namespace doris::segment_v2 {
+
+namespace {
+
+// rows decoded at a time from the dictionary encoded columns
+constexpr size_t REENCODE_BATCH_ROWS = 4096;
+
+const ColumnMetaPB* find_column_meta(const SegmentFooterPB& footer, int32_t unique_id) {
+    for (const auto& meta : footer.columns()) {
+        if (meta.unique_id() == unique_id) {
+            return &meta;
+        }
+    }
+    return nullptr;
+}
+
+const ColumnIndexMetaPB* find_index_meta(const ColumnMetaPB& meta, ColumnIndexTypePB type) {
+    for (const auto& index : meta.indexes()) {
+        if (index.type() == type) {
+            return &index;
+        }
+    }
+    return nullptr;
+}
+
+Status read_indexed_values(io::FileReaderSPtr file_reader, const IndexedColumnMetaPB& meta,
+                           std::vector<std::string>* values) {
+    IndexedColumnReader reader(std::move(file_reader), meta);
+    RETURN_IF_ERROR(reader.load(false, false));
+    if (reader.num_values() == 0) {
+        return Status::OK();
+    }
+    IndexedColumnIterator iter(&reader);
+    RETURN_IF_ERROR(iter.seek_to_ordinal(0));
+    size_t num_read = reader.num_values();
+    // Zone maps are stored as OBJECT and bloom filters as VARCHAR, both are read as strings.
+    vectorized::MutableColumnPtr column = vectorized::ColumnString::create();
+    RETURN_IF_ERROR(iter.next_batch(&num_read, column));
+    if (num_read != reader.num_values()) {
+        return Status::Corruption("read {} values of indexed column, expect {}", num_read,
+                                  reader.num_values());
+    }
+    for (size_t i = 0; i < num_read; ++i) {
+        auto value = column->get_data_at(i);
+        values->emplace_back(value.data, value.size);
+    }
+    return Status::OK();
+}
+
+Status write_indexed_values(io::FileWriter* file_writer, const TypeInfo* type_info,
+                            const IndexedColumnWriterOptions& options,
+                            const std::vector<std::string>& values, IndexedColumnMetaPB* meta) {
+    IndexedColumnWriter writer(options, type_info, file_writer);
+    RETURN_IF_ERROR(writer.init());
+    for (const auto& value : values) {
+        Slice slice(value);
+        RETURN_IF_ERROR(writer.add(&slice));
+    }
+    return writer.finish(meta);
+}
+
+} // namespace
+
+struct SegmentStitcher::StitchedColumn {
+    const TabletColumn* tablet_column = nullptr;
+    // the meta in the footer of the output segment
+    ColumnMetaPB* meta = nullptr;
+
+    // Copied pages.
+    std::unique_ptr<OrdinalIndexWriter> ordinal_index;
+    bool has_zone_map = false;
+    bool has_segment_zone_map = false;
+    ZoneMapPB segment_zone_map;
+    std::vector<std::string> page_zone_maps;
+    bool has_bloom_filter = false;
+    HashStrategyPB bloom_filter_hash_strategy;
+    BloomFilterAlgorithmPB bloom_filter_algorithm;
+    std::vector<std::string> bloom_filters;
+
+    // Encoded again, dictionary pages are per segment.
+    std::unique_ptr<ColumnWriter> writer;
+    std::unique_ptr<vectorized::OlapBlockDataConvertor> convertor;
+    vectorized::DataTypePtr data_type;
+};
+
+SegmentStitcher::SegmentStitcher(TabletSchemaSPtr tablet_schema, io::FileWriter* file_writer,
+                                 uint32_t segment_id)
+        : _tablet_schema(std::move(tablet_schema)),
+          _file_writer(file_writer),
+          _segment_id(segment_id) {
+    CHECK_NOTNULL(file_writer);
+    _io_ctx.reader_type = ReaderType::READER_CUMULATIVE_COMPACTION;
+    for (size_t cid = 0; cid < _tablet_schema->num_short_key_columns(); ++cid) {
+        const auto& column = _tablet_schema->column(cid);
+        _key_coders.push_back(get_key_coder(column.type()));
+        _key_index_size.push_back(column.index_length());
+    }
+    _short_key_index_builder = std::make_unique<ShortKeyIndexBuilder>(
+            _segment_id, SegmentWriterOptions().num_rows_per_block);
+}
+
+SegmentStitcher::~SegmentStitcher() = default;
+
+Status SegmentStitcher::check_schema(const TabletSchema& tablet_schema) {
+    if (tablet_schema.num_variant_columns() > 0) {
+        return Status::NotSupported("can not stitch segments of variant columns");
+    }
+    for (const auto& column : tablet_schema.columns()) {
+        if (column->get_subtype_count() > 0) {
+            return Status::NotSupported("can not stitch segments of nested column {}",
+                                        column->name());
+        }
+        // the inverted index and bitmap index files are built over the row ids of the segment
+        if (column->has_bitmap_index() || tablet_schema.has_inverted_index(*column) ||
+            tablet_schema.has_ngram_bf_index(column->unique_id())) {
+            return Status::NotSupported("can not stitch segments of column {} with index",
+                                        column->name());
+        }
+    }
+    return Status::OK();
+}
+
+Status SegmentStitcher::_init_columns(const SegmentFooterPB& footer) {
+    for (uint32_t cid = 0; cid < _tablet_schema->num_columns(); ++cid) {
+        const auto& tablet_column = _tablet_schema->column(cid);
+        const auto* src = find_column_meta(footer, tablet_column.unique_id());
+        if (src == nullptr) {
+            return Status::NotSupported("column {} is missing in the segment",
+                                        tablet_column.name());
+        }
+        auto column = std::make_unique<StitchedColumn>();
+        column->tablet_column = &tablet_column;
+        column->meta = _footer.add_columns();
+        column->meta->CopyFrom(*src);
+        column->meta->set_column_id(cid);
+        column->meta->clear_indexes();
+        column->meta->clear_dict_page();
+        for (const auto& index : src->indexes()) {
+            switch (index.type()) {
+            case ORDINAL_INDEX:
+                break;
+            case ZONE_MAP_INDEX:
+                column->has_zone_map = true;
+                break;
+            case BLOOM_FILTER_INDEX:
+                column->has_bloom_filter = true;
+                column->bloom_filter_hash_strategy = index.bloom_filter_index().hash_strategy();
+                column->bloom_filter_algorithm = index.bloom_filter_index().algorithm();
+                break;
+            default:
+                return Status::NotSupported("can not stitch index {} of column {}",
+                                            ColumnIndexTypePB_Name(index.type()),
+                                            tablet_column.name());
+            }
+        }
+
+        if (src->encoding() != DICT_ENCODING && !src->has_dict_page()) {
+            column->ordinal_index = std::make_unique<OrdinalIndexWriter>();
+            _columns.push_back(std::move(column));
+            continue;
+        }
+        ColumnWriterOptions opts;
+        opts.meta = column->meta;
+        opts.need_zone_map = column->has_zone_map;
+        opts.need_bloom_filter = column->has_bloom_filter;
+        if (tablet_column.is_row_store_column()) {
+            opts.data_page_size = config::row_column_page_size;
+        }
+        RETURN_IF_ERROR(ColumnWriter::create(opts, &tablet_column, _file_writer, &column->writer));
+        RETURN_IF_ERROR(column->writer->init());
+        column->convertor = std::make_unique<vectorized::OlapBlockDataConvertor>();
+        column->convertor->add_column_data_convertor(tablet_column);
+        column->data_type = vectorized::DataTypeFactory::instance().create_data_type(tablet_column);
+        _columns.push_back(std::move(column));
+    }
+    return Status::OK();
+}
+
+Status SegmentStitcher::add_segment(const SegmentSharedPtr& segment) {
+    if (segment->num_rows() == 0) {
+        return Status::OK();
+    }
+    SegmentFooterPB footer;
+    RETURN_IF_ERROR(segment->read_footer(&footer));
+    if (footer.has_primary_key_index_meta()) {
+        return Status::NotSupported("can not stitch segments with primary key index");
+    }
+    if (_columns.empty()) {
+        RETURN_IF_ERROR(_init_columns(footer));
+    }
+
+    for (auto& column : _columns) {
+        const auto* meta = find_column_meta(footer, column->tablet_column->unique_id());
+        if (meta == nullptr) {
+            return Status::NotSupported("column {} is missing in the segment",
+                                        column->tablet_column->name());
+        }
+        if (meta->type() != column->meta->type() || meta->length() != column->meta->length() ||
+            meta->is_nullable() != column->meta->is_nullable() ||
+            meta->children_columns_size() > 0) {
+            return Status::NotSupported("column {} of the segments is of different types",
+                                        column->tablet_column->name());
+        }
+        if (column->writer != nullptr) {
+            RETURN_IF_ERROR(_reencode(column.get(), segment));
+            continue;
+        }
+        // The decoders of the pages are chosen by the meta of the column.
+        if (meta->encoding() != column->meta->encoding() ||
+            meta->compression() != column->meta->compression() || meta->has_dict_page()) {
+            return Status::NotSupported("column {} of the segments is encoded differently",
+                                        column->tablet_column->name());
+        }
+        RETURN_IF_ERROR(_copy_pages(column.get(), *meta, segment));
+    }
+
+    RETURN_IF_ERROR(_add_short_keys(segment));
+    _num_rows += segment->num_rows();
+    return Status::OK();
+}
+
+Status SegmentStitcher::_copy_pages(StitchedColumn* column, const ColumnMetaPB& meta,
+                                    const SegmentSharedPtr& segment) {
+    const auto* ordinal_index = find_index_meta(meta, ORDINAL_INDEX);
+    const auto* zone_map_index = find_index_meta(meta, ZONE_MAP_INDEX);
+    const auto* bloom_filter_index = find_index_meta(meta, BLOOM_FILTER_INDEX);
+    if (ordinal_index == nullptr) {
+        return Status::Corruption("no ordinal index of column {} in segment {}",
+                                  column->tablet_column->name(),
+                                  segment->file_reader()->path().native());
+    }
+    if ((column->has_zone_map && zone_map_index == nullptr) ||
+        (column->has_bloom_filter && bloom_filter_index == nullptr)) {
+        return Status::NotSupported("column {} of the segments has different indexes",
+                                    column->tablet_column->name());
+    }
+    if (column->has_bloom_filter &&
+        (bloom_filter_index->bloom_filter_index().hash_strategy() !=
+                 column->bloom_filter_hash_strategy ||
+         bloom_filter_index->bloom_filter_index().algorithm() != column->bloom_filter_algorithm)) {
+        return Status::NotSupported("column {} of the segments has different bloom filters",
+                                    column->tablet_column->name());
+    }
+
+    auto file_reader = segment->file_reader();
+    OrdinalIndexReader ordinal_reader(file_reader, segment->num_rows(),
+                                      ordinal_index->ordinal_index());
+    RETURN_IF_ERROR(ordinal_reader.load(false, false));
+    std::vector<PagePointer> pages;
+    for (auto iter = ordinal_reader.begin(); iter.valid(); iter.next()) {
+        pages.push_back(iter.page());
+    }
+    if (pages.empty()) {
+        return Status::Corruption("no data page of column {} in segment {}",
+                                  column->tablet_column->name(), file_reader->path().native());
+    }
+
+    // The pages of a column are written one after another, they are read in one go.
+    uint64_t begin = pages.front().offset;
+    uint64_t end = pages.front().offset + pages.front().size;
+    for (const auto& page : pages) {
+        begin = std::min(begin, page.offset);
+        end = std::max(end, page.offset + page.size);
+    }
+    std::string buf;
+    buf.resize(end - begin);
+    size_t bytes_read = 0;
+    RETURN_IF_ERROR(file_reader->read_at(begin, Slice(buf.data(), buf.size()), &bytes_read,
+                                         &_io_ctx));
+    if (bytes_read != buf.size()) {
+        return Status::Corruption("read {} bytes of column {} in segment {}, expect {}",
+                                  bytes_read, column->tablet_column->name(),
+                                  file_reader->path().native(), buf.size());
+    }
+
+    // Page := PageBody, PageFooter, FooterSize(4), Checksum(4)
+    for (const auto& page : pages) {
+        const char* data = buf.data() + (page.offset - begin);
+        if (page.size < 8) {
+            return Status::Corruption("bad page size {} in segment {}", page.size,
+                                      file_reader->path().native());
+        }
+        uint32_t footer_size = decode_fixed32_le((const uint8_t*)data + page.size - 8);
+        uint32_t checksum = decode_fixed32_le((const uint8_t*)data + page.size - 4);
+        if (crc32c::Value(data, page.size - 4) != checksum) {
+            return Status::Corruption("bad page checksum at offset {} in segment {}", page.offset,
+                                      file_reader->path().native());
+        }
+        PageFooterPB footer;
+        if (footer_size > page.size - 8 ||
+            !footer.ParseFromArray(data + page.size - 8 - footer_size, footer_size) ||
+            !footer.has_data_page_footer()) {
+            return Status::Corruption("bad page footer at offset {} in segment {}", page.offset,
+                                      file_reader->path().native());
+        }
+        ordinal_t first_ordinal = _num_rows + footer.data_page_footer().first_ordinal();
+        footer.mutable_data_page_footer()->set_first_ordinal(first_ordinal);
+        // the body is written as it is, compressed or not
+        PagePointer pp;
+        RETURN_IF_ERROR(PageIO::write_page(_file_writer, {Slice(data, page.size - 8 - footer_size)},
+                                           footer, &pp));
+        column->ordinal_index->append_entry(first_ordinal, pp);
+    }
+
+    if (column->has_zone_map) {
+        const auto& zone_map = zone_map_index->zone_map_index();
+        RETURN_IF_ERROR(_merge_zone_map(column, zone_map.segment_zone_map()));
+        size_t num_page_zone_maps = column->page_zone_maps.size();
+        RETURN_IF_ERROR(read_indexed_values(file_reader, zone_map.page_zone_maps(),
+                                            &column->page_zone_maps));
+        if (column->page_zone_maps.size() - num_page_zone_maps != pages.size()) {
+            return Status::Corruption("{} page zone maps of column {} in segment {}, expect {}",
+                                      column->page_zone_maps.size() - num_page_zone_maps,
+                                      column->tablet_column->name(), file_reader->path().native(),
+                                      pages.size());
+        }
+    }
+    if (column->has_bloom_filter) {
+        size_t num_bloom_filters = column->bloom_filters.size();
+        RETURN_IF_ERROR(read_indexed_values(file_reader,
+                                            bloom_filter_index->bloom_filter_index().bloom_filter(),
+                                            &column->bloom_filters));
+        if (column->bloom_filters.size() - num_bloom_filters != pages.size()) {
+            return Status::Corruption("{} bloom filters of column {} in segment {}, expect {}",
+                                      column->bloom_filters.size() - num_bloom_filters,
+                                      column->tablet_column->name(), file_reader->path().native(),
+                                      pages.size());
+        }
+    }
+    return Status::OK();
+}
+
+Status SegmentStitcher::_merge_zone_map(StitchedColumn* column, const ZoneMapPB& zone_map) {
+    auto& merged = column->segment_zone_map;
+    if (!column->has_segment_zone_map) {
+        merged = zone_map;
+        column->has_segment_zone_map = true;
+        return Status::OK();
+    }
+    if (merged.pass_all() || zone_map.pass_all()) {
+        merged.set_min("");
+        merged.set_max("");
+        merged.set_pass_all(true);
+    } else if (zone_map.has_not_null()) {
+        if (!merged.has_not_null()) {
+            merged.set_min(zone_map.min());
+            merged.set_max(zone_map.max());
+        } else {
+            auto type = static_cast<FieldType>(column->meta->type());
+            std::unique_ptr<WrapperField> merged_value(
+                    WrapperField::create_by_type(type, column->meta->length()));
+            std::unique_ptr<WrapperField> value(
+                    WrapperField::create_by_type(type, column->meta->length()));
+            if (merged_value == nullptr || value == nullptr) {
+                return Status::NotSupported("can not merge zone maps of column {}",
+                                            column->tablet_column->name());
+            }
+            RETURN_IF_ERROR(merged_value->from_string(merged.min()));
+            RETURN_IF_ERROR(value->from_string(zone_map.min()));
+            if (value->cmp(merged_value.get()) < 0) {
+                merged.set_min(zone_map.min());
+            }
+            RETURN_IF_ERROR(merged_value->from_string(merged.max()));
+            RETURN_IF_ERROR(value->from_string(zone_map.max()));
+            if (value->cmp(merged_value.get()) > 0) {
+                merged.set_max(zone_map.max());
+            }
+        }
+    }
+    merged.set_has_null(merged.has_null() || zone_map.has_null());
+    merged.set_has_not_null(merged.has_not_null() || zone_map.has_not_null());
+    return Status::OK();
+}
+
+Status SegmentStitcher::_reencode(StitchedColumn* column, const SegmentSharedPtr& segment) {
+    StorageReadOptions read_options;
+    read_options.io_ctx = _io_ctx;
+    std::unique_ptr<ColumnIterator> iter;
+    RETURN_IF_ERROR(segment->new_column_iterator(*column->tablet_column, &iter, &read_options));
+    ColumnIteratorOptions iter_options {
+            .use_page_cache = false,
+            .file_reader = segment->file_reader().get(),
+            .stats = &_stats,
+            .io_ctx = _io_ctx,
+    };
+    RETURN_IF_ERROR(iter->init(iter_options));
+    RETURN_IF_ERROR(iter->seek_to_first());
+
+    size_t remaining = segment->num_rows();
+    while (remaining > 0) {
+        size_t num_rows = std::min(remaining, REENCODE_BATCH_ROWS);
+        auto data = column->data_type->create_column();
+        bool has_null = false;
+        RETURN_IF_ERROR(iter->next_batch(&num_rows, data, &has_null));
+        if (num_rows == 0) {
+            return Status::Corruption("{} rows of column {} are missing in segment {}", remaining,
+                                      column->tablet_column->name(),
+                                      segment->file_reader()->path().native());
+        }
+        vectorized::Block block;
+        block.insert({std::move(data), column->data_type, column->tablet_column->name()});
+        column->convertor->set_source_content(&block, 0, num_rows);
+        auto [status, accessor] = column->convertor->convert_column_data(0);
+        RETURN_IF_ERROR(status);
+        RETURN_IF_ERROR(
+                column->writer->append(accessor->get_nullmap(), accessor->get_data(), num_rows));
+        column->convertor->clear_source_content();
+        remaining -= num_rows;
+    }
+    return Status::OK();
+}
+
+// Only the key columns of the rows that start a block of the short key index are read.
+Status SegmentStitcher::_add_short_keys(const SegmentSharedPtr& segment) {
+    const uint32_t num_rows_per_block = SegmentWriterOptions().num_rows_per_block;
+    std::vector<rowid_t> rowids;
+    for (; _short_key_row_pos < _num_rows + segment->num_rows();
+         _short_key_row_pos += num_rows_per_block) {
+        rowids.push_back(_short_key_row_pos - _num_rows);
+    }
+    if (rowids.empty() || _key_coders.empty()) {
+        return Status::OK();
+    }
+
+    vectorized::Block block;
+    vectorized::OlapBlockDataConvertor convertor;
+    for (size_t cid = 0; cid < _key_coders.size(); ++cid) {
+        const auto& tablet_column = _tablet_schema->column(cid);
+        StorageReadOptions read_options;
+        read_options.io_ctx = _io_ctx;
+        std::unique_ptr<ColumnIterator> iter;
+        RETURN_IF_ERROR(segment->new_column_iterator(tablet_column, &iter, &read_options));
+        ColumnIteratorOptions iter_options {
+                .use_page_cache = false,
+                .file_reader = segment->file_reader().get(),
+                .stats = &_stats,
+                .io_ctx = _io_ctx,
+        };
+        RETURN_IF_ERROR(iter->init(iter_options));
+        auto data_type = vectorized::DataTypeFactory::instance().create_data_type(tablet_column);
+        auto data = data_type->create_column();
+        RETURN_IF_ERROR(iter->read_by_rowids(rowids.data(), rowids.size(), data));
+        block.insert({std::move(data), data_type, tablet_column.name()});
+        convertor.add_column_data_convertor(tablet_column);
+    }
+
+    convertor.set_source_content(&block, 0, rowids.size());
+    std::vector<vectorized::IOlapColumnDataAccessor*> key_columns;
+    for (size_t cid = 0; cid < _key_coders.size(); ++cid) {
+        auto [status, accessor] = convertor.convert_column_data(cid);
+        RETURN_IF_ERROR(status);
+        key_columns.push_back(accessor);
+    }
+    // the same encoding as SegmentWriter::_encode_keys()
+    for (size_t pos = 0; pos < rowids.size(); ++pos) {
+        std::string encoded_keys;
+        for (size_t cid = 0; cid < key_columns.size(); ++cid) {
+            const auto* field = key_columns[cid]->get_data_at(pos);
+            if (UNLIKELY(!field)) {
+                encoded_keys.push_back(KEY_NULL_FIRST_MARKER);
+                continue;
+            }
+            encoded_keys.push_back(KEY_NORMAL_MARKER);
+            _key_coders[cid]->encode_ascending(field, _key_index_size[cid], &encoded_keys);
+        }
+        RETURN_IF_ERROR(_short_key_index_builder->add_item(encoded_keys));
+    }
+    convertor.clear_source_content();
+    return Status::OK();
+}
+
+Status SegmentStitcher::finalize(uint64_t* segment_file_size, uint64_t* index_size) {
+    if (_num_rows == 0) {
+        return Status::InternalError("no rows to stitch into segment {}", _segment_id);
+    }
+    for (auto& column : _columns) {
+        if (column->writer != nullptr) {
+            RETURN_IF_ERROR(column->writer->finish());
+            RETURN_IF_ERROR(column->writer->write_data());
+        }
+    }
+
+    uint64_t index_start = _file_writer->bytes_appended();
+    for (auto& column : _columns) {
+        RETURN_IF_ERROR(_write_indexes(column.get()));
+    }
+    std::vector<Slice> body;
+    PageFooterPB footer;
+    RETURN_IF_ERROR(_short_key_index_builder->finalize(_num_rows, &body, &footer));
+    PagePointer pp;
+    RETURN_IF_ERROR(PageIO::write_page(_file_writer, body, footer, &pp));
+    pp.to_proto(_footer.mutable_short_key_index_page());
+    *index_size = _file_writer->bytes_appended() - index_start;
+
+    RETURN_IF_ERROR(_write_footer());
+    RETURN_IF_ERROR(_file_writer->finalize());
+    *segment_file_size = _file_writer->bytes_appended();
+    return Status::OK();
+}
+
+Status SegmentStitcher::_write_indexes(StitchedColumn* column) {
+    if (column->writer != nullptr) {
+        RETURN_IF_ERROR(column->writer->write_ordinal_index());
+        RETURN_IF_ERROR(column->writer->write_zone_map());
+        return column->writer->write_bloom_filter_index();
+    }
+
+    column->meta->set_num_rows(_num_rows);
+    RETURN_IF_ERROR(column->ordinal_index->finish(_file_writer, column->meta->add_indexes()));
+    if (column->has_zone_map) {
+        auto* index_meta = column->meta->add_indexes();
+        index_meta->set_type(ZONE_MAP_INDEX);
+        auto* meta = index_meta->mutable_zone_map_index();
+        *meta->mutable_segment_zone_map() = column->segment_zone_map;
+        // the same options as TypedZoneMapIndexWriter::finish()
+        const auto* type_info = get_scalar_type_info<FieldType::OLAP_FIELD_TYPE_OBJECT>();
+        IndexedColumnWriterOptions options;
+        options.write_ordinal_index = true;
+        options.write_value_index = false;
+        options.encoding = EncodingInfo::get_default_encoding(type_info, false);
+        options.compression = NO_COMPRESSION;
+        RETURN_IF_ERROR(write_indexed_values(_file_writer, type_info, options,
+                                             column->page_zone_maps,
+                                             meta->mutable_page_zone_maps()));
+    }
+    if (column->has_bloom_filter) {
+        auto* index_meta = column->meta->add_indexes();
+        index_meta->set_type(BLOOM_FILTER_INDEX);
+        auto* meta = index_meta->mutable_bloom_filter_index();
+        meta->set_hash_strategy(column->bloom_filter_hash_strategy);
+        meta->set_algorithm(column->bloom_filter_algorithm);
+        const auto* type_info = get_scalar_type_info<FieldType::OLAP_FIELD_TYPE_VARCHAR>();
+        IndexedColumnWriterOptions options;
+        options.write_ordinal_index = true;
+        options.write_value_index = false;
+        options.encoding = PLAIN_ENCODING;
+        RETURN_IF_ERROR(write_indexed_values(_file_writer, type_info, options,
+                                             column->bloom_filters, meta->mutable_bloom_filter()));
+    }
+    return Status::OK();
+}
+
+Status SegmentStitcher::_write_footer() {
+    _footer.set_num_rows(_num_rows);
+
+    // Footer := SegmentFooterPB, FooterPBSize(4), FooterPBChecksum(4), MagicNumber(4)
+    std::string footer_buf;
+    if (!_footer.SerializeToString(&footer_buf)) {
+        return Status::InternalError("failed to serialize segment footer");
+    }
+    faststring fixed_buf;
+    put_fixed32_le(&fixed_buf, footer_buf.size());
+    put_fixed32_le(&fixed_buf, crc32c::Value(footer_buf.data(), footer_buf.size()));
+    fixed_buf.append(k_segment_magic, k_segment_magic_length);
+
+    std::vector<Slice> slices {footer_buf, fixed_buf};
+    return _file_writer->appendv(slices.data(), slices.size());
+}
+
+} // namespace doris::segment_v2
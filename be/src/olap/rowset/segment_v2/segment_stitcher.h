@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <gen_cpp/segment_v2.pb.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "io/fs/file_reader_writer_fwd.h"
+#include "io/io_common.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/tablet_schema.h"
+#include "vec/data_types/data_type.h"
+
+namespace doris {
+
+class KeyCoder;
+class ShortKeyIndexBuilder;
+
+namespace vectorized {
+class OlapBlockDataConvertor;
+} // namespace vectorized
+
+namespace segment_v2 {
+
+class ColumnWriter;
+class OrdinalIndexWriter;
+
+// Writes one segment made of the rows of several segments, one after another, without decoding
+// them. The encoded data pages of the input segments are copied with their first ordinal moved,
+// only the ordinal index, zone map, bloom filter, short key index and footer are written again.
+//
+// The rows of an input segment must all sort after the rows of the segments added before it,
+// which is the case for the segments of non-overlapping rowsets in version order.
+//
+// Dictionary encoded pages refer to the dictionary of their own segment, so these columns are
+// decoded and encoded again. Segments with columns whose indexes can not be stitched, such as
+// inverted indexes or nested columns, are rejected with NOT_IMPLEMENTED_ERROR and should be
+// merged as usual.
+class SegmentStitcher {
+public:
+    SegmentStitcher(TabletSchemaSPtr tablet_schema, io::FileWriter* file_writer,
+                    uint32_t segment_id);
+    ~SegmentStitcher();
+
+    // Whether the segments of the schema can be stitched at all.
+    static Status check_schema(const TabletSchema& tablet_schema);
+
+    Status add_segment(const SegmentSharedPtr& segment);
+
+    Status finalize(uint64_t* segment_file_size, uint64_t* index_size);
+
+    uint32_t num_rows() const { return _num_rows; }
+
+private:
+    struct StitchedColumn;
+
+    Status _init_columns(const SegmentFooterPB& footer);
+    Status _copy_pages(StitchedColumn* column, const ColumnMetaPB& meta,
+                       const SegmentSharedPtr& segment);
+    Status _merge_zone_map(StitchedColumn* column, const ZoneMapPB& zone_map);
+    Status _reencode(StitchedColumn* column, const SegmentSharedPtr& segment);
+    Status _add_short_keys(const SegmentSharedPtr& segment);
+    Status _write_indexes(StitchedColumn* column);
+    Status _write_footer();
+
+    TabletSchemaSPtr _tablet_schema;
+    io::FileWriter* _file_writer;
+    uint32_t _segment_id;
+
+    SegmentFooterPB _footer;
+    std::vector<std::unique_ptr<StitchedColumn>> _columns;
+    uint32_t _num_rows = 0;
+
+    std::unique_ptr<ShortKeyIndexBuilder> _short_key_index_builder;
+    std::vector<const KeyCoder*> _key_coders;
+    std::vector<uint16_t> _key_index_size;
+    // the ordinal of the next row of the short key index
+    uint32_t _short_key_row_pos = 0;
+
+    io::IOContext _io_ctx;
+    OlapReaderStatistics _stats;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -40,6 +40,7 @@
 #include "gutil/ref_counted.h"
 #include "olap/calc_delete_bitmap_executor.h"
 #include "olap/compaction_permit_limiter.h"
+#include "olap/compaction_scheduler.h"
 #include "olap/olap_common.h"
 #include "olap/options.h"
 #include "olap/rowset/pending_rowset_helper.h"
@@ -255,6 +256,8 @@ public:
 
     Status get_compaction_status_json(std::string* result);
 
+    CompactionScheduler& compaction_scheduler() { return _compaction_scheduler; }
+
     const std::shared_ptr<MemTracker>& segcompaction_mem_tracker() {
         return _segcompaction_mem_tracker;
     }
@@ -349,6 +352,11 @@ private:
     std::vector<TabletSharedPtr> _generate_compaction_tasks(CompactionType compaction_type,
                                                             std::vector<DataDir*>& data_dirs,
                                                             bool check_score);
+    // Picks the candidates of all data dirs in the order of CompactionScheduler, as long as
+    // their disk has a free slot and the permits of the compaction are available.
+    std::vector<TabletSharedPtr> _pick_compaction_tasks_by_read_amplification(
+            CompactionType compaction_type, std::vector<CompactionCandidate>& candidates,
+            std::map<DataDir*, int>& free_slots);
     void _update_cumulative_compaction_policy();
 
     bool _push_tablet_into_submitted_compaction(TabletSharedPtr tablet,
@@ -457,6 +465,7 @@ private:
     std::unique_ptr<ThreadPool> _bg_multi_get_thread_pool;
 
     CompactionPermitLimiter _permit_limiter;
+    CompactionScheduler _compaction_scheduler;
 
     std::mutex _tablet_submitted_compaction_mutex;
     // a tablet can do base and cumulative compaction at same time
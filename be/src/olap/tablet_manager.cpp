@@ -729,13 +729,58 @@ TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
         const std::unordered_set<TTabletId>& tablet_submitted_compaction, uint32_t* score,
         const std::unordered_map<std::string_view, std::shared_ptr<CumulativeCompactionPolicy>>&
                 all_cumulative_compaction_policies) {
-    int64_t now_ms = UnixMillis();
     const string& compaction_type_str =
             compaction_type == CompactionType::BASE_COMPACTION ? "base" : "cumulative";
     uint32_t highest_score = 0;
     uint32_t compaction_score = 0;
     TabletSharedPtr best_tablet;
-    auto handler = [&](const TabletSharedPtr& tablet_ptr) {
+    auto handler = [&](const TabletSharedPtr& tablet_ptr, uint32_t current_compaction_score) {
+        if (current_compaction_score > highest_score) {
+            highest_score = current_compaction_score;
+            compaction_score = current_compaction_score;
+            best_tablet = tablet_ptr;
+        }
+    };
+
+    _for_each_tablet_to_compaction(compaction_type, data_dir, tablet_submitted_compaction,
+                                   all_cumulative_compaction_policies, handler);
+    if (best_tablet != nullptr) {
+        VLOG_CRITICAL << "Found the best tablet for compaction. "
+                      << "compaction_type=" << compaction_type_str
+                      << ", tablet_id=" << best_tablet->tablet_id() << ", path=" << data_dir->path()
+                      << ", compaction_score=" << compaction_score
+                      << ", highest_score=" << highest_score;
+        *score = compaction_score;
+    }
+    return best_tablet;
+}
+
+std::vector<std::pair<TabletSharedPtr, uint32_t>> TabletManager::find_tablets_to_compaction(
+        CompactionType compaction_type, DataDir* data_dir,
+        const std::unordered_set<TTabletId>& tablet_submitted_compaction,
+        const std::unordered_map<std::string_view, std::shared_ptr<CumulativeCompactionPolicy>>&
+                all_cumulative_compaction_policies) {
+    std::vector<std::pair<TabletSharedPtr, uint32_t>> tablets;
+    _for_each_tablet_to_compaction(compaction_type, data_dir, tablet_submitted_compaction,
+                                   all_cumulative_compaction_policies,
+                                   [&](const TabletSharedPtr& tablet_ptr, uint32_t score) {
+                                       if (score > 0) {
+                                           tablets.emplace_back(tablet_ptr, score);
+                                       }
+                                   });
+    return tablets;
+}
+
+void TabletManager::_for_each_tablet_to_compaction(
+        CompactionType compaction_type, DataDir* data_dir,
+        const std::unordered_set<TTabletId>& tablet_submitted_compaction,
+        const std::unordered_map<std::string_view, std::shared_ptr<CumulativeCompactionPolicy>>&
+                all_cumulative_compaction_policies,
+        const std::function<void(const TabletSharedPtr&, uint32_t)>& handler) {
+    int64_t now_ms = UnixMillis();
+    const string& compaction_type_str =
+            compaction_type == CompactionType::BASE_COMPACTION ? "base" : "cumulative";
+    auto score_handler = [&](const TabletSharedPtr& tablet_ptr) {
         if (config::enable_skip_tablet_compaction &&
             tablet_ptr->should_skip_compaction(compaction_type, UnixSeconds())) {
             return;
@@ -783,23 +828,10 @@ TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
         if (current_compaction_score < 5) {
             tablet_ptr->set_skip_compaction(true, compaction_type, UnixSeconds());
         }
-        if (current_compaction_score > highest_score) {
-            highest_score = current_compaction_score;
-            compaction_score = current_compaction_score;
-            best_tablet = tablet_ptr;
-        }
+        handler(tablet_ptr, current_compaction_score);
     };
 
-    for_each_tablet(handler, filter_all_tablets);
-    if (best_tablet != nullptr) {
-        VLOG_CRITICAL << "Found the best tablet for compaction. "
-                      << "compaction_type=" << compaction_type_str
-                      << ", tablet_id=" << best_tablet->tablet_id() << ", path=" << data_dir->path()
-                      << ", compaction_score=" << compaction_score
-                      << ", highest_score=" << highest_score;
-        *score = compaction_score;
-    }
-    return best_tablet;
+    for_each_tablet(score_handler, filter_all_tablets);
 }
 
 Status TabletManager::load_tablet_from_meta(DataDir* data_dir, TTabletId tablet_id,
@@ -79,6 +79,13 @@ public:
             const std::unordered_map<std::string_view, std::shared_ptr<CumulativeCompactionPolicy>>&
                     all_cumulative_compaction_policies);
 
+    // All the tablets of the data dir which can do compaction now, with their compaction score.
+    std::vector<std::pair<TabletSharedPtr, uint32_t>> find_tablets_to_compaction(
+            CompactionType compaction_type, DataDir* data_dir,
+            const std::unordered_set<TTabletId>& tablet_submitted_compaction,
+            const std::unordered_map<std::string_view, std::shared_ptr<CumulativeCompactionPolicy>>&
+                    all_cumulative_compaction_policies);
+
     TabletSharedPtr get_tablet(TTabletId tablet_id, bool include_deleted = false,
                                std::string* err = nullptr);
 
@@ -209,6 +216,13 @@ private:
 
     bool _move_tablet_to_trash(const TabletSharedPtr& tablet);
 
+    void _for_each_tablet_to_compaction(
+            CompactionType compaction_type, DataDir* data_dir,
+            const std::unordered_set<TTabletId>& tablet_submitted_compaction,
+            const std::unordered_map<std::string_view, std::shared_ptr<CumulativeCompactionPolicy>>&
+                    all_cumulative_compaction_policies,
+            const std::function<void(const TabletSharedPtr&, uint32_t)>& handler);
+
 private:
     DISALLOW_COPY_AND_ASSIGN(TabletManager);
 
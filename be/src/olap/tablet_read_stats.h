@@ -0,0 +1,103 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <gen_cpp/Types_types.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <mutex>
+
+#include "common/config.h"
+#include "olap/olap_common.h"
+#include "util/time.h"
+
+namespace doris {
+
+// How often a tablet is queried and how much each query pays for the segments it has to read
+// and merge. The counters decay with a half life of config::tablet_read_stats_half_life_sec,
+// so that they follow the recent query load of the tablet. The scanners of a query on the
+// tablet all record their statistics, but the query is counted once.
+class TabletReadStats {
+public:
+    struct Snapshot {
+        // decayed number of queries
+        double queries = 0;
+        // segments read by a query on average
+        double segments_per_query = 0;
+        // time of a query fetching blocks from the rowset readers on average
+        double read_ns_per_query = 0;
+    };
+
+    void record(const TUniqueId& query_id, const OlapReaderStatistics& stats) {
+        record(query_id, stats, UnixMillis());
+    }
+
+    void record(const TUniqueId& query_id, const OlapReaderStatistics& stats, int64_t now_ms) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        double factor = _decay_factor(now_ms);
+        auto recent_end = _recent_queries.begin() + _num_recent_queries;
+        bool new_query = std::find(_recent_queries.begin(), recent_end, query_id) == recent_end;
+        if (new_query) {
+            _recent_queries[_num_recorded_queries % _recent_queries.size()] = query_id;
+            _num_recorded_queries++;
+            _num_recent_queries = std::min(_num_recorded_queries, _recent_queries.size());
+        }
+        _queries = _queries * factor + (new_query ? 1 : 0);
+        _segments = _segments * factor +
+                    (stats.total_segment_number - stats.filtered_segment_number);
+        _read_ns = _read_ns * factor + stats.block_fetch_ns;
+        _last_update_ms = now_ms;
+    }
+
+    Snapshot get() const { return get(UnixMillis()); }
+
+    Snapshot get(int64_t now_ms) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Snapshot snapshot;
+        if (_queries > 0) {
+            snapshot.queries = _queries * _decay_factor(now_ms);
+            snapshot.segments_per_query = _segments / _queries;
+            snapshot.read_ns_per_query = _read_ns / _queries;
+        }
+        return snapshot;
+    }
+
+private:
+    double _decay_factor(int64_t now_ms) const {
+        int64_t half_life_ms = config::tablet_read_stats_half_life_sec * 1000L;
+        if (_last_update_ms == 0 || half_life_ms <= 0 || now_ms <= _last_update_ms) {
+            return 1;
+        }
+        return std::exp2(-static_cast<double>(now_ms - _last_update_ms) / half_life_ms);
+    }
+
+    mutable std::mutex _mutex;
+    double _queries = 0;
+    double _segments = 0;
+    double _read_ns = 0;
+    int64_t _last_update_ms = 0;
+    // the queries recorded lately, whose other scanners are not counted as new queries
+    std::array<TUniqueId, 16> _recent_queries;
+    size_t _num_recent_queries = 0;
+    size_t _num_recorded_queries = 0;
+};
+
+} // namespace doris
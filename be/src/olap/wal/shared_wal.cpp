@@ -0,0 +1,596 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/wal/shared_wal.h"
+
+#include <bvar/bvar.h>
+#include <errno.h> // IWYU pragma: keep
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <glog/logging.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "common/config.h"
+#include "gutil/macros.h"
+#include "io/fs/err_utils.h"
+#include "io/fs/local_file_system.h"
+#include "io/fs/path.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/defer_op.h"
+
+namespace doris {
+
+bvar::Adder<int64_t> g_shared_wal_sync_num("group_commit_shared_wal_sync_num");
+bvar::Adder<int64_t> g_shared_wal_synced_bytes("group_commit_shared_wal_synced_bytes");
+bvar::Adder<int64_t> g_shared_wal_segment_num("group_commit_shared_wal_segment_num");
+
+const std::string SharedWal::SHARED_WAL_DIR = "shared";
+
+namespace {
+
+Status sync_fd(int fd, const std::string& path) {
+#ifdef __APPLE__
+    if (fcntl(fd, F_FULLFSYNC) < 0) {
+        return io::localfs_error(errno, fmt::format("failed to sync {}", path));
+    }
+#else
+    if (0 != ::fdatasync(fd)) {
+        return io::localfs_error(errno, fmt::format("failed to sync {}", path));
+    }
+#endif
+    return Status::OK();
+}
+
+Status sync_dir(const std::string& dir) {
+    int fd;
+    RETRY_ON_EINTR(fd, ::open(dir.c_str(), O_DIRECTORY | O_RDONLY));
+    if (-1 == fd) {
+        return io::localfs_error(errno, fmt::format("failed to open {}", dir));
+    }
+    Defer defer {[fd] { ::close(fd); }};
+    return sync_fd(fd, dir);
+}
+
+Status pread_fully(int fd, const std::string& path, uint64_t offset, char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t res;
+        RETRY_ON_EINTR(res, ::pread(fd, buf, len, offset));
+        if (res < 0) {
+            return io::localfs_error(errno, fmt::format("failed to read {}", path));
+        }
+        if (res == 0) {
+            return Status::EndOfFile("unexpected end of {} at {}", path, offset);
+        }
+        buf += res;
+        offset += res;
+        len -= res;
+    }
+    return Status::OK();
+}
+
+Status pwrite_fully(int fd, const std::string& path, uint64_t offset, const char* buf,
+                    size_t len) {
+    while (len > 0) {
+        ssize_t res;
+        RETRY_ON_EINTR(res, ::pwrite(fd, buf, len, offset));
+        if (res < 0) {
+            return io::localfs_error(errno, fmt::format("failed to write {}", path));
+        }
+        buf += res;
+        offset += res;
+        len -= res;
+    }
+    return Status::OK();
+}
+
+uint32_t record_checksum(const uint8_t* header, std::string_view payload) {
+    // skips the length and the crc itself
+    uint32_t crc = crc32c::Value(reinterpret_cast<const char*>(header) + 8,
+                                 SharedWal::RECORD_HEADER_SIZE - 8);
+    return crc32c::Extend(crc, payload.data(), payload.size());
+}
+
+std::string segment_file_name(uint64_t segment_id) {
+    return fmt::format("{:020}.seg", segment_id);
+}
+
+// the preallocated file of the next segment, renamed to it when the log switches to it
+const std::string SPARE_SEGMENT_FILE_NAME = "spare.seg.tmp";
+
+} // namespace
+
+SharedWal::SegmentFile::~SegmentFile() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+SharedWal::SharedWal(std::string wal_dir)
+        : _wal_dir(std::move(wal_dir)), _log_dir(_wal_dir + "/" + SHARED_WAL_DIR) {}
+
+SharedWal::~SharedWal() {
+    stop();
+}
+
+std::string SharedWal::encode_header(uint32_t version, const std::string& wal_path,
+                                     const std::string& col_ids) {
+    std::string payload;
+    put_fixed32_le(&payload, version);
+    put_fixed32_le(&payload, wal_path.size());
+    payload.append(wal_path);
+    payload.append(col_ids);
+    return payload;
+}
+
+Status SharedWal::decode_header(const std::string& payload, uint32_t* version,
+                                std::string* wal_path, std::string* col_ids) {
+    if (payload.size() < 8) {
+        return Status::Corruption("bad shared wal header, size={}", payload.size());
+    }
+    *version = decode_fixed32_le(reinterpret_cast<const uint8_t*>(payload.data()));
+    uint32_t path_length = decode_fixed32_le(reinterpret_cast<const uint8_t*>(payload.data()) + 4);
+    if (payload.size() < 8 + path_length) {
+        return Status::Corruption("bad shared wal header, size={}, path length={}", payload.size(),
+                                  path_length);
+    }
+    *wal_path = payload.substr(8, path_length);
+    *col_ids = payload.substr(8 + path_length);
+    return Status::OK();
+}
+
+Status SharedWal::init(std::vector<RecoveredWal>* recovered_wals) {
+    bool exists = false;
+    RETURN_IF_ERROR(io::global_local_filesystem()->exists(_log_dir, &exists));
+    if (!exists) {
+        RETURN_IF_ERROR(io::global_local_filesystem()->create_directory(_log_dir));
+    }
+    std::vector<io::FileInfo> files;
+    RETURN_IF_ERROR(io::global_local_filesystem()->list(_log_dir, true, &files, &exists));
+    std::map<uint64_t, std::string> segment_paths;
+    for (const auto& file : files) {
+        if (file.file_name == SPARE_SEGMENT_FILE_NAME) {
+            RETURN_IF_ERROR(io::global_local_filesystem()->delete_file(_log_dir + "/" +
+                                                                       file.file_name));
+            continue;
+        }
+        char* end = nullptr;
+        uint64_t segment_id = std::strtoull(file.file_name.c_str(), &end, 10);
+        if (end == file.file_name.c_str() || std::string_view(end) != ".seg") {
+            LOG(WARNING) << "unknown file in shared wal dir " << _log_dir << ": " << file.file_name;
+            continue;
+        }
+        segment_paths.emplace(segment_id, _log_dir + "/" + file.file_name);
+    }
+
+    std::set<int64_t> released_wal_ids;
+    {
+        std::lock_guard l(_lock);
+        for (const auto& [segment_id, path] : segment_paths) {
+            RETURN_IF_ERROR(_recover_segment(segment_id, path, &released_wal_ids));
+            _current_segment_id = segment_id + 1;
+        }
+        for (int64_t wal_id : released_wal_ids) {
+            _wals.erase(wal_id);
+            for (auto& [_, segment] : _segments) {
+                segment.wal_ids.erase(wal_id);
+            }
+        }
+        for (const auto& [wal_id, wal] : _wals) {
+            recovered_wals->push_back({wal.table_id, wal_id, _wal_dir + "/" + wal.wal_path});
+        }
+        std::shared_ptr<SegmentFile> file;
+        RETURN_IF_ERROR(_create_segment_file(
+                _log_dir + "/" + segment_file_name(_current_segment_id), &file));
+        RETURN_IF_ERROR(sync_dir(_log_dir));
+        _segments[_current_segment_id].file = std::move(file);
+        g_shared_wal_segment_num << 1;
+        _truncate();
+    }
+    LOG(INFO) << "open shared wal " << _log_dir << ", recovered segments=" << segment_paths.size()
+              << ", recovered wals=" << _wals.size();
+    return Thread::create(
+            "WalMgr", "shared_wal_sync", [this]() { _sync_thread(); }, &_sync_thread_handle);
+}
+
+Status SharedWal::_recover_segment(uint64_t segment_id, const std::string& path,
+                                   std::set<int64_t>* released_wal_ids) {
+    int fd;
+    RETRY_ON_EINTR(fd, ::open(path.c_str(), O_RDWR));
+    if (-1 == fd) {
+        return io::localfs_error(errno, fmt::format("failed to open {}", path));
+    }
+    auto file = std::make_shared<SegmentFile>(path, fd);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        return io::localfs_error(errno, fmt::format("failed to stat {}", path));
+    }
+    auto file_size = static_cast<uint64_t>(st.st_size);
+
+    Segment& segment = _segments[segment_id];
+    segment.file = file;
+    uint64_t offset = 0;
+    uint8_t header[RECORD_HEADER_SIZE];
+    std::string payload;
+    while (offset + RECORD_HEADER_SIZE <= file_size) {
+        RETURN_IF_ERROR(pread_fully(fd, path, offset, reinterpret_cast<char*>(header),
+                                    RECORD_HEADER_SIZE));
+        uint32_t length = decode_fixed32_le(header);
+        uint32_t checksum = decode_fixed32_le(header + 4);
+        if (length == 0 && checksum == 0) {
+            // the preallocated space after the last record
+            break;
+        }
+        if (offset + RECORD_HEADER_SIZE + length > file_size) {
+            LOG(WARNING) << "truncated record in shared wal " << path << " at " << offset;
+            break;
+        }
+        payload.resize(length);
+        RETURN_IF_ERROR(pread_fully(fd, path, offset + RECORD_HEADER_SIZE, payload.data(), length));
+        if (record_checksum(header, payload) != checksum) {
+            LOG(WARNING) << "checksum mismatch in shared wal " << path << " at " << offset;
+            break;
+        }
+        auto table_id = static_cast<int64_t>(decode_fixed64_le(header + 8));
+        auto wal_id = static_cast<int64_t>(decode_fixed64_le(header + 16));
+        auto type = static_cast<RecordType>(header[24]);
+        RecordLocation location {segment_id, offset, length};
+        if (type == HEADER) {
+            uint32_t version = 0;
+            std::string wal_path;
+            std::string col_ids;
+            RETURN_IF_ERROR(decode_header(payload, &version, &wal_path, &col_ids));
+            _wals[wal_id] = {table_id, std::move(wal_path), {location}};
+            segment.wal_ids.insert(wal_id);
+        } else if (type == BLOCK) {
+            auto it = _wals.find(wal_id);
+            if (it != _wals.end()) {
+                it->second.records.push_back(location);
+                segment.wal_ids.insert(wal_id);
+            }
+        } else if (type == RELEASE) {
+            released_wal_ids->insert(wal_id);
+        }
+        offset += RECORD_HEADER_SIZE + length;
+    }
+    segment.size = offset;
+    return Status::OK();
+}
+
+// Allocating the blocks up front lets the syncs of the segment only flush the data.
+Status SharedWal::_create_segment_file(const std::string& path,
+                                       std::shared_ptr<SegmentFile>* file) {
+    int fd;
+    RETRY_ON_EINTR(fd, ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+    if (-1 == fd) {
+        return io::localfs_error(errno, fmt::format("failed to create {}", path));
+    }
+    *file = std::make_shared<SegmentFile>(path, fd);
+#ifndef __APPLE__
+    int res = ::posix_fallocate(fd, 0, config::group_commit_shared_wal_segment_bytes);
+    if (res != 0) {
+        LOG(WARNING) << "failed to preallocate " << path << ": " << std::strerror(res);
+    }
+#endif
+    return sync_fd(fd, path);
+}
+
+// Called with the lock held, so the preallocated spare file is renamed to the new segment, and
+// only without one the segment is created here, not preallocated. The log dir is synced by the
+// next sync, before the records in the new segment.
+Status SharedWal::_rotate_segment() {
+    uint64_t segment_id = _current_segment_id + 1;
+    std::string path = _log_dir + "/" + segment_file_name(segment_id);
+    std::shared_ptr<SegmentFile> file;
+    if (_spare_file != nullptr) {
+        if (::rename(_spare_file->path.c_str(), path.c_str()) == 0) {
+            file = std::move(_spare_file);
+            file->path = path;
+        } else {
+            LOG(WARNING) << "failed to rename " << _spare_file->path << " to " << path << ": "
+                         << std::strerror(errno);
+        }
+        _spare_file.reset();
+        _sync_cv.notify_one();
+    }
+    if (file == nullptr) {
+        int fd;
+        RETRY_ON_EINTR(fd, ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+        if (-1 == fd) {
+            return io::localfs_error(errno, fmt::format("failed to create {}", path));
+        }
+        file = std::make_shared<SegmentFile>(path, fd);
+    }
+    _current_segment_id = segment_id;
+    _segments[segment_id].file = std::move(file);
+    _log_dir_unsynced = true;
+    g_shared_wal_segment_num << 1;
+    return Status::OK();
+}
+
+Status SharedWal::_write_record(const uint8_t* header, std::string_view payload,
+                                uint64_t* offset) {
+    size_t record_size = RECORD_HEADER_SIZE + payload.size();
+    auto* segment = &_segments[_current_segment_id];
+    if (segment->size > 0 &&
+        segment->size + record_size > config::group_commit_shared_wal_segment_bytes) {
+        RETURN_IF_ERROR(_rotate_segment());
+        segment = &_segments[_current_segment_id];
+    }
+    const auto& file = segment->file;
+    RETURN_IF_ERROR(pwrite_fully(file->fd, file->path, segment->size,
+                                 reinterpret_cast<const char*>(header), RECORD_HEADER_SIZE));
+    RETURN_IF_ERROR(pwrite_fully(file->fd, file->path, segment->size + RECORD_HEADER_SIZE,
+                                 payload.data(), payload.size()));
+    *offset = segment->size;
+    segment->size += record_size;
+    _unsynced_files.emplace(_current_segment_id, file);
+    _appended_lsn += record_size;
+    return Status::OK();
+}
+
+Status SharedWal::append(int64_t table_id, int64_t wal_id, RecordType type,
+                         std::string_view payload, uint64_t* lsn) {
+    uint8_t header[RECORD_HEADER_SIZE];
+    encode_fixed32_le(header, payload.size());
+    encode_fixed64_le(header + 8, table_id);
+    encode_fixed64_le(header + 16, wal_id);
+    header[24] = type;
+    encode_fixed32_le(header + 4, record_checksum(header, payload));
+
+    std::lock_guard l(_lock);
+    RETURN_IF_ERROR(_sync_status);
+    if (_stopped) {
+        return Status::InternalError("shared wal {} is stopped", _log_dir);
+    }
+    if (auto it = _failed_wals.find(wal_id); it != _failed_wals.end()) {
+        return it->second;
+    }
+    if (type == HEADER) {
+        uint32_t version = 0;
+        std::string wal_path;
+        std::string col_ids;
+        RETURN_IF_ERROR(decode_header(std::string(payload), &version, &wal_path, &col_ids));
+        if (!_wals.emplace(wal_id, WalRecords {table_id, std::move(wal_path), {}}).second) {
+            return Status::InternalError("wal {} is already in shared wal {}", wal_id, _log_dir);
+        }
+    } else if (type == BLOCK && !_wals.contains(wal_id)) {
+        return Status::InternalError("wal {} has no header in shared wal {}", wal_id, _log_dir);
+    }
+
+    uint64_t offset = 0;
+    RETURN_IF_ERROR(_write_record(header, payload, &offset));
+    if (type != RELEASE) {
+        _wals[wal_id].records.push_back(
+                {_current_segment_id, offset, static_cast<uint32_t>(payload.size())});
+        _segments[_current_segment_id].wal_ids.insert(wal_id);
+    }
+    _unsynced_wal_ids.insert(wal_id);
+    *lsn = _appended_lsn;
+    return Status::OK();
+}
+
+Status SharedWal::sync(int64_t wal_id, uint64_t lsn) {
+    std::unique_lock l(_lock);
+    if (_synced_lsn < lsn) {
+        _sync_requested_lsn = std::max(_sync_requested_lsn, lsn);
+        _sync_cv.notify_one();
+        _synced_cv.wait(l, [&] { return _synced_lsn >= lsn || !_sync_status.ok() || _stopped; });
+        if (_synced_lsn < lsn && _sync_status.ok()) {
+            return Status::InternalError("shared wal {} is stopped", _log_dir);
+        }
+    }
+    RETURN_IF_ERROR(_sync_status);
+    auto it = _failed_wals.find(wal_id);
+    return it == _failed_wals.end() ? Status::OK() : it->second;
+}
+
+// The writers waiting while a sync is running are all made durable by the next one. When there
+// is nothing to sync, the next segment is preallocated, out of the lock of the appends.
+void SharedWal::_sync_thread() {
+    std::unique_lock l(_lock);
+    while (true) {
+        _sync_cv.wait(l, [&] {
+            return _stopped || _sync_requested_lsn > _synced_lsn || _spare_file == nullptr;
+        });
+        if (_stopped) {
+            break;
+        }
+        if (_sync_requested_lsn <= _synced_lsn) {
+            l.unlock();
+            std::shared_ptr<SegmentFile> spare;
+            Status st = _create_segment_file(_log_dir + "/" + SPARE_SEGMENT_FILE_NAME, &spare);
+            l.lock();
+            if (st.ok()) {
+                _spare_file = std::move(spare);
+            } else {
+                LOG(WARNING) << "failed to preallocate shared wal segment in " << _log_dir
+                             << ", st=" << st;
+                _sync_cv.wait_for(l, std::chrono::seconds(1), [&] {
+                    return _stopped || _sync_requested_lsn > _synced_lsn;
+                });
+            }
+            continue;
+        }
+        uint64_t target_lsn = _appended_lsn;
+        auto files = std::move(_unsynced_files);
+        _unsynced_files.clear();
+        auto wal_ids = std::move(_unsynced_wal_ids);
+        _unsynced_wal_ids.clear();
+        bool sync_log_dir = _log_dir_unsynced;
+        _log_dir_unsynced = false;
+        l.unlock();
+        Status st;
+        if (sync_log_dir) {
+            st = sync_dir(_log_dir);
+        }
+        for (const auto& [_, file] : files) {
+            if (!st.ok()) {
+                break;
+            }
+            st = sync_fd(file->fd, file->path);
+        }
+        l.lock();
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to sync shared wal " << _log_dir << ", st=" << st;
+            // The pages of a failed sync may be dropped, a retry would not write them again. So
+            // the wals with records in the sync fail, and the others go on in a new segment.
+            for (int64_t wal_id : wal_ids) {
+                if (_wals.contains(wal_id)) {
+                    _failed_wals.emplace(wal_id, st);
+                }
+            }
+            _log_dir_unsynced |= sync_log_dir;
+            if (files.contains(_current_segment_id)) {
+                Status rotate_st = _rotate_segment();
+                if (!rotate_st.ok()) {
+                    LOG(WARNING) << "failed to switch shared wal " << _log_dir
+                                 << " to a new segment, st=" << rotate_st;
+                    _sync_status = rotate_st;
+                }
+            }
+        } else {
+            g_shared_wal_sync_num << 1;
+            g_shared_wal_synced_bytes << (target_lsn - _synced_lsn);
+        }
+        _synced_lsn = target_lsn;
+        _synced_cv.notify_all();
+        if (!_sync_status.ok()) {
+            break;
+        }
+    }
+}
+
+void SharedWal::release(int64_t wal_id) {
+    std::lock_guard l(_lock);
+    auto it = _wals.find(wal_id);
+    if (it == _wals.end()) {
+        return;
+    }
+    auto table_id = it->second.table_id;
+    for (const auto& location : it->second.records) {
+        auto segment_it = _segments.find(location.segment_id);
+        if (segment_it != _segments.end()) {
+            segment_it->second.wal_ids.erase(wal_id);
+        }
+    }
+    _wals.erase(it);
+    _failed_wals.erase(wal_id);
+    // The release is synced in the background, nobody waits for it: a wal whose release is lost
+    // is replayed again and its label is already used.
+    uint8_t header[RECORD_HEADER_SIZE];
+    encode_fixed32_le(header, 0);
+    encode_fixed64_le(header + 8, table_id);
+    encode_fixed64_le(header + 16, wal_id);
+    header[24] = RELEASE;
+    encode_fixed32_le(header + 4, record_checksum(header, {}));
+    uint64_t offset = 0;
+    if (_sync_status.ok() && !_stopped && _write_record(header, {}, &offset).ok()) {
+        _sync_requested_lsn = std::max(_sync_requested_lsn, _appended_lsn);
+        _sync_cv.notify_one();
+    }
+    _truncate();
+}
+
+// The release records of the wals are in the segments after their data, so the segments are
+// only deleted from the head of the log.
+void SharedWal::_truncate() {
+    while (!_segments.empty()) {
+        auto it = _segments.begin();
+        if (it->first == _current_segment_id || !it->second.wal_ids.empty()) {
+            break;
+        }
+        auto st = io::global_local_filesystem()->delete_file(it->second.file->path);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to delete shared wal segment " << it->second.file->path
+                         << ", st=" << st;
+            break;
+        }
+        _unsynced_files.erase(it->first);
+        _segments.erase(it);
+        g_shared_wal_segment_num << -1;
+    }
+}
+
+Status SharedWal::get_records(int64_t wal_id, std::vector<RecordLocation>* records) {
+    std::lock_guard l(_lock);
+    auto it = _wals.find(wal_id);
+    if (it == _wals.end()) {
+        return Status::NotFound("wal {} is not in shared wal {}", wal_id, _log_dir);
+    }
+    *records = it->second.records;
+    return Status::OK();
+}
+
+Status SharedWal::read_record(const RecordLocation& location, std::string* payload) {
+    std::shared_ptr<SegmentFile> file;
+    {
+        std::lock_guard l(_lock);
+        auto it = _segments.find(location.segment_id);
+        if (it == _segments.end()) {
+            return Status::NotFound("segment {} is not in shared wal {}", location.segment_id,
+                                    _log_dir);
+        }
+        file = it->second.file;
+    }
+    uint8_t header[RECORD_HEADER_SIZE];
+    RETURN_IF_ERROR(pread_fully(file->fd, file->path, location.offset,
+                                reinterpret_cast<char*>(header), RECORD_HEADER_SIZE));
+    payload->resize(location.length);
+    RETURN_IF_ERROR(pread_fully(file->fd, file->path, location.offset + RECORD_HEADER_SIZE,
+                                payload->data(), location.length));
+    uint32_t checksum = decode_fixed32_le(header + 4);
+    if (decode_fixed32_le(header) != location.length ||
+        record_checksum(header, *payload) != checksum) {
+        return Status::Corruption("checksum failed for record at {} of {}", location.offset,
+                                  file->path);
+    }
+    return Status::OK();
+}
+
+void SharedWal::stop() {
+    {
+        std::lock_guard l(_lock);
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+    }
+    _sync_cv.notify_all();
+    _synced_cv.notify_all();
+    if (_sync_thread_handle) {
+        _sync_thread_handle->join();
+    }
+    // the records appended since the last sync, e.g. the releases
+    std::lock_guard l(_lock);
+    if (_log_dir_unsynced) {
+        WARN_IF_ERROR(sync_dir(_log_dir), "failed to sync shared wal dir on stop");
+    }
+    for (const auto& [_, file] : _unsynced_files) {
+        WARN_IF_ERROR(sync_fd(file->fd, file->path), "failed to sync shared wal on stop");
+    }
+    _unsynced_files.clear();
+}
+
+} // namespace doris
@@ -0,0 +1,164 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/status.h"
+#include "gutil/ref_counted.h"
+#include "util/thread.h"
+
+namespace doris {
+
+// The log of the group commit wals of one wal dir, shared by all the loads instead of a file per
+// wal. The log is made of preallocated segment files, in which every record is framed with its
+// length and crc and tagged with the table and the wal it belongs to:
+//
+//   | payload length (4) | crc32c (4) | table id (8) | wal id (8) | type (1) | payload |
+//
+// The crc covers everything after it. On recovery a segment ends at the first record with a bad
+// crc, which is the torn tail of the last write before a crash or the preallocated zeros.
+//
+// One thread fsyncs the log for all the writers waiting for their records to be durable, and
+// preallocates the next segment while there is nothing to sync. Segments are deleted from the
+// head of the log, once the wals with records in them are released.
+class SharedWal {
+public:
+    enum RecordType : uint8_t {
+        // version, wal path relative to the wal dir and column ids of the wal
+        HEADER = 1,
+        // a serialized PBlock
+        BLOCK = 2,
+        // the wal is published or moved out of the log, it is not recovered
+        RELEASE = 3,
+    };
+
+    struct RecordLocation {
+        uint64_t segment_id;
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    struct RecoveredWal {
+        int64_t table_id;
+        int64_t wal_id;
+        // the path of the wal as if it was a file, it identifies the wal for replay
+        std::string wal_path;
+    };
+
+    static constexpr size_t RECORD_HEADER_SIZE = 25;
+    static const std::string SHARED_WAL_DIR;
+
+    explicit SharedWal(std::string wal_dir);
+    ~SharedWal();
+
+    // Reads the segments of the log, the wals that were not released are returned and their
+    // records can be read by get_records(), then starts the sync thread.
+    Status init(std::vector<RecoveredWal>* recovered_wals);
+    void stop();
+
+    // `lsn` is the position of the record in the log, to wait for by sync().
+    Status append(int64_t table_id, int64_t wal_id, RecordType type, std::string_view payload,
+                  uint64_t* lsn);
+    // Waits until all the records appended up to `lsn` are durable. Fails if a sync of a record
+    // of the wal failed, its data may be lost.
+    Status sync(int64_t wal_id, uint64_t lsn);
+    // The wal is not needed anymore, the segments before the first one with records of a wal
+    // that is not released are deleted.
+    void release(int64_t wal_id);
+
+    // The records of the wal in the order they were appended, the header first.
+    Status get_records(int64_t wal_id, std::vector<RecordLocation>* records);
+    Status read_record(const RecordLocation& location, std::string* payload);
+
+    const std::string& wal_dir() const { return _wal_dir; }
+
+    static std::string encode_header(uint32_t version, const std::string& wal_path,
+                                     const std::string& col_ids);
+    static Status decode_header(const std::string& payload, uint32_t* version,
+                                std::string* wal_path, std::string* col_ids);
+
+private:
+    // Closes the fd when the last reader, writer or sync of the segment is done with it.
+    struct SegmentFile {
+        SegmentFile(std::string path_, int fd_) : path(std::move(path_)), fd(fd_) {}
+        ~SegmentFile();
+        std::string path;
+        int fd;
+    };
+
+    struct Segment {
+        std::shared_ptr<SegmentFile> file;
+        uint64_t size = 0;
+        // the wals with records in the segment that are not released
+        std::set<int64_t> wal_ids;
+    };
+
+    struct WalRecords {
+        int64_t table_id;
+        std::string wal_path;
+        std::vector<RecordLocation> records;
+    };
+
+    Status _recover_segment(uint64_t segment_id, const std::string& path,
+                            std::set<int64_t>* released_wal_ids);
+    static Status _create_segment_file(const std::string& path,
+                                       std::shared_ptr<SegmentFile>* file);
+    Status _rotate_segment();
+    Status _write_record(const uint8_t* header, std::string_view payload, uint64_t* offset);
+    void _truncate();
+    void _sync_thread();
+
+    const std::string _wal_dir;
+    const std::string _log_dir;
+
+    std::mutex _lock;
+    std::map<uint64_t, Segment> _segments;
+    uint64_t _current_segment_id = 0;
+    std::unordered_map<int64_t, WalRecords> _wals;
+
+    // the segments and the wals written since the last sync
+    std::map<uint64_t, std::shared_ptr<SegmentFile>> _unsynced_files;
+    std::set<int64_t> _unsynced_wal_ids;
+    // a segment was created since the last sync
+    bool _log_dir_unsynced = false;
+    // the preallocated file of the next segment
+    std::shared_ptr<SegmentFile> _spare_file;
+    uint64_t _appended_lsn = 0;
+    uint64_t _sync_requested_lsn = 0;
+    uint64_t _synced_lsn = 0;
+    // the wals with records in a failed sync, the appends and syncs of them fail
+    std::unordered_map<int64_t, Status> _failed_wals;
+    // the log failed to switch to a new segment after a failed sync, all the appends fail
+    Status _sync_status;
+    bool _stopped = false;
+    std::condition_variable _sync_cv;
+    std::condition_variable _synced_cv;
+    scoped_refptr<Thread> _sync_thread_handle;
+};
+
+} // namespace doris
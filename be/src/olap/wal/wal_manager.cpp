@@ -71,6 +71,9 @@ void WalManager::stop() {
             _update_wal_dirs_info_thread->join();
         }
         _thread_pool->shutdown();
+        for (auto& [_, shared_wal] : _shared_wals) {
+            shared_wal->stop();
+        }
         LOG(INFO) << "WalManager is stopped";
     }
 }
@@ -78,6 +81,7 @@ void WalManager::stop() {
 Status WalManager::init() {
     RETURN_IF_ERROR(_init_wal_dirs_conf());
     RETURN_IF_ERROR(_init_wal_dirs());
+    RETURN_IF_ERROR(_init_shared_wals());
     RETURN_IF_ERROR(_init_wal_dirs_info());
     return Thread::create(
             "WalMgr", "replay_wal", [this]() { static_cast<void>(this->_replay_background()); },
@@ -123,6 +127,29 @@ Status WalManager::_init_wal_dirs() {
     return Status::OK();
 }
 
+Status WalManager::_init_shared_wals() {
+    for (const auto& wal_dir : _wal_dirs) {
+        // opened when the shared log is disabled too, to replay the wals left in it
+        bool exists = false;
+        RETURN_IF_ERROR(io::global_local_filesystem()->exists(
+                wal_dir + "/" + SharedWal::SHARED_WAL_DIR, &exists));
+        if (!config::group_commit_enable_shared_wal && !exists) {
+            continue;
+        }
+        auto shared_wal = std::make_shared<SharedWal>(wal_dir);
+        size_t recovered_begin = _recovered_shared_wals.size();
+        RETURN_IF_ERROR(shared_wal->init(&_recovered_shared_wals));
+        {
+            std::lock_guard<std::shared_mutex> wrlock(_wal_path_lock);
+            for (size_t i = recovered_begin; i < _recovered_shared_wals.size(); ++i) {
+                _shared_wal_map.emplace(_recovered_shared_wals[i].wal_id, shared_wal);
+            }
+        }
+        _shared_wals.emplace(wal_dir, std::move(shared_wal));
+    }
+    return Status::OK();
+}
+
 Status WalManager::_init_wal_dirs_info() {
     for (const std::string& wal_dir : _wal_dirs) {
         size_t available_bytes;
@@ -218,10 +245,22 @@ Status WalManager::create_wal_path(int64_t db_id, int64_t table_id, int64_t wal_
             return Status::InternalError("wal_id {} already in wal_path_map", wal_id);
         }
         _wal_path_map.emplace(wal_id, ss.str());
+        if (config::group_commit_enable_shared_wal) {
+            auto shared_it = _shared_wals.find(base_path);
+            if (shared_it != _shared_wals.end()) {
+                _shared_wal_map.emplace(wal_id, shared_it->second);
+            }
+        }
     }
     return Status::OK();
 }
 
+std::shared_ptr<SharedWal> WalManager::get_shared_wal(int64_t wal_id) {
+    std::shared_lock rdlock(_wal_path_lock);
+    auto it = _shared_wal_map.find(wal_id);
+    return it == _shared_wal_map.end() ? nullptr : it->second;
+}
+
 Status WalManager::get_wal_path(int64_t wal_id, std::string& wal_path) {
     std::shared_lock rdlock(_wal_path_lock);
     auto it = _wal_path_map.find(wal_id);
@@ -262,11 +301,24 @@ Status WalManager::_load_wals() {
     for (auto wal_dir : _wal_dirs) {
         WARN_IF_ERROR(_scan_wals(wal_dir, wals), fmt::format("fail to scan wal dir={}", wal_dir));
     }
+    for (const auto& recovered_wal : _recovered_shared_wals) {
+        // the path of a wal is wal_dir/db_id/table_id/file_name
+        io::Path db_path = io::Path(recovered_wal.wal_path).parent_path().parent_path();
+        struct ScanWalInfo scan_wal_info;
+        scan_wal_info.wal_path = recovered_wal.wal_path;
+        scan_wal_info.db_id = std::strtoll(db_path.filename().c_str(), NULL, 10);
+        scan_wal_info.tb_id = recovered_wal.table_id;
+        scan_wal_info.wal_id = recovered_wal.wal_id;
+        scan_wal_info.be_id = -1;
+        wals.emplace_back(scan_wal_info);
+    }
+    LOG(INFO) << "recovered " << _recovered_shared_wals.size() << " wals from shared wals";
+    _recovered_shared_wals.clear();
     for (const auto& wal : wals) {
         bool exists = false;
         WARN_IF_ERROR(io::global_local_filesystem()->exists(wal.wal_path, &exists),
                       fmt::format("fail to check exist on wal file={}", wal.wal_path));
-        if (!exists) {
+        if (!exists && get_shared_wal(wal.wal_id) == nullptr) {
             continue;
         }
         LOG(INFO) << "find wal: " << wal.wal_path;
@@ -305,7 +357,8 @@ Status WalManager::_scan_wals(const std::string& wal_path, std::vector<ScanWalIn
         return st;
     }
     for (const auto& database_id : dbs) {
-        if (database_id.is_file || database_id.file_name == _tmp) {
+        if (database_id.is_file || database_id.file_name == _tmp ||
+            database_id.file_name == SharedWal::SHARED_WAL_DIR) {
             continue;
         }
         std::vector<io::FileInfo> tables;
@@ -560,7 +613,14 @@ Status WalManager::delete_wal(int64_t table_id, int64_t wal_id) {
     {
         std::lock_guard<std::shared_mutex> wrlock(_wal_path_lock);
         auto it = _wal_path_map.find(wal_id);
-        if (it != _wal_path_map.end()) {
+        auto shared_it = _shared_wal_map.find(wal_id);
+        if (it != _wal_path_map.end() && shared_it != _shared_wal_map.end()) {
+            wal_path = it->second;
+            shared_it->second->release(wal_id);
+            LOG(INFO) << "release wal=" << wal_path << " in shared wal";
+            _shared_wal_map.erase(shared_it);
+            _wal_path_map.erase(wal_id);
+        } else if (it != _wal_path_map.end()) {
             wal_path = it->second;
             auto st = io::global_local_filesystem()->delete_file(wal_path);
             if (st.ok()) {
@@ -594,14 +654,22 @@ Status WalManager::rename_to_tmp_path(const std::string wal, int64_t table_id, i
     if (!exists) {
         RETURN_IF_ERROR(io::global_local_filesystem()->create_directory(wal_path.parent_path()));
     }
-    auto res = std::rename(wal.c_str(), wal_path.string().c_str());
-    if (res < 0) {
-        LOG(INFO) << "failed to rename wal from " << wal << " to " << wal_path.string();
-        return Status::InternalError("rename fail on path " + wal);
+    auto shared_wal = get_shared_wal(wal_id);
+    if (shared_wal != nullptr) {
+        // the wal is kept as a file in tmp, out of the shared log
+        RETURN_IF_ERROR(_dump_shared_wal(*shared_wal, wal_id, wal_path.string()));
+        shared_wal->release(wal_id);
+    } else {
+        auto res = std::rename(wal.c_str(), wal_path.string().c_str());
+        if (res < 0) {
+            LOG(INFO) << "failed to rename wal from " << wal << " to " << wal_path.string();
+            return Status::InternalError("rename fail on path " + wal);
+        }
     }
     LOG(INFO) << "rename wal from " << wal << " to " << wal_path.string();
     {
         std::lock_guard<std::shared_mutex> wrlock(_wal_path_lock);
+        _shared_wal_map.erase(wal_id);
         auto it = _wal_path_map.find(wal_id);
         if (it != _wal_path_map.end()) {
             _wal_path_map.erase(wal_id);
@@ -613,4 +681,31 @@ Status WalManager::rename_to_tmp_path(const std::string wal, int64_t table_id, i
     return Status::OK();
 }
 
+Status WalManager::_dump_shared_wal(SharedWal& shared_wal, int64_t wal_id,
+                                    const std::string& path) {
+    std::vector<SharedWal::RecordLocation> records;
+    RETURN_IF_ERROR(shared_wal.get_records(wal_id, &records));
+    if (records.empty()) {
+        return Status::InternalError("wal {} has no header in shared wal", wal_id);
+    }
+    std::string payload;
+    uint32_t version = 0;
+    std::string wal_path;
+    std::string col_ids;
+    RETURN_IF_ERROR(shared_wal.read_record(records[0], &payload));
+    RETURN_IF_ERROR(SharedWal::decode_header(payload, &version, &wal_path, &col_ids));
+    WalWriter wal_writer(path);
+    RETURN_IF_ERROR(wal_writer.init());
+    RETURN_IF_ERROR(wal_writer.append_header(version, col_ids));
+    for (size_t i = 1; i < records.size(); ++i) {
+        PBlock block;
+        RETURN_IF_ERROR(shared_wal.read_record(records[i], &payload));
+        if (!block.ParseFromString(payload)) {
+            return Status::InternalError("failed to deserialize block of wal {}", wal_id);
+        }
+        RETURN_IF_ERROR(wal_writer.append_blocks({&block}));
+    }
+    return wal_writer.finalize();
+}
+
 } // namespace doris
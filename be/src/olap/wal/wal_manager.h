@@ -34,6 +34,7 @@
 #include "gen_cpp/FrontendService_types.h"
 #include "gen_cpp/HeartbeatService_types.h"
 #include "gutil/ref_counted.h"
+#include "olap/wal/shared_wal.h"
 #include "olap/wal/wal_dirs_info.h"
 #include "olap/wal/wal_reader.h"
 #include "olap/wal/wal_table.h"
@@ -75,6 +76,8 @@ public:
     Status create_wal_path(int64_t db_id, int64_t table_id, int64_t wal_id,
                            const std::string& label, std::string& base_path);
     Status get_wal_path(int64_t wal_id, std::string& wal_path);
+    // The shared log the wal is appended to, nullptr if the wal is a file.
+    std::shared_ptr<SharedWal> get_shared_wal(int64_t wal_id);
     Status delete_wal(int64_t table_id, int64_t wal_id);
     Status rename_to_tmp_path(const std::string wal, int64_t table_id, int64_t wal_id);
     Status add_recover_wal(int64_t db_id, int64_t table_id, int64_t wal_id, std::string wal);
@@ -107,6 +110,8 @@ private:
     Status _init_wal_dirs();
     Status _init_wal_dirs_info();
     Status _update_wal_dir_info_thread();
+    Status _init_shared_wals();
+    Status _dump_shared_wal(SharedWal& shared_wal, int64_t wal_id, const std::string& path);
 
     // scan all wal files under storage path
     Status _scan_wals(const std::string& wal_path, std::vector<ScanWalInfo>& res);
@@ -140,6 +145,12 @@ private:
 
     std::shared_mutex _wal_path_lock;
     std::unordered_map<int64_t, std::string> _wal_path_map;
+    // the wals in a shared log, protected by _wal_path_lock too
+    std::unordered_map<int64_t, std::shared_ptr<SharedWal>> _shared_wal_map;
+
+    // wal dir -> the shared log of the dir
+    std::unordered_map<std::string, std::shared_ptr<SharedWal>> _shared_wals;
+    std::vector<SharedWal::RecoveredWal> _recovered_shared_wals;
 
     std::shared_mutex _wal_queue_lock;
     std::unordered_map<int64_t, std::set<int64_t>> _wal_queues;
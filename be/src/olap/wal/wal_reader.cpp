@@ -17,10 +17,14 @@
 
 #include "olap/wal/wal_reader.h"
 
+#include <algorithm>
+
 #include "common/status.h"
 #include "io/fs/file_reader.h"
 #include "io/fs/local_file_system.h"
 #include "io/fs/path.h"
+#include "olap/wal/wal_manager.h"
+#include "runtime/exec_env.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
 #include "wal_writer.h"
@@ -42,6 +46,21 @@ Status WalReader::init() {
     bool exists = false;
     RETURN_IF_ERROR(io::global_local_filesystem()->exists(_file_name, &exists));
     if (!exists) {
+        int64_t version = -1;
+        int64_t backend_id = -1;
+        int64_t wal_id = -1;
+        std::string label;
+        auto* wal_mgr = ExecEnv::GetInstance()->wal_mgr();
+        if (wal_mgr != nullptr &&
+            WalManager::parse_wal_path(io::Path(_file_name).filename().string(), version,
+                                       backend_id, wal_id, label)
+                    .ok()) {
+            _shared_wal = wal_mgr->get_shared_wal(wal_id);
+        }
+        if (_shared_wal != nullptr) {
+            // the records are read in order, _offset is the index of the next one
+            return _shared_wal->get_records(wal_id, &_records);
+        }
         LOG(WARNING) << "not exist wal= " << _file_name;
         return Status::NotFound("wal {} doesn't exist", _file_name);
     }
@@ -60,6 +79,16 @@ Status WalReader::finalize() {
 }
 
 Status WalReader::read_block(PBlock& block) {
+    if (_shared_wal != nullptr) {
+        // the first record is the header
+        _offset = std::max<size_t>(_offset, 1);
+        if (_offset >= _records.size()) {
+            return Status::EndOfFile("end of wal file");
+        }
+        std::string block_buf;
+        RETURN_IF_ERROR(_shared_wal->read_record(_records[_offset++], &block_buf));
+        return _deserialize(block, block_buf);
+    }
     if (_offset >= file_reader->size()) {
         return Status::EndOfFile("end of wal file");
     }
@@ -86,6 +115,17 @@ Status WalReader::read_block(PBlock& block) {
 }
 
 Status WalReader::read_header(std::string& col_ids) {
+    if (_shared_wal != nullptr) {
+        if (_records.empty()) {
+            return Status::DataQualityError("empty file");
+        }
+        std::string header;
+        std::string wal_path;
+        RETURN_IF_ERROR(_shared_wal->read_record(_records[0], &header));
+        RETURN_IF_ERROR(SharedWal::decode_header(header, &_version, &wal_path, &col_ids));
+        _offset = 1;
+        return Status::OK();
+    }
     if (file_reader->size() == 0) {
         return Status::DataQualityError("empty file");
     }
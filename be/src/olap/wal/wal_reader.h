@@ -17,9 +17,13 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "common/status.h"
 #include "gen_cpp/internal_service.pb.h"
 #include "io/fs/file_reader_writer_fwd.h"
+#include "olap/wal/shared_wal.h"
 
 namespace doris {
 
@@ -41,6 +45,10 @@ private:
     uint32_t _version = 0;
     size_t _offset;
     io::FileReaderSPtr file_reader;
+
+    // set when the wal is in the shared log of its wal dir
+    std::shared_ptr<SharedWal> _shared_wal;
+    std::vector<SharedWal::RecordLocation> _records;
 };
 
 } // namespace doris
\ No newline at end of file
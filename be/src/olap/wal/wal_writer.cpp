@@ -22,6 +22,7 @@
 #include "io/fs/local_file_system.h"
 #include "io/fs/path.h"
 #include "olap/storage_engine.h"
+#include "olap/wal/shared_wal.h"
 #include "olap/wal/wal_manager.h"
 #include "util/crc32c.h"
 
@@ -32,9 +33,20 @@ const uint32_t k_wal_magic_length = 4;
 
 WalWriter::WalWriter(const std::string& file_name) : _file_name(file_name) {}
 
+WalWriter::WalWriter(const std::string& file_name, std::shared_ptr<SharedWal> shared_wal,
+                     int64_t table_id, int64_t wal_id)
+        : _file_name(file_name),
+          _shared_wal(std::move(shared_wal)),
+          _table_id(table_id),
+          _wal_id(wal_id) {}
+
 WalWriter::~WalWriter() {}
 
 Status WalWriter::init() {
+    if (_shared_wal != nullptr) {
+        LOG(INFO) << "create wal " << _file_name << " in shared wal of " << _shared_wal->wal_dir();
+        return Status::OK();
+    }
     io::Path wal_path = _file_name;
     auto parent_path = wal_path.parent_path();
     bool exists = false;
@@ -48,6 +60,9 @@ Status WalWriter::init() {
 }
 
 Status WalWriter::finalize() {
+    if (_shared_wal != nullptr) {
+        return _shared_wal->sync(_wal_id, _lsn);
+    }
     if (!_file_writer) {
         return Status::InternalError("wal writer is null,fail to close file={}", _file_name);
     }
@@ -59,6 +74,14 @@ Status WalWriter::finalize() {
 }
 
 Status WalWriter::append_blocks(const PBlockArray& blocks) {
+    if (_shared_wal != nullptr) {
+        for (const auto& block : blocks) {
+            RETURN_IF_ERROR(_shared_wal->append(_table_id, _wal_id, SharedWal::BLOCK,
+                                                block->SerializeAsString(), &_lsn));
+        }
+        // the loads appending at the same time are made durable by the same sync
+        return _shared_wal->sync(_wal_id, _lsn);
+    }
     if (!_file_writer) {
         return Status::InternalError("wal writer is null,fail to write file={}", _file_name);
     }
@@ -91,6 +114,16 @@ Status WalWriter::append_blocks(const PBlockArray& blocks) {
 }
 
 Status WalWriter::append_header(uint32_t version, std::string col_ids) {
+    if (_shared_wal != nullptr) {
+        const auto& wal_dir = _shared_wal->wal_dir();
+        if (!_file_name.starts_with(wal_dir + "/")) {
+            return Status::InternalError("wal {} is not in wal dir {}", _file_name, wal_dir);
+        }
+        return _shared_wal->append(
+                _table_id, _wal_id, SharedWal::HEADER,
+                SharedWal::encode_header(version, _file_name.substr(wal_dir.size() + 1), col_ids),
+                &_lsn);
+    }
     if (!_file_writer) {
         return Status::InternalError("wal writer is null,fail to write file={}", _file_name);
     }
@@ -17,12 +17,16 @@
 
 #pragma once
 
+#include <memory>
+
 #include "common/status.h"
 #include "gen_cpp/internal_service.pb.h"
 #include "io/fs/file_reader_writer_fwd.h"
 
 namespace doris {
 
+class SharedWal;
+
 using PBlockArray = std::vector<PBlock*>;
 extern const char* k_wal_magic;
 extern const uint32_t k_wal_magic_length;
@@ -30,6 +34,9 @@ extern const uint32_t k_wal_magic_length;
 class WalWriter {
 public:
     explicit WalWriter(const std::string& file_name);
+    // Appends the wal to the shared log of its wal dir instead of a file.
+    WalWriter(const std::string& file_name, std::shared_ptr<SharedWal> shared_wal,
+              int64_t table_id, int64_t wal_id);
     ~WalWriter();
 
     Status init();
@@ -48,6 +55,11 @@ public:
 private:
     std::string _file_name;
     io::FileWriterPtr _file_writer;
+
+    std::shared_ptr<SharedWal> _shared_wal;
+    int64_t _table_id = -1;
+    int64_t _wal_id = -1;
+    uint64_t _lsn = 0;
 };
 
 } // namespace doris
\ No newline at end of file
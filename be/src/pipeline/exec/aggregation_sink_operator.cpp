@@ -210,6 +210,10 @@ size_t AggSinkLocalState::_memory_usage() const {
         usage += Base::_shared_state->aggregate_data_container->memory_usage();
     }
 
+    // The states freed outside of the scope of the counter are not subtracted, but they are
+    // all freed together with the hash table, which resets the counter.
+    usage += std::max<int64_t>(0, Base::_shared_state->mem_usage_record.used_in_state_heap);
+
     std::visit(
             [&](auto&& agg_method) -> void {
                 auto data = agg_method.hash_table;
@@ -738,6 +742,8 @@ Status AggSinkOperatorX::sink(doris::RuntimeState* state, vectorized::Block* in_
     COUNTER_UPDATE(local_state.rows_input_counter(), (int64_t)in_block->rows());
     local_state._shared_state->input_num_rows += in_block->rows();
     if (in_block->rows() > 0) {
+        vectorized::AggregateStateHeapCounter::Scope heap_counter_scope(
+                &local_state._shared_state->mem_usage_record.used_in_state_heap);
         RETURN_IF_ERROR(local_state._executor->execute(&local_state, in_block));
         local_state._executor->update_memusage(&local_state);
     }
@@ -38,16 +38,10 @@ Status FileScanLocalState::_init_scanners(std::list<vectorized::VScannerSPtr>* s
     }
 
     auto& p = _parent->cast<FileScanOperatorX>();
-    size_t shard_num = std::min<size_t>(
-            config::doris_scanner_thread_pool_thread_num / state()->query_parallel_instance_num(),
-            _scan_ranges.size());
-    shard_num = std::max(shard_num, (size_t)1);
-    _kv_cache.reset(new vectorized::ShardedKVCache(shard_num));
     for (auto& scan_range : _scan_ranges) {
         std::unique_ptr<vectorized::VFileScanner> scanner = vectorized::VFileScanner::create_unique(
                 state(), this, p._limit_per_scanner,
-                scan_range.scan_range.ext_scan_range.file_scan_range, _scanner_profile.get(),
-                _kv_cache.get());
+                scan_range.scan_range.ext_scan_range.file_scan_range, _scanner_profile.get());
         RETURN_IF_ERROR(
                 scanner->prepare(_conjuncts, &_colname_to_value_range, &_colname_to_slot_id));
         scanners->push_back(std::move(scanner));
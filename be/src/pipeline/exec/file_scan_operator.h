@@ -58,12 +58,6 @@ public:
 
 private:
     std::vector<TScanRangeParams> _scan_ranges;
-    // A in memory cache to save some common components
-    // of the this scan node. eg:
-    // 1. iceberg delete file
-    // 2. parquet file meta
-    // KVCache<std::string> _kv_cache;
-    std::unique_ptr<vectorized::ShardedKVCache> _kv_cache;
     TupleId _output_tuple_id = -1;
 };
 
@@ -407,6 +407,7 @@ protected:
     ScanOperatorX(ObjectPool* pool, const TPlanNode& tnode, int operator_id,
                   const DescriptorTbl& descs, int parallel_tasks = 0);
     virtual ~ScanOperatorX() = default;
+    bool _share_conjunct_subexprs() const override { return false; }
     template <typename Derived>
     friend class ScanLocalState;
     friend class OlapScanLocalState;
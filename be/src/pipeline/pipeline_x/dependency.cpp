@@ -226,6 +226,7 @@ Status AggSharedState::reset_hash_table() {
                                 align_aggregate_states));
                 agg_method.hash_table.reset(new HashTableType());
                 agg_arena_pool.reset(new vectorized::Arena);
+                mem_usage_record.used_in_state_heap = 0;
                 return Status::OK();
             },
             agg_data->method_variant);
@@ -368,9 +368,11 @@ public:
     std::vector<size_t> make_nullable_keys;
 
     struct MemoryRecord {
-        MemoryRecord() : used_in_arena(0), used_in_state(0) {}
+        MemoryRecord() : used_in_arena(0), used_in_state(0), used_in_state_heap(0) {}
         int64_t used_in_arena;
         int64_t used_in_state;
+        // Allocated by aggregate states outside of the arena, see AggregateStateHeapCounter.
+        int64_t used_in_state_heap;
     };
     MemoryRecord mem_usage_record;
     bool agg_data_created_without_key = false;
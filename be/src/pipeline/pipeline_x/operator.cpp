@@ -21,7 +21,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "pipeline/exec/aggregation_sink_operator.h"
 #include "pipeline/exec/aggregation_source_operator.h"
@@ -76,6 +78,7 @@
 #include "pipeline/pipeline_x/local_exchange/local_exchange_source_operator.h"
 #include "util/debug_util.h"
 #include "util/runtime_profile.h"
+#include "vec/exprs/vshared_expr.h"
 
 namespace doris::pipeline {
 
@@ -136,6 +139,14 @@ Status OperatorXBase::prepare(RuntimeState* state) {
 
     RETURN_IF_ERROR(vectorized::VExpr::prepare(_projections, state, intermediate_row_desc()));
 
+    if (config::enable_common_subexpr_elimination) {
+        std::vector<vectorized::VExprContextSPtrs*> ctxs_list {&_projections};
+        if (_share_conjunct_subexprs()) {
+            ctxs_list.push_back(&_conjuncts);
+        }
+        _num_shared_subexprs = vectorized::VSharedExpr::share_common_subexprs(ctxs_list);
+    }
+
     if (_child_x && !is_source()) {
         RETURN_IF_ERROR(_child_x->prepare(state));
     }
@@ -183,6 +194,7 @@ Status OperatorXBase::do_projections(RuntimeState* state, vectorized::Block* ori
     if (rows != 0) {
         auto& mutable_columns = mutable_block.mutable_columns();
         DCHECK(mutable_columns.size() == local_state->_projections.size());
+        SharedExprEvaluationScope evaluation_scope(origin_block);
         for (int i = 0; i < mutable_columns.size(); ++i) {
             auto result_column_id = -1;
             RETURN_IF_ERROR(local_state->_projections[i]->execute(origin_block, &result_column_id));
@@ -360,6 +372,10 @@ Status PipelineXLocalState<SharedStateArg>::init(RuntimeState* state, LocalState
     _open_timer = ADD_TIMER_WITH_LEVEL(_runtime_profile, "OpenTime", 1);
     _close_timer = ADD_TIMER_WITH_LEVEL(_runtime_profile, "CloseTime", 1);
     _exec_timer = ADD_TIMER_WITH_LEVEL(_runtime_profile, "ExecTime", 1);
+    if (_parent->_num_shared_subexprs > 0) {
+        _saved_subexpr_evaluations_counter = ADD_COUNTER_WITH_LEVEL(
+                _runtime_profile, "SavedSubexprEvaluations", TUnit::UNIT, 1);
+    }
     _mem_tracker = std::make_unique<MemTracker>("PipelineXLocalState:" + _runtime_profile->name());
     _memory_used_counter = ADD_LABEL_COUNTER_WITH_LEVEL(_runtime_profile, "MemoryUsage", 1);
     _peak_memory_usage_counter = _runtime_profile->AddHighWaterMarkCounter(
@@ -381,6 +397,17 @@ Status PipelineXLocalState<SharedStateArg>::close(RuntimeState* state) {
     if (_peak_memory_usage_counter) {
         _peak_memory_usage_counter->set(_mem_tracker->peak_consumption());
     }
+    if (_conjuncts.size() > 1 && config::enable_adaptive_conjunct_order) {
+        _runtime_profile->add_info_string(
+                "ConjunctsOrder", vectorized::VExprContext::conjuncts_stats_string(_conjuncts));
+    }
+    if (_saved_subexpr_evaluations_counter != nullptr) {
+        for (const auto* ctxs : {&_conjuncts, &_projections}) {
+            for (const auto& ctx : *ctxs) {
+                COUNTER_UPDATE(_saved_subexpr_evaluations_counter, ctx->saved_evaluations());
+            }
+        }
+    }
     _closed = true;
     return Status::OK();
 }
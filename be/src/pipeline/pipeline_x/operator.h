@@ -87,6 +87,9 @@ public:
     RuntimeProfile::Counter* rows_returned_counter() { return _rows_returned_counter; }
     RuntimeProfile::Counter* blocks_returned_counter() { return _blocks_returned_counter; }
     RuntimeProfile::Counter* exec_time_counter() { return _exec_timer; }
+    RuntimeProfile::Counter* saved_subexpr_evaluations_counter() {
+        return _saved_subexpr_evaluations_counter;
+    }
     OperatorXBase* parent() { return _parent; }
     RuntimeState* state() { return _state; }
     vectorized::VExprContextSPtrs& conjuncts() { return _conjuncts; }
@@ -130,6 +133,8 @@ protected:
     RuntimeProfile::Counter* _peak_memory_usage_counter = nullptr;
     RuntimeProfile::Counter* _open_timer = nullptr;
     RuntimeProfile::Counter* _close_timer = nullptr;
+    // Only added when the operator shares subexpressions.
+    RuntimeProfile::Counter* _saved_subexpr_evaluations_counter = nullptr;
 
     OperatorXBase* _parent = nullptr;
     RuntimeState* _state = nullptr;
@@ -301,6 +306,11 @@ public:
     int parallel_tasks() const { return _parallel_tasks; }
 
 protected:
+    // Whether the subexpressions shared with the projections may be replaced in the conjuncts,
+    // see `VSharedExpr`. Scans normalize their conjuncts into pushed down predicates by the
+    // shape of the expression trees.
+    virtual bool _share_conjunct_subexprs() const { return true; }
+
     template <typename Dependency>
     friend class PipelineXLocalState;
     friend class PipelineXLocalStateBase;
@@ -326,6 +336,8 @@ protected:
     std::string _op_name;
     bool _ignore_data_distribution = false;
     int _parallel_tasks = 0;
+    // The number of distinct subexpressions evaluated once for all their occurrences.
+    size_t _num_shared_subexprs = 0;
 };
 
 template <typename LocalStateType>
@@ -21,8 +21,10 @@
 #include <chrono> // IWYU pragma: keep
 #include <string>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "pipeline/pipeline_task.h"
+#include "util/numa_util.h"
 
 namespace doris {
 namespace pipeline {
@@ -139,6 +141,12 @@ MultiCoreTaskQueue::~MultiCoreTaskQueue() = default;
 
 MultiCoreTaskQueue::MultiCoreTaskQueue(size_t core_size) : TaskQueue(core_size), _closed(false) {
     _prio_task_queue_list.reset(new PriorityTaskQueue[core_size]);
+    if (config::enable_numa_aware_scheduling && NumaUtil::is_numa_machine()) {
+        _core_to_numa_node.resize(core_size);
+        for (size_t i = 0; i < core_size; ++i) {
+            _core_to_numa_node[i] = NumaUtil::worker_numa_node(i, core_size);
+        }
+    }
 }
 
 void MultiCoreTaskQueue::close() {
@@ -173,6 +181,15 @@ PipelineTask* MultiCoreTaskQueue::take(size_t core_id) {
 }
 
 PipelineTask* MultiCoreTaskQueue::_steal_take(size_t core_id) {
+    if (_core_to_numa_node.empty()) {
+        return _steal_take(core_id, false);
+    }
+    // Stealing from the same node keeps the task close to the memory it touched before.
+    auto* task = _steal_take(core_id, true);
+    return task != nullptr ? task : _steal_take(core_id, false);
+}
+
+PipelineTask* MultiCoreTaskQueue::_steal_take(size_t core_id, bool same_node) {
     DCHECK(core_id < _core_size);
     size_t next_id = core_id;
     for (size_t i = 1; i < _core_size; ++i) {
@@ -181,6 +198,10 @@ PipelineTask* MultiCoreTaskQueue::_steal_take(size_t core_id) {
             next_id = 0;
         }
         DCHECK(next_id < _core_size);
+        if (!_core_to_numa_node.empty() &&
+            (_core_to_numa_node[next_id] == _core_to_numa_node[core_id]) != same_node) {
+            continue;
+        }
         auto task = _prio_task_queue_list[next_id].try_take(true);
         if (task) {
             task->set_core_id(next_id);
@@ -27,6 +27,7 @@
 #include <ostream>
 #include <queue>
 #include <set>
+#include <vector>
 
 #include "common/status.h"
 #include "pipeline_task.h"
@@ -127,7 +128,9 @@ private:
     int _compute_level(uint64_t real_runtime);
 };
 
-// Need consider NUMA architecture
+// When config::enable_numa_aware_scheduling is true, the cores are split into one group per
+// NUMA node, see NumaUtil::worker_numa_node, and a core steals tasks from the cores of its own
+// node before the others.
 class MultiCoreTaskQueue : public TaskQueue {
 public:
     explicit MultiCoreTaskQueue(size_t core_size);
@@ -153,8 +156,11 @@ public:
 
 private:
     PipelineTask* _steal_take(size_t core_id);
+    PipelineTask* _steal_take(size_t core_id, bool same_node);
 
     std::unique_ptr<PriorityTaskQueue[]> _prio_task_queue_list;
+    // NUMA node of each core, empty if not NUMA aware.
+    std::vector<int> _core_to_numa_node;
     std::atomic<size_t> _next_core = 0;
     std::atomic<bool> _closed;
 };
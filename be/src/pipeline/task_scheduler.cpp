@@ -31,6 +31,7 @@
 #include <thread>
 #include <utility>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "pipeline/pipeline_task.h"
 #include "pipeline/pipeline_x/pipeline_x_task.h"
@@ -39,6 +40,7 @@
 #include "runtime/exec_env.h"
 #include "runtime/query_context.h"
 #include "util/debug_util.h"
+#include "util/numa_util.h"
 #include "util/sse_util.hpp"
 #include "util/thread.h"
 #include "util/threadpool.h"
@@ -249,6 +251,13 @@ void _close_task(PipelineTask* task, PipelineTaskState state, Status exec_status
 }
 
 void TaskScheduler::_do_work(size_t index) {
+    if (config::enable_numa_aware_scheduling) {
+        int node = NumaUtil::worker_numa_node(index, _task_queue->cores());
+        Status st = NumaUtil::bind_current_thread_to_node(node);
+        if (!st.ok()) {
+            LOG(WARNING) << "Task scheduler " << _name << " worker " << index << ": " << st;
+        }
+    }
     const auto& marker = _markers[index];
     while (*marker) {
         auto* task = _task_queue->take(index);
@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/add_block_packet_sequencer.h"
+
+#include <gen_cpp/internal_service.pb.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace doris {
+
+AddBlockPacketSequencer::AddBlockPacketSequencer() = default;
+
+AddBlockPacketSequencer::~AddBlockPacketSequencer() = default;
+
+void AddBlockPacketSequencer::init(int num_senders) {
+    std::lock_guard<std::mutex> l(_lock);
+    _senders.resize(num_senders);
+}
+
+Status AddBlockPacketSequencer::accept(const PTabletWriterAddBlockRequest& request,
+                                       bool* write_now) {
+    *write_now = false;
+    std::lock_guard<std::mutex> l(_lock);
+    if (request.sender_id() < 0 || request.sender_id() >= static_cast<int>(_senders.size())) {
+        return Status::InternalError("invalid sender id {}, num senders: {}", request.sender_id(),
+                                     _senders.size());
+    }
+    auto& sender = _senders[request.sender_id()];
+    RETURN_IF_ERROR(sender.status);
+    int64_t seq = request.packet_seq();
+    if (seq < sender.next_seq || sender.buffered.contains(seq)) {
+        LOG(INFO) << "packet has already recept before, expect_seq=" << sender.next_seq
+                  << ", recept_seq=" << seq;
+        return Status::OK();
+    }
+    if (seq == sender.next_seq && !sender.writing) {
+        sender.next_seq++;
+        sender.writing = true;
+        *write_now = true;
+        return Status::OK();
+    }
+    // The oldest packet the sender has not got the response of.
+    int64_t oldest_seq = sender.writing ? sender.next_seq - 1 : sender.next_seq;
+    int64_t window = std::max(request.max_packets_in_flight(), 1);
+    if (seq - oldest_seq >= window) {
+        LOG(WARNING) << "lost data packet, expect_seq=" << sender.next_seq
+                     << ", recept_seq=" << seq << ", max_packets_in_flight=" << window;
+        sender.status = Status::InternalError("lost data packet");
+        sender.buffered.clear();
+        return sender.status;
+    }
+    sender.buffered.emplace(seq, std::make_unique<PTabletWriterAddBlockRequest>(request));
+    return Status::OK();
+}
+
+void AddBlockPacketSequencer::finish(int sender_id, const Status& status,
+                                     std::unique_ptr<PTabletWriterAddBlockRequest>* next) {
+    next->reset();
+    std::lock_guard<std::mutex> l(_lock);
+    auto& sender = _senders[sender_id];
+    DCHECK(sender.writing);
+    if (!status.ok()) {
+        if (sender.status.ok()) {
+            sender.status = status;
+        }
+        sender.buffered.clear();
+        sender.writing = false;
+        return;
+    }
+    auto it = sender.buffered.begin();
+    if (it == sender.buffered.end() || it->first != sender.next_seq) {
+        sender.writing = false;
+        return;
+    }
+    *next = std::move(it->second);
+    sender.buffered.erase(it);
+    sender.next_seq++;
+}
+
+Status AddBlockPacketSequencer::close_sender(int sender_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto& sender = _senders[sender_id];
+    RETURN_IF_ERROR(sender.status);
+    if (!sender.buffered.empty()) {
+        LOG(WARNING) << "lost data packet, expect_seq=" << sender.next_seq
+                     << ", buffered_seq=" << sender.buffered.begin()->first;
+        sender.status = Status::InternalError("lost data packet");
+        sender.buffered.clear();
+        return sender.status;
+    }
+    return Status::OK();
+}
+
+size_t AddBlockPacketSequencer::num_buffered_packets(int sender_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    return _senders[sender_id].buffered.size();
+}
+
+} // namespace doris
@@ -0,0 +1,75 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/status.h"
+
+namespace doris {
+
+class PTabletWriterAddBlockRequest;
+
+// Orders the add_block packets of the senders of a tablets channel.
+//
+// A sender keeps up to `max_packets_in_flight` packets in flight, so they may arrive out of
+// order. A packet that arrives before the packets ahead of it is buffered and the rpc returns
+// at once, instead of holding an rpc thread. The rpc writing the packet ahead of it writes the
+// buffered packet next. A packet beyond the window of the sender means an earlier one is lost,
+// it fails at once, as does any packet after a packet of the sender failed to be written.
+class AddBlockPacketSequencer {
+public:
+    AddBlockPacketSequencer();
+    ~AddBlockPacketSequencer();
+
+    void init(int num_senders);
+
+    // Accepts a packet. Sets *write_now if the caller should write it now, and then call
+    // finish(). Otherwise the packet is a duplicate or is buffered.
+    Status accept(const PTabletWriterAddBlockRequest& request, bool* write_now);
+
+    // Called after writing a packet of the sender with the status of the write. Sets *next to
+    // the buffered packet to write next, or to nullptr if it has not arrived yet. A failed
+    // write fails the sender, its buffered packets are dropped.
+    void finish(int sender_id, const Status& status,
+                std::unique_ptr<PTabletWriterAddBlockRequest>* next);
+
+    // Called at the eos of the sender, returns an error if a packet of it failed or is lost.
+    Status close_sender(int sender_id);
+
+    size_t num_buffered_packets(int sender_id);
+
+private:
+    struct SenderState {
+        // the sequence of the next packet to write
+        int64_t next_seq = 0;
+        // whether a packet of the sender is being written, that is next_seq - 1
+        bool writing = false;
+        Status status;
+        std::map<int64_t, std::unique_ptr<PTabletWriterAddBlockRequest>> buffered;
+    };
+
+    std::mutex _lock;
+    std::vector<SenderState> _senders;
+};
+
+} // namespace doris
@@ -97,6 +97,7 @@
 #include "util/threadpool.h"
 #include "util/thrift_rpc_helper.h"
 #include "util/timezone_utils.h"
+#include "vec/exec/format/table/iceberg_delete_file_cache.h"
 #include "vec/exec/scan/scanner_scheduler.h"
 #include "vec/runtime/vdata_stream_mgr.h"
 #include "vec/sink/delta_writer_v2_pool.h"
@@ -190,6 +191,12 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths,
                               .set_max_threads(64)
                               .build(&_s3_file_upload_thread_pool));
 
+    static_cast<void>(ThreadPoolBuilder("FileCacheWriteThreadPool")
+                              .set_min_threads(config::file_cache_write_behind_thread_num)
+                              .set_max_threads(config::file_cache_write_behind_thread_num)
+                              .set_max_queue_size(config::file_cache_write_behind_queue_size)
+                              .build(&_file_cache_write_thread_pool));
+
     // min num equal to fragment pool's min num
     // max num is useless because it will start as many as requested in the past
     // queue size is useless because the max thread num is very large
@@ -496,6 +503,18 @@ Status ExecEnv::_init_mem_env() {
               << PrettyPrinter::print(inverted_index_cache_limit, TUnit::BYTES)
               << ", origin config value: " << config::inverted_index_query_cache_limit;
 
+    int64_t iceberg_delete_file_cache_limit =
+            ParseUtil::parse_mem_spec(config::iceberg_delete_file_cache_limit,
+                                      MemInfo::mem_limit(), MemInfo::physical_mem(), &is_percent);
+    while (!is_percent && iceberg_delete_file_cache_limit > MemInfo::mem_limit() / 2) {
+        iceberg_delete_file_cache_limit = iceberg_delete_file_cache_limit / 2;
+    }
+    _iceberg_delete_file_cache =
+            vectorized::IcebergDeleteFileCache::create_global_cache(iceberg_delete_file_cache_limit);
+    LOG(INFO) << "Iceberg delete file cache memory limit: "
+              << PrettyPrinter::print(iceberg_delete_file_cache_limit, TUnit::BYTES)
+              << ", origin config value: " << config::iceberg_delete_file_cache_limit;
+
     RETURN_IF_ERROR(_block_spill_mgr->init());
 
     return Status::OK();
@@ -573,6 +592,7 @@ void ExecEnv::destroy() {
     SAFE_STOP(_spill_stream_mgr);
     SAFE_SHUTDOWN(_buffered_reader_prefetch_thread_pool);
     SAFE_SHUTDOWN(_s3_file_upload_thread_pool);
+    SAFE_SHUTDOWN(_file_cache_write_thread_pool);
     SAFE_SHUTDOWN(_join_node_thread_pool);
     SAFE_SHUTDOWN(_lazy_release_obj_pool);
     SAFE_SHUTDOWN(_send_report_thread_pool);
@@ -590,6 +610,7 @@ void ExecEnv::destroy() {
     SAFE_DELETE(_spill_stream_mgr);
     SAFE_DELETE(_block_spill_mgr);
     SAFE_DELETE(_inverted_index_query_cache);
+    SAFE_DELETE(_iceberg_delete_file_cache);
     SAFE_DELETE(_inverted_index_searcher_cache);
     SAFE_DELETE(_lookup_connection_cache);
     SAFE_DELETE(_schema_cache);
@@ -630,6 +651,7 @@ void ExecEnv::destroy() {
     _send_table_stats_thread_pool.reset(nullptr);
     _buffered_reader_prefetch_thread_pool.reset(nullptr);
     _s3_file_upload_thread_pool.reset(nullptr);
+    _file_cache_write_thread_pool.reset(nullptr);
     _send_batch_thread_pool.reset(nullptr);
 
     SAFE_DELETE(_broker_client_cache);
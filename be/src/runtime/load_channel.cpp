@@ -20,13 +20,18 @@
 #include <gen_cpp/internal_service.pb.h>
 #include <glog/logging.h>
 
+#include <algorithm>
+
 #include "bvar/bvar.h"
 #include "cloud/cloud_tablets_channel.h"
 #include "cloud/config.h"
+#include "olap/memtable_flush_executor.h"
+#include "olap/memtable_writer.h"
 #include "olap/storage_engine.h"
 #include "runtime/exec_env.h"
 #include "runtime/memory/mem_tracker.h"
 #include "runtime/tablets_channel.h"
+#include "util/pretty_printer.h"
 
 namespace doris {
 
@@ -73,6 +78,16 @@ void LoadChannel::_init_profile() {
     _add_batch_timer = ADD_TIMER(_self_profile, "AddBatchTime");
     _handle_eos_timer = ADD_CHILD_TIMER(_self_profile, "HandleEosTime", "AddBatchTime");
     _add_batch_times = ADD_COUNTER(_self_profile, "AddBatchTimes", TUnit::UNIT);
+    if (config::enable_load_shared_write_buffer) {
+        _write_buffer_flush_times =
+                ADD_COUNTER(_self_profile, "WriteBufferFlushTimes", TUnit::UNIT);
+        _write_buffer_flushed_memtables =
+                ADD_COUNTER(_self_profile, "WriteBufferFlushedMemtables", TUnit::UNIT);
+        _write_buffer_batched_memtables =
+                ADD_COUNTER(_self_profile, "WriteBufferBatchedMemtables", TUnit::UNIT);
+        _write_buffer_flushed_bytes =
+                ADD_COUNTER(_self_profile, "WriteBufferFlushedBytes", TUnit::BYTES);
+    }
 }
 
 Status LoadChannel::open(const PTabletWriterOpenRequest& params) {
@@ -156,6 +171,15 @@ Status LoadChannel::add_batch(const PTabletWriterAddBlockRequest& request,
     if (request.has_block()) {
         RETURN_IF_ERROR(channel->add_batch(request, response));
         _add_batch_number_counter->update(1);
+        if (_write_buffer_flush_times != nullptr) {
+            const auto& block = request.block();
+            int64_t bytes = block.compressed() ? block.uncompressed_size()
+                                               : block.column_values().size();
+            if (_write_buffer_estimated_bytes.fetch_add(bytes) + bytes >
+                config::load_shared_write_buffer_bytes) {
+                _flush_write_buffer();
+            }
+        }
     }
 
     // 3. handle eos
@@ -194,6 +218,79 @@ Status LoadChannel::_handle_eos(BaseTabletsChannel* channel,
     return Status::OK();
 }
 
+void LoadChannel::_flush_write_buffer() {
+    std::unique_lock<std::mutex> l(_write_buffer_lock, std::try_to_lock);
+    if (!l.owns_lock()) {
+        // another add_batch of this load is flushing
+        return;
+    }
+    const int64_t estimated_bytes = _write_buffer_estimated_bytes.load();
+    std::vector<std::shared_ptr<BaseTabletsChannel>> channels;
+    {
+        std::lock_guard<SpinLock> channels_lock(_tablets_channels_lock);
+        for (auto& [index_id, channel] : _tablets_channels) {
+            channels.push_back(channel);
+        }
+    }
+    std::vector<std::shared_ptr<MemTableWriter>> writers;
+    for (auto& channel : channels) {
+        channel->get_memtable_writers(&writers);
+    }
+    std::vector<std::pair<int64_t, MemTableWriter*>> active_writers;
+    int64_t active_mem_usage = 0;
+    for (auto& writer : writers) {
+        int64_t mem_usage = writer->active_memtable_mem_consumption();
+        if (mem_usage > 0) {
+            active_writers.emplace_back(mem_usage, writer.get());
+            active_mem_usage += mem_usage;
+        }
+    }
+    const int64_t limit = config::load_shared_write_buffer_bytes;
+    if (active_mem_usage <= limit) {
+        // the blocks received meanwhile stay counted
+        _write_buffer_estimated_bytes.fetch_sub(estimated_bytes - active_mem_usage);
+        return;
+    }
+
+    // Flush the largest memtables first until half of the buffer is free, so that memtables
+    // have time to grow into segments of a reasonable size. The small ones that still have to
+    // be flushed share flush tasks.
+    std::sort(active_writers.begin(), active_writers.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+    const int64_t need_flush = active_mem_usage - limit / 2;
+    int64_t mem_flushed = 0;
+    int64_t num_flushed = 0;
+    MemTableFlushBatch batch;
+    for (auto& [mem_usage, writer] : active_writers) {
+        if (mem_flushed >= need_flush) {
+            break;
+        }
+        bool batched = mem_usage < config::load_shared_write_buffer_batch_flush_bytes;
+        Status st = writer->flush_async(batched ? &batch : nullptr);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to flush memtable of load write buffer, load_id=" << _load_id
+                         << ", tablet_id=" << writer->tablet_id() << ", err=" << st;
+            static_cast<void>(writer->cancel_with_status(st));
+            continue;
+        }
+        mem_flushed += mem_usage;
+        num_flushed++;
+    }
+    _write_buffer_estimated_bytes.fetch_sub(estimated_bytes - (active_mem_usage - mem_flushed));
+    COUNTER_UPDATE(_write_buffer_batched_memtables, batch.size());
+    Status st = batch.submit();
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to submit memtable flush batch, load_id=" << _load_id
+                     << ", err=" << st;
+    }
+    COUNTER_UPDATE(_write_buffer_flush_times, 1);
+    COUNTER_UPDATE(_write_buffer_flushed_memtables, num_flushed);
+    COUNTER_UPDATE(_write_buffer_flushed_bytes, mem_flushed);
+    VLOG_NOTICE << "flushed " << num_flushed << " out of " << active_writers.size()
+                << " memtables of load write buffer, load_id=" << _load_id
+                << ", flushed size: " << PrettyPrinter::print_bytes(mem_flushed);
+}
+
 void LoadChannel::_report_profile(PTabletWriterAddBlockResult* response) {
     if (!_enable_profile) {
         return;
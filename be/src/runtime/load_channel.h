@@ -86,6 +86,9 @@ protected:
                        PTabletWriterAddBlockResult* response);
 
     void _init_profile();
+    // Flush the largest memtables of the load when the memtables of all its tablets, which
+    // make up the write buffer of the load, exceed config::load_shared_write_buffer_bytes.
+    void _flush_write_buffer();
     // thread safety
     void _report_profile(PTabletWriterAddBlockResult* response);
 
@@ -102,9 +105,19 @@ private:
     RuntimeProfile::Counter* _mgr_add_batch_timer = nullptr;
     RuntimeProfile::Counter* _handle_mem_limit_timer = nullptr;
     RuntimeProfile::Counter* _handle_eos_timer = nullptr;
+    // only set when config::enable_load_shared_write_buffer is true
+    RuntimeProfile::Counter* _write_buffer_flush_times = nullptr;
+    RuntimeProfile::Counter* _write_buffer_flushed_memtables = nullptr;
+    RuntimeProfile::Counter* _write_buffer_batched_memtables = nullptr;
+    RuntimeProfile::Counter* _write_buffer_flushed_bytes = nullptr;
 
     // lock protect the tablets channel map
     std::mutex _lock;
+    // only one add_batch flushes the write buffer at a time
+    std::mutex _write_buffer_lock;
+    // The active memtable bytes measured by the last scan of the write buffer, plus the bytes of
+    // the blocks received since. The memtables are scanned only once it exceeds the buffer.
+    std::atomic<int64_t> _write_buffer_estimated_bytes = 0;
     // index id -> tablets channel
     std::unordered_map<int64_t, std::shared_ptr<BaseTabletsChannel>> _tablets_channels;
     // index id -> (received rows, filtered rows)
@@ -45,6 +45,8 @@ public:
         CREATE_TABLET_RR_IDX_CACHE = 15,
         CLOUD_TABLET_CACHE = 16,
         CLOUD_TXN_DELETE_BITMAP_CACHE = 17,
+        QUERY_BUFFER_POOL = 18,
+        ICEBERG_DELETE_FILE_CACHE = 19,
     };
 
     static std::string type_string(CacheType type) {
@@ -85,6 +87,10 @@ public:
             return "CloudTabletCache";
         case CacheType::CLOUD_TXN_DELETE_BITMAP_CACHE:
             return "CloudTxnDeleteBitmapCache";
+        case CacheType::QUERY_BUFFER_POOL:
+            return "QueryBufferPool";
+        case CacheType::ICEBERG_DELETE_FILE_CACHE:
+            return "IcebergDeleteFileCache";
         default:
             LOG(FATAL) << "not match type of cache policy :" << static_cast<int>(type);
         }
@@ -30,6 +30,7 @@
 #include "olap/memtable_memory_limiter.h"
 #include "runtime/exec_env.h"
 #include "runtime/fragment_mgr.h"
+#include "runtime/memory/recycled_buffer_pool.h"
 #include "runtime/task_group/task_group.h"
 #include "runtime/thread_context.h"
 #include "service/backend_options.h"
@@ -83,6 +84,9 @@ MemTrackerLimiter::MemTrackerLimiter(Type type, const std::string& label, int64_
     if (_type == Type::LOAD || _type == Type::QUERY) {
         _query_statistics = std::make_shared<QueryStatistics>();
     }
+    if (_type == Type::QUERY && config::enable_query_buffer_pool) {
+        _buffer_pool = std::make_unique<RecycledBufferPool>(this, _limit);
+    }
 
     {
         std::lock_guard<std::mutex> l(mem_tracker_limiter_pool[_group_num].group_lock);
@@ -96,6 +100,8 @@ MemTrackerLimiter::~MemTrackerLimiter() {
     if (_type == Type::GLOBAL) {
         return;
     }
+    // Unmap the retained buffers, their consumption is released from this tracker.
+    _buffer_pool.reset();
     consume(_untracked_mem);
     // mem hook record tracker cannot guarantee that the final consumption is 0,
     // nor can it guarantee that the memory alloc and free are recorded in a one-to-one correspondence.
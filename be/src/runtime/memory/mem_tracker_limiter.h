@@ -42,6 +42,7 @@
 namespace doris {
 
 class RuntimeProfile;
+class RecycledBufferPool;
 
 constexpr auto MEM_TRACKER_GROUP_NUM = 1000;
 
@@ -149,6 +150,9 @@ public:
 
     void set_is_query_cancelled(bool is_cancelled) { _is_query_cancelled.store(is_cancelled); }
 
+    // Not null only for query trackers when config::enable_query_buffer_pool is true.
+    RecycledBufferPool* buffer_pool() const { return _buffer_pool.get(); }
+
 public:
     // If need to consume the tracker frequently, use it
     void cache_consume(int64_t bytes);
@@ -281,6 +285,9 @@ private:
     // query or load
     std::atomic<bool> _is_query_cancelled = false;
 
+    // Large buffers freed by Allocator and kept for reuse by this query.
+    std::unique_ptr<RecycledBufferPool> _buffer_pool;
+
     // Avoid frequent printing.
     bool _enable_print_log_usage = false;
     static std::atomic<bool> _enable_print_log_process_usage;
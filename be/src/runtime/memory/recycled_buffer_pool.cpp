@@ -0,0 +1,253 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/memory/recycled_buffer_pool.h"
+
+#include <fmt/format.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+
+#include "common/config.h"
+#include "runtime/memory/mem_tracker.h"
+#include "util/mem_info.h"
+#include "util/time.h"
+
+namespace doris {
+
+RecycledBufferPool::RecycledBufferPool(MemTracker* mem_tracker, int64_t mem_limit)
+        : _mem_tracker(mem_tracker) {
+    _capacity = config::query_buffer_pool_max_bytes;
+    if (mem_limit > 0) {
+        _capacity = std::min(
+                _capacity, static_cast<int64_t>(mem_limit * config::query_buffer_pool_limit_ratio));
+    }
+    _it = RecycledBufferPoolCache::instance()->register_pool(this);
+}
+
+RecycledBufferPool::~RecycledBufferPool() {
+    // After unregister, memory GC no longer touches this pool.
+    RecycledBufferPoolCache::instance()->unregister_pool(_it);
+    _release_unused_since(std::numeric_limits<int64_t>::max());
+    DCHECK_EQ(_retained_bytes.load(), 0);
+}
+
+bool RecycledBufferPool::is_poolable_size(size_t size) {
+    return config::enable_query_buffer_pool &&
+           size >= static_cast<size_t>(config::query_buffer_pool_min_bytes) &&
+           (size & (size - 1)) == 0;
+}
+
+size_t RecycledBufferPool::_size_class(size_t size) {
+    DCHECK(size != 0 && (size & (size - 1)) == 0);
+    DCHECK_LT(__builtin_ctzll(size), NUM_SIZE_CLASSES);
+    return __builtin_ctzll(size);
+}
+
+size_t RecycledBufferPool::_magazine_index() {
+    static thread_local size_t index = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return index % NUM_MAGAZINES;
+}
+
+void RecycledBufferPool::advise(void* buf, size_t size) {
+#if defined(OS_LINUX) && defined(MADV_HUGEPAGE)
+    if (config::query_buffer_pool_use_huge_page) {
+        // Best effort, the buffer is still usable without huge pages.
+        static_cast<void>(madvise(buf, size, MADV_HUGEPAGE));
+    }
+#endif
+}
+
+bool RecycledBufferPool::_try_reserve(size_t size) {
+    int64_t retained = _retained_bytes.load(std::memory_order_relaxed);
+    do {
+        if (retained + static_cast<int64_t>(size) > _capacity) {
+            return false;
+        }
+    } while (!_retained_bytes.compare_exchange_weak(retained, retained + size,
+                                                    std::memory_order_relaxed));
+    // The buffer stays resident, so it is still part of the query memory.
+    _mem_tracker->consume(size);
+    return true;
+}
+
+void RecycledBufferPool::_unreserve(size_t size) {
+    _retained_bytes.fetch_sub(size, std::memory_order_relaxed);
+    _mem_tracker->release(size);
+}
+
+void* RecycledBufferPool::acquire(size_t size) {
+    if (!is_poolable_size(size)) {
+        return nullptr;
+    }
+    auto& size_class = _classes[_size_class(size)];
+    void* buf = nullptr;
+    {
+        auto& magazine = size_class.magazines[_magazine_index()];
+        std::lock_guard<SpinLock> l(magazine.lock);
+        if (magazine.num > 0) {
+            buf = magazine.buffers[--magazine.num].data;
+        }
+    }
+    if (buf == nullptr) {
+        std::lock_guard<std::mutex> l(size_class.depot_lock);
+        if (!size_class.depot.empty()) {
+            buf = size_class.depot.back().data;
+            size_class.depot.pop_back();
+        }
+    }
+    if (buf == nullptr) {
+        _miss_count.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    _hit_count.fetch_add(1, std::memory_order_relaxed);
+    _unreserve(size);
+    return buf;
+}
+
+bool RecycledBufferPool::release(void* buf, size_t size) {
+    if (!is_poolable_size(size)) {
+        return false;
+    }
+    // Under process memory pressure, give the memory back to the system.
+    if (MemInfo::is_exceed_soft_mem_limit(size) || !_try_reserve(size)) {
+        return false;
+    }
+    Buffer buffer {buf, MonotonicSeconds()};
+    auto& size_class = _classes[_size_class(size)];
+    {
+        auto& magazine = size_class.magazines[_magazine_index()];
+        std::lock_guard<SpinLock> l(magazine.lock);
+        if (magazine.num < MAGAZINE_CAPACITY) {
+            magazine.buffers[magazine.num++] = buffer;
+            return true;
+        }
+    }
+    std::lock_guard<std::mutex> l(size_class.depot_lock);
+    size_class.depot.push_back(buffer);
+    return true;
+}
+
+std::pair<int64_t, int64_t> RecycledBufferPool::_release_unused_since(int64_t before_s) {
+    int64_t freed_buffers = 0;
+    int64_t freed_bytes = 0;
+    auto pred = [before_s](const Buffer& b) { return b.last_used_s < before_s; };
+    std::vector<Buffer> to_free;
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        auto& size_class = _classes[i];
+        const size_t size = 1ULL << i;
+        to_free.clear();
+        for (auto& magazine : size_class.magazines) {
+            std::lock_guard<SpinLock> l(magazine.lock);
+            size_t kept = 0;
+            for (size_t j = 0; j < magazine.num; ++j) {
+                if (pred(magazine.buffers[j])) {
+                    to_free.push_back(magazine.buffers[j]);
+                } else {
+                    magazine.buffers[kept++] = magazine.buffers[j];
+                }
+            }
+            magazine.num = kept;
+        }
+        {
+            std::lock_guard<std::mutex> l(size_class.depot_lock);
+            auto it = std::partition(size_class.depot.begin(), size_class.depot.end(),
+                                     [&](const Buffer& b) { return !pred(b); });
+            to_free.insert(to_free.end(), it, size_class.depot.end());
+            size_class.depot.erase(it, size_class.depot.end());
+        }
+        // munmap outside the locks, it may be slow.
+        for (auto& buffer : to_free) {
+            if (0 != munmap(buffer.data, size)) {
+                LOG(WARNING) << fmt::format("RecycledBufferPool: Cannot munmap {}.", size);
+            }
+            _unreserve(size);
+            freed_buffers++;
+            freed_bytes += size;
+        }
+    }
+    return {freed_buffers, freed_bytes};
+}
+
+RecycledBufferPoolCache* RecycledBufferPoolCache::instance() {
+    static RecycledBufferPoolCache* instance = new RecycledBufferPoolCache();
+    return instance;
+}
+
+RecycledBufferPoolCache::RecycledBufferPoolCache()
+        : CachePolicy(CacheType::QUERY_BUFFER_POOL, config::query_buffer_pool_stale_sweep_time_sec,
+                      true) {}
+
+std::list<RecycledBufferPool*>::iterator RecycledBufferPoolCache::register_pool(
+        RecycledBufferPool* pool) {
+    std::lock_guard<std::mutex> l(_lock);
+    return _pools.insert(_pools.end(), pool);
+}
+
+void RecycledBufferPoolCache::unregister_pool(std::list<RecycledBufferPool*>::iterator it) {
+    std::lock_guard<std::mutex> l(_lock);
+    _pools.erase(it);
+}
+
+std::pair<int64_t, int64_t> RecycledBufferPoolCache::_release_unused_since(int64_t before_s) {
+    int64_t freed_buffers = 0;
+    int64_t freed_bytes = 0;
+    std::lock_guard<std::mutex> l(_lock);
+    for (auto* pool : _pools) {
+        if (pool->retained_bytes() == 0) {
+            continue;
+        }
+        auto [buffers, bytes] = pool->_release_unused_since(before_s);
+        freed_buffers += buffers;
+        freed_bytes += bytes;
+    }
+    return {freed_buffers, freed_bytes};
+}
+
+void RecycledBufferPoolCache::prune_stale() {
+    COUNTER_SET(_freed_entrys_counter, (int64_t)0);
+    COUNTER_SET(_freed_memory_counter, (int64_t)0);
+    COUNTER_SET(_cost_timer, (int64_t)0);
+    SCOPED_TIMER(_cost_timer);
+    auto [freed_buffers, freed_bytes] = _release_unused_since(
+            MonotonicSeconds() - config::query_buffer_pool_stale_sweep_time_sec);
+    COUNTER_SET(_freed_entrys_counter, freed_buffers);
+    COUNTER_SET(_freed_memory_counter, freed_bytes);
+    COUNTER_UPDATE(_prune_stale_number_counter, 1);
+    LOG(INFO) << fmt::format("[MemoryGC] {} prune stale {} buffers, {} bytes", type_string(_type),
+                             freed_buffers, freed_bytes);
+}
+
+void RecycledBufferPoolCache::prune_all(bool force) {
+    COUNTER_SET(_freed_entrys_counter, (int64_t)0);
+    COUNTER_SET(_freed_memory_counter, (int64_t)0);
+    COUNTER_SET(_cost_timer, (int64_t)0);
+    SCOPED_TIMER(_cost_timer);
+    auto [freed_buffers, freed_bytes] =
+            _release_unused_since(std::numeric_limits<int64_t>::max());
+    COUNTER_SET(_freed_entrys_counter, freed_buffers);
+    COUNTER_SET(_freed_memory_counter, freed_bytes);
+    COUNTER_UPDATE(_prune_all_number_counter, 1);
+    LOG(INFO) << fmt::format("[MemoryGC] {} prune all {} buffers, {} bytes, is force: {}",
+                             type_string(_type), freed_buffers, freed_bytes, force);
+}
+
+} // namespace doris
@@ -0,0 +1,144 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "runtime/memory/cache_policy.h"
+#include "util/spinlock.h"
+
+namespace doris {
+
+class MemTracker;
+
+// Per-query pool of large mmap'd buffers, used by `Allocator` for power-of-two sizes not
+// smaller than `config::query_buffer_pool_min_bytes`.
+//
+// Hash join, sort and exchange allocate and free multi-megabyte PODArrays for every block,
+// each time paying for mmap, page faults and munmap TLB shootdowns. Instead of unmapping, a
+// freed buffer is kept warm in the pool and handed out again by the next allocation of the
+// same size class.
+//
+// Buffers are bucketed by size class (log2 of the size). Each class has a few small
+// magazines, a thread picks one by its thread id so that frequent alloc/free in one pipeline
+// task rarely contends, and a shared depot that takes the overflow of the magazines.
+//
+// A buffer retained by the pool is still consumed by the query mem tracker, and the total
+// retained bytes are limited by `query mem limit * query_buffer_pool_limit_ratio` and
+// `query_buffer_pool_max_bytes`. All pools are registered to RecycledBufferPoolCache, memory GC
+// releases stale buffers by prune_stale and all buffers by prune_all.
+class RecycledBufferPool {
+public:
+    static constexpr size_t NUM_SIZE_CLASSES = 48;
+    static constexpr size_t NUM_MAGAZINES = 16;
+    static constexpr size_t MAGAZINE_CAPACITY = 2;
+
+    // `mem_tracker` is the query MemTrackerLimiter owning this pool, it must outlive the pool.
+    RecycledBufferPool(MemTracker* mem_tracker, int64_t mem_limit);
+    ~RecycledBufferPool();
+
+    // Whether an allocation of `size` bytes is managed by the pool, only exact powers of two
+    // are, so the size passed to free always equals the length of the mapping.
+    static bool is_poolable_size(size_t size);
+
+    // Return a recycled buffer of exactly `size` bytes, or nullptr if none is retained.
+    // The content of the buffer is undefined.
+    void* acquire(size_t size);
+
+    // Keep `buf` for reuse. Returns false if the pool is full or under memory pressure,
+    // then the caller must unmap the buffer itself.
+    bool release(void* buf, size_t size);
+
+    // Called on a freshly mmap'd poolable buffer, before it is first touched.
+    static void advise(void* buf, size_t size);
+
+    int64_t retained_bytes() const { return _retained_bytes.load(std::memory_order_relaxed); }
+    int64_t capacity() const { return _capacity; }
+    int64_t hit_count() const { return _hit_count.load(std::memory_order_relaxed); }
+    int64_t miss_count() const { return _miss_count.load(std::memory_order_relaxed); }
+
+private:
+    friend class RecycledBufferPoolCache;
+
+    struct Buffer {
+        void* data = nullptr;
+        int64_t last_used_s = 0;
+    };
+
+    struct Magazine {
+        SpinLock lock;
+        size_t num = 0;
+        std::array<Buffer, MAGAZINE_CAPACITY> buffers;
+    };
+
+    struct SizeClass {
+        std::array<Magazine, NUM_MAGAZINES> magazines;
+        std::mutex depot_lock;
+        std::vector<Buffer> depot;
+    };
+
+    static size_t _size_class(size_t size);
+    static size_t _magazine_index();
+
+    bool _try_reserve(size_t size);
+    void _unreserve(size_t size);
+    // Unmap the buffers not used since `before_s`, returns the number of freed buffers and bytes.
+    std::pair<int64_t, int64_t> _release_unused_since(int64_t before_s);
+
+    MemTracker* _mem_tracker;
+    int64_t _capacity;
+
+    std::array<SizeClass, NUM_SIZE_CLASSES> _classes;
+
+    std::atomic<int64_t> _retained_bytes = 0;
+    std::atomic<int64_t> _hit_count = 0;
+    std::atomic<int64_t> _miss_count = 0;
+
+    std::list<RecycledBufferPool*>::iterator _it;
+};
+
+// Registers the RecycledBufferPool of all running queries to CacheManager, so that memory GC
+// can release the buffers retained by them.
+class RecycledBufferPoolCache final : public CachePolicy {
+public:
+    static RecycledBufferPoolCache* instance();
+
+    std::list<RecycledBufferPool*>::iterator register_pool(RecycledBufferPool* pool);
+    void unregister_pool(std::list<RecycledBufferPool*>::iterator it);
+
+    void prune_stale() override;
+    void prune_all(bool force) override;
+
+private:
+    RecycledBufferPoolCache();
+
+    std::pair<int64_t, int64_t> _release_unused_since(int64_t before_s);
+
+    std::mutex _lock;
+    std::list<RecycledBufferPool*> _pools;
+};
+
+} // namespace doris
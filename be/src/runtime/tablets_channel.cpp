@@ -84,20 +84,35 @@ BaseTabletsChannel::~BaseTabletsChannel() {
 
 TabletsChannel::~TabletsChannel() = default;
 
-Status BaseTabletsChannel::_get_current_seq(int64_t& cur_seq,
-                                            const PTabletWriterAddBlockRequest& request) {
+Status BaseTabletsChannel::_check_opened() {
     std::lock_guard<std::mutex> l(_lock);
     if (_state != kOpened) {
         return _state == kFinished ? _close_status
                                    : Status::InternalError("TabletsChannel {} state: {}",
                                                            _key.to_string(), _state);
     }
-    cur_seq = _next_seqs[request.sender_id()];
-    // check packet
-    if (request.packet_seq() > cur_seq) {
-        LOG(WARNING) << "lost data packet, expect_seq=" << cur_seq
-                     << ", recept_seq=" << request.packet_seq();
-        return Status::InternalError("lost data packet");
+    return Status::OK();
+}
+
+Status BaseTabletsChannel::add_batch(const PTabletWriterAddBlockRequest& request,
+                                     PTabletWriterAddBlockResult* response) {
+    SCOPED_TIMER(_add_batch_timer);
+    _add_batch_number_counter->update(1);
+    RETURN_IF_ERROR(_check_opened());
+
+    bool write_now = false;
+    RETURN_IF_ERROR(_packet_sequencer.accept(request, &write_now));
+    if (!write_now) {
+        return Status::OK();
+    }
+    // Write the packet, then the buffered packets that arrived before it.
+    const PTabletWriterAddBlockRequest* packet = &request;
+    std::unique_ptr<PTabletWriterAddBlockRequest> next_packet;
+    while (packet != nullptr) {
+        Status st = _write_packet(*packet, response);
+        _packet_sequencer.finish(request.sender_id(), st, &next_packet);
+        RETURN_IF_ERROR(st);
+        packet = next_packet.get();
     }
     return Status::OK();
 }
@@ -142,7 +157,7 @@ Status BaseTabletsChannel::open(const PTabletWriterOpenRequest& request) {
     _tuple_desc = _schema->tuple_desc();
 
     _num_remaining_senders = request.num_senders();
-    _next_seqs.resize(_num_remaining_senders, 0);
+    _packet_sequencer.init(_num_remaining_senders);
     _closed_senders.Reset(_num_remaining_senders);
 
     RETURN_IF_ERROR(_open_all_writers(request));
@@ -230,6 +245,8 @@ Status TabletsChannel::close(LoadChannel* parent, const PTabletWriterAddBlockReq
         *finished = (_num_remaining_senders == 0);
         return _close_status;
     }
+    // The packets of the sender are all written before its eos, unless one of them is lost.
+    RETURN_IF_ERROR(_packet_sequencer.close_sender(sender_id));
     LOG(INFO) << "close tablets channel: " << _key << ", sender id: " << sender_id
               << ", backend id: " << backend_id;
     for (auto pid : partition_ids) {
@@ -389,6 +406,14 @@ void BaseTabletsChannel::_add_error_tablet(
                   << "err msg " << error;
 }
 
+void BaseTabletsChannel::get_memtable_writers(
+        std::vector<std::shared_ptr<MemTableWriter>>* writers) {
+    std::lock_guard<SpinLock> l(_tablet_writers_lock);
+    for (auto&& [tablet_id, writer] : _tablet_writers) {
+        writers->push_back(writer->memtable_writer());
+    }
+}
+
 void BaseTabletsChannel::refresh_profile() {
     int64_t write_mem_usage = 0;
     int64_t flush_mem_usage = 0;
@@ -512,7 +537,7 @@ std::ostream& operator<<(std::ostream& os, const TabletsChannelKey& key) {
 }
 
 Status BaseTabletsChannel::_write_block_data(
-        const PTabletWriterAddBlockRequest& request, int64_t cur_seq,
+        const PTabletWriterAddBlockRequest& request,
         std::unordered_map<int64_t, std::vector<uint32_t>>& tablet_to_rowidxs,
         PTabletWriterAddBlockResult* response) {
     vectorized::Block send_data;
@@ -564,36 +589,16 @@ Status BaseTabletsChannel::_write_block_data(
                     }));
         }
     }
-
-    {
-        std::lock_guard<std::mutex> l(_lock);
-        _next_seqs[request.sender_id()] = cur_seq + 1;
-    }
     return Status::OK();
 }
 
-Status TabletsChannel::add_batch(const PTabletWriterAddBlockRequest& request,
-                                 PTabletWriterAddBlockResult* response) {
-    SCOPED_TIMER(_add_batch_timer);
-    int64_t cur_seq = 0;
-    _add_batch_number_counter->update(1);
-
-    auto status = _get_current_seq(cur_seq, request);
-    if (UNLIKELY(!status.ok())) {
-        return status;
-    }
-
-    if (request.packet_seq() < cur_seq) {
-        LOG(INFO) << "packet has already recept before, expect_seq=" << cur_seq
-                  << ", recept_seq=" << request.packet_seq();
-        return Status::OK();
-    }
-
+Status TabletsChannel::_write_packet(const PTabletWriterAddBlockRequest& request,
+                                     PTabletWriterAddBlockResult* response) {
     std::unordered_map<int64_t /* tablet_id */, std::vector<uint32_t> /* row index */>
             tablet_to_rowidxs;
     _build_tablet_to_rowidxs(request, &tablet_to_rowidxs);
 
-    return _write_block_data(request, cur_seq, tablet_to_rowidxs, response);
+    return _write_block_data(request, tablet_to_rowidxs, response);
 }
 
 void BaseTabletsChannel::_add_broken_tablet(int64_t tablet_id) {
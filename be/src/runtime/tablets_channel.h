@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "common/status.h"
+#include "runtime/add_block_packet_sequencer.h"
 #include "util/bitmap.h"
 #include "util/runtime_profile.h"
 #include "util/spinlock.h"
@@ -97,8 +98,8 @@ public:
     virtual std::unique_ptr<BaseDeltaWriter> create_delta_writer(const WriteRequest& request) = 0;
 
     // no-op when this channel has been closed or cancelled
-    virtual Status add_batch(const PTabletWriterAddBlockRequest& request,
-                             PTabletWriterAddBlockResult* response) = 0;
+    Status add_batch(const PTabletWriterAddBlockRequest& request,
+                     PTabletWriterAddBlockResult* response);
 
     // Mark sender with 'sender_id' as closed.
     // If all senders are closed, close this channel, set '*finished' to true, update 'tablet_vec'
@@ -116,12 +117,19 @@ public:
 
     size_t num_rows_filtered() const { return _num_rows_filtered; }
 
+    // append the memtable writers of the tablets of this channel to `writers`
+    void get_memtable_writers(std::vector<std::shared_ptr<MemTableWriter>>* writers);
+
 protected:
-    Status _write_block_data(const PTabletWriterAddBlockRequest& request, int64_t cur_seq,
+    // Writes a packet of a sender, the packets of a sender are written in order.
+    virtual Status _write_packet(const PTabletWriterAddBlockRequest& request,
+                                 PTabletWriterAddBlockResult* response) = 0;
+
+    Status _write_block_data(const PTabletWriterAddBlockRequest& request,
                              std::unordered_map<int64_t, std::vector<uint32_t>>& tablet_to_rowidxs,
                              PTabletWriterAddBlockResult* response);
 
-    Status _get_current_seq(int64_t& cur_seq, const PTabletWriterAddBlockRequest& request);
+    Status _check_opened();
 
     // open all writer
     Status _open_all_writers(const PTabletWriterOpenRequest& request);
@@ -161,9 +169,9 @@ protected:
 
     TupleDescriptor* _tuple_desc = nullptr;
 
-    // next sequence we expect
     int _num_remaining_senders = 0;
-    std::vector<int64_t> _next_seqs;
+    // orders the packets of each sender
+    AddBlockPacketSequencer _packet_sequencer;
     Bitmap _closed_senders;
     // status to return when operate on an already closed/cancelled channel
     // currently it's OK.
@@ -215,15 +223,15 @@ public:
 
     std::unique_ptr<BaseDeltaWriter> create_delta_writer(const WriteRequest& request) override;
 
-    Status add_batch(const PTabletWriterAddBlockRequest& request,
-                     PTabletWriterAddBlockResult* response) override;
-
     Status close(LoadChannel* parent, const PTabletWriterAddBlockRequest& req,
                  PTabletWriterAddBlockResult* res, bool* finished) override;
 
     Status cancel() override;
 
 private:
+    Status _write_packet(const PTabletWriterAddBlockRequest& request,
+                         PTabletWriterAddBlockResult* response) override;
+
     void _init_profile(RuntimeProfile* profile) override;
 
     // deal with DeltaWriter commit_txn(), add tablet to list for return.
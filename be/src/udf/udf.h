@@ -146,6 +146,10 @@ public:
 
     vectorized::Arena& get_arena() { return arena; }
 
+    // The blocks in a row with too many distinct values to evaluate the function once per
+    // distinct value of its string argument, see VectorizedFnCall::_execute_on_dictionary.
+    uint32_t& dictionary_misses() { return _dictionary_misses; }
+
 private:
     FunctionContext() = default;
 
@@ -183,6 +187,8 @@ private:
 
     std::string _string_result;
 
+    uint32_t _dictionary_misses = 0;
+
     vectorized::Arena arena;
 };
 
@@ -18,8 +18,10 @@
 // the implement of BitPacking is from impala
 
 #include <boost/preprocessor/repetition/repeat_from_to.hpp>
+#include <type_traits>
 
 #include "util/bit_packing.h"
+#include "util/sse_util.hpp"
 
 namespace doris {
 
@@ -48,6 +50,100 @@ constexpr bool IsSupportedUnpackingType() {
            std::is_same<T, uint32_t>::value || std::is_same<T, uint64_t>::value;
 }
 
+// Bytes the SIMD kernels may read after the 32 values they unpack.
+constexpr int SIMD_UNPACK_OVERREAD = 4;
+
+// Whether 32 values of BIT_WIDTH are unpacked to OutType by SimdUnpack32Values().
+template <typename OutType, int BIT_WIDTH>
+constexpr bool HasSimdUnpacking() {
+#ifdef __AVX2__
+    return BIT_WIDTH > 0 && BIT_WIDTH <= 25;
+#elif defined(__SSE4_1__)
+    return std::is_same<OutType, uint32_t>::value && (BIT_WIDTH == 8 || BIT_WIDTH == 16);
+#else
+    return false;
+#endif
+}
+
+#ifdef __AVX2__
+// Stores 8 unpacked values from the 32 bit lanes of 'values' as OutType.
+template <typename OutType>
+inline void StoreUnpacked8Values(__m256i values, OutType* __restrict__ out) {
+    if constexpr (sizeof(OutType) == 4) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), values);
+    } else if constexpr (sizeof(OutType) == 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                            _mm256_cvtepu32_epi64(_mm256_castsi256_si128(values)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4),
+                            _mm256_cvtepu32_epi64(_mm256_extracti128_si256(values, 1)));
+    } else {
+        __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(values),
+                                          _mm256_extracti128_si256(values, 1));
+        if constexpr (sizeof(OutType) == 2) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+        } else {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(packed, packed));
+        }
+    }
+}
+#endif
+
+// Unpacks 32 values of BIT_WIDTH to 'out', only for the bit widths of HasSimdUnpacking().
+// 'in' must have SIMD_UNPACK_OVERREAD addressable bytes after the 32 values.
+//
+// With AVX2, 8 values are unpacked at a time: every lane gathers the 4 bytes its value starts
+// in and shifts the value down by its bit offset in them, so a value fits in the lane if it
+// has at most 25 bits. The byte aligned widths are widened without the gathers. With SSE4.1
+// only the byte aligned widths are vectorized.
+template <typename OutType, int BIT_WIDTH>
+const uint8_t* SimdUnpack32Values(const uint8_t* __restrict__ in, OutType* __restrict__ out) {
+    static_assert(HasSimdUnpacking<OutType, BIT_WIDTH>(), "BIT_WIDTH is not SIMD unpacked");
+    constexpr int BYTES_TO_READ = BitUtil::RoundUpNumBytes(32 * BIT_WIDTH);
+#ifdef __AVX2__
+    if constexpr (BIT_WIDTH == 8) {
+        for (int i = 0; i < 32; i += 8) {
+            StoreUnpacked8Values(_mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                                         reinterpret_cast<const __m128i*>(in + i))),
+                                 out + i);
+        }
+    } else if constexpr (BIT_WIDTH == 16) {
+        for (int i = 0; i < 32; i += 8) {
+            StoreUnpacked8Values(_mm256_cvtepu16_epi32(_mm_loadu_si128(
+                                         reinterpret_cast<const __m128i*>(in + i * 2))),
+                                 out + i);
+        }
+    } else {
+        const __m256i mask = _mm256_set1_epi32(static_cast<int>(GetMask(BIT_WIDTH)));
+        const __m256i bit_offset_mask = _mm256_set1_epi32(7);
+        const __m256i lane_bits = _mm256_setr_epi32(0, BIT_WIDTH, 2 * BIT_WIDTH, 3 * BIT_WIDTH,
+                                                    4 * BIT_WIDTH, 5 * BIT_WIDTH, 6 * BIT_WIDTH,
+                                                    7 * BIT_WIDTH);
+        for (int i = 0; i < 32; i += 8) {
+            const __m256i bits = _mm256_add_epi32(lane_bits, _mm256_set1_epi32(i * BIT_WIDTH));
+            const __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(in),
+                                                         _mm256_srli_epi32(bits, 3), 1);
+            const __m256i values = _mm256_srlv_epi32(
+                    words, _mm256_and_si256(bits, bit_offset_mask));
+            StoreUnpacked8Values(_mm256_and_si256(values, mask), out + i);
+        }
+    }
+#elif defined(__SSE4_1__)
+    for (int i = 0; i < 32; i += 4) {
+        __m128i values;
+        if constexpr (BIT_WIDTH == 8) {
+            int32_t bytes;
+            memcpy(&bytes, in + i, sizeof(bytes));
+            values = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+        } else {
+            values = _mm_cvtepu16_epi32(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i * 2)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), values);
+    }
+#endif
+    return in + BYTES_TO_READ;
+}
+
 template <typename OutType>
 std::pair<const uint8_t*, int64_t> BitPacking::UnpackValues(int bit_width,
                                                             const uint8_t* __restrict__ in,
@@ -85,7 +181,15 @@ std::pair<const uint8_t*, int64_t> BitPacking::UnpackValues(const uint8_t* __res
 
     // First unpack as many full batches as possible.
     for (int64_t i = 0; i < batches_to_read; ++i) {
-        in_pos = Unpack32Values<OutType, BIT_WIDTH>(in_pos, in_bytes, out_pos);
+        if constexpr (HasSimdUnpacking<OutType, BIT_WIDTH>()) {
+            if (LIKELY(in_bytes >= (BATCH_SIZE * BIT_WIDTH) / CHAR_BIT + SIMD_UNPACK_OVERREAD)) {
+                in_pos = SimdUnpack32Values<OutType, BIT_WIDTH>(in_pos, out_pos);
+            } else {
+                in_pos = Unpack32Values<OutType, BIT_WIDTH>(in_pos, in_bytes, out_pos);
+            }
+        } else {
+            in_pos = Unpack32Values<OutType, BIT_WIDTH>(in_pos, in_bytes, out_pos);
+        }
         out_pos += BATCH_SIZE;
         in_bytes -= (BATCH_SIZE * BIT_WIDTH) / CHAR_BIT;
     }
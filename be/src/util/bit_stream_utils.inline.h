@@ -135,6 +135,18 @@ bool BitReader::GetValue(int num_bits, T* v) {
     return true;
 }
 
+template <typename T>
+int BitReader::UnpackBatch(int num_bits, int num_values, T* v) {
+    DCHECK_EQ(position() % 8, 0);
+    int byte_pos = position() / 8;
+    int64_t num_read;
+    std::tie(std::ignore, num_read) = BitPacking::UnpackValues(
+            num_bits, buffer_ + byte_pos, max_bytes_ - byte_pos, num_values, v);
+    bool result = Advance(num_read * num_bits);
+    DCHECK(result);
+    return static_cast<int>(num_read);
+}
+
 inline void BitReader::Rewind(int num_bits) {
     bit_offset_ -= num_bits;
     if (bit_offset_ >= 0) {
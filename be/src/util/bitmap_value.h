@@ -26,6 +26,7 @@
 #include <cstdio>
 #include <limits>
 #include <map>
+#include <memory>
 #include <new>
 #include <numeric>
 #include <roaring/roaring.hh>
@@ -103,6 +104,7 @@ class Roaring64MapSetBitBiDirectionalIterator;
 // What we change includes
 // - a custom serialization format is used inside read()/write()/getSizeInBytes()
 // - added clear() and is32BitsEnough()
+// - added readFrozen(), and fastunion() unions the bitmaps of each high 32 bits at once
 class Roaring64Map {
     typedef roaring::api::roaring_bitmap_t roaring_bitmap_t;
 
@@ -137,15 +139,30 @@ public:
         emplaceOrInsert(0, r);
     }
 
+    // A copy never references the serialized bytes of a frozen bitmap, its containers are cloned.
     Roaring64Map(const Roaring64Map& r) : roarings(r.roarings), copyOnWrite(r.copyOnWrite) {}
 
-    Roaring64Map(Roaring64Map&& r) : roarings(r.roarings), copyOnWrite(r.copyOnWrite) {}
+    Roaring64Map(Roaring64Map&& r) noexcept
+            : frozenBuffer(std::move(r.frozenBuffer)),
+              roarings(std::move(r.roarings)),
+              copyOnWrite(r.copyOnWrite) {}
 
     /**
      * Assignment operator.
      */
     Roaring64Map& operator=(const Roaring64Map& r) {
-        roarings = r.roarings;
+        if (this != &r) {
+            roarings = r.roarings;
+            frozenBuffer.reset();
+        }
+        return *this;
+    }
+
+    Roaring64Map& operator=(Roaring64Map&& r) noexcept {
+        if (this != &r) {
+            roarings = std::move(r.roarings);
+            frozenBuffer = std::move(r.frozenBuffer);
+        }
         return *this;
     }
 
@@ -352,7 +369,10 @@ public:
     /**
      * Exchange the content of this bitmap with another.
      */
-    void swap(Roaring64Map& r) { roarings.swap(r.roarings); }
+    void swap(Roaring64Map& r) {
+        roarings.swap(r.roarings);
+        frozenBuffer.swap(r.frozenBuffer);
+    }
 
     /**
      * Get the cardinality of the bitmap (number of elements).
@@ -771,6 +791,43 @@ public:
         return result;
     }
 
+    /**
+     * Read a bitmap written by write() without decoding its containers, they reference the
+     * serialized bytes in `buffer` instead, which the returned bitmap keeps alive.
+     *
+     * The returned bitmap is frozen: it supports all read only operations, but must be copied
+     * before being modified.
+     */
+    static Roaring64Map readFrozen(std::shared_ptr<const std::string> buffer) {
+        Roaring64Map result;
+        const char* buf = buffer->data();
+        bool is_v1 = BitmapTypeCode::BITMAP32 == *buf || BitmapTypeCode::BITMAP64 == *buf;
+        bool is_bitmap32 = BitmapTypeCode::BITMAP32 == *buf || BitmapTypeCode::BITMAP32_V2 == *buf;
+        size_t size = 0;
+        if (is_bitmap32) {
+            result.roarings.emplace(0, readFrozenRoaring(buf + 1, is_v1, &size));
+            result.frozenBuffer = std::move(buffer);
+            return result;
+        }
+
+        buf++;
+        uint64_t map_size;
+        buf = reinterpret_cast<const char*>(
+                decode_varint64_ptr(reinterpret_cast<const uint8_t*>(buf),
+                                    reinterpret_cast<const uint8_t*>(buf + 10), &map_size));
+        DCHECK(buf != nullptr);
+        for (uint64_t lcv = 0; lcv < map_size; lcv++) {
+            uint32_t key = decode_fixed32_le(reinterpret_cast<const uint8_t*>(buf));
+            buf += sizeof(uint32_t);
+            result.roarings.emplace(key, readFrozenRoaring(buf, is_v1, &size));
+            buf += size;
+        }
+        result.frozenBuffer = std::move(buffer);
+        return result;
+    }
+
+    bool isFrozen() const { return frozenBuffer != nullptr; }
+
     /**
      * How many bytes are required to serialize this bitmap
      */
@@ -931,10 +988,21 @@ public:
      * pointer).
      */
     static Roaring64Map fastunion(size_t n, const Roaring64Map** inputs) {
-        Roaring64Map ans;
-        // not particularly fast
+        // Group the 32-bits bitmaps by their high bits, roaring's fastunion then unions each group
+        // with lazy container unions, instead of folding the inputs one by one.
+        phmap::btree_map<uint32_t, std::vector<const roaring::Roaring*>> groups;
         for (size_t lcv = 0; lcv < n; ++lcv) {
-            ans |= *(inputs[lcv]);
+            for (const auto& map_entry : inputs[lcv]->roarings) {
+                groups[map_entry.first].push_back(&map_entry.second);
+            }
+        }
+        Roaring64Map ans;
+        for (auto& [key, group] : groups) {
+            if (group.size() == 1) {
+                ans.roarings.emplace(key, *group[0]);
+            } else {
+                ans.roarings.emplace(key, roaring::Roaring::fastunion(group.size(), group.data()));
+            }
         }
         return ans;
     }
@@ -965,6 +1033,27 @@ public:
     const_iterator end() const;
 
 private:
+    // In the native format of roaring, used by serialize version 2, a bitmap is written either as
+    // an array of uint32 or in the portable format, see roaring_bitmap_serialize().
+    static constexpr char SERIALIZATION_CONTAINER = 2;
+
+    // Read one 32-bits bitmap as a frozen view, `size` is set to its serialized size.
+    static roaring::Roaring readFrozenRoaring(const char* buf, bool portable, size_t* size) {
+        if (!portable && *buf != SERIALIZATION_CONTAINER) {
+            // Only sparse bitmaps are written as an array, decoding them is cheap.
+            roaring::Roaring r = roaring::Roaring::read(buf, false);
+            *size = r.getSizeInBytes(false);
+            return r;
+        }
+        const char* portable_buf = portable ? buf : buf + 1;
+        roaring::Roaring r = roaring::Roaring::portableDeserializeFrozen(portable_buf);
+        *size = (portable_buf - buf) + r.getSizeInBytes(true);
+        return r;
+    }
+
+    // The serialized bytes referenced by the containers of a frozen bitmap, declared before
+    // `roarings` so that it is released after them.
+    std::shared_ptr<const std::string> frozenBuffer;
     phmap::btree_map<uint32_t, roaring::Roaring> roarings {};
     bool copyOnWrite {false};
     static uint32_t highBytes(const uint64_t in) { return uint32_t(in >> 32); }
@@ -1630,7 +1719,12 @@ public:
                 _bitmap->add(_sv);
                 break;
             case BITMAP:
-                *_bitmap |= detail::Roaring64Map::fastunion(bitmaps.size(), bitmaps.data());
+                // union the batch on its own, the accumulated bitmap is not rebuilt
+                if (bitmaps.size() == 1) {
+                    *_bitmap |= *bitmaps[0];
+                } else {
+                    *_bitmap |= detail::Roaring64Map::fastunion(bitmaps.size(), bitmaps.data());
+                }
                 break;
             case SET: {
                 *_bitmap = detail::Roaring64Map::fastunion(bitmaps.size(), bitmaps.data());
@@ -2181,9 +2275,12 @@ public:
             }
             break;
         case BITMAP:
-            _prepare_bitmap_for_write();
-            _bitmap->runOptimize();
-            _bitmap->shrinkToFit();
+            // a frozen bitmap was optimized before being written, do not materialize it
+            if (!_bitmap->isFrozen()) {
+                _prepare_bitmap_for_write();
+                _bitmap->runOptimize();
+                _bitmap->shrinkToFit();
+            }
             res = _bitmap->getSizeInBytes(config::bitmap_serialize_version);
             break;
         case SET:
@@ -2227,6 +2324,25 @@ public:
         }
     }
 
+    // Deserialize a bitmap value from the `size` bytes at `src`. A large roaring bitmap is kept
+    // as a frozen view over a copy of the bytes, so that cardinality, contains and unions do not
+    // decode its containers, it is decoded on the first modification.
+    bool deserialize_frozen(const char* src, size_t size) {
+        const bool is_bitmap = *src == BitmapTypeCode::BITMAP32 ||
+                               *src == BitmapTypeCode::BITMAP64 ||
+                               *src == BitmapTypeCode::BITMAP32_V2 ||
+                               *src == BitmapTypeCode::BITMAP64_V2;
+        const int64_t min_bytes = config::frozen_bitmap_min_bytes;
+        if (!is_bitmap || min_bytes < 0 || size < min_bytes) {
+            return deserialize(src);
+        }
+        reset();
+        _type = BITMAP;
+        _bitmap = std::make_shared<detail::Roaring64Map>(detail::Roaring64Map::readFrozen(
+                std::make_shared<const std::string>(src, size)));
+        return true;
+    }
+
     // Deserialize a bitmap value from `src`.
     // Return false if `src` begins with unknown type code, true otherwise.
     bool deserialize(const char* src) {
@@ -2691,6 +2807,13 @@ private:
             return;
         }
 
+        if (_bitmap->isFrozen()) {
+            // the containers reference the serialized bytes, materialize them by a copy
+            _bitmap = std::make_shared<detail::Roaring64Map>(*_bitmap);
+            _is_shared = false;
+            return;
+        }
+
         if (!_is_shared) {
             // the state is not shared, not need to check use count any more
             return;
@@ -14,51 +14,95 @@
 // KIND, either express or implied.  See the License for the
 // specific language governing permissions and limitations
 // under the License.
-
 #pragma once
 
+#include <parallel_hashmap/phmap.h>
+#include <pdqsort.h>
+#include <stdint.h>
+#include <string.h>
+
 #include <algorithm>
 #include <cmath>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include "udf/udf.h"
-
 namespace doris {
 
+// Exact value distribution of the percentile aggregate function.
+//
+// Values are first appended to a plain buffer. Once the buffer grows, the ratio of distinct
+// values is sampled and a low cardinality input is converted to an open addressing map from
+// value to count, a high cardinality input keeps the buffer, which needs less memory and no
+// hashing. Percentiles are computed by selection (nth_element) on the buffer, or by a single
+// sort of the distinct values of the map, for all requested quantiles at once.
 class Counts {
 public:
+    // The buffer is checked for duplicates every time it doubles starting from this size.
+    static constexpr size_t FIRST_CARDINALITY_CHECK = 4096;
+    // The buffer is converted to a map if there are at least this many values per distinct value.
+    static constexpr size_t MIN_DUPLICATES_FOR_MAP = 4;
+
     Counts() = default;
 
+    bool empty() const { return _values.empty() && _counts.empty(); }
+
     inline void merge(const Counts* other) {
-        if (other == nullptr || other->_counts.empty()) {
+        if (other == nullptr || other->empty()) {
             return;
         }
-
-        for (auto& cell : other->_counts) {
-            increment(cell.first, cell.second);
+        if (!_use_map && !other->_use_map) {
+            _values.insert(_values.end(), other->_values.begin(), other->_values.end());
+            _maybe_convert_to_map();
+            return;
+        }
+        _convert_to_map();
+        if (other->_use_map) {
+            _counts.reserve(_counts.size() + other->_counts.size());
+            for (const auto& cell : other->_counts) {
+                _counts[cell.first] += cell.second;
+            }
+        } else {
+            for (int64_t value : other->_values) {
+                ++_counts[value];
+            }
         }
     }
 
     void increment(int64_t key, uint32_t i) {
-        auto item = _counts.find(key);
-        if (item != _counts.end()) {
-            item->second += i;
-        } else {
-            _counts.emplace(std::make_pair(key, i));
+        if (!_use_map && i == 1) {
+            _values.push_back(key);
+            _maybe_convert_to_map();
+            return;
         }
+        _convert_to_map();
+        _counts[key] += i;
     }
 
+    // Append a batch of values, each with count 1.
+    void increment_batch(const int64_t* keys, size_t num) {
+        if (_use_map) {
+            for (size_t i = 0; i < num; ++i) {
+                ++_counts[keys[i]];
+            }
+            return;
+        }
+        _values.insert(_values.end(), keys, keys + num);
+        _maybe_convert_to_map();
+    }
+
+    // The original format: uint32 number of distinct values, followed by (int64 value,
+    // uint32 count) pairs.
     uint32_t serialized_size() const {
-        return sizeof(uint32_t) + sizeof(int64_t) * _counts.size() +
-               sizeof(uint32_t) * _counts.size();
+        const size_t size = _distinct_pairs().size();
+        return sizeof(uint32_t) + sizeof(int64_t) * size + sizeof(uint32_t) * size;
     }
 
     void serialize(uint8_t* writer) const {
-        uint32_t size = _counts.size();
+        auto pairs = _distinct_pairs();
+        uint32_t size = pairs.size();
         memcpy(writer, &size, sizeof(uint32_t));
         writer += sizeof(uint32_t);
-        for (auto& cell : _counts) {
+        for (auto& cell : pairs) {
             memcpy(writer, &cell.first, sizeof(int64_t));
             writer += sizeof(int64_t);
             memcpy(writer, &cell.second, sizeof(uint32_t));
@@ -77,62 +121,215 @@ public:
             type_reader += sizeof(int64_t);
             memcpy(&count, type_reader, sizeof(uint32_t));
             type_reader += sizeof(uint32_t);
-            _counts.emplace(std::make_pair(key, count));
+            increment(key, count);
         }
     }
 
-    double get_percentile(std::vector<std::pair<int64_t, uint32_t>>& counts,
-                          double position) const {
-        long lower = std::floor(position);
-        long higher = std::ceil(position);
-
-        auto iter = counts.begin();
-        for (; iter != counts.end() && iter->second < lower + 1; ++iter)
-            ;
-
-        int64_t lower_key = iter->first;
-        if (higher == lower) {
-            return lower_key;
+    // The compact format: uint8 mode and uint32 size, followed by the raw buffered values,
+    // or by the distinct values and then their counts in map mode.
+    uint32_t compact_serialized_size() const {
+        if (_use_map) {
+            return sizeof(uint8_t) + sizeof(uint32_t) +
+                   (sizeof(int64_t) + sizeof(uint32_t)) * _counts.size();
         }
+        return sizeof(uint8_t) + sizeof(uint32_t) + sizeof(int64_t) * _values.size();
+    }
 
-        if (iter->second < higher + 1) {
-            iter++;
+    void compact_serialize(uint8_t* writer) const {
+        uint8_t mode = _use_map;
+        memcpy(writer, &mode, sizeof(uint8_t));
+        writer += sizeof(uint8_t);
+        uint32_t size = _use_map ? _counts.size() : _values.size();
+        memcpy(writer, &size, sizeof(uint32_t));
+        writer += sizeof(uint32_t);
+        if (!_use_map) {
+            memcpy(writer, _values.data(), sizeof(int64_t) * size);
+            return;
         }
+        auto* keys = writer;
+        auto* counts = writer + sizeof(int64_t) * size;
+        for (const auto& cell : _counts) {
+            memcpy(keys, &cell.first, sizeof(int64_t));
+            keys += sizeof(int64_t);
+            memcpy(counts, &cell.second, sizeof(uint32_t));
+            counts += sizeof(uint32_t);
+        }
+    }
 
-        int64_t higher_key = iter->first;
-        if (lower_key == higher_key) {
-            return lower_key;
+    void compact_unserialize(const uint8_t* type_reader) {
+        uint8_t mode;
+        memcpy(&mode, type_reader, sizeof(uint8_t));
+        type_reader += sizeof(uint8_t);
+        uint32_t size;
+        memcpy(&size, type_reader, sizeof(uint32_t));
+        type_reader += sizeof(uint32_t);
+        if (mode == 0) {
+            const size_t old_size = _values.size();
+            _values.resize(old_size + size);
+            memcpy(_values.data() + old_size, type_reader, sizeof(int64_t) * size);
+            _maybe_convert_to_map();
+            return;
+        }
+        _convert_to_map();
+        _counts.reserve(_counts.size() + size);
+        const auto* keys = type_reader;
+        const auto* counts = type_reader + sizeof(int64_t) * size;
+        for (uint32_t i = 0; i < size; ++i) {
+            int64_t key;
+            uint32_t count;
+            memcpy(&key, keys, sizeof(int64_t));
+            keys += sizeof(int64_t);
+            memcpy(&count, counts, sizeof(uint32_t));
+            counts += sizeof(uint32_t);
+            _counts[key] += count;
         }
+    }
 
-        return (higher - position) * lower_key + (position - lower) * higher_key;
+    double terminate(double quantile) {
+        double result = 0.0;
+        terminate(&quantile, 1, &result);
+        return result;
     }
 
-    double terminate(double quantile) const {
-        if (_counts.empty()) {
+    // Compute the percentile of every quantile in `quantiles` into `results`. The selection
+    // reorders the buffered values in place, whose order is meaningless, instead of a copy.
+    void terminate(const double* quantiles, size_t num, double* results) {
+        if (empty()) {
             // Although set null here, but the value is 0.0 and the call method just
             // get val in aggregate_function_percentile_approx.h
-            return 0.0;
+            std::fill(results, results + num, 0.0);
+            return;
+        }
+        if (_use_map) {
+            _terminate_map(quantiles, num, results);
+        } else {
+            _terminate_buffer(quantiles, num, results);
+        }
+    }
+
+    void clear() {
+        _values.clear();
+        _counts.clear();
+        _use_map = false;
+        _next_cardinality_check = FIRST_CARDINALITY_CHECK;
+    }
+
+private:
+    struct Position {
+        double position;
+        size_t lower;
+        size_t higher;
+    };
+
+    static Position _position(double quantile, size_t total) {
+        const double position = static_cast<double>(total - 1) * quantile;
+        const auto max_rank = static_cast<double>(total - 1);
+        return {position, static_cast<size_t>(std::clamp(std::floor(position), 0.0, max_rank)),
+                static_cast<size_t>(std::clamp(std::ceil(position), 0.0, max_rank))};
+    }
+
+    static double _interpolate(const Position& pos, int64_t lower_key, int64_t higher_key) {
+        if (pos.higher == pos.lower || lower_key == higher_key) {
+            return lower_key;
         }
+        return (pos.higher - pos.position) * lower_key + (pos.position - pos.lower) * higher_key;
+    }
 
-        std::vector<std::pair<int64_t, uint32_t>> elems(_counts.begin(), _counts.end());
-        sort(elems.begin(), elems.end(),
-             [](const std::pair<int64_t, uint32_t> l, const std::pair<int64_t, uint32_t> r) {
-                 return l.first < r.first;
-             });
+    void _terminate_buffer(const double* quantiles, size_t num, double* results) {
+        std::vector<Position> positions(num);
+        std::vector<size_t> ranks;
+        ranks.reserve(num * 2);
+        for (size_t i = 0; i < num; ++i) {
+            positions[i] = _position(quantiles[i], _values.size());
+            ranks.push_back(positions[i].lower);
+            ranks.push_back(positions[i].higher);
+        }
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
 
-        long total = 0;
+        // Select the ranks in ascending order, each selection leaves only larger values after
+        // the selected one, so the next selection only scans the remaining range.
+        auto* values = _values.data();
+        const size_t size = _values.size();
+        size_t from = 0;
+        for (size_t rank : ranks) {
+            std::nth_element(values + from, values + rank, values + size);
+            from = rank + 1;
+        }
+        for (size_t i = 0; i < num; ++i) {
+            results[i] = _interpolate(positions[i], values[positions[i].lower],
+                                      values[positions[i].higher]);
+        }
+    }
+
+    void _terminate_map(const double* quantiles, size_t num, double* results) const {
+        std::vector<std::pair<int64_t, uint64_t>> elems(_counts.begin(), _counts.end());
+        pdqsort(elems.begin(), elems.end(),
+                [](const auto& l, const auto& r) { return l.first < r.first; });
+        uint64_t total = 0;
         for (auto& cell : elems) {
             total += cell.second;
             cell.second = total;
         }
+        // The value of the `rank`-th smallest element, the first with accumulated count > rank.
+        auto value_at = [&](size_t rank) {
+            return std::upper_bound(elems.begin(), elems.end(), rank,
+                                    [](size_t r, const auto& cell) { return r < cell.second; })
+                    ->first;
+        };
+        for (size_t i = 0; i < num; ++i) {
+            auto pos = _position(quantiles[i], total);
+            results[i] = _interpolate(pos, value_at(pos.lower), value_at(pos.higher));
+        }
+    }
 
-        long max_position = total - 1;
-        double position = max_position * quantile;
-        return get_percentile(elems, position);
+    std::vector<std::pair<int64_t, uint32_t>> _distinct_pairs() const {
+        if (_use_map) {
+            return {_counts.begin(), _counts.end()};
+        }
+        std::vector<std::pair<int64_t, uint32_t>> pairs;
+        std::vector<int64_t> sorted(_values);
+        pdqsort(sorted.begin(), sorted.end());
+        for (int64_t value : sorted) {
+            if (pairs.empty() || pairs.back().first != value) {
+                pairs.emplace_back(value, 0);
+            }
+            ++pairs.back().second;
+        }
+        return pairs;
     }
 
-private:
-    std::unordered_map<int64_t, uint32_t> _counts;
+    void _maybe_convert_to_map() {
+        if (_values.size() < _next_cardinality_check) {
+            return;
+        }
+        _next_cardinality_check = _values.size() * 2;
+        // Sorting is not wasted when the buffer is kept, finalize then selects on sorted ranges.
+        pdqsort(_values.begin(), _values.end());
+        size_t distinct = 1;
+        for (size_t i = 1; i < _values.size(); ++i) {
+            distinct += _values[i] != _values[i - 1];
+        }
+        if (distinct * MIN_DUPLICATES_FOR_MAP <= _values.size()) {
+            _convert_to_map();
+        }
+    }
+
+    void _convert_to_map() {
+        if (_use_map) {
+            return;
+        }
+        _use_map = true;
+        for (int64_t value : _values) {
+            ++_counts[value];
+        }
+        std::vector<int64_t>().swap(_values);
+    }
+
+    std::vector<int64_t> _values;
+    phmap::flat_hash_map<int64_t, uint32_t> _counts;
+    bool _use_map = false;
+    size_t _next_cardinality_check = FIRST_CARDINALITY_CHECK;
 };
 
 } // namespace doris
@@ -73,9 +73,12 @@
 #include <algorithm>
 #include <cctype>
 #include <charconv>
+#include <cstring>
 #include <limits>
+#include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "common/compiler_util.h" // IWYU pragma: keep
 
@@ -88,7 +91,10 @@ namespace doris {
 #endif
 #pragma pack(push, 1)
 
+// Documents without indexed containers (see ContainerVal) keep version 1, so that they can
+// still be read by older versions.
 #define JSONB_VER 1
+#define JSONB_VER_INDEXED 2
 
 using int128_t = __int128;
 
@@ -834,26 +840,66 @@ private:
 /*
  * ContainerVal is the base class (derived from JsonbValue) for object and
  * array types. The size_ indicates the total bytes of the payload_.
+ *
+ * ** Indexed containers **
+ * Large containers (in documents of version JSONB_VER_INDEXED) are followed
+ * by an index, which is flagged by the highest bit of size_:
+ *
+ * indexed_object ::= key_value_list int32[n] (int32 int32)[n] int32
+ *   the offsets of the key-value pairs in the payload, then the (hash of the
+ *   key, position of the pair) sorted by hash, and the number of pairs n.
+ * indexed_array ::= value_list int32[n] int32
+ *   the offsets of the values in the payload, and the number of values n.
+ *
+ * The index is not part of the key/value list, so iterators are not aware of
+ * it.
  */
 class ContainerVal : public JsonbValue {
 public:
+    static const uint32_t sIndexedFlag = 1U << 31;
+    // Containers with fewer elements are searched linearly.
+    static const uint32_t sMinIndexedElems = 16;
+
     // size of the container payload only
-    unsigned int getContainerSize() const { return size_; }
+    unsigned int getContainerSize() const { return size_ & ~sIndexedFlag; }
 
     // return the container payload as byte array
     const char* getPayload() const { return payload_; }
 
     // size of the total packed bytes
-    unsigned int numPackedBytes() const { return sizeof(JsonbValue) + sizeof(size_) + size_; }
+    unsigned int numPackedBytes() const {
+        return sizeof(JsonbValue) + sizeof(size_) + getContainerSize();
+    }
+
+    bool isIndexed() const { return size_ & sIndexedFlag; }
     friend class JsonbDocument;
 
 protected:
+    // i-th uint32 of the index, counted backwards from the element count which is the 0-th
+    uint32_t indexEntry(uint32_t i) const {
+        uint32_t entry;
+        memcpy(&entry, payload_ + getContainerSize() - (i + 1) * sizeof(uint32_t),
+               sizeof(uint32_t));
+        return entry;
+    }
+
+    uint32_t indexedNumElem() const { return indexEntry(0); }
+
     uint32_t size_;
     char payload_[0];
 
     ContainerVal();
 };
 
+// Hash of the keys in the index of objects, it is persisted, so it must never change.
+inline uint32_t jsonbKeyHash(const char* key, unsigned int klen) {
+    uint32_t hash = 2166136261U; // FNV-1a
+    for (unsigned int i = 0; i < klen; ++i) {
+        hash = (hash ^ (uint8_t)key[i]) * 16777619U;
+    }
+    return hash;
+}
+
 /*
  * Object type
  */
@@ -896,7 +942,7 @@ public:
         if (key_id < 0 || key_id > JsonbKeyValue::sMaxKeyId) return end();
 
         const char* pch = payload_;
-        const char* fence = payload_ + size_;
+        const char* fence = payload_ + elementsSize();
 
         while (pch < fence) {
             JsonbKeyValue* pkey = (JsonbKeyValue*)(pch);
@@ -912,6 +958,9 @@ public:
 
     // Get number of elements in object
     int numElem() const {
+        if (isIndexed()) {
+            return indexedNumElem();
+        }
         const char* pch = payload_;
         const char* fence = payload_ + size_;
 
@@ -928,6 +977,10 @@ public:
     }
 
     JsonbKeyValue* getJsonbKeyValue(unsigned int i) const {
+        if (isIndexed()) {
+            const uint32_t num = indexedNumElem();
+            return i < num ? (JsonbKeyValue*)(payload_ + offsetAt(num, i)) : nullptr;
+        }
         const char* pch = payload_;
         const char* fence = payload_ + size_;
 
@@ -977,12 +1030,52 @@ public:
 
     const_iterator begin() const { return const_iterator((pointer)payload_); }
 
-    iterator end() { return iterator((pointer)(payload_ + size_)); }
+    iterator end() { return iterator((pointer)(payload_ + elementsSize())); }
+
+    const_iterator end() const { return const_iterator((pointer)(payload_ + elementsSize())); }
 
-    const_iterator end() const { return const_iterator((pointer)(payload_ + size_)); }
+    // Bytes of the index for an object of `num` key-value pairs.
+    static uint32_t indexSize(uint32_t num) { return (3 * num + 1) * sizeof(uint32_t); }
 
 private:
+    // size of the key-value pairs, without the index
+    unsigned int elementsSize() const {
+        return isIndexed() ? getContainerSize() - indexSize(indexedNumElem()) : size_;
+    }
+
+    // offset of the i-th key-value pair in the payload
+    uint32_t offsetAt(uint32_t num, uint32_t i) const { return indexEntry(3 * num - i); }
+
+    iterator indexedSearch(const char* key, unsigned int klen) {
+        const uint32_t num = indexedNumElem();
+        const uint32_t hash = jsonbKeyHash(key, klen);
+        // (hash, position) pairs sorted by hash, the first pair is the (2 * num)-th entry.
+        auto hash_at = [&](uint32_t i) { return indexEntry(2 * num - 2 * i); };
+        uint32_t lo = 0;
+        uint32_t hi = num;
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            if (hash_at(mid) < hash) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        // Pairs with the same hash are sorted by position, so a duplicate key finds the first.
+        for (; lo < num && hash_at(lo) == hash; ++lo) {
+            const uint32_t pos = indexEntry(2 * num - 2 * lo - 1);
+            auto* pkey = (JsonbKeyValue*)(payload_ + offsetAt(num, pos));
+            if (klen == pkey->klen() && strncmp(key, pkey->getKeyStr(), klen) == 0) {
+                return iterator(pkey);
+            }
+        }
+        return end();
+    }
+
     iterator internalSearch(const char* key, unsigned int klen) {
+        if (isIndexed()) {
+            return indexedSearch(key, klen);
+        }
         const char* pch = payload_;
         const char* fence = payload_ + size_;
 
@@ -1011,6 +1104,10 @@ public:
     // get the JSONB value at index
     JsonbValue* get(int idx) const {
         if (idx < 0) return nullptr;
+        if (isIndexed()) {
+            const uint32_t num = indexedNumElem();
+            return (uint32_t)idx < num ? (JsonbValue*)(payload_ + indexEntry(num - idx)) : nullptr;
+        }
 
         const char* pch = payload_;
         const char* fence = payload_ + size_;
@@ -1023,6 +1120,9 @@ public:
 
     // Get number of elements in array
     int numElem() const {
+        if (isIndexed()) {
+            return indexedNumElem();
+        }
         const char* pch = payload_;
         const char* fence = payload_ + size_;
 
@@ -1047,14 +1147,48 @@ public:
 
     const_iterator begin() const { return const_iterator((pointer)payload_); }
 
-    iterator end() { return iterator((pointer)(payload_ + size_)); }
+    iterator end() { return iterator((pointer)(payload_ + elementsSize())); }
 
-    const_iterator end() const { return const_iterator((pointer)(payload_ + size_)); }
+    const_iterator end() const { return const_iterator((pointer)(payload_ + elementsSize())); }
+
+    // Bytes of the index for an array of `num` values.
+    static uint32_t indexSize(uint32_t num) { return (num + 1) * sizeof(uint32_t); }
 
 private:
+    // size of the values, without the index
+    unsigned int elementsSize() const {
+        return isIndexed() ? getContainerSize() - indexSize(indexedNumElem()) : size_;
+    }
+
     ArrayVal();
 };
 
+// Whether the value is or holds an indexed container, which needs a JSONB_VER_INDEXED document.
+inline bool hasIndexedContainer(const JsonbValue* value) {
+    if (value->isObject()) {
+        const auto* object = (const ObjectVal*)value;
+        if (object->isIndexed()) {
+            return true;
+        }
+        for (auto it = object->begin(); it != object->end(); ++it) {
+            if (hasIndexedContainer(it->value())) {
+                return true;
+            }
+        }
+    } else if (value->isArray()) {
+        const auto* array = (const ArrayVal*)value;
+        if (array->isIndexed()) {
+            return true;
+        }
+        for (auto it = array->begin(); it != array->end(); ++it) {
+            if (hasIndexedContainer(&*it)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 // Prepare an empty document
 // input: pb - buuffer/packed bytes for jsonb document
 //        size - size of the buffer
@@ -1097,8 +1231,8 @@ inline JsonbDocument* JsonbDocument::makeDocument(char* pb, uint32_t size, const
         return nullptr;
     }
     JsonbDocument* doc = (JsonbDocument*)pb;
-    // Write header
-    doc->header_.ver_ = JSONB_VER;
+    // Write header, the version only changes if the value holds indexed containers.
+    doc->header_.ver_ = hasIndexedContainer(rval) ? JSONB_VER_INDEXED : JSONB_VER;
     // get the starting byte of the value
     JsonbValue* value = doc->getValue();
     // binary copy of the rval
@@ -1114,7 +1248,7 @@ inline JsonbDocument* JsonbDocument::createDocument(const char* pb, uint32_t siz
     }
 
     JsonbDocument* doc = (JsonbDocument*)pb;
-    if (doc->header_.ver_ != JSONB_VER) {
+    if (doc->header_.ver_ != JSONB_VER && doc->header_.ver_ != JSONB_VER_INDEXED) {
         return nullptr;
     }
 
@@ -1136,7 +1270,7 @@ inline JsonbValue* JsonbDocument::createValue(const char* pb, uint32_t size) {
     }
 
     JsonbDocument* doc = (JsonbDocument*)pb;
-    if (doc->header_.ver_ != JSONB_VER) {
+    if (doc->header_.ver_ != JSONB_VER && doc->header_.ver_ != JSONB_VER_INDEXED) {
         return nullptr;
     }
 
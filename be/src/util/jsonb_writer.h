@@ -36,10 +36,15 @@
 #ifndef JSONB_JSONBWRITER_H
 #define JSONB_JSONBWRITER_H
 
+#include <algorithm>
 #include <limits>
 #include <stack>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "common/config.h"
 #include "jsonb_document.h"
 #include "jsonb_stream.h"
 
@@ -110,6 +115,9 @@ public:
     uint32_t writeValue(const JsonbValue* value) {
         if ((first_ && stack_.empty()) || (!stack_.empty() && verifyValueState())) {
             if (!writeFirstHeader()) return 0;
+            if (hasIndexedContainer(value)) {
+                markIndexed();
+            }
             os_->write((char*)value, value->numPackedBytes());
             kvState_ = WS_Value;
             return value->size();
@@ -407,13 +415,7 @@ public:
     bool writeEndObject() {
         if (!stack_.empty() && stack_.top().state == WS_Object && kvState_ == WS_Value) {
             WriteInfo& ci = stack_.top();
-            std::streampos cur_pos = os_->tellp();
-            int32_t size = (int32_t)(cur_pos - ci.sz_pos - sizeof(uint32_t));
-            assert(size >= 0);
-
-            os_->seekp(ci.sz_pos);
-            os_->write((char*)&size, sizeof(uint32_t));
-            os_->seekp(cur_pos);
+            writeEndContainer<ObjectVal>(ci.sz_pos);
             stack_.pop();
 
             return true;
@@ -455,13 +457,7 @@ public:
     bool writeEndArray() {
         if (!stack_.empty() && stack_.top().state == WS_Array && kvState_ == WS_Value) {
             WriteInfo& ci = stack_.top();
-            std::streampos cur_pos = os_->tellp();
-            int32_t size = (int32_t)(cur_pos - ci.sz_pos - sizeof(uint32_t));
-            assert(size >= 0);
-
-            os_->seekp(ci.sz_pos);
-            os_->write((char*)&size, sizeof(uint32_t));
-            os_->seekp(cur_pos);
+            writeEndContainer<ArrayVal>(ci.sz_pos);
             stack_.pop();
 
             return true;
@@ -522,8 +518,78 @@ private:
     }
 
     void writeHeader() {
+        hdr_pos_ = os_->tellp();
         os_->put(JSONB_VER);
         hasHdr_ = true;
+        // Fixed per document, so that all its containers are written alike.
+        indexContainers_ = config::enable_jsonb_container_index;
+    }
+
+    void markIndexed() {
+        std::streampos cur_pos = os_->tellp();
+        os_->seekp(hdr_pos_);
+        os_->put(JSONB_VER_INDEXED);
+        os_->seekp(cur_pos);
+    }
+
+    // Write the size of the container whose size is at `sz_pos`, and its index if it is large
+    // and indexing is enabled.
+    template <class Cont_Type>
+    void writeEndContainer(std::streampos sz_pos) {
+        std::streampos cur_pos = os_->tellp();
+        int32_t size = (int32_t)(cur_pos - sz_pos - sizeof(uint32_t));
+        assert(size >= 0);
+        if (!indexContainers_) {
+            os_->seekp(sz_pos);
+            os_->write((char*)&size, sizeof(uint32_t));
+            os_->seekp(cur_pos);
+            return;
+        }
+
+        offsets_.clear();
+        const char* payload = os_->getBuffer() + (std::streamoff)sz_pos + sizeof(uint32_t);
+        for (int32_t offset = 0; offset < size;) {
+            offsets_.push_back(offset);
+            if constexpr (std::is_same_v<Cont_Type, ObjectVal>) {
+                const auto* pkey = (const JsonbKeyValue*)(payload + offset);
+                if (pkey->klen() == 0) {
+                    // Keys from an external dictionary are not indexed.
+                    offsets_.clear();
+                    break;
+                }
+                offset += pkey->numPackedBytes();
+            } else {
+                offset += ((const JsonbValue*)(payload + offset))->numPackedBytes();
+            }
+        }
+
+        uint32_t packed_size = size;
+        const auto num = (uint32_t)offsets_.size();
+        if (num >= ContainerVal::sMinIndexedElems) {
+            if constexpr (std::is_same_v<Cont_Type, ObjectVal>) {
+                hashes_.clear();
+                for (uint32_t i = 0; i < num; ++i) {
+                    const auto* pkey = (const JsonbKeyValue*)(payload + offsets_[i]);
+                    hashes_.emplace_back(jsonbKeyHash(pkey->getKeyStr(), pkey->klen()), i);
+                }
+                std::sort(hashes_.begin(), hashes_.end());
+                os_->write((char*)offsets_.data(), num * sizeof(uint32_t));
+                for (const auto& [hash, pos] : hashes_) {
+                    os_->write((char*)&hash, sizeof(uint32_t));
+                    os_->write((char*)&pos, sizeof(uint32_t));
+                }
+            } else {
+                os_->write((char*)offsets_.data(), num * sizeof(uint32_t));
+            }
+            os_->write((char*)&num, sizeof(uint32_t));
+            packed_size = (size + Cont_Type::indexSize(num)) | ContainerVal::sIndexedFlag;
+            markIndexed();
+            cur_pos = os_->tellp();
+        }
+
+        os_->seekp(sz_pos);
+        os_->write((char*)&packed_size, sizeof(uint32_t));
+        os_->seekp(cur_pos);
     }
 
 private:
@@ -550,6 +616,11 @@ private:
     std::streampos str_pos_;
     std::stack<WriteInfo> stack_;
     bool first_ = true;
+    std::streampos hdr_pos_ = 0;
+    bool indexContainers_ = false;
+    // Reused to build the index of the containers.
+    std::vector<uint32_t> offsets_;
+    std::vector<std::pair<uint32_t, uint32_t>> hashes_;
 };
 
 typedef JsonbWriterT<JsonbOutStream> JsonbWriter;
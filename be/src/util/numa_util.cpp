@@ -0,0 +1,321 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/numa_util.h"
+
+#include <errno.h>
+#include <glog/logging.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#if defined(OS_LINUX)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+#include "bvar/bvar.h"
+#include "util/cpu_info.h"
+
+namespace doris {
+
+bvar::Adder<int64_t> g_numa_bound_threads("numa_bound_threads");
+bvar::Adder<int64_t> g_numa_interleaved_bytes("numa_interleaved_bytes");
+
+namespace {
+
+#if defined(OS_LINUX)
+// Bitmask of all NUMA nodes, as expected by set_mempolicy/mbind.
+std::vector<unsigned long> all_nodes_mask() {
+    const int num_nodes = CpuInfo::get_max_num_numa_nodes();
+    constexpr int bits = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> mask((num_nodes + bits - 1) / bits, 0);
+    for (int node = 0; node < num_nodes; ++node) {
+        mask[node / bits] |= 1UL << (node % bits);
+    }
+    return mask;
+}
+
+long mbind_interleave(uintptr_t begin, size_t len, unsigned flags) {
+    auto mask = all_nodes_mask();
+    return syscall(SYS_mbind, begin, len, MPOL_INTERLEAVE, mask.data(),
+                   mask.size() * sizeof(unsigned long) * 8, flags);
+}
+#endif
+
+// Nothing of a new mapping is faulted in yet, so no page has to be moved.
+void interleave_mapped(void* buf, size_t size) {
+#if defined(OS_LINUX)
+    if (NumaUtil::is_numa_machine()) {
+        if (mbind_interleave(reinterpret_cast<uintptr_t>(buf), size, 0) != 0) {
+            LOG_EVERY_N(WARNING, 100) << "failed to interleave memory range: " << strerror(errno);
+        } else {
+            g_numa_interleaved_bytes << size;
+        }
+    }
+#endif
+}
+
+} // namespace
+
+bool NumaUtil::is_numa_machine() {
+    return CpuInfo::get_max_num_numa_nodes() > 1;
+}
+
+int NumaUtil::worker_numa_node(size_t worker_index, size_t num_workers) {
+    const int num_nodes = CpuInfo::get_max_num_numa_nodes();
+    if (num_nodes <= 1 || num_workers == 0) {
+        return 0;
+    }
+    return static_cast<int>(worker_index * num_nodes / num_workers);
+}
+
+Status NumaUtil::bind_current_thread_to_node(int node) {
+#if defined(OS_LINUX)
+    if (!is_numa_machine()) {
+        return Status::OK();
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int core : CpuInfo::get_cores_of_numa_node(node)) {
+        CPU_SET(core, &cpu_set);
+    }
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+        return Status::InternalError("failed to bind thread to numa node {}: {}", node,
+                                     strerror(errno));
+    }
+    g_numa_bound_threads << 1;
+#endif
+    return Status::OK();
+}
+
+Status NumaUtil::set_thread_interleave(bool interleave) {
+#if defined(OS_LINUX)
+    if (!is_numa_machine()) {
+        return Status::OK();
+    }
+    long ret = 0;
+    if (interleave) {
+        auto mask = all_nodes_mask();
+        ret = syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, mask.data(),
+                      mask.size() * sizeof(unsigned long) * 8);
+    } else {
+        ret = syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+    }
+    if (ret != 0) {
+        return Status::InternalError("failed to set numa memory policy: {}", strerror(errno));
+    }
+#endif
+    return Status::OK();
+}
+
+NumaInterleaveGuard::NumaInterleaveGuard(bool enable) {
+    if (enable && NumaUtil::is_numa_machine()) {
+        Status st = NumaUtil::set_thread_interleave(true);
+        if (st.ok()) {
+            _enabled = true;
+        } else {
+            LOG_EVERY_N(WARNING, 100) << st;
+        }
+    }
+}
+
+NumaInterleaveGuard::~NumaInterleaveGuard() {
+    if (_enabled) {
+        static_cast<void>(NumaUtil::set_thread_interleave(false));
+    }
+}
+
+NumaInterleavedArena::~NumaInterleavedArena() {
+    for (char* chunk : _chunks) {
+        if (munmap(chunk, CHUNK_SIZE) != 0) {
+            LOG(WARNING) << "failed to unmap numa interleaved memory: " << strerror(errno);
+        }
+    }
+}
+
+NumaInterleavedArena* NumaInterleavedArena::instance() {
+    static NumaInterleavedArena* instance = new NumaInterleavedArena();
+    return instance;
+}
+
+size_t NumaInterleavedArena::block_size(size_t size) {
+    if (size <= MIN_BLOCK_SIZE) {
+        return MIN_BLOCK_SIZE;
+    }
+    // 2^k < size <= 2^(k+1), rounded up to a quarter of 2^k
+    size_t step = (1UL << (63 - __builtin_clzll(size - 1))) / 4;
+    if (size > MAX_BLOCK_SIZE) {
+        step = MIN_BLOCK_SIZE;
+    }
+    return (size + step - 1) & ~(step - 1);
+}
+
+size_t NumaInterleavedArena::_size_class(size_t block_size) {
+    DCHECK(block_size >= MIN_BLOCK_SIZE && block_size <= MAX_BLOCK_SIZE);
+    if (block_size == MIN_BLOCK_SIZE) {
+        return 0;
+    }
+    int k = 63 - __builtin_clzll(block_size - 1);
+    size_t step = (1UL << k) / 4;
+    return 1 + (k - 12) * 4 + ((block_size - (1UL << k)) / step - 1);
+}
+
+NumaInterleavedArena::ChunkHeader* NumaInterleavedArena::_chunk_of(void* buf) {
+    return reinterpret_cast<ChunkHeader*>(reinterpret_cast<uintptr_t>(buf) & ~(CHUNK_SIZE - 1));
+}
+
+void* NumaInterleavedArena::_map(size_t size) {
+    void* buf = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED) {
+        return nullptr;
+    }
+    interleave_mapped(buf, size);
+    _mapped_bytes.fetch_add(size, std::memory_order_relaxed);
+    return buf;
+}
+
+char* NumaInterleavedArena::_map_chunk() {
+    // Twice the size is mapped to carve a chunk aligned to CHUNK_SIZE, so that the chunk of a
+    // block is found from its address.
+    void* buf = mmap(nullptr, 2 * CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                     -1, 0);
+    if (buf == MAP_FAILED) {
+        return nullptr;
+    }
+    auto begin = reinterpret_cast<uintptr_t>(buf);
+    auto chunk = (begin + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
+    if (chunk > begin) {
+        munmap(buf, chunk - begin);
+    }
+    munmap(reinterpret_cast<void*>(chunk + CHUNK_SIZE), begin + CHUNK_SIZE - chunk);
+    interleave_mapped(reinterpret_cast<void*>(chunk), CHUNK_SIZE);
+    _mapped_bytes.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+    new (reinterpret_cast<void*>(chunk)) ChunkHeader();
+    return reinterpret_cast<char*>(chunk);
+}
+
+void NumaInterleavedArena::_release_chunk(char* chunk) {
+    std::lock_guard<std::mutex> l(_chunk_lock);
+    auto it = std::find(_chunks.begin(), _chunks.end(), chunk);
+    // the chunk is released by another free, or blocks are still carved from it
+    if (it == _chunks.end() || (_chunk_pos > chunk && _chunk_pos <= chunk + CHUNK_SIZE)) {
+        return;
+    }
+    std::array<std::unique_lock<std::mutex>, NUM_SIZE_CLASSES> class_locks;
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        class_locks[i] = std::unique_lock<std::mutex>(_classes[i].lock);
+    }
+    // a block may have been taken from the free lists in the meantime
+    if (reinterpret_cast<ChunkHeader*>(chunk)->used_blocks.load() != 0) {
+        return;
+    }
+    for (auto& size_class : _classes) {
+        auto& blocks = size_class.free_blocks;
+        blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+                                    [chunk](void* buf) {
+                                        return reinterpret_cast<char*>(_chunk_of(buf)) == chunk;
+                                    }),
+                     blocks.end());
+    }
+    _chunks.erase(it);
+    if (munmap(chunk, CHUNK_SIZE) != 0) {
+        LOG(WARNING) << "failed to unmap numa interleaved memory: " << strerror(errno);
+    }
+    _mapped_bytes.fetch_sub(CHUNK_SIZE, std::memory_order_relaxed);
+}
+
+void* NumaInterleavedArena::alloc(size_t size) {
+    size_t block = block_size(size);
+    if (block > MAX_BLOCK_SIZE) {
+        return _map(block);
+    }
+    auto& size_class = _classes[_size_class(block)];
+    {
+        std::lock_guard<std::mutex> l(size_class.lock);
+        if (!size_class.free_blocks.empty()) {
+            void* buf = size_class.free_blocks.back();
+            size_class.free_blocks.pop_back();
+            _chunk_of(buf)->used_blocks.fetch_add(1);
+            return buf;
+        }
+    }
+    void* buf = nullptr;
+    char* retired_chunk = nullptr;
+    {
+        std::lock_guard<std::mutex> l(_chunk_lock);
+        if (static_cast<size_t>(_chunk_end - _chunk_pos) < block) {
+            // the rest of the chunk, smaller than MAX_BLOCK_SIZE, is left unused
+            char* chunk = _map_chunk();
+            if (chunk == nullptr) {
+                return nullptr;
+            }
+            if (_chunk_end != nullptr) {
+                retired_chunk = _chunk_end - CHUNK_SIZE;
+            }
+            _chunks.push_back(chunk);
+            _chunk_pos = chunk + MIN_BLOCK_SIZE;
+            _chunk_end = chunk + CHUNK_SIZE;
+        }
+        buf = _chunk_pos;
+        _chunk_pos += block;
+        _chunk_of(buf)->used_blocks.fetch_add(1);
+    }
+    if (retired_chunk != nullptr) {
+        // all the blocks of the chunk may be freed while they were still carved from it
+        _release_chunk(retired_chunk);
+    }
+    return buf;
+}
+
+void NumaInterleavedArena::free(void* buf, size_t size) {
+    size_t block = block_size(size);
+    if (block > MAX_BLOCK_SIZE) {
+        if (munmap(buf, block) != 0) {
+            LOG(WARNING) << "failed to unmap numa interleaved memory: " << strerror(errno);
+        }
+        _mapped_bytes.fetch_sub(block, std::memory_order_relaxed);
+        return;
+    }
+    // Give back the pages fully covered by the block, the interleave policy of the chunk stays
+    // for the pages faulted in again.
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+    auto begin = (reinterpret_cast<uintptr_t>(buf) + page_size - 1) & ~(page_size - 1);
+    auto end = (reinterpret_cast<uintptr_t>(buf) + block) & ~(page_size - 1);
+    if (begin < end && madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED) != 0) {
+        LOG_EVERY_N(WARNING, 100) << "failed to release numa interleaved memory: "
+                                  << strerror(errno);
+    }
+    ChunkHeader* chunk = _chunk_of(buf);
+    bool chunk_unused = false;
+    {
+        auto& size_class = _classes[_size_class(block)];
+        std::lock_guard<std::mutex> l(size_class.lock);
+        size_class.free_blocks.push_back(buf);
+        chunk_unused = chunk->used_blocks.fetch_sub(1) == 1;
+    }
+    if (chunk_unused) {
+        _release_chunk(reinterpret_cast<char*>(chunk));
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,128 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "common/status.h"
+
+namespace doris {
+
+// NUMA memory placement helpers, based on the topology detected by CpuInfo.
+// Use the raw mempolicy syscalls, so there is no dependency on libnuma.
+// All functions are no-op on machines with a single NUMA node.
+class NumaUtil {
+public:
+    // Whether the machine has more than one NUMA node.
+    static bool is_numa_machine();
+
+    // The NUMA node that the i-th of `num_workers` workers belongs to, workers are
+    // split into contiguous groups, one group per node.
+    static int worker_numa_node(size_t worker_index, size_t num_workers);
+
+    // Restrict the current thread to the cores of `node`. Since the default memory policy
+    // is local allocation, memory first touched by the thread is then placed on `node`.
+    static Status bind_current_thread_to_node(int node);
+
+    // Set the memory policy of the current thread to interleave pages over all nodes,
+    // or back to the default local allocation.
+    static Status set_thread_interleave(bool interleave);
+};
+
+// While alive, memory first touched by the current thread is interleaved over all NUMA
+// nodes. Used when building data that is read by tasks running on every node, such as the
+// broadcast hash table shared through SharedHashTableController.
+class NumaInterleaveGuard {
+public:
+    explicit NumaInterleaveGuard(bool enable);
+    ~NumaInterleaveGuard();
+
+    NumaInterleaveGuard(const NumaInterleaveGuard&) = delete;
+    NumaInterleaveGuard& operator=(const NumaInterleaveGuard&) = delete;
+
+private:
+    bool _enabled = false;
+};
+
+// Memory interleaved over all NUMA nodes without a mempolicy syscall per allocation, used for the
+// pages of StoragePageCache. Chunks of CHUNK_SIZE bytes are mapped and interleaved once, before
+// they are touched, so their pages are spread over the nodes as they are faulted in.
+//
+// Allocations are rounded up to size classes, a quarter of their power of two apart and at least
+// a page. The pages of a freed block are given back to the system, and the block is kept for the
+// next allocation of its class. A chunk is unmapped once all its blocks are freed, unless blocks
+// are still carved from it. Allocations larger than MAX_BLOCK_SIZE are mapped on their own and
+// unmapped when freed.
+class NumaInterleavedArena {
+public:
+    static constexpr size_t CHUNK_SIZE = 64UL << 20;
+    static constexpr size_t MAX_BLOCK_SIZE = CHUNK_SIZE / 8;
+
+    NumaInterleavedArena() = default;
+    // Unmaps the chunks, the blocks must not be used anymore.
+    ~NumaInterleavedArena();
+
+    static NumaInterleavedArena* instance();
+
+    // Returns nullptr if the memory can not be mapped. The block is aligned to 1024 bytes.
+    void* alloc(size_t size);
+    void free(void* buf, size_t size);
+
+    // The size of the block an allocation of `size` bytes takes.
+    static size_t block_size(size_t size);
+
+    int64_t mapped_bytes() const { return _mapped_bytes.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t MIN_BLOCK_SIZE = 4096;
+    // MIN_BLOCK_SIZE, then 4 classes for every power of two up to MAX_BLOCK_SIZE
+    static constexpr size_t NUM_SIZE_CLASSES = 1 + (23 - 12) * 4;
+
+    struct SizeClass {
+        std::mutex lock;
+        std::vector<void*> free_blocks;
+    };
+
+    // The first MIN_BLOCK_SIZE bytes of a chunk, which is aligned to CHUNK_SIZE. The count is
+    // changed under the lock of the size class of the block, or under _chunk_lock while blocks
+    // are carved from the chunk.
+    struct ChunkHeader {
+        std::atomic<size_t> used_blocks = 0;
+    };
+
+    static size_t _size_class(size_t block_size);
+    static ChunkHeader* _chunk_of(void* buf);
+    void* _map(size_t size);
+    char* _map_chunk();
+    void _release_chunk(char* chunk);
+
+    std::mutex _chunk_lock;
+    std::vector<char*> _chunks;
+    char* _chunk_pos = nullptr;
+    char* _chunk_end = nullptr;
+    std::array<SizeClass, NUM_SIZE_CLASSES> _classes;
+    std::atomic<int64_t> _mapped_bytes = 0;
+};
+
+} // namespace doris
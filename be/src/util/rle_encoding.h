@@ -19,6 +19,7 @@
 #include <glog/logging.h>
 
 #include <limits> // IWYU pragma: keep
+#include <type_traits>
 
 #include "gutil/port.h"
 #include "util/bit_stream_utils.inline.h"
@@ -358,7 +359,23 @@ size_t RleDecoder<T>::get_values(T* values, size_t num_values) {
             read_num += read_this_time;
         } else if (literal_count_ > 0) {
             read_this_time = std::min((size_t)literal_count_, read_this_time);
-            for (int i = 0; i < read_this_time; ++i) {
+            size_t i = 0;
+            if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8) {
+                // a literal run starts at a byte boundary, read the values up to the next one
+                // by one and unpack the rest in batches
+                for (; i < read_this_time && bit_reader_.position() % 8 != 0; ++i) {
+                    bool result = bit_reader_.GetValue(bit_width_, values++);
+                    DCHECK(result);
+                }
+                if (i < read_this_time && bit_width_ <= sizeof(T) * 8) {
+                    int num_read = bit_reader_.UnpackBatch(
+                            bit_width_, read_this_time - i,
+                            reinterpret_cast<std::make_unsigned_t<T>*>(values));
+                    values += num_read;
+                    i += num_read;
+                }
+            }
+            for (; i < read_this_time; ++i) {
                 bool result = bit_reader_.GetValue(bit_width_, values);
                 DCHECK(result);
                 values++;
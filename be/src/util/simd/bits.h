@@ -55,6 +55,34 @@ inline uint32_t bytes32_mask_to_bits32_mask(const bool* data) {
     return bytes32_mask_to_bits32_mask(reinterpret_cast<const uint8_t*>(data));
 }
 
+/// Transform the 64 bytes from `data` to a 64-bit mask, bit i is set if data[i] == c
+inline uint64_t bytes64_eq_mask(const char* data, char c) {
+#ifdef __AVX2__
+    const auto pattern = _mm256_set1_epi8(c);
+    const auto low = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), pattern)));
+    const auto high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)), pattern)));
+    return low | (static_cast<uint64_t>(high) << 32);
+#elif defined(__SSE2__) || defined(__aarch64__)
+    const auto pattern = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)),
+                        pattern))))
+                << (i * 16);
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < 64; ++i) {
+        mask |= static_cast<uint64_t>(data[i] == c) << i;
+    }
+    return mask;
+#endif
+}
+
 inline size_t count_zero_num(const int8_t* __restrict data, size_t size) {
     size_t num = 0;
     const int8_t* end = data + size;
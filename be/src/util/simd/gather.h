@@ -0,0 +1,58 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "util/sse_util.hpp"
+
+namespace doris {
+namespace simd {
+
+/// out[i] = table[indexes[i]] for i in [0, n), e.g. to decode dictionary indexes into the values
+/// of a column. The indexes must be valid positions of table, they are not checked.
+template <typename T>
+inline void gather(const T* __restrict table, const uint32_t* __restrict indexes, size_t n,
+                   T* __restrict out) {
+    size_t i = 0;
+#ifdef __AVX2__
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 4) {
+        for (; i + 8 <= n; i += 8) {
+            __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indexes + i));
+            _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(out + i),
+                    _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), index, 4));
+        }
+    } else if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 8) {
+        for (; i + 4 <= n; i += 4) {
+            __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indexes + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                _mm256_i32gather_epi64(
+                                        reinterpret_cast<const long long*>(table), index, 8));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = table[indexes[i]];
+    }
+}
+
+} // namespace simd
+} // namespace doris
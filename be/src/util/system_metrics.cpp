@@ -18,6 +18,7 @@
 #include "util/system_metrics.h"
 
 #include <ctype.h>
+#include <fmt/format.h>
 // IWYU pragma: no_include <bthread/errno.h>
 #include <errno.h> // IWYU pragma: keep
 #include <glog/logging.h>
@@ -33,6 +34,7 @@
 
 #include "gutil/strings/split.h" // for string split
 #include "gutil/strtoint.h"      //  for atoi64
+#include "util/cpu_info.h"
 #include "util/mem_info.h"
 #include "util/perf_counters.h"
 
@@ -328,6 +330,38 @@ struct ProcMetrics {
     IntAtomicCounter* proc_procs_blocked;
 };
 
+#define DEFINE_NUMA_COUNTER_METRIC(metric)                                               \
+    DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(numa_##metric, MetricUnit::NOUNIT, "", numa_pages, \
+                                         Labels({{"mode", #metric}}));
+DEFINE_NUMA_COUNTER_METRIC(hit);
+DEFINE_NUMA_COUNTER_METRIC(miss);
+DEFINE_NUMA_COUNTER_METRIC(foreign);
+DEFINE_NUMA_COUNTER_METRIC(interleave_hit);
+DEFINE_NUMA_COUNTER_METRIC(local_node);
+DEFINE_NUMA_COUNTER_METRIC(other_node);
+
+// /sys/devices/system/node/node<N>/numastat, counted in pages.
+// local_node/other_node are the pages allocated by processes running on this node
+// from this node / other nodes, i.e. local vs remote memory.
+struct NumaMetrics {
+    NumaMetrics(MetricEntity* ent) : entity(ent) {
+        INT_ATOMIC_COUNTER_METRIC_REGISTER(entity, numa_hit);
+        INT_ATOMIC_COUNTER_METRIC_REGISTER(entity, numa_miss);
+        INT_ATOMIC_COUNTER_METRIC_REGISTER(entity, numa_foreign);
+        INT_ATOMIC_COUNTER_METRIC_REGISTER(entity, numa_interleave_hit);
+        INT_ATOMIC_COUNTER_METRIC_REGISTER(entity, numa_local_node);
+        INT_ATOMIC_COUNTER_METRIC_REGISTER(entity, numa_other_node);
+    }
+
+    MetricEntity* entity = nullptr;
+    IntAtomicCounter* numa_hit;
+    IntAtomicCounter* numa_miss;
+    IntAtomicCounter* numa_foreign;
+    IntAtomicCounter* numa_interleave_hit;
+    IntAtomicCounter* numa_local_node;
+    IntAtomicCounter* numa_other_node;
+};
+
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(max_disk_io_util_percent, MetricUnit::PERCENT);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(max_network_send_bytes_rate, MetricUnit::BYTES);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(max_network_receive_bytes_rate, MetricUnit::BYTES);
@@ -349,6 +383,7 @@ SystemMetrics::SystemMetrics(MetricRegistry* registry, const std::set<std::strin
     _install_snmp_metrics(_server_entity.get());
     _install_load_avg_metrics(_server_entity.get());
     _install_proc_metrics(_server_entity.get());
+    _install_numa_metrics();
 
     INT_GAUGE_METRIC_REGISTER(_server_entity.get(), max_disk_io_util_percent);
     INT_GAUGE_METRIC_REGISTER(_server_entity.get(), max_network_send_bytes_rate);
@@ -368,6 +403,9 @@ SystemMetrics::~SystemMetrics() {
     for (auto& it : _network_metrics) {
         delete it.second;
     }
+    for (auto& it : _numa_metrics) {
+        delete it.second;
+    }
     if (_line_ptr != nullptr) {
         free(_line_ptr);
     }
@@ -382,6 +420,7 @@ void SystemMetrics::update() {
     _update_snmp_metrics();
     _update_load_avg_metrics();
     _update_proc_metrics();
+    _update_numa_metrics();
 }
 
 void SystemMetrics::_install_cpu_metrics() {
@@ -847,6 +886,48 @@ void SystemMetrics::_update_load_avg_metrics() {
     fclose(fp);
 }
 
+void SystemMetrics::_install_numa_metrics() {
+    if (CpuInfo::get_max_num_numa_nodes() <= 1) {
+        return;
+    }
+    for (int node = 0; node < CpuInfo::get_max_num_numa_nodes(); ++node) {
+        auto node_name = fmt::format("node{}", node);
+        auto numa_entity = _registry->register_entity("numa_" + node_name, {{"node", node_name}});
+        _numa_metrics.emplace(node, new NumaMetrics(numa_entity.get()));
+    }
+}
+
+void SystemMetrics::_update_numa_metrics() {
+    for (auto& [node, metrics] : _numa_metrics) {
+        auto path = fmt::format("/sys/devices/system/node/node{}/numastat", node);
+        FILE* fp = fopen(path.c_str(), "r");
+        if (fp == nullptr) {
+            continue;
+        }
+        char name[64];
+        int64_t value = 0;
+        while (getline(&_line_ptr, &_line_buf_size, fp) > 0) {
+            if (sscanf(_line_ptr, "%63s %" PRId64, name, &value) != 2) {
+                continue;
+            }
+            if (strcmp(name, "numa_hit") == 0) {
+                metrics->numa_hit->set_value(value);
+            } else if (strcmp(name, "numa_miss") == 0) {
+                metrics->numa_miss->set_value(value);
+            } else if (strcmp(name, "numa_foreign") == 0) {
+                metrics->numa_foreign->set_value(value);
+            } else if (strcmp(name, "interleave_hit") == 0) {
+                metrics->numa_interleave_hit->set_value(value);
+            } else if (strcmp(name, "local_node") == 0) {
+                metrics->numa_local_node->set_value(value);
+            } else if (strcmp(name, "other_node") == 0) {
+                metrics->numa_other_node->set_value(value);
+            }
+        }
+        fclose(fp);
+    }
+}
+
 int64_t SystemMetrics::get_max_io_util(const std::map<std::string, int64_t>& lst_value,
                                        int64_t interval_sec) {
     int64_t max = 0;
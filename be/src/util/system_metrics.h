@@ -38,6 +38,7 @@ struct FileDescriptorMetrics;
 struct SnmpMetrics;
 struct LoadAverageMetrics;
 struct ProcMetrics;
+struct NumaMetrics;
 
 class SystemMetrics {
 public:
@@ -90,6 +91,9 @@ private:
     void _install_proc_metrics(MetricEntity* entity);
     void _update_proc_metrics();
 
+    void _install_numa_metrics();
+    void _update_numa_metrics();
+
     void get_metrics_from_proc_vmstat();
     void get_cpu_name();
 
@@ -105,6 +109,7 @@ private:
     int _proc_net_dev_version = 0;
     std::unique_ptr<SnmpMetrics> _snmp_metrics;
     std::unique_ptr<ProcMetrics> _proc_metrics;
+    std::map<int, NumaMetrics*> _numa_metrics;
 
     std::vector<std::string> _cpu_names;
     char* _line_ptr = nullptr;
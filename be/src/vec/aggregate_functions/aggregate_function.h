@@ -48,6 +48,30 @@ using DataTypes = std::vector<DataTypePtr>;
 using AggregateDataPtr = char*;
 using ConstAggregateDataPtr = const char*;
 
+/// Bytes allocated by aggregate states outside of the arena, e.g. by the sets of exact distinct
+/// counting. The states report their allocations to the counter installed on the current thread,
+/// so that the aggregation sink can account for them as revocable memory when it spills.
+class AggregateStateHeapCounter {
+public:
+    class Scope {
+    public:
+        explicit Scope(int64_t* counter) : _old(_current) { _current = counter; }
+        ~Scope() { _current = _old; }
+
+    private:
+        int64_t* _old;
+    };
+
+    static void add(int64_t bytes) {
+        if (_current != nullptr) {
+            *_current += bytes;
+        }
+    }
+
+private:
+    static inline thread_local int64_t* _current = nullptr;
+};
+
 #define SAFE_CREATE(create, destroy) \
     do {                             \
         try {                        \
@@ -66,6 +66,7 @@ struct AggregateFunctionBitmapUnionOp {
 
     static void add_batch(BitmapValue& res, std::vector<const BitmapValue*>& data, bool& is_first) {
         res.fastunion(data);
+        is_first = false;
     }
 
     static void merge(BitmapValue& res, const BitmapValue& data, bool& is_first) {
@@ -154,6 +155,10 @@ class AggregateFunctionBitmapSerializationHelper
 public:
     using BaseHelper = IAggregateFunctionHelper<Derived>;
 
+    // Merging many bitmaps of a union at once with fastunion is much faster than one by one.
+    static constexpr bool is_union =
+            std::is_same_v<Data, AggregateFunctionBitmapData<AggregateFunctionBitmapUnionOp>>;
+
     AggregateFunctionBitmapSerializationHelper(const DataTypes& argument_types_)
             : IAggregateFunctionDataHelper<Data, Derived>(argument_types_) {}
 
@@ -196,6 +201,14 @@ public:
             const size_t num_rows = column.size();
             auto* data = col.get_data().data();
 
+            if constexpr (is_union) {
+                std::vector<const BitmapValue*> values(num_rows);
+                for (size_t i = 0; i != num_rows; ++i) {
+                    values[i] = &data[i];
+                }
+                this->data(place).add_batch(values);
+                return;
+            }
             for (size_t i = 0; i != num_rows; ++i) {
                 this->data(place).merge(data[i]);
             }
@@ -212,6 +225,15 @@ public:
         if (version >= 3) {
             auto& col = assert_cast<const ColumnBitmap&>(column);
             auto* data = col.get_data().data();
+            if constexpr (is_union) {
+                std::vector<const BitmapValue*> values;
+                values.reserve(end - begin + 1);
+                for (size_t i = begin; i <= end; ++i) {
+                    values.push_back(&data[i]);
+                }
+                this->data(place).add_batch(values);
+                return;
+            }
             for (size_t i = begin; i <= end; ++i) {
                 this->data(place).merge(data[i]);
             }
@@ -29,6 +29,7 @@
 #include <string>
 #include <vector>
 
+#include "agent/be_exec_version_manager.h"
 #include "util/counts.h"
 #include "util/tdigest.h"
 #include "vec/aggregate_functions/aggregate_function.h"
@@ -287,12 +288,13 @@ public:
     }
 };
 
+// All quantiles of one group share a single Counts, since every row is added to all of them.
 struct PercentileState {
-    std::vector<Counts> vec_counts;
+    Counts counts;
     std::vector<double> vec_quantile {-1};
     bool inited_flag = false;
 
-    void write(BufferWritable& buf) const {
+    void write(BufferWritable& buf, int be_exec_version) const {
         write_binary(inited_flag, buf);
         int size_num = vec_quantile.size();
         write_binary(size_num, buf);
@@ -300,14 +302,21 @@ struct PercentileState {
             write_binary(quantile, buf);
         }
         std::string serialize_str;
-        for (const auto& counts : vec_counts) {
-            serialize_str.resize(counts.serialized_size(), '0');
-            counts.serialize((uint8_t*)serialize_str.c_str());
+        if (be_exec_version >= COMPACT_PERCENTILE_STATE) {
+            serialize_str.resize(counts.compact_serialized_size(), '0');
+            counts.compact_serialize((uint8_t*)serialize_str.c_str());
+            write_binary(serialize_str, buf);
+            return;
+        }
+        // The old format keeps a copy of the counts per quantile.
+        serialize_str.resize(counts.serialized_size(), '0');
+        counts.serialize((uint8_t*)serialize_str.c_str());
+        for (int i = 0; i < size_num; ++i) {
             write_binary(serialize_str, buf);
         }
     }
 
-    void read(BufferReadable& buf) {
+    void read(BufferReadable& buf, int be_exec_version) {
         read_binary(inited_flag, buf);
         int size_num = 0;
         read_binary(size_num, buf);
@@ -318,26 +327,38 @@ struct PercentileState {
             vec_quantile.emplace_back(data);
         }
         StringRef ref;
-        vec_counts.clear();
-        vec_counts.resize(size_num);
+        counts.clear();
+        if (be_exec_version >= COMPACT_PERCENTILE_STATE) {
+            read_binary(ref, buf);
+            counts.compact_unserialize((uint8_t*)ref.data);
+            return;
+        }
         for (int i = 0; i < size_num; ++i) {
             read_binary(ref, buf);
-            vec_counts[i].unserialize((uint8_t*)ref.data);
+            if (i == 0) {
+                counts.unserialize((uint8_t*)ref.data);
+            }
         }
     }
 
     void add(int64_t source, const PaddedPODArray<Float64>& quantiles, int arg_size) {
         if (!inited_flag) {
-            vec_counts.resize(arg_size);
             vec_quantile.resize(arg_size, -1);
             inited_flag = true;
             for (int i = 0; i < arg_size; ++i) {
                 vec_quantile[i] = quantiles[i];
             }
         }
-        for (int i = 0; i < arg_size; ++i) {
-            vec_counts[i].increment(source, 1);
+        counts.increment(source, 1);
+    }
+
+    void add_batch(const int64_t* sources, size_t num, const PaddedPODArray<Float64>& quantiles,
+                   int arg_size) {
+        if (num == 0) {
+            return;
         }
+        add(sources[0], quantiles, arg_size);
+        counts.increment_batch(sources + 1, num - 1);
     }
 
     void merge(const PercentileState& rhs) {
@@ -346,7 +367,6 @@ struct PercentileState {
         }
         int size_num = rhs.vec_quantile.size();
         if (!inited_flag) {
-            vec_counts.resize(size_num);
             vec_quantile.resize(size_num, -1);
             inited_flag = true;
         }
@@ -355,23 +375,27 @@ struct PercentileState {
             if (vec_quantile[i] == -1.0) {
                 vec_quantile[i] = rhs.vec_quantile[i];
             }
-            vec_counts[i].merge(&(rhs.vec_counts[i]));
         }
+        counts.merge(&rhs.counts);
     }
 
     void reset() {
-        vec_counts.clear();
+        counts.clear();
         vec_quantile.clear();
         inited_flag = false;
     }
 
-    double get() const { return vec_counts[0].terminate(vec_quantile[0]); }
+    // Computing the result reorders the buffered values of `counts`.
+    double get() { return counts.terminate(vec_quantile[0]); }
 
-    void insert_result_into(IColumn& to) const {
+    void insert_result_into(IColumn& to) {
         auto& column_data = assert_cast<ColumnVector<Float64>&>(to).get_data();
-        for (int i = 0; i < vec_counts.size(); ++i) {
-            column_data.push_back(vec_counts[i].terminate(vec_quantile[i]));
+        if (!inited_flag) {
+            return;
         }
+        const size_t old_size = column_data.size();
+        column_data.resize(old_size + vec_quantile.size());
+        counts.terminate(vec_quantile.data(), vec_quantile.size(), column_data.data() + old_size);
     }
 };
 
@@ -394,6 +418,23 @@ public:
                                                      1);
     }
 
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        const auto& sources = assert_cast<const ColumnVector<Int64>&>(*columns[0]);
+        const auto& quantile = assert_cast<const ColumnVector<Float64>&>(*columns[1]);
+        AggregateFunctionPercentile::data(place).add_batch(sources.get_data().data(), batch_size,
+                                                           quantile.get_data(), 1);
+    }
+
+    void add_batch_range(size_t batch_begin, size_t batch_end, AggregateDataPtr place,
+                         const IColumn** columns, Arena*, bool) override {
+        const auto& sources = assert_cast<const ColumnVector<Int64>&>(*columns[0]);
+        const auto& quantile = assert_cast<const ColumnVector<Float64>&>(*columns[1]);
+        AggregateFunctionPercentile::data(place).add_batch(sources.get_data().data() + batch_begin,
+                                                           batch_end - batch_begin + 1,
+                                                           quantile.get_data(), 1);
+    }
+
     void reset(AggregateDataPtr __restrict place) const override {
         AggregateFunctionPercentile::data(place).reset();
     }
@@ -404,17 +445,18 @@ public:
     }
 
     void serialize(ConstAggregateDataPtr __restrict place, BufferWritable& buf) const override {
-        AggregateFunctionPercentile::data(place).write(buf);
+        AggregateFunctionPercentile::data(place).write(buf, version);
     }
 
     void deserialize(AggregateDataPtr __restrict place, BufferReadable& buf,
                      Arena*) const override {
-        AggregateFunctionPercentile::data(place).read(buf);
+        AggregateFunctionPercentile::data(place).read(buf, version);
     }
 
     void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const override {
         auto& col = assert_cast<ColumnVector<Float64>&>(to);
-        col.insert_value(AggregateFunctionPercentile::data(place).get());
+        col.insert_value(
+                AggregateFunctionPercentile::data(const_cast<AggregateDataPtr>(place)).get());
     }
 };
 
@@ -456,12 +498,12 @@ public:
     }
 
     void serialize(ConstAggregateDataPtr __restrict place, BufferWritable& buf) const override {
-        AggregateFunctionPercentileArray::data(place).write(buf);
+        AggregateFunctionPercentileArray::data(place).write(buf, version);
     }
 
     void deserialize(AggregateDataPtr __restrict place, BufferReadable& buf,
                      Arena*) const override {
-        AggregateFunctionPercentileArray::data(place).read(buf);
+        AggregateFunctionPercentileArray::data(place).read(buf, version);
     }
 
     void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const override {
@@ -469,11 +511,12 @@ public:
         auto& to_nested_col = to_arr.get_data();
         if (to_nested_col.is_nullable()) {
             auto col_null = reinterpret_cast<ColumnNullable*>(&to_nested_col);
-            AggregateFunctionPercentileArray::data(place).insert_result_into(
-                    col_null->get_nested_column());
+            AggregateFunctionPercentileArray::data(const_cast<AggregateDataPtr>(place))
+                    .insert_result_into(col_null->get_nested_column());
             col_null->get_null_map_data().resize_fill(col_null->get_nested_column().size(), 0);
         } else {
-            AggregateFunctionPercentileArray::data(place).insert_result_into(to_nested_col);
+            AggregateFunctionPercentileArray::data(const_cast<AggregateDataPtr>(place))
+                    .insert_result_into(to_nested_col);
         }
         to_arr.get_offsets().push_back(to_nested_col.size());
     }
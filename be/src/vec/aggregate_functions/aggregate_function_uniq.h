@@ -28,8 +28,10 @@
 #include <type_traits>
 #include <vector>
 
+#include "agent/be_exec_version_manager.h"
 #include "common/compiler_util.h" // IWYU pragma: keep
 #include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/aggregate_functions/uniq_exact_set.h"
 #include "vec/columns/column.h"
 #include "vec/columns/column_vector.h"
 #include "vec/columns/columns_number.h"
@@ -66,7 +68,7 @@ struct AggregateFunctionUniqExactData {
     using Key = std::conditional_t<is_string_key, UInt128, T>;
     using Hash = std::conditional_t<is_string_key, UInt128TrivialHash, HashCRC32<Key>>;
 
-    using Set = flat_hash_set<Key, Hash>;
+    using Set = UniqExactSet<Key, Hash>;
 
     static UInt128 ALWAYS_INLINE get_key(const StringRef& value) {
         UInt128 key;
@@ -159,71 +161,54 @@ public:
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
                Arena*) const override {
-        auto& rhs_set = this->data(rhs).set;
-        if (rhs_set.size() == 0) return;
-
-        auto& set = this->data(place).set;
-        set.rehash(set.size() + rhs_set.size());
-
-        for (auto elem : rhs_set) {
-            set.insert(elem);
-        }
+        this->data(place).set.merge(this->data(rhs).set);
     }
 
     void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
                                 Arena* arena) const override {
         std::vector<KeyType> keys_container;
         const KeyType* keys = get_keys(keys_container, *columns[0], batch_size);
-        auto& set = this->data(place).set;
-
-        for (size_t i = 0; i != batch_size; ++i) {
-            if (i + HASH_MAP_PREFETCH_DIST < batch_size) {
-                set.prefetch(keys[i + HASH_MAP_PREFETCH_DIST]);
-            }
-            set.insert(keys[i]);
-        }
+        this->data(place).set.insert(keys, batch_size);
     }
 
     void serialize(ConstAggregateDataPtr __restrict place, BufferWritable& buf) const override {
         auto& set = this->data(place).set;
-        write_var_uint(set.size(), buf);
-        for (const auto& elem : set) {
-            write_pod_binary(elem, buf);
+        if (this->version >= COMPACT_UNIQ_EXACT_STATE) {
+            set.write(buf);
+            return;
         }
+        write_var_uint(set.size(), buf);
+        set.for_each([&](const KeyType& elem) { write_pod_binary(elem, buf); });
     }
 
     void deserialize_and_merge(AggregateDataPtr __restrict place, AggregateDataPtr __restrict rhs,
                                BufferReadable& buf, Arena* arena) const override {
-        auto& set = this->data(place).set;
-        UInt64 size;
-        read_var_uint(size, buf);
-
-        set.rehash(size + set.size());
-
-        for (size_t i = 0; i < size; ++i) {
-            KeyType ref;
-            read_pod_binary(ref, buf);
-            set.insert(ref);
-        }
+        read_and_merge(place, buf);
     }
 
     void deserialize(AggregateDataPtr __restrict place, BufferReadable& buf,
                      Arena* arena) const override {
+        read_and_merge(place, buf);
+    }
+
+    void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const override {
+        assert_cast<ColumnInt64&>(to).get_data().push_back(this->data(place).set.size());
+    }
+
+private:
+    void read_and_merge(AggregateDataPtr __restrict place, BufferReadable& buf) const {
         auto& set = this->data(place).set;
+        if (this->version >= COMPACT_UNIQ_EXACT_STATE) {
+            set.read_and_merge(buf);
+            return;
+        }
         UInt64 size;
         read_var_uint(size, buf);
-
-        set.rehash(size + set.size());
-
+        std::vector<KeyType> keys(size);
         for (size_t i = 0; i < size; ++i) {
-            KeyType ref;
-            read_pod_binary(ref, buf);
-            set.insert(ref);
+            read_pod_binary(keys[i], buf);
         }
-    }
-
-    void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const override {
-        assert_cast<ColumnInt64&>(to).get_data().push_back(this->data(place).set.size());
+        set.insert_distinct(keys.data(), keys.size());
     }
 };
 
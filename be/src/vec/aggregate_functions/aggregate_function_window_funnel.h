@@ -79,19 +79,32 @@ struct WindowFunnelState {
     int64_t window;
     WindowFunnelMode window_funnel_mode;
     bool enable_mode;
+    // (first, last) timestamps of the funnel reaching each level, evaluated incrementally while
+    // `events` arrive in order, so a sorted state never needs to be sorted or scanned again.
+    // Only valid while `sorted` is true.
+    std::vector<std::optional<std::pair<DateValueType, DateValueType>>> events_timestamp;
+    bool is_first_set;
+    // The result once later events in order can no longer change it, otherwise -1.
+    int result;
 
     WindowFunnelState() {
         sorted = true;
         max_event_level = 0;
         window = 0;
         window_funnel_mode = WindowFunnelMode::INVALID;
+        is_first_set = false;
+        result = -1;
     }
 
     void reset() {
         sorted = true;
         max_event_level = 0;
         window = 0;
+        events.clear();
         events.shrink_to_fit();
+        events_timestamp.clear();
+        is_first_set = false;
+        result = -1;
     }
 
     void add(const DateValueType& timestamp, int event_idx, int event_num, int64_t win,
@@ -100,6 +113,9 @@ struct WindowFunnelState {
         max_event_level = event_num;
         window_funnel_mode = enable_mode ? mode : WindowFunnelMode::DEFAULT;
 
+        if (is_completed()) {
+            return;
+        }
         if (sorted && events.size() > 0) {
             if (events.back().first == timestamp) {
                 sorted = events.back().second <= event_idx;
@@ -108,6 +124,15 @@ struct WindowFunnelState {
             }
         }
         events.emplace_back(timestamp, event_idx);
+
+        if (sorted) {
+            if (events_timestamp.size() != static_cast<size_t>(max_event_level)) {
+                rebuild();
+            } else {
+                advance(timestamp, event_idx);
+                collapse_if_completed();
+            }
+        }
     }
 
     void sort() {
@@ -115,77 +140,31 @@ struct WindowFunnelState {
             return;
         }
         std::stable_sort(events.begin(), events.end());
+        sorted = true;
+        rebuild();
     }
 
     int get() const {
         if (max_event_level == 0) {
             return 0;
         }
-        std::vector<std::optional<std::pair<DateValueType, DateValueType>>> events_timestamp(
-                max_event_level);
-        bool is_first_set = false;
-        for (int64_t i = 0; i < events.size(); i++) {
-            const int& event_idx = events[i].second;
-            const DateValueType& timestamp = events[i].first;
-            if (event_idx == 0) {
-                events_timestamp[0] = {timestamp, timestamp};
-                is_first_set = true;
-                continue;
-            }
-            if (window_funnel_mode == WindowFunnelMode::DEDUPLICATION &&
-                events_timestamp[event_idx].has_value()) {
-                break;
-            }
-            if (events_timestamp[event_idx - 1].has_value()) {
-                const DateValueType& first_timestamp =
-                        events_timestamp[event_idx - 1].value().first;
-                DateValueType last_timestamp = first_timestamp;
-                TimeInterval interval(SECOND, window, false);
-                last_timestamp.template date_add_interval<SECOND>(interval);
-
-                if (window_funnel_mode != WindowFunnelMode::INCREASE) {
-                    if (timestamp <= last_timestamp) {
-                        events_timestamp[event_idx] = {first_timestamp, timestamp};
-                        if (event_idx + 1 == max_event_level) {
-                            // Usually, max event level is small.
-                            return max_event_level;
-                        }
-                    }
-                } else {
-                    if (timestamp <= last_timestamp &&
-                        events_timestamp[event_idx - 1].value().second < timestamp) {
-                        if (!events_timestamp[event_idx].has_value() ||
-                            events_timestamp[event_idx].value().second > timestamp) {
-                            events_timestamp[event_idx] = {first_timestamp, timestamp};
-                        }
-                        if (event_idx + 1 == max_event_level) {
-                            // Usually, max event level is small.
-                            return max_event_level;
-                        }
-                    }
-                }
-            } else {
-                if (is_first_set && window_funnel_mode == WindowFunnelMode::FIXED) {
-                    for (size_t i = 0; i < events_timestamp.size(); i++) {
-                        if (!events_timestamp[i].has_value()) {
-                            return i;
-                        }
-                    }
-                }
-            }
-        }
-
-        for (int64_t i = events_timestamp.size() - 1; i >= 0; i--) {
-            if (events_timestamp[i].has_value()) {
-                return i + 1;
-            }
-        }
+        DCHECK(sorted);
+        return result >= 0 ? result : highest_level();
+    }
 
-        return 0;
+    // In default mode the result is the length of the longest chain of events with increasing
+    // levels that fits in the window, so adding events never decreases it. Once the funnel
+    // is complete, the state is not changed by any later, earlier or merged event.
+    // The other modes are not monotonic: an earlier event merged in can repeat a level
+    // (deduplication), skip one (fixed) or start a chain that blocks the later one (increase),
+    // so their complete funnels keep all the events.
+    bool is_completed() const {
+        return window_funnel_mode == WindowFunnelMode::DEFAULT && sorted && max_event_level > 1 &&
+               result == max_event_level;
     }
 
     void merge(const WindowFunnelState& other) {
-        if (other.events.empty()) {
+        if (other.events.empty() || is_completed()) {
             return;
         }
 
@@ -212,6 +191,7 @@ struct WindowFunnelState {
             window_funnel_mode = WindowFunnelMode::DEFAULT;
         }
         sorted = true;
+        rebuild();
     }
 
     void write(BufferWritable& out) const {
@@ -254,6 +234,99 @@ struct WindowFunnelState {
             add(time_value, (int)event_idx, max_event_level, window, window_funnel_mode);
         }
     }
+
+private:
+    void advance(const DateValueType& timestamp, int event_idx) {
+        if (result >= 0) {
+            return;
+        }
+        if (event_idx == 0) {
+            events_timestamp[0] = {timestamp, timestamp};
+            is_first_set = true;
+            return;
+        }
+        if (window_funnel_mode == WindowFunnelMode::DEDUPLICATION &&
+            events_timestamp[event_idx].has_value()) {
+            result = highest_level();
+            return;
+        }
+        if (events_timestamp[event_idx - 1].has_value()) {
+            const DateValueType& first_timestamp = events_timestamp[event_idx - 1].value().first;
+            DateValueType last_timestamp = first_timestamp;
+            TimeInterval interval(SECOND, window, false);
+            last_timestamp.template date_add_interval<SECOND>(interval);
+
+            if (window_funnel_mode != WindowFunnelMode::INCREASE) {
+                if (timestamp <= last_timestamp) {
+                    events_timestamp[event_idx] = {first_timestamp, timestamp};
+                    if (event_idx + 1 == max_event_level) {
+                        // Usually, max event level is small.
+                        result = max_event_level;
+                    }
+                }
+            } else {
+                if (timestamp <= last_timestamp &&
+                    events_timestamp[event_idx - 1].value().second < timestamp) {
+                    if (!events_timestamp[event_idx].has_value() ||
+                        events_timestamp[event_idx].value().second > timestamp) {
+                        events_timestamp[event_idx] = {first_timestamp, timestamp};
+                    }
+                    if (event_idx + 1 == max_event_level) {
+                        // Usually, max event level is small.
+                        result = max_event_level;
+                    }
+                }
+            }
+        } else {
+            if (is_first_set && window_funnel_mode == WindowFunnelMode::FIXED) {
+                for (size_t i = 0; i < events_timestamp.size(); i++) {
+                    if (!events_timestamp[i].has_value()) {
+                        result = i;
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    int highest_level() const {
+        for (int64_t i = events_timestamp.size() - 1; i >= 0; i--) {
+            if (events_timestamp[i].has_value()) {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    // Evaluate the sorted `events` from scratch.
+    void rebuild() {
+        events_timestamp.assign(max_event_level, std::nullopt);
+        is_first_set = false;
+        result = -1;
+        for (const auto& [timestamp, event_idx] : events) {
+            advance(timestamp, event_idx);
+            if (result >= 0) {
+                break;
+            }
+        }
+        collapse_if_completed();
+    }
+
+    // Replace the buffered events of a complete funnel by the shortest chain that completes
+    // it: the first event at the start of the funnel, all the others at its end.
+    void collapse_if_completed() {
+        if (!is_completed() || events.size() == static_cast<size_t>(max_event_level)) {
+            return;
+        }
+        auto [first_timestamp, last_timestamp] = events_timestamp[max_event_level - 1].value();
+        events.clear();
+        events.shrink_to_fit();
+        events.reserve(max_event_level);
+        events.emplace_back(first_timestamp, 0);
+        for (int i = 1; i < max_event_level; i++) {
+            events.emplace_back(last_timestamp, i);
+        }
+    }
 };
 
 template <typename DateValueType, typename NativeType>
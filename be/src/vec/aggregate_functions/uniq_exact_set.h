@@ -0,0 +1,270 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <pdqsort.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "common/compiler_util.h" // IWYU pragma: keep
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/common/hash_table/hash.h"
+#include "vec/common/hash_table/phmap_fwd_decl.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/io/io_helper.h"
+#include "vec/io/var_int.h"
+
+namespace doris::vectorized {
+
+/// Allocator of the sets held by aggregate states, reports the memory to AggregateStateHeapCounter.
+template <typename T>
+class AggregateStateAllocator : public Allocator_<T> {
+public:
+    AggregateStateAllocator() = default;
+
+    template <typename T_>
+    AggregateStateAllocator(const AggregateStateAllocator<T_>&) {};
+
+    T* allocate(size_t n) {
+        AggregateStateHeapCounter::add(n * sizeof(T));
+        return Allocator_<T>::allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        AggregateStateHeapCounter::add(-static_cast<int64_t>(n * sizeof(T)));
+        Allocator_<T>::deallocate(p, n);
+    }
+
+    friend bool operator==(const AggregateStateAllocator&, const AggregateStateAllocator&) {
+        return true;
+    }
+};
+
+/// The set of exact distinct counting.
+///
+/// Starts as a single hash set. Once it holds TWO_LEVEL_THRESHOLD elements it is split into
+/// NUM_BUCKETS sets by the high bits of the hash, two sets are then merged bucket by bucket, and
+/// each bucket merge only touches a cache-friendly fraction of the set. The buckets are merged
+/// serially: a group state is merged by the pipeline task that owns the group, and the second
+/// phase already runs the groups in parallel across the instances the keys are shuffled to.
+///
+/// The serialized form is sorted: integer keys are written as variable length deltas, which
+/// packs dense ids such as user ids into one or two bytes each, other keys as a raw array.
+template <typename Key, typename Hash>
+class UniqExactSet {
+public:
+    using Set = flat_hash_set<Key, Hash, phmap::EqualTo<Key>, AggregateStateAllocator<Key>>;
+
+    static constexpr size_t NUM_BUCKETS_BITS = 4;
+    static constexpr size_t NUM_BUCKETS = 1 << NUM_BUCKETS_BITS;
+    static constexpr size_t TWO_LEVEL_THRESHOLD = 1 << 16;
+
+    size_t size() const {
+        if (!is_two_level()) {
+            return _single.size();
+        }
+        size_t size = 0;
+        for (const auto& bucket : *_buckets) {
+            size += bucket.size();
+        }
+        return size;
+    }
+
+    bool is_two_level() const { return _buckets != nullptr; }
+
+    void ALWAYS_INLINE prefetch(const Key& key) const {
+        if (!is_two_level()) {
+            _single.prefetch(key);
+        } else {
+            (*_buckets)[bucket_of(key)].prefetch(key);
+        }
+    }
+
+    void ALWAYS_INLINE insert(const Key& key) {
+        if (!is_two_level()) {
+            _single.insert(key);
+            if (UNLIKELY(_single.size() >= TWO_LEVEL_THRESHOLD)) {
+                convert_to_two_level();
+            }
+        } else {
+            (*_buckets)[bucket_of(key)].insert(key);
+        }
+    }
+
+    /// Insert a batch of keys. The keys of a column may repeat a lot, the set grows with the
+    /// distinct ones instead of being reserved for the whole batch.
+    void insert(const Key* keys, size_t num) {
+        for (size_t i = 0; i != num; ++i) {
+            if (i + HASH_MAP_PREFETCH_DIST < num) {
+                prefetch(keys[i + HASH_MAP_PREFETCH_DIST]);
+            }
+            insert(keys[i]);
+        }
+    }
+
+    /// Insert a batch of keys distinct from each other, e.g. read from a serialized set, the set
+    /// is reserved for all of them.
+    void insert_distinct(const Key* keys, size_t num) {
+        reserve(size() + num);
+        insert(keys, num);
+    }
+
+    void merge(const UniqExactSet& rhs) {
+        if (rhs.size() == 0) {
+            return;
+        }
+        if (!rhs.is_two_level()) {
+            reserve(size() + rhs._single.size());
+            for (const auto& key : rhs._single) {
+                insert(key);
+            }
+            return;
+        }
+        convert_to_two_level();
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            merge_bucket(rhs, i);
+        }
+    }
+
+    template <typename Func>
+    void for_each(Func&& func) const {
+        if (!is_two_level()) {
+            std::for_each(_single.begin(), _single.end(), func);
+            return;
+        }
+        for (const auto& bucket : *_buckets) {
+            std::for_each(bucket.begin(), bucket.end(), func);
+        }
+    }
+
+    void write(BufferWritable& buf) const {
+        std::vector<Key> keys;
+        keys.reserve(size());
+        for_each([&](const Key& key) { keys.push_back(key); });
+        write_var_uint(keys.size(), buf);
+        if constexpr (use_delta_encoding) {
+            std::vector<UInt64> values(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                values[i] = to_ordered(keys[i]);
+            }
+            pdqsort(values.begin(), values.end());
+            UInt64 prev = 0;
+            for (auto value : values) {
+                write_var_uint(value - prev, buf);
+                prev = value;
+            }
+        } else {
+            buf.write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(Key));
+        }
+    }
+
+    /// Read a set written by `write` and insert its elements.
+    void read_and_merge(BufferReadable& buf) {
+        UInt64 size = 0;
+        read_var_uint(size, buf);
+        std::vector<Key> keys(size);
+        if constexpr (use_delta_encoding) {
+            UInt64 value = 0;
+            for (size_t i = 0; i < size; ++i) {
+                UInt64 delta = 0;
+                read_var_uint(delta, buf);
+                value += delta;
+                keys[i] = from_ordered(value);
+            }
+        } else {
+            buf.read(reinterpret_cast<char*>(keys.data()), size * sizeof(Key));
+        }
+        insert_distinct(keys.data(), keys.size());
+    }
+
+private:
+    static constexpr bool use_delta_encoding = std::is_integral_v<Key> && sizeof(Key) <= 8;
+
+    using UnsignedKey = std::make_unsigned_t<std::conditional_t<use_delta_encoding, Key, Int64>>;
+
+    /// Map the key to an unsigned integer preserving the order, so sorted keys have small deltas.
+    static UInt64 to_ordered(Key key) {
+        auto value = static_cast<UnsignedKey>(key);
+        if constexpr (std::is_signed_v<Key>) {
+            value ^= UnsignedKey(1) << (sizeof(Key) * 8 - 1);
+        }
+        return value;
+    }
+
+    static Key from_ordered(UInt64 value) {
+        auto key = static_cast<UnsignedKey>(value);
+        if constexpr (std::is_signed_v<Key>) {
+            key ^= UnsignedKey(1) << (sizeof(Key) * 8 - 1);
+        }
+        return static_cast<Key>(key);
+    }
+
+    /// Merge the `bucket`-th bucket of `rhs`, both sets must be two level.
+    void merge_bucket(const UniqExactSet& rhs, size_t bucket) {
+        DCHECK(is_two_level() && rhs.is_two_level());
+        auto& set = (*_buckets)[bucket];
+        const auto& rhs_set = (*rhs._buckets)[bucket];
+        set.reserve(set.size() + rhs_set.size());
+        for (const auto& key : rhs_set) {
+            set.insert(key);
+        }
+    }
+
+    /// Use the high bits of a multiplicative hash, independent of the bits used inside the sets.
+    static size_t bucket_of(const Key& key) {
+        return (UInt64(Hash()(key)) * 0x9E3779B97F4A7C15ULL) >> (64 - NUM_BUCKETS_BITS);
+    }
+
+    void reserve(size_t size) {
+        if (!is_two_level() && size >= TWO_LEVEL_THRESHOLD) {
+            convert_to_two_level();
+        }
+        if (!is_two_level()) {
+            _single.reserve(size);
+        } else {
+            for (auto& bucket : *_buckets) {
+                bucket.reserve(std::max(bucket.size(), size / NUM_BUCKETS));
+            }
+        }
+    }
+
+    void convert_to_two_level() {
+        if (is_two_level()) {
+            return;
+        }
+        _buckets = std::make_unique<std::array<Set, NUM_BUCKETS>>();
+        for (auto& bucket : *_buckets) {
+            bucket.reserve(_single.size() / NUM_BUCKETS);
+        }
+        for (const auto& key : _single) {
+            (*_buckets)[bucket_of(key)].insert(key);
+        }
+        Set().swap(_single);
+    }
+
+    Set _single;
+    std::unique_ptr<std::array<Set, NUM_BUCKETS>> _buckets;
+};
+
+} // namespace doris::vectorized
@@ -75,7 +75,7 @@ public:
         }
 
         if constexpr (std::is_same_v<T, BitmapValue>) {
-            pvalue->deserialize(pos);
+            pvalue->deserialize_frozen(pos, length);
         } else if constexpr (std::is_same_v<T, HyperLogLog>) {
             pvalue->deserialize(Slice(pos, length));
         } else if constexpr (std::is_same_v<T, QuantileState>) {
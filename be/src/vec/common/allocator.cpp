@@ -29,6 +29,7 @@
 // Allocator is used by too many files. For compilation speed, put dependencies in `.cpp` as much as possible.
 #include "runtime/fragment_mgr.h"
 #include "runtime/memory/mem_tracker_limiter.h"
+#include "runtime/memory/recycled_buffer_pool.h"
 #include "runtime/memory/thread_mem_tracker_mgr.h"
 #include "runtime/thread_context.h"
 #include "util/defer_op.h"
@@ -195,6 +196,45 @@ void Allocator<clear_memory_, mmap_populate, use_mmap>::throw_bad_alloc(
     throw doris::Exception(doris::ErrorCode::MEM_ALLOC_FAILED, err);
 }
 
+static doris::RecycledBufferPool* thread_buffer_pool() {
+    if (!doris::config::enable_query_buffer_pool || !doris::is_thread_context_init()) {
+        return nullptr;
+    }
+    auto* tracker = doris::thread_context()->thread_mem_tracker();
+    return tracker == nullptr ? nullptr : tracker->buffer_pool();
+}
+
+template <bool clear_memory_, bool mmap_populate, bool use_mmap>
+void* Allocator<clear_memory_, mmap_populate, use_mmap>::mmap_alloc(size_t size) {
+    const bool recyclable = doris::RecycledBufferPool::is_poolable_size(size);
+    if (recyclable) {
+        if (auto* pool = thread_buffer_pool(); pool != nullptr) {
+            if (void* buf = pool->acquire(size); buf != nullptr) {
+                if constexpr (clear_memory) memset(buf, 0, size);
+                return buf;
+            }
+        }
+    }
+    void* buf = mmap(nullptr, size, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+    /// No need for zero-fill, because mmap guarantees it.
+    if (recyclable && MAP_FAILED != buf) {
+        doris::RecycledBufferPool::advise(buf, size);
+    }
+    return buf;
+}
+
+template <bool clear_memory_, bool mmap_populate, bool use_mmap>
+void Allocator<clear_memory_, mmap_populate, use_mmap>::mmap_free(void* buf, size_t size) {
+    if (doris::RecycledBufferPool::is_poolable_size(size)) {
+        if (auto* pool = thread_buffer_pool(); pool != nullptr && pool->release(buf, size)) {
+            return;
+        }
+    }
+    if (0 != munmap(buf, size)) {
+        throw_bad_alloc(fmt::format("Allocator: Cannot munmap {}.", size));
+    }
+}
+
 template <bool clear_memory_, bool mmap_populate, bool use_mmap>
 void* Allocator<clear_memory_, mmap_populate, use_mmap>::alloc(size_t size, size_t alignment) {
     return alloc_impl(size, alignment);
@@ -100,20 +100,18 @@ public:
         consume_memory(size);
         void* buf;
 
-        if (use_mmap && size >= doris::config::mmap_threshold) {
+        if (is_mmap_size(size)) {
             if (alignment > MMAP_MIN_ALIGNMENT)
                 throw doris::Exception(
                         doris::ErrorCode::INVALID_ARGUMENT,
                         "Too large alignment {}: more than page size when allocating {}.",
                         alignment, size);
 
-            buf = mmap(nullptr, size, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+            buf = mmap_alloc(size);
             if (MAP_FAILED == buf) {
                 release_memory(size);
                 throw_bad_alloc(fmt::format("Allocator: Cannot mmap {}.", size));
             }
-
-            /// No need for zero-fill, because mmap guarantees it.
         } else {
             if (alignment <= MALLOC_MIN_ALIGNMENT) {
                 if constexpr (clear_memory)
@@ -143,10 +141,8 @@ public:
 
     /// Free memory range.
     void free(void* buf, size_t size) {
-        if (use_mmap && size >= doris::config::mmap_threshold) {
-            if (0 != munmap(buf, size)) {
-                throw_bad_alloc(fmt::format("Allocator: Cannot munmap {}.", size));
-            }
+        if (is_mmap_size(size)) {
+            mmap_free(buf, size);
         } else {
             ::free(buf);
         }
@@ -167,7 +163,7 @@ public:
         consume_memory(new_size - old_size);
 
         if (!use_mmap ||
-            (old_size < doris::config::mmap_threshold && new_size < doris::config::mmap_threshold &&
+            (!is_mmap_size(old_size) && !is_mmap_size(new_size) &&
              alignment <= MALLOC_MIN_ALIGNMENT)) {
             /// Resize malloc'd memory region with no special alignment requirement.
             void* new_buf = ::realloc(buf, new_size);
@@ -181,9 +177,9 @@ public:
             if constexpr (clear_memory)
                 if (new_size > old_size)
                     memset(reinterpret_cast<char*>(buf) + old_size, 0, new_size - old_size);
-        } else if (old_size >= doris::config::mmap_threshold &&
-                   new_size >= doris::config::mmap_threshold) {
+        } else if (is_mmap_size(old_size) && is_mmap_size(new_size)) {
             /// Resize mmap'd memory region.
+            /// A recycled buffer is mapped with exactly `old_size`, so it can be remapped too.
             // On apple and freebsd self-implemented mremap used (common/mremap.h)
             buf = clickhouse_mremap(buf, old_size, new_size, MREMAP_MAYMOVE, PROT_READ | PROT_WRITE,
                                     mmap_flags, -1, 0);
@@ -212,9 +208,24 @@ public:
         return buf;
     }
 
+    /// Whether memory of `size` bytes is allocated by mmap rather than malloc.
+    /// Large power-of-two buffers also go through mmap when the query buffer pool is enabled,
+    /// so that they can be recycled, see `RecycledBufferPool`.
+    static bool is_mmap_size(size_t size) {
+        return use_mmap && (size >= doris::config::mmap_threshold ||
+                            (doris::config::enable_query_buffer_pool &&
+                             size >= doris::config::query_buffer_pool_min_bytes &&
+                             (size & (size - 1)) == 0));
+    }
+
 protected:
     static constexpr size_t get_stack_threshold() { return 0; }
 
+    /// mmap a new region or reuse one from the query buffer pool, returns MAP_FAILED on failure.
+    void* mmap_alloc(size_t size);
+    /// munmap a region or keep it in the query buffer pool.
+    void mmap_free(void* buf, size_t size);
+
     static constexpr bool clear_memory = clear_memory_;
 
     // Freshly mmapped pages are copy-on-write references to a global zero page.
@@ -82,6 +82,8 @@ private:
 
     mutable int64_t _compress_time_ns = 0;
 
+    uint64_t _evaluation_id = 0;
+
 public:
     Block() = default;
     Block(std::initializer_list<ColumnWithTypeAndName> il);
@@ -371,6 +373,11 @@ public:
 
     void clear_same_bit() { row_same_bit.clear(); }
 
+    // Identifies one evaluation of the expressions of an operator on the rows of the block, in
+    // which the shared subexpressions are evaluated once, see VSharedExpr. 0 means none.
+    void set_evaluation_id(uint64_t evaluation_id) { _evaluation_id = evaluation_id; }
+    uint64_t evaluation_id() const { return _evaluation_id; }
+
     // return string contains use_count() of each columns
     // for debug purpose.
     std::string print_use_count();
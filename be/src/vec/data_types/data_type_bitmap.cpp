@@ -83,7 +83,7 @@ const char* DataTypeBitMap::deserialize(const char* buf, IColumn* column,
     data.resize(meta_ptr[0]);
     const char* data_ptr = buf + sizeof(size_t) * (meta_ptr[0] + 1);
     for (size_t i = 0; i < meta_ptr[0]; ++i) {
-        data[i].deserialize(data_ptr);
+        data[i].deserialize_frozen(data_ptr, meta_ptr[i + 1]);
         data_ptr += meta_ptr[i + 1];
     }
 
@@ -106,7 +106,7 @@ void DataTypeBitMap::serialize_as_stream(const BitmapValue& cvalue, BufferWritab
 void DataTypeBitMap::deserialize_as_stream(BitmapValue& value, BufferReadable& buf) {
     StringRef ref;
     read_string_binary(ref, buf);
-    value.deserialize(ref.data);
+    value.deserialize_frozen(ref.data, ref.size);
 }
 
 void DataTypeBitMap::to_string(const IColumn& column, size_t row_num, BufferWritable& ostr) const {
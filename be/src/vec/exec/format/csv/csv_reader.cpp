@@ -43,6 +43,7 @@
 #include "runtime/descriptors.h"
 #include "runtime/runtime_state.h"
 #include "runtime/types.h"
+#include "util/simd/bits.h"
 #include "util/string_util.h"
 #include "util/utf8_check.h"
 #include "vec/common/typeid_cast.h"
@@ -87,9 +88,24 @@ void PlainCsvTextFieldSplitter::_split_field_single_char(const Slice& line,
                                                          std::vector<Slice>* splitted_values) {
     const char* data = line.data;
     const size_t size = line.size;
+    const char sep = _value_sep[0];
     size_t value_start = 0;
-    for (size_t i = 0; i < size; ++i) {
-        if (data[i] == _value_sep[0]) {
+    size_t i = 0;
+    // Find the separators of 64 bytes at once, from the bitmask of their positions. Only the
+    // fields of a line are located this way: the line reader already finds the line delimiters
+    // and the enclosed fields, and the fields are deserialized row by row from its buffer.
+    for (; i + 64 <= size; i += 64) {
+        uint64_t mask = simd::bytes64_eq_mask(data + i, sep);
+        while (mask != 0) {
+            const size_t pos = i + __builtin_ctzll(mask);
+            process_value_func(data, value_start, pos - value_start, _trimming_char,
+                               splitted_values);
+            value_start = pos + _value_sep_len;
+            mask &= mask - 1;
+        }
+    }
+    for (; i < size; ++i) {
+        if (data[i] == sep) {
             process_value_func(data, value_start, i - value_start, _trimming_char, splitted_values);
             value_start = i + _value_sep_len;
         }
@@ -29,6 +29,7 @@
 
 #include "exec/decompressor.h"
 #include "io/fs/file_reader.h"
+#include "util/simd/bits.h"
 #include "util/slice.h"
 
 // INPUT_CHUNK must
@@ -99,8 +100,15 @@ const uint8_t* EncloseCsvLineReaderContext::look_for_column_sep_pos(const uint8_
 
     if constexpr (SingleChar) {
         char sep = column_sep[0];
+        size_t i = 0;
         // note(tsy): tests show that simple `for + if` performs better than native memchr or memmem under normal `short feilds` case.
-        for (size_t i = 0; i < curr_len; ++i) {
+        // Long fields are skipped 64 bytes at once, from the bitmask of the separator positions.
+        for (; i + 64 <= curr_len; i += 64) {
+            if (uint64_t mask = simd::bytes64_eq_mask((const char*)curr_start + i, sep)) {
+                return curr_start + i + __builtin_ctzll(mask);
+            }
+        }
+        for (; i < curr_len; ++i) {
             if (curr_start[i] == sep) {
                 return curr_start + i;
             }
@@ -142,10 +150,29 @@ void EncloseCsvLineReaderContext::_on_normal(const uint8_t* start, size_t& len)
     _idx = len;
 }
 
+size_t EncloseCsvLineReaderContext::skip_to_enclose_or_escape(const uint8_t* start,
+                                                              size_t len) const {
+    size_t pos = _idx;
+    for (; pos + 64 <= len; pos += 64) {
+        const auto* data = (const char*)start + pos;
+        if (uint64_t mask = simd::bytes64_eq_mask(data, _enclose) |
+                            simd::bytes64_eq_mask(data, _escape)) {
+            return pos + __builtin_ctzll(mask);
+        }
+    }
+    return pos;
+}
+
 void EncloseCsvLineReaderContext::_on_pre_match_enclose(const uint8_t* start, size_t& len) {
     bool should_escape = false;
     do {
-        do {
+        while (_idx != len) {
+            if (!should_escape) {
+                _idx = skip_to_enclose_or_escape(start, len);
+                if (_idx == len) {
+                    break;
+                }
+            }
             if (start[_idx] == _escape) [[unlikely]] {
                 should_escape = !should_escape;
             } else if (should_escape) [[unlikely]] {
@@ -156,7 +183,7 @@ void EncloseCsvLineReaderContext::_on_pre_match_enclose(const uint8_t* start, si
                 return;
             }
             ++_idx;
-        } while (_idx != len);
+        }
 
         if (_idx != _total_len) {
             len = update_reading_bound(start);
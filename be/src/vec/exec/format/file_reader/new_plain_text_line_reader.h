@@ -140,7 +140,7 @@ public:
         _state.reset();
     }
 
-    [[nodiscard]] inline const std::vector<size_t> column_sep_positions() const {
+    [[nodiscard]] inline const std::vector<size_t>& column_sep_positions() const {
         return _column_sep_positions;
     }
 
@@ -152,6 +152,9 @@ private:
                                                   const char* column_sep, size_t column_sep_len);
 
     size_t update_reading_bound(const uint8_t* start);
+    // The position of the first enclose or escape char from `_idx`, found 64 bytes at once.
+    // The position of the remaining bytes, less than 64, is returned if there is none.
+    size_t skip_to_enclose_or_escape(const uint8_t* start, size_t len) const;
     void on_col_sep_found(const uint8_t* curr_start, const uint8_t* col_sep_pos);
 
     void _on_start(const uint8_t* start, size_t& len);
@@ -21,6 +21,7 @@
 
 #include "util/coding.h"
 #include "util/rle_encoding.h"
+#include "util/simd/gather.h"
 #include "vec/columns/column.h"
 #include "vec/columns/column_dictionary.h"
 #include "vec/columns/column_string.h"
@@ -131,11 +132,10 @@ Status ByteArrayDictDecoder::_decode_values(MutableColumnPtr& doris_column, Data
     while (size_t run_length = select_vector.get_next_run<has_filter>(&read_type)) {
         switch (read_type) {
         case ColumnSelectVector::CONTENT: {
-            std::vector<StringRef> string_values;
-            string_values.reserve(run_length);
-            for (size_t i = 0; i < run_length; ++i) {
-                string_values.emplace_back(_dict_items[_indexes[dict_index++]]);
-            }
+            std::vector<StringRef> string_values(run_length);
+            simd::gather(_dict_items.data(), &_indexes[dict_index], run_length,
+                         string_values.data());
+            dict_index += run_length;
             doris_column->insert_many_strings_overflow(&string_values[0], run_length,
                                                        _max_value_length);
             break;
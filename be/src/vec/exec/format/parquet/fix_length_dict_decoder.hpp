@@ -18,6 +18,7 @@
 #pragma once
 
 #include "util/bit_util.h"
+#include "util/simd/gather.h"
 #include "vec/columns/column_dictionary.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/data_types/data_type_nullable.h"
@@ -102,9 +103,10 @@ protected:
         while (size_t run_length = select_vector.get_next_run<has_filter>(&read_type)) {
             switch (read_type) {
             case ColumnSelectVector::CONTENT: {
-                for (size_t i = 0; i < run_length; ++i) {
-                    data[data_index++] = _dict_items[_indexes[dict_index++]];
-                }
+                simd::gather(_dict_items.data(), &_indexes[dict_index], run_length,
+                             data + data_index);
+                data_index += run_length;
+                dict_index += run_length;
                 break;
             }
             case ColumnSelectVector::NULL_DATA: {
@@ -0,0 +1,88 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/format/parquet/parquet_bloom_filter.h"
+
+#include <gen_cpp/parquet_types.h>
+#include <xxh3.h>
+
+#include <algorithm>
+
+#include "io/fs/file_reader.h"
+#include "util/slice.h"
+#include "util/thrift_util.h"
+
+namespace doris::vectorized {
+
+// The header is a thrift struct of an i32 and three unions of empty structs
+static constexpr size_t MAX_BLOOM_FILTER_HEADER_SIZE = 64;
+
+Status ParquetBloomFilter::read(io::FileReader* file_reader, int64_t offset,
+                                io::IOContext* io_ctx, std::unique_ptr<ParquetBloomFilter>* filter,
+                                size_t* bytes_read) {
+    filter->reset();
+    if (offset <= 0 || static_cast<size_t>(offset) >= file_reader->size()) {
+        return Status::OK();
+    }
+    uint8_t header_buf[MAX_BLOOM_FILTER_HEADER_SIZE];
+    size_t header_read = 0;
+    size_t to_read = std::min<size_t>(MAX_BLOOM_FILTER_HEADER_SIZE, file_reader->size() - offset);
+    RETURN_IF_ERROR(
+            file_reader->read_at(offset, Slice(header_buf, to_read), &header_read, io_ctx));
+    *bytes_read += header_read;
+
+    tparquet::BloomFilterHeader header;
+    uint32_t header_size = header_read;
+    if (!deserialize_thrift_msg(header_buf, &header_size, true, &header).ok() ||
+        !header.algorithm.__isset.BLOCK || !header.hash.__isset.XXHASH ||
+        !header.compression.__isset.UNCOMPRESSED) {
+        return Status::OK();
+    }
+    uint32_t num_bytes = header.numBytes;
+    if (num_bytes < MINIMUM_BYTES || num_bytes > MAXIMUM_BYTES ||
+        (num_bytes & (num_bytes - 1)) != 0 ||
+        offset + header_size + num_bytes > static_cast<int64_t>(file_reader->size())) {
+        return Status::OK();
+    }
+
+    auto bloom_filter = std::make_unique<ParquetBloomFilter>();
+    RETURN_IF_ERROR(bloom_filter->init(num_bytes));
+    size_t bitset_read = 0;
+    RETURN_IF_ERROR(file_reader->read_at(offset + header_size,
+                                         Slice(bloom_filter->data(), num_bytes), &bitset_read,
+                                         io_ctx));
+    *bytes_read += bitset_read;
+    if (bitset_read != num_bytes) {
+        return Status::OK();
+    }
+    *filter = std::move(bloom_filter);
+    return Status::OK();
+}
+
+uint64_t ParquetBloomFilter::hash_plain_value(const std::string& plain_value) {
+    return XXH64(plain_value.data(), plain_value.size(), 0);
+}
+
+void ParquetBloomFilter::add_hash(uint64_t hash) {
+    _add_to_block(_bucket_index(hash), static_cast<uint32_t>(hash));
+}
+
+bool ParquetBloomFilter::test_hash(uint64_t hash) const {
+    return _test_block(_bucket_index(hash), static_cast<uint32_t>(hash));
+}
+
+} // namespace doris::vectorized
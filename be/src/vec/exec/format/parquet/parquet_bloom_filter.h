@@ -0,0 +1,71 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "common/status.h"
+#include "olap/rowset/segment_v2/block_split_bloom_filter.h"
+
+namespace doris {
+namespace io {
+class FileReader;
+struct IOContext;
+} // namespace io
+} // namespace doris
+
+namespace doris::vectorized {
+
+/**
+ * The split block bloom filter of a parquet column chunk, which is stored at the
+ * bloom_filter_offset of the chunk as a BloomFilterHeader followed by the bitset.
+ * It sets the same bits in a block as segment_v2::BlockSplitBloomFilter, but picks the block
+ * of a hash by multiplication instead of masking, and hashes the plain-encoded values by XXH64.
+ * refer: https://github.com/apache/parquet-format/blob/master/BloomFilter.md
+ */
+class ParquetBloomFilter : public segment_v2::BlockSplitBloomFilter {
+public:
+    // Reads the bloom filter at offset. *filter is left null if the filter is malformed, or uses
+    // an algorithm, a hash or a compression that is not supported, only the failures of the
+    // file reader are returned.
+    static Status read(io::FileReader* file_reader, int64_t offset, io::IOContext* io_ctx,
+                       std::unique_ptr<ParquetBloomFilter>* filter, size_t* bytes_read);
+
+    static uint64_t hash_plain_value(const std::string& plain_value);
+
+    void add_hash(uint64_t hash) override;
+    bool test_hash(uint64_t hash) const override;
+
+    void add_plain_value(const std::string& plain_value) {
+        add_hash(hash_plain_value(plain_value));
+    }
+    bool test_plain_value(const std::string& plain_value) const {
+        return test_hash(hash_plain_value(plain_value));
+    }
+
+private:
+    uint32_t _bucket_index(uint64_t hash) const {
+        return static_cast<uint32_t>(((hash >> 32) * (_num_bytes / BYTES_PER_BLOCK)) >> 32);
+    }
+};
+
+} // namespace doris::vectorized
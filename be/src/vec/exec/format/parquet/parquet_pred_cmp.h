@@ -18,6 +18,8 @@
 #pragma once
 
 #include <cstring>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include "cctz/civil_time.h"
@@ -408,6 +410,62 @@ public:
                 col_val_range);
         return need_filter;
     }
+
+    // Appends the plain encoding of the values of an IN or EQ predicate to *values, so that they
+    // can be looked up in a dictionary page or probed in a bloom filter. Returns false if the range
+    // is not a set of fixed values, or the column is converted from its physical type in a way
+    // that the plain encoding of a value is not its identity.
+    static bool get_plain_encoded_values(const ColumnValueRangeType& col_val_range,
+                                         const FieldSchema* col_schema,
+                                         std::vector<std::string>* values) {
+        bool supported = false;
+        std::visit(
+                [&](auto&& range) {
+                    using CppType = typename std::decay_t<decltype(range)>::CppType;
+                    if (!range.is_fixed_value_range() || range.contain_null() ||
+                        range.get_fixed_value_size() == 0) {
+                        return;
+                    }
+                    if constexpr (std::is_same_v<CppType, int8_t> ||
+                                  std::is_same_v<CppType, int16_t> ||
+                                  std::is_same_v<CppType, int32_t>) {
+                        if (col_schema->physical_type != tparquet::Type::INT32 ||
+                            col_schema->type.type != range.type()) {
+                            return;
+                        }
+                        for (const auto& value : range.get_fixed_value_set()) {
+                            int32_t encoded = value;
+                            values->emplace_back(reinterpret_cast<const char*>(&encoded),
+                                                 sizeof(encoded));
+                        }
+                        supported = true;
+                    } else if constexpr (std::is_same_v<CppType, int64_t>) {
+                        if (col_schema->physical_type != tparquet::Type::INT64 ||
+                            col_schema->type.type != range.type()) {
+                            return;
+                        }
+                        for (const auto& value : range.get_fixed_value_set()) {
+                            values->emplace_back(reinterpret_cast<const char*>(&value),
+                                                 sizeof(value));
+                        }
+                        supported = true;
+                    } else if constexpr (std::is_same_v<CppType, StringRef>) {
+                        // the values of a CHAR column are padded
+                        if (range.type() == TYPE_CHAR ||
+                            col_schema->physical_type != tparquet::Type::BYTE_ARRAY ||
+                            (col_schema->type.type != TYPE_STRING &&
+                             col_schema->type.type != TYPE_VARCHAR)) {
+                            return;
+                        }
+                        for (const auto& value : range.get_fixed_value_set()) {
+                            values->emplace_back(value.data, value.size);
+                        }
+                        supported = true;
+                    }
+                },
+                col_val_range);
+        return supported;
+    }
 };
 
 } // namespace doris::vectorized
@@ -22,10 +22,14 @@
 #include <gen_cpp/parquet_types.h>
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <functional>
 #include <ostream>
+#include <string_view>
+#include <unordered_set>
 #include <utility>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "exec/schema_scanner.h"
 #include "gen_cpp/descriptors.pb.h"
@@ -39,14 +43,20 @@
 #include "parquet_thrift_util.h"
 #include "runtime/define_primitive_type.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/types.h"
+#include "util/block_compression.h"
+#include "util/coding.h"
 #include "util/slice.h"
+#include "util/thrift_util.h"
+#include "util/threadpool.h"
 #include "util/timezone_utils.h"
 #include "vec/columns/column.h"
 #include "vec/common/typeid_cast.h"
 #include "vec/core/block.h"
 #include "vec/core/column_with_type_and_name.h"
 #include "vec/core/types.h"
+#include "vec/exec/format/parquet/parquet_bloom_filter.h"
 #include "vec/exec/format/parquet/parquet_common.h"
 #include "vec/exec/format/parquet/schema_desc.h"
 #include "vec/exec/format/parquet/vparquet_file_metadata.h"
@@ -120,6 +130,12 @@ void ParquetReader::_init_profile() {
 
         _parquet_profile.filtered_row_groups = ADD_CHILD_COUNTER_WITH_LEVEL(
                 _profile, "FilteredGroups", TUnit::UNIT, parquet_profile, 1);
+        _parquet_profile.filtered_row_groups_by_min_max = ADD_CHILD_COUNTER_WITH_LEVEL(
+                _profile, "FilteredGroupsByMinMax", TUnit::UNIT, parquet_profile, 1);
+        _parquet_profile.filtered_row_groups_by_dict = ADD_CHILD_COUNTER_WITH_LEVEL(
+                _profile, "FilteredGroupsByDict", TUnit::UNIT, parquet_profile, 1);
+        _parquet_profile.filtered_row_groups_by_bloom_filter = ADD_CHILD_COUNTER_WITH_LEVEL(
+                _profile, "FilteredGroupsByBloomFilter", TUnit::UNIT, parquet_profile, 1);
         _parquet_profile.to_read_row_groups = ADD_CHILD_COUNTER_WITH_LEVEL(
                 _profile, "ReadGroups", TUnit::UNIT, parquet_profile, 1);
         _parquet_profile.filtered_group_rows = ADD_CHILD_COUNTER_WITH_LEVEL(
@@ -170,6 +186,12 @@ void ParquetReader::_init_profile() {
                 ADD_CHILD_TIMER_WITH_LEVEL(_profile, "DecodeLevelTime", parquet_profile, 1);
         _parquet_profile.decode_null_map_time =
                 ADD_CHILD_TIMER_WITH_LEVEL(_profile, "DecodeNullMapTime", parquet_profile, 1);
+        // the time the scanner waits for the file, and the time it spends on the rest of reading
+        // the columns, which tell whether the scan is bound by IO or by CPU
+        _parquet_profile.io_wait_time =
+                ADD_CHILD_TIMER_WITH_LEVEL(_profile, "IOWaitTime", parquet_profile, 1);
+        _parquet_profile.decode_time =
+                ADD_CHILD_TIMER_WITH_LEVEL(_profile, "DecodeTime", parquet_profile, 1);
     }
 }
 
@@ -180,8 +202,19 @@ Status ParquetReader::close() {
 
 void ParquetReader::_close_internal() {
     if (!_closed) {
+        int64_t prefetch_wait_time = 0;
+        if (_row_group_prefetcher != nullptr) {
+            _row_group_prefetcher->close();
+            prefetch_wait_time = _row_group_prefetcher->statistics().wait_time;
+        }
         if (_profile != nullptr) {
             COUNTER_UPDATE(_parquet_profile.filtered_row_groups, _statistics.filtered_row_groups);
+            COUNTER_UPDATE(_parquet_profile.filtered_row_groups_by_min_max,
+                           _statistics.filtered_row_groups_by_min_max);
+            COUNTER_UPDATE(_parquet_profile.filtered_row_groups_by_dict,
+                           _statistics.filtered_row_groups_by_dict);
+            COUNTER_UPDATE(_parquet_profile.filtered_row_groups_by_bloom_filter,
+                           _statistics.filtered_row_groups_by_bloom_filter);
             COUNTER_UPDATE(_parquet_profile.to_read_row_groups, _statistics.read_row_groups);
             COUNTER_UPDATE(_parquet_profile.filtered_group_rows, _statistics.filtered_group_rows);
             COUNTER_UPDATE(_parquet_profile.filtered_page_rows, _statistics.filtered_page_rows);
@@ -216,6 +249,11 @@ void ParquetReader::_close_internal() {
                            _column_statistics.decode_level_time);
             COUNTER_UPDATE(_parquet_profile.decode_null_map_time,
                            _column_statistics.decode_null_map_time);
+            COUNTER_UPDATE(_parquet_profile.io_wait_time,
+                           _column_statistics.read_time + prefetch_wait_time);
+            COUNTER_UPDATE(_parquet_profile.decode_time,
+                           std::max<int64_t>(0, _statistics.column_read_time -
+                                                        _column_statistics.read_time));
         }
         _closed = true;
     }
@@ -610,6 +648,14 @@ Status ParquetReader::_next_row_group_reader() {
         // InMemoryFileReader has the ability to merge small IO
         group_file_reader = _file_reader;
     } else {
+        if (!_row_group_prefetcher_inited) {
+            _init_row_group_prefetcher(row_group_index);
+        }
+        if (_row_group_prefetcher != nullptr) {
+            RETURN_IF_ERROR(_row_group_prefetcher->next_group(&group_file_reader));
+        }
+    }
+    if (group_file_reader == nullptr) {
         size_t avg_io_size = 0;
         const std::vector<io::PrefetchRange> io_ranges =
                 _generate_random_access_ranges(row_group_index, &avg_io_size);
@@ -630,6 +676,61 @@ Status ParquetReader::_next_row_group_reader() {
                                        _slot_id_to_filter_conjuncts);
 }
 
+void ParquetReader::_init_row_group_prefetcher(const RowGroupReader::RowGroupIndex& first_group) {
+    _row_group_prefetcher_inited = true;
+    // Reading ahead pays off only when the file is remote and there is a next row group to
+    // overlap with. The count push down reads no column at all.
+    if (!config::enable_parquet_prefetch || _read_row_groups.empty() ||
+        _system_properties.system_type == TFileType::FILE_LOCAL ||
+        _push_down_agg_type == TPushAggOp::type::COUNT ||
+        ExecEnv::GetInstance()->buffered_reader_prefetch_thread_pool() == nullptr) {
+        return;
+    }
+    _row_group_prefetcher = std::make_unique<io::RowGroupPrefetcher>(
+            _profile, _file_reader, config::parquet_prefetch_budget_bytes, _io_ctx);
+    // the groups are added in the order _next_row_group_reader() takes them
+    _row_group_prefetcher->add_group(_generate_prefetch_ranges(first_group));
+    for (const auto& row_group_index : _read_row_groups) {
+        _row_group_prefetcher->add_group(_generate_prefetch_ranges(row_group_index));
+    }
+    _row_group_prefetcher->start();
+}
+
+std::vector<io::PrefetchRange> ParquetReader::_generate_prefetch_ranges(
+        const RowGroupReader::RowGroupIndex& group) {
+    PageIndex page_index;
+    if (_may_filter_pages() &&
+        _has_page_index(_t_metadata->row_groups[group.row_group_id].columns, page_index)) {
+        // an empty group is read by the decoder directly
+        return {};
+    }
+    size_t avg_io_size = 0;
+    return _generate_random_access_ranges(group, &avg_io_size, _lazy_read_ctx.can_lazy_read);
+}
+
+void ParquetReader::prefetch_footer(const TFileScanRangeParams& params,
+                                    const TFileRangeDesc& range, FileMetaCache* meta_cache) {
+    auto* pool = ExecEnv::GetInstance()->buffered_reader_prefetch_thread_pool();
+    auto file_type = range.__isset.file_type ? range.file_type : params.file_type;
+    if (meta_cache == nullptr || pool == nullptr || file_type == TFileType::FILE_LOCAL) {
+        return;
+    }
+    // the task owns copies of the params and the range, it may outlive the scanner
+    auto st = pool->submit_func([params, range, meta_cache]() {
+        ParquetReader reader(params, range, nullptr, nullptr, false);
+        reader._meta_cache = meta_cache;
+        auto st = reader._open_file();
+        if (!st.ok() && !st.is<ErrorCode::END_OF_FILE>()) {
+            LOG(INFO) << "failed to prefetch the footer of " << range.path << ": "
+                      << st.to_string();
+        }
+    });
+    if (!st.ok()) {
+        LOG(INFO) << "failed to submit the footer prefetch of " << range.path << ": "
+                  << st.to_string();
+    }
+}
+
 Status ParquetReader::_init_row_groups(const bool& is_filter_groups) {
     SCOPED_RAW_TIMER(&_statistics.row_group_filter_time);
     if (is_filter_groups && (_total_groups == 0 || _t_metadata->num_rows == 0 || _range_size < 0)) {
@@ -689,7 +790,7 @@ Status ParquetReader::_init_row_groups(const bool& is_filter_groups) {
 }
 
 std::vector<io::PrefetchRange> ParquetReader::_generate_random_access_ranges(
-        const RowGroupReader::RowGroupIndex& group, size_t* avg_io_size) {
+        const RowGroupReader::RowGroupIndex& group, size_t* avg_io_size, bool skip_lazy_columns) {
     std::vector<io::PrefetchRange> result;
     int64_t last_chunk_end = -1;
     size_t total_io_size = 0;
@@ -719,7 +820,12 @@ std::vector<io::PrefetchRange> ParquetReader::_generate_random_access_ranges(
                 }
             };
     const tparquet::RowGroup& row_group = _t_metadata->row_groups[group.row_group_id];
+    const auto& lazy_columns = _lazy_read_ctx.lazy_read_columns;
     for (const auto& read_col : _read_columns) {
+        if (skip_lazy_columns &&
+            std::find(lazy_columns.begin(), lazy_columns.end(), read_col) != lazy_columns.end()) {
+            continue;
+        }
         const FieldSchema* field = _file_metadata->schema().get_column(read_col);
         scalar_range(field, row_group);
     }
@@ -743,6 +849,11 @@ bool ParquetReader::_is_misaligned_range_group(const tparquet::RowGroup& row_gro
     return false;
 }
 
+bool ParquetReader::_may_filter_pages() const {
+    return !_lazy_read_ctx.has_complex_type && !_lazy_read_ctx.conjuncts.empty() &&
+           _colname_to_value_range != nullptr && !_colname_to_value_range->empty();
+}
+
 bool ParquetReader::_has_page_index(const std::vector<tparquet::ColumnChunk>& columns,
                                     PageIndex& page_index) {
     return page_index.check_and_get_page_index_ranges(columns);
@@ -760,8 +871,7 @@ Status ParquetReader::_process_page_index(const tparquet::RowGroup& row_group,
         _statistics.read_rows += row_group.num_rows;
     };
 
-    if (_lazy_read_ctx.has_complex_type || _lazy_read_ctx.conjuncts.empty() ||
-        _colname_to_value_range == nullptr || _colname_to_value_range->empty()) {
+    if (!_may_filter_pages()) {
         read_whole_row_group();
         return Status::OK();
     }
@@ -861,10 +971,20 @@ Status ParquetReader::_process_page_index(const tparquet::RowGroup& row_group,
 Status ParquetReader::_process_row_group_filter(const tparquet::RowGroup& row_group,
                                                 bool* filter_group) {
     static_cast<void>(_process_column_stat_filter(row_group.columns, filter_group));
-    _init_chunk_dicts();
-    RETURN_IF_ERROR(_process_dict_filter(filter_group));
-    _init_bloom_filter();
-    RETURN_IF_ERROR(_process_bloom_filter(filter_group));
+    if (*filter_group) {
+        _statistics.filtered_row_groups_by_min_max++;
+        return Status::OK();
+    }
+    _init_plain_encoded_values();
+    RETURN_IF_ERROR(_process_dict_filter(row_group, filter_group));
+    if (*filter_group) {
+        _statistics.filtered_row_groups_by_dict++;
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_process_bloom_filter(row_group, filter_group));
+    if (*filter_group) {
+        _statistics.filtered_row_groups_by_bloom_filter++;
+    }
     return Status::OK();
 }
 
@@ -911,15 +1031,198 @@ Status ParquetReader::_process_column_stat_filter(const std::vector<tparquet::Co
     return Status::OK();
 }
 
-void ParquetReader::_init_chunk_dicts() {}
+void ParquetReader::_init_plain_encoded_values() {
+    if (_plain_encoded_values_inited) {
+        return;
+    }
+    _plain_encoded_values_inited = true;
+    if (_colname_to_value_range == nullptr || _colname_to_value_range->empty()) {
+        return;
+    }
+    for (auto& col_name : _read_columns) {
+        auto slot_iter = _colname_to_value_range->find(col_name);
+        if (slot_iter == _colname_to_value_range->end()) {
+            continue;
+        }
+        const FieldSchema* col_schema = _file_metadata->schema().get_column(col_name);
+        if (col_schema->physical_column_index < 0) {
+            // complex type, not support filter yet.
+            continue;
+        }
+        std::vector<std::string> values;
+        if (ParquetPredicate::get_plain_encoded_values(slot_iter->second, col_schema, &values)) {
+            _plain_encoded_values.emplace_back(col_schema->physical_column_index,
+                                               std::move(values));
+        }
+    }
+}
+
+bool ParquetReader::_is_dictionary_encoded(const tparquet::ColumnMetaData& column_meta) {
+    if (column_meta.__isset.encoding_stats) {
+        for (const auto& stats : column_meta.encoding_stats) {
+            if ((stats.page_type == tparquet::PageType::DATA_PAGE ||
+                 stats.page_type == tparquet::PageType::DATA_PAGE_V2) &&
+                stats.encoding != tparquet::Encoding::PLAIN_DICTIONARY &&
+                stats.encoding != tparquet::Encoding::RLE_DICTIONARY && stats.count > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Without the encoding stats, the data pages can only be told to be dictionary encoded if no
+    // other encoding of values is used. Parquet 2.0 writers encode the dictionary page by PLAIN,
+    // which can't be told apart from the fallback of the data pages.
+    bool has_dict_encoding = false;
+    for (auto encoding : column_meta.encodings) {
+        if (encoding == tparquet::Encoding::PLAIN_DICTIONARY ||
+            encoding == tparquet::Encoding::RLE_DICTIONARY) {
+            has_dict_encoding = true;
+        } else if (encoding != tparquet::Encoding::RLE &&
+                   encoding != tparquet::Encoding::BIT_PACKED) {
+            // RLE and BIT_PACKED are the encodings of the levels
+            return false;
+        }
+    }
+    return has_dict_encoding;
+}
 
-Status ParquetReader::_process_dict_filter(bool* filter_group) {
+Status ParquetReader::_process_dict_filter(const tparquet::RowGroup& row_group,
+                                          bool* filter_group) {
+    if (!config::enable_parquet_dict_filter) {
+        return Status::OK();
+    }
+    for (const auto& [parquet_col_id, values] : _plain_encoded_values) {
+        const auto& column_meta = row_group.columns[parquet_col_id].meta_data;
+        if (!_is_dictionary_encoded(column_meta)) {
+            continue;
+        }
+        bool contains = true;
+        RETURN_IF_ERROR(_dict_contains_any(column_meta, values, &contains));
+        if (!contains) {
+            *filter_group = true;
+            break;
+        }
+    }
     return Status::OK();
 }
 
-void ParquetReader::_init_bloom_filter() {}
+Status ParquetReader::_dict_contains_any(const tparquet::ColumnMetaData& column_meta,
+                                         const std::vector<std::string>& values, bool* contains) {
+    *contains = true;
+    if (!column_meta.__isset.dictionary_page_offset || column_meta.dictionary_page_offset <= 0 ||
+        column_meta.dictionary_page_offset >= column_meta.data_page_offset ||
+        column_meta.data_page_offset - column_meta.dictionary_page_offset >
+                column_meta.total_compressed_size) {
+        return Status::OK();
+    }
+    // Only the dictionary page is read, which lies before the first data page.
+    size_t dict_size = column_meta.data_page_offset - column_meta.dictionary_page_offset;
+    std::unique_ptr<uint8_t[]> dict_buf(new uint8_t[dict_size]);
+    size_t bytes_read = 0;
+    RETURN_IF_ERROR(_file_reader->read_at(column_meta.dictionary_page_offset,
+                                          Slice(dict_buf.get(), dict_size), &bytes_read,
+                                          _io_ctx));
+    _column_statistics.read_bytes += bytes_read;
+    _column_statistics.meta_read_calls++;
+
+    tparquet::PageHeader header;
+    uint32_t header_size = bytes_read;
+    if (!deserialize_thrift_msg(dict_buf.get(), &header_size, true, &header).ok() ||
+        header.type != tparquet::PageType::DICTIONARY_PAGE ||
+        header.compressed_page_size < 0 || header.uncompressed_page_size < 0 ||
+        header_size + header.compressed_page_size > bytes_read) {
+        return Status::OK();
+    }
+    tparquet::Encoding::type dict_encoding = header.dictionary_page_header.encoding;
+    if (dict_encoding != tparquet::Encoding::PLAIN_DICTIONARY &&
+        dict_encoding != tparquet::Encoding::PLAIN) {
+        return Status::OK();
+    }
+    Slice dict_data(dict_buf.get() + header_size, header.compressed_page_size);
+    std::unique_ptr<uint8_t[]> decompressed_buf;
+    BlockCompressionCodec* codec = nullptr;
+    RETURN_IF_ERROR(get_block_compression_codec(column_meta.codec, &codec));
+    if (codec != nullptr) {
+        SCOPED_RAW_TIMER(&_column_statistics.decompress_time);
+        _column_statistics.decompress_cnt++;
+        decompressed_buf.reset(new uint8_t[header.uncompressed_page_size]);
+        Slice decompressed(decompressed_buf.get(), header.uncompressed_page_size);
+        RETURN_IF_ERROR(codec->decompress(dict_data, &decompressed));
+        dict_data = decompressed;
+    }
 
-Status ParquetReader::_process_bloom_filter(bool* filter_group) {
+    SCOPED_RAW_TIMER(&_column_statistics.decode_dict_time);
+    std::unordered_set<std::string_view> value_set(values.begin(), values.end());
+    int32_t num_values = header.dictionary_page_header.num_values;
+    const char* data = dict_data.data;
+    const char* end = dict_data.data + dict_data.size;
+    if (column_meta.type == tparquet::Type::BYTE_ARRAY) {
+        for (int32_t i = 0; i < num_values; ++i) {
+            if (static_cast<size_t>(end - data) < sizeof(uint32_t)) {
+                return Status::OK();
+            }
+            uint32_t length = decode_fixed32_le(reinterpret_cast<const uint8_t*>(data));
+            data += sizeof(uint32_t);
+            if (static_cast<size_t>(end - data) < length) {
+                return Status::OK();
+            }
+            if (value_set.find(std::string_view(data, length)) != value_set.end()) {
+                return Status::OK();
+            }
+            data += length;
+        }
+    } else {
+        size_t type_length = 0;
+        if (column_meta.type == tparquet::Type::INT32) {
+            type_length = sizeof(int32_t);
+        } else if (column_meta.type == tparquet::Type::INT64) {
+            type_length = sizeof(int64_t);
+        }
+        if (type_length == 0 || num_values < 0 || dict_data.size < num_values * type_length) {
+            return Status::OK();
+        }
+        for (int32_t i = 0; i < num_values; ++i, data += type_length) {
+            if (value_set.find(std::string_view(data, type_length)) != value_set.end()) {
+                return Status::OK();
+            }
+        }
+    }
+    *contains = false;
+    return Status::OK();
+}
+
+Status ParquetReader::_process_bloom_filter(const tparquet::RowGroup& row_group,
+                                           bool* filter_group) {
+    if (!config::enable_parquet_bloom_filter) {
+        return Status::OK();
+    }
+    for (const auto& [parquet_col_id, values] : _plain_encoded_values) {
+        const auto& column_meta = row_group.columns[parquet_col_id].meta_data;
+        if (!column_meta.__isset.bloom_filter_offset) {
+            continue;
+        }
+        std::unique_ptr<ParquetBloomFilter> bloom_filter;
+        size_t bytes_read = 0;
+        RETURN_IF_ERROR(ParquetBloomFilter::read(_file_reader.get(),
+                                                 column_meta.bloom_filter_offset, _io_ctx,
+                                                 &bloom_filter, &bytes_read));
+        _column_statistics.read_bytes += bytes_read;
+        _column_statistics.meta_read_calls++;
+        if (bloom_filter == nullptr) {
+            continue;
+        }
+        bool contains = false;
+        for (const auto& value : values) {
+            if (bloom_filter->test_plain_value(value)) {
+                contains = true;
+                break;
+            }
+        }
+        if (!contains) {
+            *filter_group = true;
+            break;
+        }
+    }
     return Status::OK();
 }
 
@@ -28,6 +28,7 @@
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "common/status.h"
@@ -56,6 +57,7 @@ class TupleDescriptor;
 
 namespace io {
 class FileSystem;
+class RowGroupPrefetcher;
 struct IOContext;
 } // namespace io
 namespace vectorized {
@@ -76,6 +78,9 @@ class ParquetReader : public GenericReader {
 public:
     struct Statistics {
         int32_t filtered_row_groups = 0;
+        int32_t filtered_row_groups_by_min_max = 0;
+        int32_t filtered_row_groups_by_dict = 0;
+        int32_t filtered_row_groups_by_bloom_filter = 0;
         int32_t read_row_groups = 0;
         int64_t filtered_group_rows = 0;
         int64_t filtered_page_rows = 0;
@@ -104,6 +109,11 @@ public:
     // for test
     void set_file_reader(io::FileReaderSPtr file_reader) { _file_reader = file_reader; }
 
+    // Reads the footer of a parquet file into meta_cache in the background, so that the
+    // reader opening the file next does not wait for it.
+    static void prefetch_footer(const TFileScanRangeParams& params, const TFileRangeDesc& range,
+                                FileMetaCache* meta_cache);
+
     Status open();
 
     Status init_reader(
@@ -154,6 +164,9 @@ public:
 private:
     struct ParquetProfile {
         RuntimeProfile::Counter* filtered_row_groups = nullptr;
+        RuntimeProfile::Counter* filtered_row_groups_by_min_max = nullptr;
+        RuntimeProfile::Counter* filtered_row_groups_by_dict = nullptr;
+        RuntimeProfile::Counter* filtered_row_groups_by_bloom_filter = nullptr;
         RuntimeProfile::Counter* to_read_row_groups = nullptr;
         RuntimeProfile::Counter* filtered_group_rows = nullptr;
         RuntimeProfile::Counter* filtered_page_rows = nullptr;
@@ -180,12 +193,15 @@ private:
         RuntimeProfile::Counter* decode_dict_time = nullptr;
         RuntimeProfile::Counter* decode_level_time = nullptr;
         RuntimeProfile::Counter* decode_null_map_time = nullptr;
+        RuntimeProfile::Counter* io_wait_time = nullptr;
+        RuntimeProfile::Counter* decode_time = nullptr;
     };
 
     Status _open_file();
     void _init_profile();
     void _close_internal();
     Status _next_row_group_reader();
+    void _init_row_group_prefetcher(const RowGroupReader::RowGroupIndex& first_group);
     RowGroupReader::PositionDeleteContext _get_position_delete_ctx(
             const tparquet::RowGroup& row_group,
             const RowGroupReader::RowGroupIndex& row_group_index);
@@ -193,6 +209,8 @@ private:
     void _init_system_properties();
     void _init_file_description();
     // Page Index Filter
+    // Whether the predicates may skip pages of the row groups with a page index.
+    bool _may_filter_pages() const;
     bool _has_page_index(const std::vector<tparquet::ColumnChunk>& columns, PageIndex& page_index);
     Status _process_page_index(const tparquet::RowGroup& row_group,
                                std::vector<RowRange>& candidate_row_ranges);
@@ -202,14 +220,23 @@ private:
     Status _process_column_stat_filter(const std::vector<tparquet::ColumnChunk>& column_meta,
                                        bool* filter_group);
     Status _process_row_group_filter(const tparquet::RowGroup& row_group, bool* filter_group);
-    void _init_chunk_dicts();
-    Status _process_dict_filter(bool* filter_group);
-    void _init_bloom_filter();
-    Status _process_bloom_filter(bool* filter_group);
+    void _init_plain_encoded_values();
+    Status _process_dict_filter(const tparquet::RowGroup& row_group, bool* filter_group);
+    // Whether all the data pages of the column chunk are dictionary encoded, so that the
+    // dictionary page holds every value of the chunk.
+    static bool _is_dictionary_encoded(const tparquet::ColumnMetaData& column_meta);
+    Status _dict_contains_any(const tparquet::ColumnMetaData& column_meta,
+                              const std::vector<std::string>& values, bool* contains);
+    Status _process_bloom_filter(const tparquet::RowGroup& row_group, bool* filter_group);
     int64_t _get_column_start_offset(const tparquet::ColumnMetaData& column_init_column_readers);
     std::string _meta_cache_key(const std::string& path) { return "meta_" + path; }
     std::vector<io::PrefetchRange> _generate_random_access_ranges(
-            const RowGroupReader::RowGroupIndex& group, size_t* avg_io_size);
+            const RowGroupReader::RowGroupIndex& group, size_t* avg_io_size,
+            bool skip_lazy_columns = false);
+    // The ranges of the row group read ahead: not the lazy columns, which are only read for the
+    // rows passing the predicates, and nothing when the page index may skip some pages.
+    std::vector<io::PrefetchRange> _generate_prefetch_ranges(
+            const RowGroupReader::RowGroupIndex& group);
 
     RuntimeProfile* _profile = nullptr;
     const TFileScanRangeParams& _scan_params;
@@ -231,6 +258,9 @@ private:
 
     std::shared_ptr<io::FileSystem> _file_system;
     io::FileReaderSPtr _file_reader = nullptr;
+    // reads the row groups ahead of the decoder, null if the file is not read ahead
+    std::unique_ptr<io::RowGroupPrefetcher> _row_group_prefetcher;
+    bool _row_group_prefetcher_inited = false;
     std::unique_ptr<RowGroupReader> _current_group_reader;
     // read to the end of current reader
     bool _row_group_eof = true;
@@ -238,6 +268,10 @@ private:
     // table column name to file column name map. For iceberg schema evolution.
     std::unordered_map<std::string, std::string> _table_col_to_file_col;
     std::unordered_map<std::string, ColumnValueRangeType>* _colname_to_value_range = nullptr;
+    // physical column index -> plain-encoded values of the IN/EQ predicate on the column,
+    // looked up in the dictionary pages and the bloom filters of the row groups
+    std::vector<std::pair<int, std::vector<std::string>>> _plain_encoded_values;
+    bool _plain_encoded_values_inited = false;
     std::vector<std::string> _read_columns;
     RowRange _whole_range = RowRange(0, 0);
     const std::vector<int64_t>* _delete_rows = nullptr;
@@ -0,0 +1,91 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/format/table/iceberg_delete_file_cache.h"
+
+#include "olap/lru_cache.h"
+
+namespace doris::vectorized {
+
+Status IcebergDeleteFileCache::_get_or_load(const std::string& key,
+                                            const Loader<const void>& loader,
+                                            std::shared_ptr<const void>* value, bool* hit) {
+    *hit = false;
+    *value = _lookup(key);
+    if (*value != nullptr) {
+        *hit = true;
+        return Status::OK();
+    }
+
+    std::shared_ptr<std::mutex> load_lock;
+    {
+        std::lock_guard<std::mutex> l(_loading_lock);
+        auto& lock = _loading[key];
+        if (lock == nullptr) {
+            lock = std::make_shared<std::mutex>();
+        }
+        load_lock = lock;
+    }
+    Status st;
+    {
+        std::lock_guard<std::mutex> l(*load_lock);
+        // loaded by the caller holding the lock before
+        *value = _lookup(key);
+        if (*value != nullptr) {
+            *hit = true;
+        } else {
+            size_t charge = 0;
+            st = loader(value, &charge);
+            if (st.ok()) {
+                _insert(key, *value, charge);
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> l(_loading_lock);
+        auto it = _loading.find(key);
+        // nobody else is waiting for the key
+        if (it != _loading.end() && it->second == load_lock && load_lock.use_count() == 2) {
+            _loading.erase(it);
+        }
+    }
+    return st;
+}
+
+std::shared_ptr<const void> IcebergDeleteFileCache::_lookup(const std::string& key) {
+    Cache::Handle* handle = cache()->lookup(key);
+    if (handle == nullptr) {
+        return nullptr;
+    }
+    std::shared_ptr<const void> value =
+            *reinterpret_cast<std::shared_ptr<const void>*>(cache()->value(handle));
+    cache()->release(handle);
+    return value;
+}
+
+void IcebergDeleteFileCache::_insert(const std::string& key, std::shared_ptr<const void> value,
+                                     size_t charge) {
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        delete reinterpret_cast<std::shared_ptr<const void>*>(value);
+    };
+    Cache::Handle* handle =
+            cache()->insert(key, new std::shared_ptr<const void>(std::move(value)), charge,
+                            deleter, CachePriority::NORMAL);
+    cache()->release(handle);
+}
+
+} // namespace doris::vectorized
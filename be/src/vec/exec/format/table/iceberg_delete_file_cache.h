@@ -0,0 +1,94 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/status.h"
+#include "runtime/exec_env.h"
+#include "runtime/memory/lru_cache_policy.h"
+
+namespace doris::vectorized {
+
+// The rows of the iceberg delete files, shared by the scanners of all queries, so that a delete
+// file referenced by many data files is read once. The loaded values are immutable and handed
+// out as shared pointers, which keep them alive after they are evicted. The capacity is the
+// memory the values take, config::iceberg_delete_file_cache_limit.
+class IcebergDeleteFileCache : public LRUCachePolicy {
+public:
+    template <typename T>
+    using Loader = std::function<Status(std::shared_ptr<T>* value, size_t* charge)>;
+
+    // Create global instance of this class
+    static IcebergDeleteFileCache* create_global_cache(size_t capacity, uint32_t num_shards = 16) {
+        return new IcebergDeleteFileCache(capacity, num_shards);
+    }
+
+    // Return global instance, which is null if the ExecEnv is not initialized.
+    static IcebergDeleteFileCache* instance() {
+        return ExecEnv::GetInstance()->get_iceberg_delete_file_cache();
+    }
+
+    IcebergDeleteFileCache(size_t capacity, uint32_t num_shards)
+            : LRUCachePolicy(CachePolicy::CacheType::ICEBERG_DELETE_FILE_CACHE, capacity,
+                             LRUCacheType::SIZE,
+                             config::iceberg_delete_file_cache_stale_sweep_time_sec, num_shards) {}
+
+    // Gets the value of key, which is loaded by loader if it is not cached. The concurrent
+    // callers of a key wait for the one loading it instead of loading it again.
+    template <typename T>
+    Status get_or_load(const std::string& key, const Loader<T>& loader,
+                       std::shared_ptr<const T>* value, bool* hit) {
+        std::shared_ptr<const void> cached;
+        RETURN_IF_ERROR(_get_or_load(
+                key,
+                [&loader](std::shared_ptr<const void>* loaded, size_t* charge) {
+                    std::shared_ptr<T> typed;
+                    RETURN_IF_ERROR(loader(&typed, charge));
+                    *loaded = std::move(typed);
+                    return Status::OK();
+                },
+                &cached, hit));
+        *value = std::static_pointer_cast<const T>(cached);
+        return Status::OK();
+    }
+
+    int64_t mem_consumption() { return cache()->mem_consumption(); }
+
+private:
+    Status _get_or_load(const std::string& key, const Loader<const void>& loader,
+                        std::shared_ptr<const void>* value, bool* hit);
+
+    std::shared_ptr<const void> _lookup(const std::string& key);
+
+    void _insert(const std::string& key, std::shared_ptr<const void> value, size_t charge);
+
+    std::mutex _loading_lock;
+    // key -> the lock held by the caller loading the key
+    std::unordered_map<std::string, std::shared_ptr<std::mutex>> _loading;
+};
+
+} // namespace doris::vectorized
@@ -18,6 +18,8 @@
 #include "iceberg_reader.h"
 
 #include <ctype.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
 #include <gen_cpp/Metrics_types.h>
 #include <gen_cpp/PlanNodes_types.h>
 #include <gen_cpp/parquet_types.h>
@@ -31,30 +33,36 @@
 #include <boost/iterator/iterator_facade.hpp>
 #include <functional>
 #include <memory>
-#include <mutex>
 
 #include "common/compiler_util.h" // IWYU pragma: keep
+#include "common/config.h"
 #include "common/status.h"
 #include "olap/olap_common.h"
 #include "runtime/define_primitive_type.h"
 #include "runtime/primitive_type.h"
 #include "runtime/runtime_state.h"
 #include "runtime/types.h"
+#include "util/bitmap_value.h"
+#include "util/simd/bits.h"
 #include "util/string_util.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/columns/column.h"
+#include "vec/columns/column_nullable.h"
 #include "vec/columns/column_string.h"
 #include "vec/columns/column_vector.h"
+#include "vec/common/arena.h"
 #include "vec/common/assert_cast.h"
 #include "vec/common/string_ref.h"
 #include "vec/core/block.h"
 #include "vec/core/column_with_type_and_name.h"
 #include "vec/data_types/data_type.h"
 #include "vec/data_types/data_type_factory.hpp"
+#include "vec/data_types/data_type_nullable.h"
 #include "vec/exec/format/format_common.h"
 #include "vec/exec/format/generic_reader.h"
 #include "vec/exec/format/parquet/parquet_common.h"
 #include "vec/exec/format/parquet/vparquet_reader.h"
+#include "vec/exec/format/table/iceberg_delete_file_cache.h"
 #include "vec/exec/format/table/table_format_reader.h"
 
 namespace cctz {
@@ -75,27 +83,116 @@ class VExprContext;
 
 namespace doris::vectorized {
 
-using DeleteRows = std::vector<int64_t>;
-using DeleteFile = phmap::parallel_flat_hash_map<
-        std::string, std::unique_ptr<DeleteRows>, std::hash<std::string>,
-        std::equal_to<std::string>,
-        std::allocator<std::pair<const std::string, std::unique_ptr<DeleteRows>>>, 8, std::mutex>;
+struct IcebergTableReader::PositionDeleteFile {
+    // data file path -> the deleted positions in the data file
+    std::unordered_map<std::string, doris::detail::Roaring64Map> positions;
+};
+
+struct IcebergTableReader::EqualityDeleteSet {
+    Arena arena;
+    // the values of the equality columns of a row, serialized one after another
+    phmap::flat_hash_set<StringRef, StringRefHash> keys;
+
+    size_t charge() const {
+        return sizeof(EqualityDeleteSet) + arena.size() + keys.capacity() * (sizeof(StringRef) + 1);
+    }
+};
 
 const int64_t MIN_SUPPORT_DELETE_FILES_VERSION = 2;
 const std::string ICEBERG_ROW_POS = "pos";
 const std::string ICEBERG_FILE_PATH = "file_path";
+const size_t READ_DELETE_FILE_BATCH_SIZE = 102400;
+
+// Gets the delete file from the delete file cache shared by all queries, or loads it if the cache
+// is not initialized.
+template <typename T>
+static Status get_delete_file(const std::string& key,
+                              const IcebergDeleteFileCache::Loader<T>& loader,
+                              std::shared_ptr<const T>* value, bool* hit) {
+    IcebergDeleteFileCache* cache = IcebergDeleteFileCache::instance();
+    if (cache != nullptr) {
+        return cache->get_or_load(key, loader, value, hit);
+    }
+    std::shared_ptr<T> loaded;
+    size_t charge = 0;
+    RETURN_IF_ERROR(loader(&loaded, &charge));
+    *value = std::move(loaded);
+    *hit = false;
+    return Status::OK();
+}
+
+// Parses the field id to lowercase column name map from the iceberg schema which is written to
+// the key value metadata of the parquet files. Returns false if the file has no iceberg schema.
+static bool parse_iceberg_schema(const std::vector<tparquet::KeyValue>& parquet_meta_kv,
+                                 std::unordered_map<int, std::string>* field_id_to_name) {
+    for (const auto& kv : parquet_meta_kv) {
+        if (kv.key != "iceberg.schema") {
+            continue;
+        }
+        rapidjson::Document json;
+        json.Parse(kv.value.c_str());
+        if (json.IsObject() && json.HasMember("fields")) {
+            rapidjson::Value& fields = json["fields"];
+            if (fields.IsArray()) {
+                for (int j = 0; j < fields.Size(); j++) {
+                    rapidjson::Value& e = fields[j];
+                    rapidjson::Value& id = e["id"];
+                    rapidjson::Value& name = e["name"];
+                    std::string name_string = name.GetString();
+                    transform(name_string.begin(), name_string.end(), name_string.begin(),
+                              ::tolower);
+                    field_id_to_name->emplace(id.GetInt(), name_string);
+                }
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+// Serializes the key columns of the rows like the serialized keys of hash join, so the keys
+// serialized here are equal to the ones serialized by IColumn::serialize_value_into_arena.
+static void serialize_keys(const ColumnRawPtrs& key_columns, size_t num_rows,
+                           std::vector<StringRef>* keys, Arena* arena) {
+    arena->clear();
+    keys->resize(num_rows);
+    size_t max_one_row_byte_size = 0;
+    for (const auto* column : key_columns) {
+        max_one_row_byte_size += column->get_max_row_byte_size();
+    }
+    size_t total_bytes = max_one_row_byte_size * num_rows;
+    if (total_bytes > config::pre_serialize_keys_limit_bytes) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            const char* begin = nullptr;
+            size_t sum_size = 0;
+            for (const auto* column : key_columns) {
+                sum_size += column->serialize_value_into_arena(i, *arena, begin).size;
+            }
+            (*keys)[i] = {begin, sum_size};
+        }
+    } else {
+        auto* serialized_key_buffer = reinterpret_cast<uint8_t*>(arena->alloc(total_bytes));
+        for (size_t i = 0; i < num_rows; ++i) {
+            (*keys)[i].data =
+                    reinterpret_cast<char*>(serialized_key_buffer + i * max_one_row_byte_size);
+            (*keys)[i].size = 0;
+        }
+        for (const auto* column : key_columns) {
+            column->serialize_vec(*keys, num_rows, max_one_row_byte_size);
+        }
+    }
+}
 
 IcebergTableReader::IcebergTableReader(std::unique_ptr<GenericReader> file_format_reader,
                                        RuntimeProfile* profile, RuntimeState* state,
                                        const TFileScanRangeParams& params,
-                                       const TFileRangeDesc& range, ShardedKVCache* kv_cache,
-                                       io::IOContext* io_ctx, int64_t push_down_count)
+                                       const TFileRangeDesc& range, io::IOContext* io_ctx,
+                                       int64_t push_down_count)
         : TableFormatReader(std::move(file_format_reader)),
           _profile(profile),
           _state(state),
           _params(params),
           _range(range),
-          _kv_cache(kv_cache),
           _io_ctx(io_ctx),
           _remaining_push_down_count(push_down_count) {
     static const char* iceberg_profile = "IcebergProfile";
@@ -106,8 +203,14 @@ IcebergTableReader::IcebergTableReader(std::unique_ptr<GenericReader> file_forma
             ADD_CHILD_COUNTER(_profile, "NumDeleteRows", TUnit::UNIT, iceberg_profile);
     _iceberg_profile.delete_files_read_time =
             ADD_CHILD_TIMER(_profile, "DeleteFileReadTime", iceberg_profile);
-    _iceberg_profile.delete_rows_sort_time =
-            ADD_CHILD_TIMER(_profile, "DeleteRowsSortTime", iceberg_profile);
+    _iceberg_profile.delete_rows_merge_time =
+            ADD_CHILD_TIMER(_profile, "DeleteRowsMergeTime", iceberg_profile);
+    _iceberg_profile.delete_file_cache_hits =
+            ADD_CHILD_COUNTER(_profile, "DeleteFileCacheHits", TUnit::UNIT, iceberg_profile);
+    _iceberg_profile.num_equality_deleted_rows =
+            ADD_CHILD_COUNTER(_profile, "NumEqualityDeletedRows", TUnit::UNIT, iceberg_profile);
+    _iceberg_profile.equality_delete_probe_time =
+            ADD_CHILD_TIMER(_profile, "EqualityDeleteProbeTime", iceberg_profile);
 }
 
 Status IcebergTableReader::init_reader(
@@ -127,6 +230,7 @@ Status IcebergTableReader::init_reader(
     static_cast<void>(_gen_col_name_maps(parquet_meta_kv));
     _gen_file_col_names();
     _gen_new_colname_to_value_range();
+    RETURN_IF_ERROR(_init_equality_delete_columns());
     parquet_reader->set_table_to_file_col_map(_table_col_to_file_col);
     parquet_reader->iceberg_sanitize(_all_required_col_names);
     Status status = parquet_reader->init_reader(
@@ -170,7 +274,24 @@ Status IcebergTableReader::get_next_block(Block* block, size_t* read_rows, bool*
         block->initialize_index_by_name();
     }
 
+    // The equality columns not required by the query are read to the tail of the block,
+    // and removed after the deleted rows are filtered.
+    for (const auto& [name, type] : _equality_delete_extra_cols) {
+        block->insert(ColumnWithTypeAndName(type->create_column(), type, name));
+    }
+    if (!_equality_delete_groups.empty() && !_equality_delete_sets_loaded) {
+        RETURN_IF_ERROR(_load_equality_delete_sets(*block));
+        _equality_delete_sets_loaded = true;
+    }
+
     auto res = _file_format_reader->get_next_block(block, read_rows, eof);
+    if (res.ok() && !_equality_delete_groups.empty()) {
+        res = _equality_delete(block, read_rows);
+    }
+    if (!_equality_delete_extra_cols.empty()) {
+        Block::erase_useless_column(block,
+                                    block->columns() - _equality_delete_extra_cols.size());
+    }
     // Set the name back to table column name before return this block.
     if (_has_schema_change) {
         for (int i = 0; i < block->columns(); i++) {
@@ -202,6 +323,15 @@ Status IcebergTableReader::get_columns(
     return _file_format_reader->get_columns(name_to_type, missing_cols);
 }
 
+/*
+ * The content in TIcebergFileDesc is the type of the last delete file of the split, the data file
+ * may have both position and equality delete files. The equality delete files are the ones with
+ * the equality field ids.
+ */
+bool IcebergTableReader::_is_equality_delete(const TIcebergDeleteFileDesc& delete_file) {
+    return delete_file.__isset.field_ids && !delete_file.field_ids.empty();
+}
+
 Status IcebergTableReader::init_row_filters(const TFileRangeDesc& range) {
     // We get the count value by doris's be, so we don't need to read the delete file
     if (_push_down_agg_type == TPushAggOp::type::COUNT && _remaining_push_down_count > 0) {
@@ -213,26 +343,41 @@ Status IcebergTableReader::init_row_filters(const TFileRangeDesc& range) {
     if (version < MIN_SUPPORT_DELETE_FILES_VERSION) {
         return Status::OK();
     }
-    auto& delete_file_type = table_desc.content;
     const std::vector<TIcebergDeleteFileDesc>& files = table_desc.delete_files;
     if (files.empty()) {
         return Status::OK();
     }
 
-    if (delete_file_type == POSITION_DELETE) {
-        RETURN_IF_ERROR(_position_delete(files));
+    std::vector<const TIcebergDeleteFileDesc*> position_delete_files;
+    for (const auto& delete_file : files) {
+        if (!_is_equality_delete(delete_file)) {
+            position_delete_files.emplace_back(&delete_file);
+        }
     }
-
-    // todo: equality delete
-    //       If it is a count operation and it has equality delete file kind,
-    //       the push down operation of the count for this split needs to be canceled.
+    if (!position_delete_files.empty()) {
+        RETURN_IF_ERROR(_position_delete(position_delete_files));
+    }
+    // The equality delete files are loaded when the first block is read, and the rows of every
+    // block are probed against them. The count of the split is not pushed down by FE if it has
+    // equality delete files.
 
     COUNTER_UPDATE(_iceberg_profile.num_delete_files, files.size());
     return Status::OK();
 }
 
+TFileRangeDesc IcebergTableReader::_delete_file_range(const TIcebergDeleteFileDesc& delete_file) {
+    TFileRangeDesc delete_range;
+    // must use __set() method to make sure __isset is true
+    delete_range.__set_fs_name(_range.fs_name);
+    delete_range.path = delete_file.path;
+    delete_range.start_offset = 0;
+    delete_range.size = -1;
+    delete_range.file_size = -1;
+    return delete_range;
+}
+
 Status IcebergTableReader::_position_delete(
-        const std::vector<TIcebergDeleteFileDesc>& delete_files) {
+        const std::vector<const TIcebergDeleteFileDesc*>& delete_files) {
     std::string data_file_path = _range.path;
     // the path in _range is remove the namenode prefix,
     // and the file_path in delete file is full path, so we should add it back.
@@ -246,159 +391,439 @@ Status IcebergTableReader::_position_delete(
     // position delete
     ParquetReader* parquet_reader = (ParquetReader*)(_file_format_reader.get());
     RowRange whole_range = parquet_reader->get_whole_range();
-    bool init_schema = false;
-    std::vector<std::string> delete_file_col_names;
-    std::vector<TypeDescriptor> delete_file_col_types;
-    std::vector<DeleteRows*> delete_rows_array;
-    int64_t num_delete_rows = 0;
-    std::vector<DeleteFile*> erase_data;
-    for (auto& delete_file : delete_files) {
-        if (whole_range.last_row <= delete_file.position_lower_bound ||
-            whole_range.first_row > delete_file.position_upper_bound) {
+    doris::detail::Roaring64Map delete_rows;
+    for (const auto* delete_file : delete_files) {
+        if (whole_range.last_row <= delete_file->position_lower_bound ||
+            whole_range.first_row > delete_file->position_upper_bound) {
             continue;
         }
 
-        SCOPED_TIMER(_iceberg_profile.delete_files_read_time);
-        Status create_status = Status::OK();
-        DeleteFile* delete_file_cache = _kv_cache->get<
-                DeleteFile>(_delet_file_cache_key(delete_file.path), [&]() -> DeleteFile* {
-            TFileRangeDesc delete_range;
-            // must use __set() method to make sure __isset is true
-            delete_range.__set_fs_name(_range.fs_name);
-            delete_range.path = delete_file.path;
-            delete_range.start_offset = 0;
-            delete_range.size = -1;
-            delete_range.file_size = -1;
-            ParquetReader delete_reader(_profile, _params, delete_range, 102400,
-                                        const_cast<cctz::time_zone*>(&_state->timezone_obj()),
-                                        _io_ctx, _state);
-            if (!init_schema) {
-                static_cast<void>(delete_reader.get_parsed_schema(&delete_file_col_names,
-                                                                  &delete_file_col_types));
-                init_schema = true;
-            }
-            create_status = delete_reader.open();
-            if (!create_status.ok()) {
-                return nullptr;
-            }
-            create_status = delete_reader.init_reader(delete_file_col_names, _not_in_file_col_names,
-                                                      nullptr, {}, nullptr, nullptr, nullptr,
-                                                      nullptr, nullptr, false);
-            if (!create_status.ok()) {
-                return nullptr;
-            }
+        std::shared_ptr<const PositionDeleteFile> position_delete;
+        bool hit = false;
+        Status st;
+        {
+            SCOPED_TIMER(_iceberg_profile.delete_files_read_time);
+            st = get_delete_file<PositionDeleteFile>(
+                    "iceberg_pos_delete:" + delete_file->path,
+                    [&](std::shared_ptr<PositionDeleteFile>* value, size_t* charge) {
+                        return _load_position_delete_file(*delete_file, value, charge);
+                    },
+                    &position_delete, &hit);
+        }
+        if (st.is<ErrorCode::END_OF_FILE>()) {
+            continue;
+        }
+        RETURN_IF_ERROR(st);
+        if (hit) {
+            COUNTER_UPDATE(_iceberg_profile.delete_file_cache_hits, 1);
+        }
 
-            std::unordered_map<std::string, std::tuple<std::string, const SlotDescriptor*>>
-                    partition_columns;
-            std::unordered_map<std::string, VExprContextSPtr> missing_columns;
-            static_cast<void>(delete_reader.set_fill_columns(partition_columns, missing_columns));
-
-            bool dictionary_coded = true;
-            const tparquet::FileMetaData* meta_data = delete_reader.get_meta_data();
-            for (int i = 0; i < delete_file_col_names.size(); ++i) {
-                if (delete_file_col_names[i] == ICEBERG_FILE_PATH) {
-                    for (int j = 0; j < meta_data->row_groups.size(); ++j) {
-                        auto& column_chunk = meta_data->row_groups[j].columns[i];
-                        if (!(column_chunk.__isset.meta_data &&
-                              column_chunk.meta_data.__isset.dictionary_page_offset)) {
-                            dictionary_coded = false;
-                            break;
-                        }
-                    }
+        auto iter = position_delete->positions.find(data_file_path);
+        if (iter != position_delete->positions.end()) {
+            SCOPED_TIMER(_iceberg_profile.delete_rows_merge_time);
+            delete_rows |= iter->second;
+        }
+    }
+    if (!delete_rows.isEmpty()) {
+        SCOPED_TIMER(_iceberg_profile.delete_rows_merge_time);
+        _delete_rows.resize(delete_rows.cardinality());
+        delete_rows.toUint64Array(reinterpret_cast<uint64_t*>(_delete_rows.data()));
+        parquet_reader->set_delete_rows(&_delete_rows);
+        COUNTER_UPDATE(_iceberg_profile.num_delete_rows, _delete_rows.size());
+    }
+    return Status::OK();
+}
+
+/**
+ * https://iceberg.apache.org/spec/#position-delete-files
+ * The rows in the delete file must be sorted by file_path then position to optimize filtering
+ * rows while scanning. The positions of every data file are kept in a bitmap, so the positions
+ * of the delete files of a data file are merged by union.
+ */
+Status IcebergTableReader::_load_position_delete_file(
+        const TIcebergDeleteFileDesc& delete_file,
+        std::shared_ptr<PositionDeleteFile>* position_delete, size_t* charge) {
+    TFileRangeDesc delete_range = _delete_file_range(delete_file);
+    ParquetReader delete_reader(_profile, _params, delete_range, READ_DELETE_FILE_BATCH_SIZE,
+                                const_cast<cctz::time_zone*>(&_state->timezone_obj()), _io_ctx,
+                                _state);
+    std::vector<std::string> delete_file_col_names;
+    std::vector<TypeDescriptor> delete_file_col_types;
+    RETURN_IF_ERROR(
+            delete_reader.get_parsed_schema(&delete_file_col_names, &delete_file_col_types));
+    RETURN_IF_ERROR(delete_reader.open());
+    RETURN_IF_ERROR(delete_reader.init_reader(delete_file_col_names, {}, nullptr, {}, nullptr,
+                                              nullptr, nullptr, nullptr, nullptr, false));
+
+    std::unordered_map<std::string, std::tuple<std::string, const SlotDescriptor*>>
+            partition_columns;
+    std::unordered_map<std::string, VExprContextSPtr> missing_columns;
+    RETURN_IF_ERROR(delete_reader.set_fill_columns(partition_columns, missing_columns));
+
+    bool dictionary_coded = true;
+    const tparquet::FileMetaData* meta_data = delete_reader.get_meta_data();
+    for (int i = 0; i < delete_file_col_names.size(); ++i) {
+        if (delete_file_col_names[i] == ICEBERG_FILE_PATH) {
+            for (int j = 0; j < meta_data->row_groups.size(); ++j) {
+                auto& column_chunk = meta_data->row_groups[j].columns[i];
+                if (!(column_chunk.__isset.meta_data &&
+                      column_chunk.meta_data.__isset.dictionary_page_offset)) {
+                    dictionary_coded = false;
                     break;
                 }
             }
+            break;
+        }
+    }
+
+    auto result = std::make_shared<PositionDeleteFile>();
+    bool eof = false;
+    while (!eof) {
+        Block block = Block();
+        for (int i = 0; i < delete_file_col_names.size(); ++i) {
+            DataTypePtr data_type = DataTypeFactory::instance().create_data_type(
+                    delete_file_col_types[i], false);
+            if (delete_file_col_names[i] == ICEBERG_FILE_PATH && dictionary_coded) {
+                // the dictionary data in ColumnDictI32 is referenced by StringValue, it does keep
+                // the dictionary data in its life circle, so the upper caller should keep the
+                // dictionary data alive after ColumnDictI32.
+                MutableColumnPtr dict_column = ColumnDictI32::create();
+                block.insert(ColumnWithTypeAndName(std::move(dict_column), data_type,
+                                                   delete_file_col_names[i]));
+            } else {
+                MutableColumnPtr data_column = data_type->create_column();
+                block.insert(ColumnWithTypeAndName(std::move(data_column), data_type,
+                                                   delete_file_col_names[i]));
+            }
+        }
+        size_t read_rows = 0;
+        RETURN_IF_ERROR(delete_reader.get_next_block(&block, &read_rows, &eof));
+        if (read_rows == 0) {
+            continue;
+        }
+        ColumnPtr path_column = block.get_by_name(ICEBERG_FILE_PATH).column;
+        DCHECK_EQ(path_column->size(), read_rows);
+        ColumnPtr pos_column = block.get_by_name(ICEBERG_ROW_POS).column;
+        using ColumnType = typename PrimitiveTypeTraits<TYPE_BIGINT>::ColumnType;
+        const int64_t* src_data = assert_cast<const ColumnType&>(*pos_column).get_data().data();
+        IcebergTableReader::PositionDeleteRange range;
+        if (dictionary_coded) {
+            range = _get_range(assert_cast<const ColumnDictI32&>(*path_column));
+        } else {
+            range = _get_range(assert_cast<const ColumnString&>(*path_column));
+        }
+        for (int i = 0; i < range.range.size(); ++i) {
+            doris::detail::Roaring64Map& positions = result->positions[range.data_file_path[i]];
+            positions.addMany(range.range[i].second - range.range[i].first,
+                              reinterpret_cast<const uint64_t*>(src_data + range.range[i].first));
+        }
+    }
 
-            DeleteFile* position_delete = new DeleteFile;
-            bool eof = false;
-            while (!eof) {
-                Block block = Block();
-                for (int i = 0; i < delete_file_col_names.size(); ++i) {
-                    DataTypePtr data_type = DataTypeFactory::instance().create_data_type(
-                            delete_file_col_types[i], false);
-                    if (delete_file_col_names[i] == ICEBERG_FILE_PATH && dictionary_coded) {
-                        // the dictionary data in ColumnDictI32 is referenced by StringValue, it does keep
-                        // the dictionary data in its life circle, so the upper caller should keep the
-                        // dictionary data alive after ColumnDictI32.
-                        MutableColumnPtr dict_column = ColumnDictI32::create();
-                        block.insert(ColumnWithTypeAndName(std::move(dict_column), data_type,
-                                                           delete_file_col_names[i]));
-                    } else {
-                        MutableColumnPtr data_column = data_type->create_column();
-                        block.insert(ColumnWithTypeAndName(std::move(data_column), data_type,
-                                                           delete_file_col_names[i]));
-                    }
+    *charge = sizeof(PositionDeleteFile);
+    for (auto& [path, positions] : result->positions) {
+        positions.runOptimize();
+        positions.shrinkToFit();
+        *charge += path.size() + positions.getSizeInBytes(1);
+    }
+    *position_delete = std::move(result);
+    return Status::OK();
+}
+
+/*
+ * Resolves the equality columns of the equality delete files to the columns in the data file,
+ * and adds the ones not required by the query to the columns to read.
+ */
+Status IcebergTableReader::_init_equality_delete_columns() {
+    if (_push_down_agg_type == TPushAggOp::type::COUNT && _remaining_push_down_count > 0) {
+        return Status::OK();
+    }
+    auto& table_desc = _range.table_format_params.iceberg_params;
+    if (table_desc.format_version < MIN_SUPPORT_DELETE_FILES_VERSION) {
+        return Status::OK();
+    }
+
+    ParquetReader* parquet_reader = static_cast<ParquetReader*>(_file_format_reader.get());
+    std::vector<std::string> file_col_names;
+    std::vector<TypeDescriptor> file_col_types;
+    for (const auto& delete_file : table_desc.delete_files) {
+        if (!_is_equality_delete(delete_file)) {
+            continue;
+        }
+        auto group = std::find_if(
+                _equality_delete_groups.begin(), _equality_delete_groups.end(),
+                [&](const auto& g) { return g.field_ids == delete_file.field_ids; });
+        if (group != _equality_delete_groups.end()) {
+            group->delete_files.emplace_back(&delete_file);
+            continue;
+        }
+
+        EqualityDeleteGroup new_group;
+        new_group.field_ids = delete_file.field_ids;
+        new_group.delete_files.emplace_back(&delete_file);
+        for (int field_id : delete_file.field_ids) {
+            auto iter = _file_field_id_to_col.find(field_id);
+            if (iter == _file_field_id_to_col.end()) {
+                if (!_has_iceberg_schema) {
+                    return Status::NotSupported(
+                            "Iceberg equality delete is not supported on data file {} without "
+                            "iceberg schema",
+                            _range.path);
                 }
-                eof = false;
-                size_t read_rows = 0;
-                create_status = delete_reader.get_next_block(&block, &read_rows, &eof);
-                if (!create_status.ok()) {
-                    return nullptr;
+                // The column is added after the data file was written, so it is null in the file.
+                new_group.column_names.emplace_back("");
+                continue;
+            }
+            std::string name = iter->second;
+            if (std::find(_all_required_col_names.begin(), _all_required_col_names.end(), name) ==
+                _all_required_col_names.end()) {
+                if (file_col_names.empty()) {
+                    RETURN_IF_ERROR(
+                            parquet_reader->get_parsed_schema(&file_col_names, &file_col_types));
                 }
-                if (read_rows > 0) {
-                    ColumnPtr path_column = block.get_by_name(ICEBERG_FILE_PATH).column;
-                    DCHECK_EQ(path_column->size(), read_rows);
-                    ColumnPtr pos_column = block.get_by_name(ICEBERG_ROW_POS).column;
-                    using ColumnType = typename PrimitiveTypeTraits<TYPE_BIGINT>::ColumnType;
-                    const int64_t* src_data =
-                            assert_cast<const ColumnType&>(*pos_column).get_data().data();
-                    IcebergTableReader::PositionDeleteRange range;
-                    if (dictionary_coded) {
-                        range = _get_range(assert_cast<const ColumnDictI32&>(*path_column));
-                    } else {
-                        range = _get_range(assert_cast<const ColumnString&>(*path_column));
-                    }
-                    for (int i = 0; i < range.range.size(); ++i) {
-                        std::string key = range.data_file_path[i];
-                        auto iter = position_delete->find(key);
-                        DeleteRows* delete_rows;
-                        if (iter == position_delete->end()) {
-                            delete_rows = new DeleteRows;
-                            std::unique_ptr<DeleteRows> delete_rows_ptr(delete_rows);
-                            (*position_delete)[key] = std::move(delete_rows_ptr);
-                        } else {
-                            delete_rows = iter->second.get();
-                        }
-                        const int64_t* cpy_start = src_data + range.range[i].first;
-                        const int64_t cpy_count = range.range[i].second - range.range[i].first;
-                        int64_t origin_size = delete_rows->size();
-                        delete_rows->resize(origin_size + cpy_count);
-                        int64_t* dest_position = &(*delete_rows)[origin_size];
-                        memcpy(dest_position, cpy_start, cpy_count * sizeof(int64_t));
-                    }
+                auto pos = std::find(file_col_names.begin(), file_col_names.end(), name);
+                if (pos == file_col_names.end()) {
+                    new_group.column_names.emplace_back("");
+                    continue;
                 }
+                _all_required_col_names.emplace_back(name);
+                _equality_delete_extra_cols.emplace_back(
+                        name, DataTypeFactory::instance().create_data_type(
+                                      file_col_types[pos - file_col_names.begin()], true));
+            }
+            new_group.column_names.emplace_back(std::move(name));
+        }
+        _equality_delete_groups.emplace_back(std::move(new_group));
+    }
+    return Status::OK();
+}
+
+/*
+ * Loads the equality delete files with the types of the equality columns in the block, so that
+ * the rows of the delete files are serialized to the same keys as the equal rows of the data file.
+ */
+Status IcebergTableReader::_load_equality_delete_sets(const Block& block) {
+    for (auto& group : _equality_delete_groups) {
+        std::vector<DataTypePtr> key_types;
+        std::string key_suffix = fmt::format("{}", fmt::join(group.field_ids, ","));
+        for (const auto& name : group.column_names) {
+            if (name.empty()) {
+                key_types.emplace_back(nullptr);
+                key_suffix += ":null";
+                continue;
+            }
+            if (!block.has(name)) {
+                return Status::InternalError("Iceberg equality delete column {} is not in block {}",
+                                             name, block.dump_names());
+            }
+            key_types.emplace_back(make_nullable(block.get_by_name(name).type));
+            key_suffix += ":" + key_types.back()->get_name();
+        }
+
+        std::vector<std::shared_ptr<const EqualityDeleteSet>> delete_sets;
+        std::vector<std::string> delete_paths;
+        for (const auto* delete_file : group.delete_files) {
+            std::shared_ptr<const EqualityDeleteSet> delete_set;
+            bool hit = false;
+            Status st;
+            {
+                SCOPED_TIMER(_iceberg_profile.delete_files_read_time);
+                st = get_delete_file<EqualityDeleteSet>(
+                        "iceberg_eq_delete:" + delete_file->path + ":" + key_suffix,
+                        [&](std::shared_ptr<EqualityDeleteSet>* value, size_t* charge) {
+                            return _load_equality_delete_file(*delete_file, group.field_ids,
+                                                              key_types, value, charge);
+                        },
+                        &delete_set, &hit);
             }
-            return position_delete;
-        });
-        if (create_status.is<ErrorCode::END_OF_FILE>()) {
+            if (st.is<ErrorCode::END_OF_FILE>()) {
+                continue;
+            }
+            RETURN_IF_ERROR(st);
+            if (hit) {
+                COUNTER_UPDATE(_iceberg_profile.delete_file_cache_hits, 1);
+            }
+            if (!delete_set->keys.empty()) {
+                delete_sets.emplace_back(std::move(delete_set));
+                delete_paths.emplace_back(delete_file->path);
+            }
+        }
+        if (delete_sets.size() <= 1) {
+            group.delete_set = delete_sets.empty() ? nullptr : std::move(delete_sets[0]);
             continue;
-        } else if (!create_status.ok()) {
-            return create_status;
-        }
-
-        DeleteFile& delete_file_map = *((DeleteFile*)delete_file_cache);
-        auto get_value = [&](const auto& v) {
-            DeleteRows* row_ids = v.second.get();
-            if (row_ids->size() > 0) {
-                delete_rows_array.emplace_back(row_ids);
-                num_delete_rows += row_ids->size();
-                if (row_ids->front() >= whole_range.first_row &&
-                    row_ids->back() < whole_range.last_row) {
-                    erase_data.emplace_back(delete_file_cache);
-                }
+        }
+        // The sets are merged, so that a row is probed once per group. The union is cached as
+        // well, for the other data files deleted by the same files.
+        bool hit = false;
+        RETURN_IF_ERROR(get_delete_file<EqualityDeleteSet>(
+                fmt::format("iceberg_eq_delete:{}:{}", fmt::join(delete_paths, ","), key_suffix),
+                [&](std::shared_ptr<EqualityDeleteSet>* value, size_t* charge) {
+                    _merge_delete_sets(delete_sets, value, charge);
+                    return Status::OK();
+                },
+                &group.delete_set, &hit));
+        if (hit) {
+            COUNTER_UPDATE(_iceberg_profile.delete_file_cache_hits, 1);
+        }
+    }
+    return Status::OK();
+}
+
+/*
+ * https://iceberg.apache.org/spec/#equality-delete-files
+ * A row of the data file is deleted if its values of the equality columns are equal to the ones
+ * of a row in the delete file, where null is equal to null. The rows of the delete file are
+ * loaded to a hash set of their serialized equality columns.
+ */
+Status IcebergTableReader::_load_equality_delete_file(
+        const TIcebergDeleteFileDesc& delete_file, const std::vector<int>& field_ids,
+        const std::vector<DataTypePtr>& key_types, std::shared_ptr<EqualityDeleteSet>* delete_set,
+        size_t* charge) {
+    TFileRangeDesc delete_range = _delete_file_range(delete_file);
+    ParquetReader delete_reader(_profile, _params, delete_range, READ_DELETE_FILE_BATCH_SIZE,
+                                const_cast<cctz::time_zone*>(&_state->timezone_obj()), _io_ctx,
+                                _state);
+    std::vector<std::string> delete_file_col_names;
+    std::vector<TypeDescriptor> delete_file_col_types;
+    RETURN_IF_ERROR(
+            delete_reader.get_parsed_schema(&delete_file_col_names, &delete_file_col_types));
+    RETURN_IF_ERROR(delete_reader.open());
+    std::unordered_map<int, std::string> field_id_to_col;
+    if (!parse_iceberg_schema(delete_reader.get_metadata_key_values(), &field_id_to_col)) {
+        return Status::NotSupported("Iceberg equality delete file {} has no iceberg schema",
+                                    delete_file.path);
+    }
+
+    std::vector<std::string> key_names;
+    DataTypes read_types;
+    for (size_t i = 0; i < field_ids.size(); ++i) {
+        auto iter = field_id_to_col.find(field_ids[i]);
+        if (iter == field_id_to_col.end()) {
+            return Status::NotSupported(
+                    "Equality field {} is not a top level column of iceberg delete file {}",
+                    field_ids[i], delete_file.path);
+        }
+        auto pos = std::find_if(
+                delete_file_col_names.begin(), delete_file_col_names.end(),
+                [&](const std::string& name) { return to_lower(name) == iter->second; });
+        if (pos == delete_file_col_names.end()) {
+            return Status::InternalError("Equality column {} is not in iceberg delete file {}",
+                                         iter->second, delete_file.path);
+        }
+        key_names.emplace_back(*pos);
+        if (key_types[i] != nullptr) {
+            read_types.emplace_back(key_types[i]);
+        } else {
+            read_types.emplace_back(DataTypeFactory::instance().create_data_type(
+                    delete_file_col_types[pos - delete_file_col_names.begin()], true));
+        }
+    }
+    RETURN_IF_ERROR(delete_reader.init_reader(key_names, {}, nullptr, {}, nullptr, nullptr,
+                                              nullptr, nullptr, nullptr, false));
+    std::unordered_map<std::string, std::tuple<std::string, const SlotDescriptor*>>
+            partition_columns;
+    std::unordered_map<std::string, VExprContextSPtr> missing_columns;
+    RETURN_IF_ERROR(delete_reader.set_fill_columns(partition_columns, missing_columns));
+
+    auto result = std::make_shared<EqualityDeleteSet>();
+    bool eof = false;
+    while (!eof) {
+        Block block = Block();
+        for (size_t i = 0; i < key_names.size(); ++i) {
+            block.insert(ColumnWithTypeAndName(read_types[i]->create_column(), read_types[i],
+                                               key_names[i]));
+        }
+        size_t read_rows = 0;
+        RETURN_IF_ERROR(delete_reader.get_next_block(&block, &read_rows, &eof));
+        ColumnRawPtrs key_columns;
+        Columns key_holders;
+        for (size_t i = 0; i < key_names.size(); ++i) {
+            key_holders.emplace_back(
+                    block.get_by_position(i).column->convert_to_full_column_if_const());
+            key_columns.emplace_back(key_holders.back().get());
+        }
+        for (size_t row = 0; row < read_rows; ++row) {
+            const char* begin = nullptr;
+            size_t sum_size = 0;
+            for (const auto* column : key_columns) {
+                sum_size += column->serialize_value_into_arena(row, result->arena, begin).size;
             }
-        };
-        delete_file_map.if_contains(data_file_path, get_value);
+            if (!result->keys.emplace(begin, sum_size).second) {
+                result->arena.rollback(sum_size);
+            }
+        }
     }
-    if (num_delete_rows > 0) {
-        SCOPED_TIMER(_iceberg_profile.delete_rows_sort_time);
-        _sort_delete_rows(delete_rows_array, num_delete_rows);
-        parquet_reader->set_delete_rows(&_delete_rows);
-        COUNTER_UPDATE(_iceberg_profile.num_delete_rows, num_delete_rows);
+
+    *charge = result->charge();
+    *delete_set = std::move(result);
+    return Status::OK();
+}
+
+void IcebergTableReader::_merge_delete_sets(
+        const std::vector<std::shared_ptr<const EqualityDeleteSet>>& delete_sets,
+        std::shared_ptr<EqualityDeleteSet>* merged, size_t* charge) {
+    auto result = std::make_shared<EqualityDeleteSet>();
+    size_t num_keys = 0;
+    for (const auto& delete_set : delete_sets) {
+        num_keys += delete_set->keys.size();
+    }
+    result->keys.reserve(num_keys);
+    for (const auto& delete_set : delete_sets) {
+        for (const auto& key : delete_set->keys) {
+            if (!result->keys.contains(key)) {
+                result->keys.emplace(result->arena.insert(key.data, key.size), key.size);
+            }
+        }
     }
-    // the deleted rows are copy out, we can erase them.
-    for (auto& erase_item : erase_data) {
-        erase_item->erase(data_file_path);
+    *charge = result->charge();
+    *merged = std::move(result);
+}
+
+/*
+ * Filters the rows of the block deleted by the equality delete files. The keys of the rows are
+ * serialized column by column and probed against the merged set of the delete files with the
+ * same equality columns.
+ */
+Status IcebergTableReader::_equality_delete(Block* block, size_t* read_rows) {
+    size_t rows = block->rows();
+    if (rows == 0) {
+        return Status::OK();
+    }
+    SCOPED_TIMER(_iceberg_profile.equality_delete_probe_time);
+    IColumn::Filter filter(rows, 1);
+    std::vector<StringRef> keys;
+    Arena arena;
+    for (const auto& group : _equality_delete_groups) {
+        if (group.delete_set == nullptr) {
+            continue;
+        }
+        ColumnRawPtrs key_columns;
+        Columns key_holders;
+        for (const auto& name : group.column_names) {
+            if (name.empty()) {
+                key_holders.emplace_back(
+                        ColumnNullable::create(ColumnUInt8::create(rows, 0),
+                                               ColumnUInt8::create(rows, 1)));
+            } else {
+                key_holders.emplace_back(make_nullable(
+                        block->get_by_name(name).column->convert_to_full_column_if_const()));
+            }
+            key_columns.emplace_back(key_holders.back().get());
+        }
+        serialize_keys(key_columns, rows, &keys, &arena);
+        const auto& delete_keys = group.delete_set->keys;
+        for (size_t i = 0; i < rows; ++i) {
+            if (filter[i] && delete_keys.contains(keys[i])) {
+                filter[i] = 0;
+            }
+        }
+    }
+
+    size_t num_deleted = simd::count_zero_num((int8_t*)filter.data(), rows);
+    if (num_deleted > 0) {
+        Block::filter_block_internal(block, filter, block->columns());
+        *read_rows = block->rows();
+        COUNTER_UPDATE(_iceberg_profile.num_delete_rows, num_deleted);
+        COUNTER_UPDATE(_iceberg_profile.num_equality_deleted_rows, num_deleted);
     }
     return Status::OK();
 }
@@ -508,38 +933,17 @@ void IcebergTableReader::_sort_delete_rows(std::vector<std::vector<int64_t>*>& d
  * 2. col1 -> col1_new
  */
 Status IcebergTableReader::_gen_col_name_maps(std::vector<tparquet::KeyValue> parquet_meta_kv) {
-    for (int i = 0; i < parquet_meta_kv.size(); ++i) {
-        tparquet::KeyValue kv = parquet_meta_kv[i];
-        if (kv.key == "iceberg.schema") {
-            _has_iceberg_schema = true;
-            std::string schema = kv.value;
-            rapidjson::Document json;
-            json.Parse(schema.c_str());
-
-            if (json.HasMember("fields")) {
-                rapidjson::Value& fields = json["fields"];
-                if (fields.IsArray()) {
-                    for (int j = 0; j < fields.Size(); j++) {
-                        rapidjson::Value& e = fields[j];
-                        rapidjson::Value& id = e["id"];
-                        rapidjson::Value& name = e["name"];
-                        std::string name_string = name.GetString();
-                        transform(name_string.begin(), name_string.end(), name_string.begin(),
-                                  ::tolower);
-                        auto iter = _col_id_name_map.find(id.GetInt());
-                        if (iter != _col_id_name_map.end()) {
-                            _table_col_to_file_col.emplace(iter->second, name_string);
-                            _file_col_to_table_col.emplace(name_string, iter->second);
-                            if (name_string != iter->second) {
-                                _has_schema_change = true;
-                            }
-                        } else {
-                            _has_schema_change = true;
-                        }
-                    }
-                }
+    _has_iceberg_schema = parse_iceberg_schema(parquet_meta_kv, &_file_field_id_to_col);
+    for (const auto& [field_id, name_string] : _file_field_id_to_col) {
+        auto iter = _col_id_name_map.find(field_id);
+        if (iter != _col_id_name_map.end()) {
+            _table_col_to_file_col.emplace(iter->second, name_string);
+            _file_col_to_table_col.emplace(name_string, iter->second);
+            if (name_string != iter->second) {
+                _has_schema_change = true;
             }
-            break;
+        } else {
+            _has_schema_change = true;
         }
     }
     return Status::OK();
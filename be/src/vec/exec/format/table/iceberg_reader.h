@@ -20,6 +20,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -32,6 +33,7 @@
 #include "table_format_reader.h"
 #include "util/runtime_profile.h"
 #include "vec/columns/column_dictionary.h"
+#include "vec/data_types/data_type.h"
 
 namespace tparquet {
 class KeyValue;
@@ -55,7 +57,6 @@ namespace vectorized {
 class Block;
 class ColumnString;
 class GenericReader;
-class ShardedKVCache;
 class VExprContext;
 
 class IcebergTableReader : public TableFormatReader {
@@ -69,8 +70,7 @@ public:
 
     IcebergTableReader(std::unique_ptr<GenericReader> file_format_reader, RuntimeProfile* profile,
                        RuntimeState* state, const TFileScanRangeParams& params,
-                       const TFileRangeDesc& range, ShardedKVCache* kv_cache, io::IOContext* io_ctx,
-                       int64_t push_down_count);
+                       const TFileRangeDesc& range, io::IOContext* io_ctx, int64_t push_down_count);
     ~IcebergTableReader() override = default;
 
     Status init_row_filters(const TFileRangeDesc& range) override;
@@ -104,19 +104,52 @@ private:
         RuntimeProfile::Counter* num_delete_files;
         RuntimeProfile::Counter* num_delete_rows;
         RuntimeProfile::Counter* delete_files_read_time;
-        RuntimeProfile::Counter* delete_rows_sort_time;
+        RuntimeProfile::Counter* delete_rows_merge_time;
+        RuntimeProfile::Counter* delete_file_cache_hits;
+        RuntimeProfile::Counter* num_equality_deleted_rows;
+        RuntimeProfile::Counter* equality_delete_probe_time;
     };
 
-    Status _position_delete(const std::vector<TIcebergDeleteFileDesc>& delete_files);
+    // The deleted positions of every data file in a position delete file.
+    struct PositionDeleteFile;
+    // The values of the equality columns of the rows in an equality delete file.
+    struct EqualityDeleteSet;
+
+    // The equality delete files with the same equality columns, probed with the same keys.
+    struct EqualityDeleteGroup {
+        std::vector<int> field_ids;
+        // names of the equality columns in the data file, empty if the column is not in it
+        std::vector<std::string> column_names;
+        std::vector<const TIcebergDeleteFileDesc*> delete_files;
+        // the union of the sets of the delete files, null if they delete nothing
+        std::shared_ptr<const EqualityDeleteSet> delete_set;
+    };
+
+    static bool _is_equality_delete(const TIcebergDeleteFileDesc& delete_file);
+
+    Status _position_delete(const std::vector<const TIcebergDeleteFileDesc*>& delete_files);
+
+    Status _load_position_delete_file(const TIcebergDeleteFileDesc& delete_file,
+                                      std::shared_ptr<PositionDeleteFile>* position_delete,
+                                      size_t* charge);
+
+    Status _init_equality_delete_columns();
 
-    /**
-     * https://iceberg.apache.org/spec/#position-delete-files
-     * The rows in the delete file must be sorted by file_path then position to optimize filtering rows while scanning.
-     * Sorting by file_path allows filter pushdown by file in columnar storage formats.
-     * Sorting by position allows filtering rows while scanning, to avoid keeping deletes in memory.
-     */
-    void _sort_delete_rows(std::vector<std::vector<int64_t>*>& delete_rows_array,
-                           int64_t num_delete_rows);
+    Status _load_equality_delete_sets(const Block& block);
+
+    Status _load_equality_delete_file(const TIcebergDeleteFileDesc& delete_file,
+                                      const std::vector<int>& field_ids,
+                                      const std::vector<DataTypePtr>& key_types,
+                                      std::shared_ptr<EqualityDeleteSet>* delete_set,
+                                      size_t* charge);
+
+    static void _merge_delete_sets(
+            const std::vector<std::shared_ptr<const EqualityDeleteSet>>& delete_sets,
+            std::shared_ptr<EqualityDeleteSet>* merged, size_t* charge);
+
+    Status _equality_delete(Block* block, size_t* read_rows);
+
+    TFileRangeDesc _delete_file_range(const TIcebergDeleteFileDesc& delete_file);
 
     PositionDeleteRange _get_range(const ColumnDictI32& file_path_column);
 
@@ -125,14 +158,11 @@ private:
     Status _gen_col_name_maps(std::vector<tparquet::KeyValue> parquet_meta_kv);
     void _gen_file_col_names();
     void _gen_new_colname_to_value_range();
-    std::string _delet_file_cache_key(const std::string& path) { return "delete_" + path; }
 
     RuntimeProfile* _profile;
     RuntimeState* _state;
     const TFileScanRangeParams& _params;
     const TFileRangeDesc& _range;
-    // owned by scan node
-    ShardedKVCache* _kv_cache;
     IcebergProfile _iceberg_profile;
     std::vector<int64_t> _delete_rows;
     // col names from _file_slot_descs
@@ -150,6 +180,13 @@ private:
     std::vector<std::string> _all_required_col_names;
     // col names in table but not in parquet file
     std::vector<std::string> _not_in_file_col_names;
+    // field id to col name in the parquet file, from the iceberg schema of the file
+    std::unordered_map<int, std::string> _file_field_id_to_col;
+
+    std::vector<EqualityDeleteGroup> _equality_delete_groups;
+    // equality columns not required by the query, read only to probe the equality delete files
+    std::vector<std::pair<std::string, DataTypePtr>> _equality_delete_extra_cols;
+    bool _equality_delete_sets_loaded = false;
 
     io::IOContext* _io_ctx;
     bool _has_schema_change = false;
@@ -51,6 +51,7 @@
 #include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
 #include "util/defer_op.h"
+#include "util/numa_util.h"
 #include "util/uid_util.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/columns/column_vector.h"
@@ -709,6 +710,9 @@ Status HashJoinNode::_materialize_build_side(RuntimeState* state) {
 Status HashJoinNode::sink(doris::RuntimeState* state, vectorized::Block* in_block, bool eos) {
     SCOPED_TIMER(_exec_timer);
     SCOPED_TIMER(_build_timer);
+    // The shared hash table is probed by instances on every NUMA node.
+    NumaInterleaveGuard numa_guard(_shared_hashtable_controller && _should_build_hash_table &&
+                                   config::numa_interleave_shared_hash_table);
 
     if (_should_build_hash_table) {
         // If eos or have already met a null value using short-circuit strategy, we do not need to pull
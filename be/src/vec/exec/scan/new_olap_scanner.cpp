@@ -663,6 +663,9 @@ void NewOlapScanner::_update_counters_before_close() {
     tablet->query_scan_bytes->increment(_compressed_bytes_read);
     tablet->query_scan_rows->increment(_raw_rows_read);
     tablet->query_scan_count->increment(1);
+    if (config::enable_read_amplification_compaction_scheduling) {
+        tablet->read_stats.record(_state->query_id(), _tablet_reader->stats());
+    }
 }
 
 } // namespace doris::vectorized
@@ -68,6 +68,7 @@
 #include "vec/exec/format/wal/wal_reader.h"
 #include "vec/exec/scan/new_file_scan_node.h"
 #include "vec/exec/scan/vscan_node.h"
+#include "vec/exprs/vcast_expr.h"
 #include "vec/exprs/vexpr.h"
 #include "vec/exprs/vexpr_context.h"
 #include "vec/exprs/vslot_ref.h"
@@ -78,24 +79,17 @@
 namespace cctz {
 class time_zone;
 } // namespace cctz
-namespace doris {
-namespace vectorized {
-class ShardedKVCache;
-} // namespace vectorized
-} // namespace doris
 
 namespace doris::vectorized {
 using namespace ErrorCode;
 
 VFileScanner::VFileScanner(RuntimeState* state, NewFileScanNode* parent, int64_t limit,
-                           const TFileScanRange& scan_range, RuntimeProfile* profile,
-                           ShardedKVCache* kv_cache)
+                           const TFileScanRange& scan_range, RuntimeProfile* profile)
         : VScanner(state, static_cast<VScanNode*>(parent), limit, profile),
           _ranges(scan_range.ranges),
           _next_range(0),
           _cur_reader(nullptr),
           _cur_reader_eof(false),
-          _kv_cache(kv_cache),
           _strict_mode(false) {
     if (scan_range.params.__isset.strict_mode) {
         _strict_mode = scan_range.params.strict_mode;
@@ -117,14 +111,12 @@ VFileScanner::VFileScanner(RuntimeState* state, NewFileScanNode* parent, int64_t
 }
 
 VFileScanner::VFileScanner(RuntimeState* state, pipeline::FileScanLocalState* local_state,
-                           int64_t limit, const TFileScanRange& scan_range, RuntimeProfile* profile,
-                           ShardedKVCache* kv_cache)
+                           int64_t limit, const TFileScanRange& scan_range, RuntimeProfile* profile)
         : VScanner(state, local_state, limit, profile),
           _ranges(scan_range.ranges),
           _next_range(0),
           _cur_reader(nullptr),
           _cur_reader_eof(false),
-          _kv_cache(kv_cache),
           _strict_mode(false) {
     if (scan_range.params.__isset.strict_mode) {
         _strict_mode = scan_range.params.strict_mode;
@@ -164,6 +156,10 @@ Status VFileScanner::prepare(
         _pre_filter_timer = ADD_TIMER(_parent->_scanner_profile, "FileScannerPreFilterTimer");
         _convert_to_output_block_timer =
                 ADD_TIMER(_parent->_scanner_profile, "FileScannerConvertOuputBlockTime");
+        _direct_output_block_timer =
+                ADD_TIMER(_parent->_scanner_profile, "FileScannerDirectOutputBlockTime");
+        _direct_output_rows_counter =
+                ADD_COUNTER(_parent->_scanner_profile, "FileScannerDirectOutputRows", TUnit::UNIT);
         _empty_file_counter = ADD_COUNTER(_parent->_scanner_profile, "EmptyFileNum", TUnit::UNIT);
         _file_counter = ADD_COUNTER(_parent->_scanner_profile, "FileNumber", TUnit::UNIT);
         _has_fully_rf_file_counter =
@@ -181,6 +177,10 @@ Status VFileScanner::prepare(
         _pre_filter_timer = ADD_TIMER(_local_state->scanner_profile(), "FileScannerPreFilterTimer");
         _convert_to_output_block_timer =
                 ADD_TIMER(_local_state->scanner_profile(), "FileScannerConvertOuputBlockTime");
+        _direct_output_block_timer =
+                ADD_TIMER(_local_state->scanner_profile(), "FileScannerDirectOutputBlockTime");
+        _direct_output_rows_counter = ADD_COUNTER(_local_state->scanner_profile(),
+                                                  "FileScannerDirectOutputRows", TUnit::UNIT);
         _empty_file_counter =
                 ADD_COUNTER(_local_state->scanner_profile(), "EmptyFileNum", TUnit::UNIT);
         _file_counter = ADD_COUNTER(_local_state->scanner_profile(), "FileNumber", TUnit::UNIT);
@@ -338,7 +338,11 @@ Status VFileScanner::_get_block_impl(RuntimeState* state, Block* block, bool* eo
         if (read_rows > 0) {
             // If the push_down_agg_type is COUNT, no need to do the rest,
             // because we only save a number in block.
-            if (_get_push_down_agg_type() != TPushAggOp::type::COUNT) {
+            if (_get_push_down_agg_type() != TPushAggOp::type::COUNT && _direct_output) {
+                // The file columns already have the dest types, move them to the output block.
+                RETURN_IF_ERROR(_direct_to_output_block(block, read_rows));
+                RETURN_IF_ERROR(_truncate_char_or_varchar_columns(block));
+            } else if (_get_push_down_agg_type() != TPushAggOp::type::COUNT) {
                 // Convert the src block columns type to string in-place.
                 RETURN_IF_ERROR(_cast_to_input_block(block));
                 // FileReader can fill partition and missing columns itself
@@ -663,6 +667,119 @@ Status VFileScanner::_convert_to_output_block(Block* block) {
     return Status::OK();
 }
 
+// The dest expr of a column loaded from a typed file is a slot ref, or a cast of the slot ref
+// when the input slots are strings. When the file column already has the dest type, the cast
+// from the file type to the input type and the cast back are identities, the column can be
+// moved to the output block as it is.
+void VFileScanner::_init_direct_output() {
+    _direct_output = false;
+    _direct_output_src_idx.clear();
+    if (!_is_load || !config::enable_load_direct_typed_columns || !_pre_conjunct_ctxs.empty()) {
+        return;
+    }
+    auto is_direct_type = [](PrimitiveType type) {
+        return is_int_or_bool(type) || is_float_or_double(type) || is_string_type(type) ||
+               type == TYPE_DECIMAL32 || type == TYPE_DECIMAL64 || type == TYPE_DECIMAL128I ||
+               type == TYPE_DECIMAL256 || type == TYPE_DATEV2 || type == TYPE_DATETIMEV2;
+    };
+    const auto& src_slots = _input_tuple_desc->slots();
+    int ctx_idx = 0;
+    for (auto* slot_desc : _output_tuple_desc->slots()) {
+        if (!slot_desc->is_materialized()) {
+            continue;
+        }
+        const auto& ctx = _dest_vexpr_ctx[ctx_idx++];
+        if (ctx == nullptr || !is_direct_type(slot_desc->type().type)) {
+            return;
+        }
+        VExpr* expr = ctx->root().get();
+        if (dynamic_cast<VCastExpr*>(expr) != nullptr && expr->children().size() == 1) {
+            expr = expr->children()[0].get();
+        }
+        auto* slot_ref = dynamic_cast<VSlotRef*>(expr);
+        if (slot_ref == nullptr) {
+            return;
+        }
+        auto src_it = std::find_if(src_slots.begin(), src_slots.end(), [&](SlotDescriptor* slot) {
+            return slot->id() == slot_ref->slot_id();
+        });
+        if (src_it == src_slots.end() || _partition_slot_index_map.contains((*src_it)->id()) ||
+            _missing_cols.contains((*src_it)->col_name())) {
+            return;
+        }
+        auto file_it = _name_to_col_type.find((*src_it)->col_name());
+        if (file_it == _name_to_col_type.end()) {
+            return;
+        }
+        auto file_type = DataTypeFactory::instance().create_data_type(file_it->second, false);
+        if (!file_type->equals(*remove_nullable(slot_desc->get_data_type_ptr())) ||
+            !file_type->equals(*remove_nullable(ctx->root()->data_type()))) {
+            return;
+        }
+        _direct_output_src_idx.push_back(src_it - src_slots.begin());
+    }
+    _direct_output = true;
+}
+
+Status VFileScanner::_direct_to_output_block(Block* block, size_t rows) {
+    SCOPED_TIMER(_direct_output_block_timer);
+    auto filter_column = vectorized::ColumnUInt8::create(rows, 1);
+    auto& filter_map = filter_column->get_data();
+
+    // makes the columns of the output block if it is not reused
+    MutableBlock mutable_output_block =
+            VectorizedUtils::build_mutable_mem_reuse_block(block, *_dest_row_desc);
+    auto& mutable_output_columns = mutable_output_block.mutable_columns();
+    std::vector<std::pair<int, ColumnPtr>> direct_columns;
+    int ctx_idx = 0;
+    for (int i = 0; i < mutable_output_columns.size(); ++i) {
+        auto* slot_desc = _output_tuple_desc->slots()[i];
+        if (!slot_desc->is_materialized()) {
+            continue;
+        }
+        // the columns of the file are always nullable in the src block
+        auto column_ptr =
+                _src_block_ptr->get_by_position(_direct_output_src_idx[ctx_idx++]).column;
+        if (!slot_desc->is_nullable()) {
+            const auto& nullable_column = assert_cast<const ColumnNullable&>(*column_ptr);
+            for (int row = 0; nullable_column.has_null() && row < rows; ++row) {
+                if (filter_map[row] && nullable_column.is_null_at(row)) {
+                    RETURN_IF_ERROR(_state->append_error_msg_to_file(
+                            [&]() -> std::string {
+                                return _src_block_ptr->dump_one_line(row,
+                                                                     _num_of_columns_from_file);
+                            },
+                            [&]() -> std::string {
+                                return fmt::format(
+                                        "column({}) values is null while columns is not nullable",
+                                        slot_desc->col_name());
+                            },
+                            &_scanner_eof));
+                    filter_map[row] = false;
+                }
+            }
+            column_ptr = nullable_column.get_nested_column_ptr();
+        }
+        direct_columns.emplace_back(i, std::move(column_ptr));
+    }
+    // Release the src columns first, so the file columns are moved to the output block without
+    // a copy, unless one is referred to by several output columns.
+    _src_block_ptr->clear();
+    for (auto& [i, column_ptr] : direct_columns) {
+        mutable_output_columns[i] = (*std::move(column_ptr)).mutate();
+    }
+    block->set_columns(std::move(mutable_output_columns));
+
+    size_t dest_size = block->columns();
+    block->insert(vectorized::ColumnWithTypeAndName(std::move(filter_column),
+                                                    std::make_shared<vectorized::DataTypeUInt8>(),
+                                                    "filter column"));
+    RETURN_IF_ERROR(vectorized::Block::filter_block(block, dest_size, dest_size));
+    _counter.num_rows_filtered += rows - block->rows();
+    COUNTER_UPDATE(_direct_output_rows_counter, rows);
+    return Status::OK();
+}
+
 Status VFileScanner::_truncate_char_or_varchar_columns(Block* block) {
     // Truncate char columns or varchar columns if size is smaller than file columns
     // or not found in the file column schema.
@@ -822,6 +939,13 @@ Status VFileScanner::_get_next_reader() {
                 SCOPED_TIMER(_open_reader_timer);
                 RETURN_IF_ERROR(parquet_reader->open());
             }
+            // read the footer of the next file while this one is scanned
+            if (config::enable_parquet_prefetch && config::max_external_file_meta_cache_num > 0 &&
+                _params->format_type == TFileFormatType::FORMAT_PARQUET &&
+                _next_range < _ranges.size() && _ranges[_next_range].path != range.path) {
+                ParquetReader::prefetch_footer(*_params, _ranges[_next_range],
+                                               ExecEnv::GetInstance()->file_meta_cache());
+            }
             if (push_down_predicates) {
                 RETURN_IF_ERROR(_process_late_arrival_conjuncts());
             }
@@ -829,7 +953,7 @@ Status VFileScanner::_get_next_reader() {
                 range.table_format_params.table_format_type == "iceberg") {
                 std::unique_ptr<IcebergTableReader> iceberg_reader =
                         IcebergTableReader::create_unique(std::move(parquet_reader), _profile,
-                                                          _state, *_params, range, _kv_cache,
+                                                          _state, *_params, range,
                                                           _io_ctx.get(), _get_push_down_count());
                 init_status = iceberg_reader->init_reader(
                         _file_col_names, _col_id_name_map, _colname_to_value_range,
@@ -865,6 +989,20 @@ Status VFileScanner::_get_next_reader() {
             if (push_down_predicates) {
                 RETURN_IF_ERROR(_process_late_arrival_conjuncts());
             }
+            if (range.__isset.table_format_params &&
+                range.table_format_params.table_format_type == "iceberg") {
+                // The equality deletes of iceberg are only applied to parquet data files, never
+                // return the deleted rows silently.
+                for (const auto& delete_file :
+                     range.table_format_params.iceberg_params.delete_files) {
+                    if (delete_file.__isset.field_ids && !delete_file.field_ids.empty()) {
+                        return Status::NotSupported(
+                                "iceberg equality delete file {} of orc data file {} is not "
+                                "supported",
+                                delete_file.path, range.path);
+                    }
+                }
+            }
             if (range.__isset.table_format_params &&
                 range.table_format_params.table_format_type == "transactional_hive") {
                 std::unique_ptr<TransactionalHiveReader> tran_orc_reader =
@@ -950,6 +1088,7 @@ Status VFileScanner::_get_next_reader() {
         RETURN_IF_ERROR(_cur_reader->get_columns(&_name_to_col_type, &_missing_cols));
         _cur_reader->set_push_down_agg_type(_get_push_down_agg_type());
         RETURN_IF_ERROR(_generate_fill_columns());
+        _init_direct_output();
         if (VLOG_NOTICE_IS_ON && !_missing_cols.empty() && _is_load) {
             fmt::memory_buffer col_buf;
             for (auto& col : _missing_cols) {
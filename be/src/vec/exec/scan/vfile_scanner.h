@@ -46,7 +46,6 @@ class TFileScanRange;
 class TFileScanRangeParams;
 
 namespace vectorized {
-class ShardedKVCache;
 class VExpr;
 class VExprContext;
 } // namespace vectorized
@@ -64,12 +63,10 @@ public:
     static constexpr const char* NAME = "VFileScanner";
 
     VFileScanner(RuntimeState* state, NewFileScanNode* parent, int64_t limit,
-                 const TFileScanRange& scan_range, RuntimeProfile* profile,
-                 ShardedKVCache* kv_cache);
+                 const TFileScanRange& scan_range, RuntimeProfile* profile);
 
     VFileScanner(RuntimeState* state, pipeline::FileScanLocalState* parent, int64_t limit,
-                 const TFileScanRange& scan_range, RuntimeProfile* profile,
-                 ShardedKVCache* kv_cache);
+                 const TFileScanRange& scan_range, RuntimeProfile* profile);
 
     Status open(RuntimeState* state) override;
 
@@ -128,6 +125,11 @@ protected:
 
     std::unordered_map<std::string, size_t> _src_block_name_to_idx;
 
+    // For load, whether the materialized dest columns are moved from the src block, see
+    // _init_direct_output(), and the index in the src block of each of them.
+    bool _direct_output = false;
+    std::vector<size_t> _direct_output_src_idx;
+
     // Get from GenericReader, save the existing columns in file to their type.
     std::unordered_map<std::string, TypeDescriptor> _name_to_col_type;
     // Get from GenericReader, save columns that required by scan but not exist in file.
@@ -145,8 +147,6 @@ protected:
     std::unique_ptr<RowDescriptor> _dest_row_desc;
     // row desc for default exprs
     std::unique_ptr<RowDescriptor> _default_val_row_desc;
-    // owned by scan node
-    ShardedKVCache* _kv_cache = nullptr;
 
     bool _scanner_eof = false;
     int _rows = 0;
@@ -176,6 +176,8 @@ private:
     RuntimeProfile::Counter* _fill_missing_columns_timer = nullptr;
     RuntimeProfile::Counter* _pre_filter_timer = nullptr;
     RuntimeProfile::Counter* _convert_to_output_block_timer = nullptr;
+    RuntimeProfile::Counter* _direct_output_block_timer = nullptr;
+    RuntimeProfile::Counter* _direct_output_rows_counter = nullptr;
     RuntimeProfile::Counter* _empty_file_counter = nullptr;
     RuntimeProfile::Counter* _file_counter = nullptr;
     RuntimeProfile::Counter* _has_fully_rf_file_counter = nullptr;
@@ -204,6 +206,8 @@ private:
     Status _fill_missing_columns(size_t rows);
     Status _pre_filter_src_block();
     Status _convert_to_output_block(Block* block);
+    void _init_direct_output();
+    Status _direct_to_output_block(Block* block, size_t rows);
     Status _truncate_char_or_varchar_columns(Block* block);
     void _truncate_char_or_varchar_column(Block* block, int idx, int len);
     Status _generate_fill_columns();
@@ -265,6 +265,11 @@ void VScanner::_update_counters_before_close() {
     } else {
         COUNTER_UPDATE(_local_state->_scan_cpu_timer, _scan_cpu_timer);
         COUNTER_UPDATE(_local_state->_rows_read_counter, _num_rows_read);
+        if (auto* counter = _local_state->saved_subexpr_evaluations_counter()) {
+            for (const auto& ctx : _projections) {
+                COUNTER_UPDATE(counter, ctx->saved_evaluations());
+            }
+        }
     }
     if (!_state->enable_profile() && !_is_load) return;
     // Update stats for load
@@ -26,13 +26,18 @@
 #include <ostream>
 #include <vector>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/columns/column.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
 #include "vec/core/block.h"
 #include "vec/core/column_numbers.h"
 #include "vec/core/column_with_type_and_name.h"
 #include "vec/core/columns_with_type_and_name.h"
+#include "vec/data_types/data_type_nullable.h"
 #include "vec/exprs/vexpr_context.h"
 #include "vec/functions/simple_function_factory.h"
 
@@ -73,6 +78,22 @@ Status VCaseExpr::prepare(RuntimeState* state, const RowDescriptor& desc, VExprC
                                     _fn.name.function_name);
     }
 
+    // The case expr and the first when are evaluated on all rows anyway. The results of the
+    // branches are gathered as is, so they must have the type of the result.
+    for (size_t i = _has_case_expr ? 2 : 1; i < _children.size(); ++i) {
+        _selective_evaluation |= !is_trivial_branch(*_children[i]);
+    }
+    const size_t when_begin = _has_case_expr ? 1 : 0;
+    for (size_t i = when_begin + 1; i < _children.size(); i += 2) {
+        if (!remove_nullable(_children[i]->data_type())->equals(*remove_nullable(_data_type))) {
+            _selective_evaluation = false;
+        }
+    }
+    if (_has_else_expr &&
+        !remove_nullable(_children.back()->data_type())->equals(*remove_nullable(_data_type))) {
+        _selective_evaluation = false;
+    }
+
     VExpr::register_function_context(state, context);
     _prepare_finished = true;
     return Status::OK();
@@ -103,6 +124,10 @@ Status VCaseExpr::execute(VExprContext* context, Block* block, int* result_colum
         return get_result_from_const(block, _expr_name, result_column_id);
     }
     DCHECK(_open_finished || _getting_const_col);
+    if (_selective_evaluation && block->rows() > 0 &&
+        config::selective_branch_evaluation_max_density > 0) {
+        return _execute_selective(context, block, result_column_id);
+    }
     ColumnNumbers arguments(_children.size());
     for (int i = 0; i < _children.size(); i++) {
         int column_id = -1;
@@ -121,6 +146,115 @@ Status VCaseExpr::execute(VExprContext* context, Block* block, int* result_colum
     return Status::OK();
 }
 
+Status VCaseExpr::_execute_selective(VExprContext* context, Block* block, int* result_column_id) {
+    const size_t rows = block->rows();
+    const size_t when_begin = _has_case_expr ? 1 : 0;
+    const size_t num_branches = (_children.size() - when_begin - _has_else_expr) / 2 + 1;
+
+    ColumnPtr case_column;
+    ColumnPtr nullable_case_column;
+    if (_has_case_expr) {
+        int column_id = -1;
+        RETURN_IF_ERROR(_children[0]->execute(context, block, &column_id));
+        case_column = block->get_by_position(column_id).column->convert_to_full_column_if_const();
+    }
+
+    // The branch taken by each row, 0 is the else branch taken by the rows no when matches.
+    std::vector<uint32_t> branch_of_row(rows, 0);
+    IColumn::Filter unmatched(rows, 1);
+    size_t num_unmatched = rows;
+    for (size_t branch = 1; branch < num_branches && num_unmatched > 0; ++branch) {
+        ColumnPtr when_column;
+        bool compacted = false;
+        RETURN_IF_ERROR(execute_on_selected_rows(context, block,
+                                                 _children[when_begin + 2 * (branch - 1)],
+                                                 unmatched, num_unmatched, &when_column,
+                                                 &compacted));
+        when_column = when_column->convert_to_full_column_if_const();
+
+        const IColumn* lhs = case_column.get();
+        const UInt8* when_data = nullptr;
+        const UInt8* when_null_map = nullptr;
+        if (_has_case_expr) {
+            // Nullable columns only compare to nullable columns.
+            if (case_column->is_nullable() && !when_column->is_nullable()) {
+                when_column = make_nullable(when_column);
+            } else if (!case_column->is_nullable() && when_column->is_nullable()) {
+                if (nullable_case_column == nullptr) {
+                    nullable_case_column = make_nullable(case_column);
+                }
+                lhs = nullable_case_column.get();
+            }
+        } else if (when_column->is_nullable()) {
+            const auto& nullable_column = assert_cast<const ColumnNullable&>(*when_column);
+            when_null_map = nullable_column.get_null_map_data().data();
+            when_data = assert_cast<const ColumnUInt8&>(nullable_column.get_nested_column())
+                                .get_data()
+                                .data();
+        } else {
+            when_data = assert_cast<const ColumnUInt8&>(*when_column).get_data().data();
+        }
+
+        size_t when_row = 0;
+        for (size_t row = 0; row < rows; ++row) {
+            if (!unmatched[row]) {
+                continue;
+            }
+            const size_t pos = compacted ? when_row++ : row;
+            bool matched = false;
+            if (_has_case_expr) {
+                matched = !lhs->is_null_at(row) && lhs->compare_at(row, pos, *when_column, -1) == 0;
+            } else {
+                matched = (when_null_map == nullptr || !when_null_map[pos]) && when_data[pos];
+            }
+            if (matched) {
+                branch_of_row[row] = branch;
+                unmatched[row] = 0;
+                --num_unmatched;
+            }
+        }
+    }
+
+    std::vector<size_t> branch_rows(num_branches, 0);
+    for (size_t row = 0; row < rows; ++row) {
+        ++branch_rows[branch_of_row[row]];
+    }
+    std::vector<ColumnPtr> branch_columns(num_branches);
+    std::vector<uint8_t> compacted(num_branches, 0);
+    IColumn::Filter selector;
+    for (size_t branch = 0; branch < num_branches; ++branch) {
+        if (branch_rows[branch] == 0 || (branch == 0 && !_has_else_expr)) {
+            continue;
+        }
+        const auto& expr =
+                branch == 0 ? _children.back() : _children[when_begin + 2 * (branch - 1) + 1];
+        if (branch > 0) {
+            selector.resize(rows);
+            for (size_t row = 0; row < rows; ++row) {
+                selector[row] = branch_of_row[row] == branch;
+            }
+        }
+        bool is_compacted = false;
+        RETURN_IF_ERROR(execute_on_selected_rows(context, block, expr,
+                                                 branch == 0 ? unmatched : selector,
+                                                 branch_rows[branch], &branch_columns[branch],
+                                                 &is_compacted));
+        compacted[branch] = is_compacted;
+    }
+
+    std::vector<uint32_t> source_row(rows);
+    std::vector<uint32_t> next_row(num_branches, 0);
+    for (size_t row = 0; row < rows; ++row) {
+        const uint32_t branch = branch_of_row[row];
+        source_row[row] = compacted[branch] ? next_row[branch]++ : row;
+    }
+    *result_column_id = block->columns();
+    block->insert({gather_branches(_data_type, branch_of_row, source_row,
+                                   std::move(branch_columns)),
+                   _data_type, _expr_name});
+    return Status::OK();
+}
+
 const std::string& VCaseExpr::expr_name() const {
     return _expr_name;
 }
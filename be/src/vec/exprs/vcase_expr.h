@@ -52,8 +52,14 @@ public:
     std::string debug_string() const override;
 
 private:
+    // Evaluate each when only on the rows not matched yet, and each then/else only on the rows
+    // that select it.
+    Status _execute_selective(VExprContext* context, Block* block, int* result_column_id);
+
     bool _has_case_expr;
     bool _has_else_expr;
+    // Some branch is not trivial, so it is worth to be evaluated on its rows only.
+    bool _selective_evaluation = false;
 
     FunctionBasePtr _function;
     std::string _function_name = "case";
@@ -20,6 +20,7 @@
 #include <fmt/format.h>
 #include <fmt/ranges.h> // IWYU pragma: keep
 #include <gen_cpp/Types_types.h>
+#include <parallel_hashmap/phmap.h>
 
 #include <ostream>
 #include <string_view>
@@ -28,15 +29,22 @@
 #include "common/config.h"
 #include "common/consts.h"
 #include "common/status.h"
+#include "runtime/primitive_type.h"
 #include "runtime/runtime_state.h"
 #include "udf/udf.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
 #include "vec/columns/column.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/string_ref.h"
 #include "vec/core/block.h"
 #include "vec/core/column_with_type_and_name.h"
 #include "vec/core/columns_with_type_and_name.h"
 #include "vec/data_types/data_type.h"
 #include "vec/data_types/data_type_agg_state.h"
+#include "vec/data_types/data_type_nullable.h"
 #include "vec/exprs/vexpr_context.h"
 #include "vec/functions/function_agg_state.h"
 #include "vec/functions/function_java_udf.h"
@@ -54,6 +62,14 @@ namespace doris::vectorized {
 
 const std::string AGG_STATE_SUFFIX = "_state";
 
+// Deterministic functions of a string, whose other arguments are usually constants, and costly
+// enough that hashing the strings to find the distinct ones is worth it.
+static const phmap::flat_hash_set<std::string> DICTIONARY_EVALUATED_FUNCTIONS = {
+        "upper", "lower", "substring", "trim", "ltrim", "rtrim", "reverse", "split_part",
+        "parse_url", "extract_url_parameter", "regexp_extract", "regexp_extract_all",
+        "regexp_replace", "regexp_replace_one", "get_json_string", "get_json_int",
+        "get_json_double", "json_extract"};
+
 VectorizedFnCall::VectorizedFnCall(const TExprNode& node) : VExpr(node) {}
 
 Status VectorizedFnCall::prepare(RuntimeState* state, const RowDescriptor& desc,
@@ -113,6 +129,37 @@ Status VectorizedFnCall::prepare(RuntimeState* state, const RowDescriptor& desc,
     VExpr::register_function_context(state, context);
     _function_name = _fn.name.function_name;
     _can_fast_execute = _function->can_fast_execute();
+    if (_fn.binary_type == TFunctionBinaryType::BUILTIN &&
+        (_function_name == "if" || _function_name == "coalesce" || _function_name == "ifnull" ||
+         _function_name == "nvl")) {
+        // The condition of if and the first argument of coalesce are evaluated on all rows.
+        // The results of the branches are gathered as is, so they must have the result type.
+        const size_t first_branch = _function_name == "if" ? 1 : 0;
+        for (size_t i = first_branch; i < _children.size(); ++i) {
+            if (i > 0 && !is_trivial_branch(*_children[i])) {
+                _selective_evaluation = true;
+            }
+            if (!remove_nullable(_children[i]->data_type())->equals(*remove_nullable(_data_type))) {
+                _selective_evaluation = false;
+                break;
+            }
+        }
+    }
+    if (_fn.binary_type == TFunctionBinaryType::BUILTIN &&
+        DICTIONARY_EVALUATED_FUNCTIONS.contains(_function->get_name())) {
+        size_t num_non_constant = 0;
+        for (size_t i = 0; i < _children.size(); ++i) {
+            if (!_children[i]->is_constant()) {
+                ++num_non_constant;
+                _dictionary_argument = i;
+            }
+        }
+        _dictionary_evaluation =
+                num_non_constant == 1 &&
+                is_string_type(remove_nullable(_children[_dictionary_argument]->data_type())
+                                       ->get_type_as_type_descriptor()
+                                       .type);
+    }
     _prepare_finished = true;
     return Status::OK();
 }
@@ -143,6 +190,10 @@ Status VectorizedFnCall::execute(VExprContext* context, vectorized::Block* block
     }
 
     DCHECK(_open_finished || _getting_const_col) << debug_string();
+    if (_selective_evaluation && block->rows() > 0 &&
+        config::selective_branch_evaluation_max_density > 0) {
+        return _execute_selective(context, block, result_column_id);
+    }
     // TODO: not execute const expr again, but use the const column in function context
     vectorized::ColumnNumbers arguments(_children.size());
     for (int i = 0; i < _children.size(); ++i) {
@@ -166,6 +217,16 @@ Status VectorizedFnCall::execute(VExprContext* context, vectorized::Block* block
         }
     }
 
+    if (_dictionary_evaluation) {
+        bool executed = false;
+        RETURN_IF_ERROR(_execute_on_dictionary(context, block, arguments,
+                                               num_columns_without_result, &executed));
+        if (executed) {
+            *result_column_id = num_columns_without_result;
+            return Status::OK();
+        }
+    }
+
     RETURN_IF_ERROR(_function->execute(context->fn_context(_fn_context_index), *block, arguments,
                                        num_columns_without_result, block->rows(), false));
     *result_column_id = num_columns_without_result;
@@ -173,6 +234,192 @@ Status VectorizedFnCall::execute(VExprContext* context, vectorized::Block* block
     return Status::OK();
 }
 
+Status VectorizedFnCall::_execute_on_dictionary(VExprContext* context, Block* block,
+                                                const ColumnNumbers& arguments, size_t result,
+                                                bool* executed) {
+    // Not worth it for small blocks.
+    constexpr size_t MIN_ROWS = 256;
+    constexpr uint32_t MAX_MISSES = 8;
+    *executed = false;
+    const size_t rows = block->rows();
+    const auto max_dictionary_size =
+            static_cast<size_t>(rows * config::dictionary_function_evaluation_max_ratio);
+    // Blocks with too many distinct values in a row, the dictionary is not built any more after
+    // a few of them. Kept in the function context, which is not shared by the cloned contexts.
+    uint32_t& misses = context->fn_context(_fn_context_index)->dictionary_misses();
+    if (rows < MIN_ROWS || max_dictionary_size == 0 || misses >= MAX_MISSES) {
+        return Status::OK();
+    }
+    // Only the string argument is not a constant.
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        const bool is_const = is_column_const(*block->get_by_position(arguments[i]).column);
+        if (is_const != (i != _dictionary_argument)) {
+            return Status::OK();
+        }
+    }
+
+    const auto& argument_column = block->get_by_position(arguments[_dictionary_argument]).column;
+    const IColumn* data_column = argument_column.get();
+    const UInt8* null_map = nullptr;
+    if (const auto* nullable_column = check_and_get_column<ColumnNullable>(*data_column)) {
+        null_map = nullable_column->get_null_map_data().data();
+        data_column = &nullable_column->get_nested_column();
+    }
+    const auto* strings = check_and_get_column<ColumnString>(*data_column);
+    if (strings == nullptr) {
+        return Status::OK();
+    }
+
+    // The entry of each row, and the first row of each entry. All the null rows share one entry.
+    std::vector<uint32_t> codes(rows);
+    std::vector<uint32_t> entry_rows;
+    phmap::flat_hash_map<StringRef, uint32_t, StringRefHash> dictionary;
+    int64_t null_code = -1;
+    for (uint32_t row = 0; row < rows; ++row) {
+        if (null_map != nullptr && null_map[row]) {
+            if (null_code < 0) {
+                null_code = entry_rows.size();
+                entry_rows.push_back(row);
+            }
+            codes[row] = null_code;
+            continue;
+        }
+        auto [it, inserted] =
+                dictionary.try_emplace(strings->get_data_at(row), (uint32_t)entry_rows.size());
+        if (inserted) {
+            if (entry_rows.size() >= max_dictionary_size) {
+                ++misses;
+                return Status::OK();
+            }
+            entry_rows.push_back(row);
+        }
+        codes[row] = it->second;
+    }
+    misses = 0;
+
+    const size_t dictionary_size = entry_rows.size();
+    Block dictionary_block;
+    ColumnNumbers dictionary_arguments(arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        const auto& argument = block->get_by_position(arguments[i]);
+        ColumnPtr column;
+        if (i == _dictionary_argument) {
+            auto entries = argument.column->clone_empty();
+            entries->insert_indices_from(*argument.column, entry_rows.data(),
+                                         entry_rows.data() + dictionary_size);
+            column = std::move(entries);
+        } else {
+            column = argument.column->clone_resized(dictionary_size);
+        }
+        dictionary_arguments[i] = i;
+        dictionary_block.insert({std::move(column), argument.type, argument.name});
+    }
+    dictionary_block.insert({nullptr, _data_type, _expr_name});
+    RETURN_IF_ERROR(_function->execute(context->fn_context(_fn_context_index), dictionary_block,
+                                       dictionary_arguments, arguments.size(), dictionary_size,
+                                       false));
+
+    auto dictionary_result = dictionary_block.get_by_position(arguments.size())
+                                     .column->convert_to_full_column_if_const();
+    auto result_column = dictionary_result->clone_empty();
+    result_column->insert_indices_from(*dictionary_result, codes.data(), codes.data() + rows);
+    block->replace_by_position(result, std::move(result_column));
+    *executed = true;
+    return Status::OK();
+}
+
+Status VectorizedFnCall::_execute_selective(VExprContext* context, Block* block,
+                                            int* result_column_id) {
+    const size_t rows = block->rows();
+    // The branch taken by each row and its row in the result of the branch. For if, 0 is the
+    // then branch and 1 the else branch. For coalesce, the first not null argument.
+    std::vector<uint32_t> branch_of_row(rows, 0);
+    std::vector<uint32_t> source_row(rows);
+    std::vector<ColumnPtr> branch_columns;
+
+    if (_function_name == "if") {
+        int column_id = -1;
+        RETURN_IF_ERROR(_children[0]->execute(context, block, &column_id));
+        auto cond_column =
+                block->get_by_position(column_id).column->convert_to_full_column_if_const();
+        const UInt8* cond_null_map = nullptr;
+        const IColumn* cond_data_column = cond_column.get();
+        if (cond_column->is_nullable()) {
+            const auto& nullable_column = assert_cast<const ColumnNullable&>(*cond_column);
+            cond_null_map = nullable_column.get_null_map_data().data();
+            cond_data_column = &nullable_column.get_nested_column();
+        }
+        const auto* cond_data =
+                assert_cast<const ColumnUInt8*>(cond_data_column)->get_data().data();
+
+        IColumn::Filter then_rows(rows);
+        IColumn::Filter else_rows(rows);
+        size_t num_then = 0;
+        for (size_t row = 0; row < rows; ++row) {
+            const bool is_then =
+                    (cond_null_map == nullptr || !cond_null_map[row]) && cond_data[row];
+            then_rows[row] = is_then;
+            else_rows[row] = !is_then;
+            branch_of_row[row] = !is_then;
+            num_then += is_then;
+        }
+
+        branch_columns.resize(2);
+        bool compacted[2] = {false, false};
+        if (num_then > 0) {
+            RETURN_IF_ERROR(execute_on_selected_rows(context, block, _children[1], then_rows,
+                                                     num_then, &branch_columns[0],
+                                                     &compacted[0]));
+        }
+        if (num_then < rows) {
+            RETURN_IF_ERROR(execute_on_selected_rows(context, block, _children[2], else_rows,
+                                                     rows - num_then, &branch_columns[1],
+                                                     &compacted[1]));
+        }
+        uint32_t next_row[2] = {0, 0};
+        for (size_t row = 0; row < rows; ++row) {
+            const uint32_t branch = branch_of_row[row];
+            source_row[row] = compacted[branch] ? next_row[branch]++ : row;
+        }
+    } else {
+        branch_columns.resize(_children.size());
+        IColumn::Filter remaining(rows, 1);
+        size_t num_remaining = rows;
+        for (size_t arg = 0; arg < _children.size() && num_remaining > 0; ++arg) {
+            bool compacted = false;
+            RETURN_IF_ERROR(execute_on_selected_rows(context, block, _children[arg], remaining,
+                                                     num_remaining, &branch_columns[arg],
+                                                     &compacted));
+            auto& column = branch_columns[arg];
+            column = column->convert_to_full_column_if_const();
+            // The remaining rows all take the last argument, or the first not nullable one.
+            const UInt8* null_map = nullptr;
+            if (arg + 1 < _children.size() && column->is_nullable()) {
+                null_map = assert_cast<const ColumnNullable&>(*column).get_null_map_data().data();
+            }
+            size_t pos = 0;
+            for (size_t row = 0; row < rows; ++row) {
+                if (!remaining[row]) {
+                    continue;
+                }
+                const size_t arg_row = compacted ? pos++ : row;
+                if (null_map == nullptr || !null_map[arg_row]) {
+                    branch_of_row[row] = arg;
+                    source_row[row] = arg_row;
+                    remaining[row] = 0;
+                    --num_remaining;
+                }
+            }
+        }
+    }
+
+    *result_column_id = block->columns();
+    block->insert({gather_branches(_data_type, branch_of_row, source_row,
+                                   std::move(branch_columns)),
+                   _data_type, _expr_name});
+    return Status::OK();
+}
+
 // fast_execute can direct copy expr filter result which build by apply index in segment_iterator
 bool VectorizedFnCall::fast_execute(FunctionContext* context, Block& block,
                                     const ColumnNumbers& arguments, size_t result,
@@ -67,8 +67,21 @@ public:
                       size_t result, size_t input_rows_count);
 
 protected:
+    // if, coalesce and ifnull evaluate a branch only on the rows that take it, see
+    // `VCaseExpr::_execute_selective`.
+    Status _execute_selective(VExprContext* context, Block* block, int* result_column_id);
+    // Deterministic string functions of a single string column are evaluated once per distinct
+    // value of the column, the results are then gathered back for every row. `executed` is
+    // false when the block has too many distinct values.
+    Status _execute_on_dictionary(VExprContext* context, Block* block,
+                                  const ColumnNumbers& arguments, size_t result, bool* executed);
+
     FunctionBasePtr _function;
     bool _can_fast_execute = false;
+    bool _selective_evaluation = false;
+    bool _dictionary_evaluation = false;
+    // The string argument evaluated on its distinct values, the others must be constants.
+    size_t _dictionary_argument = 0;
     std::string _expr_name;
     std::string _function_name;
 };
@@ -27,10 +27,14 @@
 #include <stack>
 
 #include "common/config.h"
+#include "common/consts.h"
 #include "common/exception.h"
 #include "common/status.h"
+#include "vec/columns/column_const.h"
+#include "vec/columns/column_nullable.h"
 #include "vec/columns/column_vector.h"
 #include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
 #include "vec/data_types/data_type_factory.hpp"
 #include "vec/data_types/data_type_number.h"
 #include "vec/exprs/varray_literal.h"
@@ -556,6 +560,156 @@ Status VExpr::check_constant(const Block& block, ColumnNumbers arguments) const
     return Status::OK();
 }
 
+namespace {
+
+// Collect the block columns read by `expr`, false if it reads the block in other ways than
+// through slot refs, e.g. lambda arguments or inverted index results indexed by row.
+bool collect_slot_column_ids(const VExpr& expr, std::vector<int>* column_ids) {
+    switch (expr.node_type()) {
+    case TExprNodeType::SLOT_REF:
+        column_ids->push_back(static_cast<const VSlotRef&>(expr).column_id());
+        return true;
+    case TExprNodeType::COLUMN_REF:
+    case TExprNodeType::LAMBDA_FUNCTION_EXPR:
+    case TExprNodeType::LAMBDA_FUNCTION_CALL_EXPR:
+    case TExprNodeType::MATCH_PRED:
+        return false;
+    default:
+        break;
+    }
+    return std::all_of(expr.children().begin(), expr.children().end(),
+                       [&](const VExprSPtr& child) {
+                           return collect_slot_column_ids(*child, column_ids);
+                       });
+}
+
+} // namespace
+
+bool VExpr::is_trivial_branch(const VExpr& expr) {
+    if (expr.node_type() == TExprNodeType::CAST_EXPR) {
+        return is_trivial_branch(*expr.children()[0]);
+    }
+    return expr.is_slot_ref() || expr.is_constant();
+}
+
+Status VExpr::execute_on_selected_rows(VExprContext* context, Block* block, const VExprSPtr& expr,
+                                       const IColumn::Filter& selector, size_t num_selected,
+                                       ColumnPtr* result, bool* compacted) {
+    const size_t rows = block->rows();
+    std::vector<int> column_ids;
+    if (is_trivial_branch(*expr) || num_selected >= rows ||
+        num_selected > rows * config::selective_branch_evaluation_max_density ||
+        !collect_slot_column_ids(*expr, &column_ids) || column_ids.empty()) {
+        int column_id = -1;
+        RETURN_IF_ERROR(expr->execute(context, block, &column_id));
+        *result = block->get_by_position(column_id).column;
+        *compacted = false;
+        return Status::OK();
+    }
+
+    // Same column positions as `block`, only the columns read by `expr` are filtered, the
+    // others are replaced by constants of the right size. A column shorter than the block, such
+    // as a column not read yet by a lazily materializing scan, is replaced by an empty one.
+    Block selected_block;
+    std::vector<uint8_t> is_read(block->columns(), 0);
+    for (int column_id : column_ids) {
+        is_read[column_id] = 1;
+    }
+    for (size_t i = 0; i < block->columns(); ++i) {
+        const auto& column = block->get_by_position(i);
+        ColumnPtr selected_column;
+        if (is_read[i] || column.name.starts_with(BeConsts::BLOCK_TEMP_COLUMN_PREFIX)) {
+            // Temp columns hold the results of inverted index filters, see `fast_execute`.
+            selected_column = column.column->filter(selector, num_selected);
+        } else if (column.column == nullptr || column.column->size() < rows) {
+            selected_column = column.column == nullptr ? nullptr : column.column->clone_empty();
+        } else if (is_column_const(*column.column)) {
+            selected_column = column.column->clone_resized(num_selected);
+        } else {
+            selected_column = ColumnConst::create(column.column->cut(0, 1), num_selected);
+        }
+        selected_block.insert({std::move(selected_column), column.type, column.name});
+    }
+    int column_id = -1;
+    RETURN_IF_ERROR(expr->execute(context, &selected_block, &column_id));
+    *result = selected_block.get_by_position(column_id).column;
+    *compacted = true;
+    return Status::OK();
+}
+
+ColumnPtr VExpr::gather_branches(const DataTypePtr& data_type,
+                                 const std::vector<uint32_t>& branch_of_row,
+                                 const std::vector<uint32_t>& source_row,
+                                 std::vector<ColumnPtr> branch_columns) {
+    const size_t rows = branch_of_row.size();
+    // A constant branch keeps its single value, all its rows are taken from row 0.
+    std::vector<uint8_t> is_const(branch_columns.size(), 0);
+    for (size_t branch = 0; branch < branch_columns.size(); ++branch) {
+        auto& column = branch_columns[branch];
+        if (column == nullptr) {
+            continue;
+        }
+        if (is_column_const(*column)) {
+            column = assert_cast<const ColumnConst&>(*column).get_data_column_ptr();
+            is_const[branch] = 1;
+        }
+        if (data_type->is_nullable() && !column->is_nullable()) {
+            column = make_nullable(column);
+        } else if (!data_type->is_nullable() && column->is_nullable()) {
+            // The rows taken from a nullable branch of a not nullable result are not null.
+            column = assert_cast<const ColumnNullable&>(*column).get_nested_column_ptr();
+        }
+    }
+
+    // All the rows taken in place from one branch evaluated on the whole block.
+    const uint32_t first_branch = rows > 0 ? branch_of_row[0] : 0;
+    const auto& first_column = rows > 0 ? branch_columns[first_branch] : nullptr;
+    if (first_column != nullptr && !is_const[first_branch] && first_column->size() == rows) {
+        bool in_place = true;
+        for (size_t row = 0; row < rows && in_place; ++row) {
+            in_place = branch_of_row[row] == first_branch && source_row[row] == row;
+        }
+        if (in_place) {
+            return first_column;
+        }
+    }
+
+    // The columns of the branches are appended to each other, followed by a default value for
+    // the rows of the branches that are not evaluated, and the rows of the result are taken
+    // from there by index, with the typed copies of the columns instead of one virtual call
+    // per row.
+    std::vector<uint32_t> offsets(branch_columns.size(), 0);
+    size_t num_branch_rows = 0;
+    for (size_t branch = 0; branch < branch_columns.size(); ++branch) {
+        if (branch_columns[branch] != nullptr) {
+            offsets[branch] = num_branch_rows;
+            num_branch_rows += branch_columns[branch]->size();
+        }
+    }
+    auto branch_rows = data_type->create_column();
+    branch_rows->reserve(num_branch_rows + 1);
+    for (const auto& column : branch_columns) {
+        if (column != nullptr) {
+            branch_rows->insert_range_from(*column, 0, column->size());
+        }
+    }
+    const auto default_row = static_cast<uint32_t>(num_branch_rows);
+    branch_rows->insert_default();
+
+    std::vector<uint32_t> indices(rows);
+    for (size_t row = 0; row < rows; ++row) {
+        const uint32_t branch = branch_of_row[row];
+        if (branch_columns[branch] == nullptr) {
+            indices[row] = default_row;
+        } else {
+            indices[row] = offsets[branch] + (is_const[branch] ? 0 : source_row[row]);
+        }
+    }
+    auto result = data_type->create_column();
+    result->insert_indices_from(*branch_rows, indices.data(), indices.data() + rows);
+    return result;
+}
+
 Status VExpr::get_result_from_const(vectorized::Block* block, const std::string& expr_name,
                                     int* result_column_id) {
     *result_column_id = block->columns();
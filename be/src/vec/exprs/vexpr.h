@@ -76,6 +76,16 @@ public:
 
     static bool is_acting_on_a_slot(const VExpr& expr);
 
+    /// Execute `expr` on the rows of `block` selected by `selector`. `result` holds only the
+    /// selected rows if `compacted` is set, otherwise all the rows of the block: `expr` is then
+    /// evaluated in place, when it is trivial or selects most of the rows, see
+    /// `config::selective_branch_evaluation_max_density`. Used by the branches of conditional
+    /// expressions and by conjuncts evaluated after more selective ones.
+    static Status execute_on_selected_rows(VExprContext* context, Block* block,
+                                           const VExprSPtr& expr, const IColumn::Filter& selector,
+                                           size_t num_selected, ColumnPtr* result,
+                                           bool* compacted);
+
     VExpr(const TExprNode& node);
     VExpr(const VExpr& vexpr);
     VExpr(TypeDescriptor type, bool is_slotref, bool is_nullable);
@@ -235,6 +245,20 @@ protected:
 
     Status check_constant(const Block& block, ColumnNumbers arguments) const;
 
+    /// Helpers for the selective evaluation of conditional expressions (CASE, IF, COALESCE,
+    /// IFNULL), which only evaluate a branch on the rows that select it.
+    /// Whether `expr` is cheap enough to always be evaluated on the whole block: a slot, a
+    /// constant, or a cast of them. The selective evaluation is only used when some branch is
+    /// not trivial.
+    static bool is_trivial_branch(const VExpr& expr);
+
+    /// Build the result of a conditional expression, row i is row `source_row[i]` of the column
+    /// of branch `branch_of_row[i]`, or the default value (NULL) if that column is null.
+    static ColumnPtr gather_branches(const DataTypePtr& data_type,
+                                     const std::vector<uint32_t>& branch_of_row,
+                                     const std::vector<uint32_t>& source_row,
+                                     std::vector<ColumnPtr> branch_columns);
+
     /// Helper function that calls ctx->register(), sets fn_context_index_, and returns the
     /// registered FunctionContext
     void register_function_context(RuntimeState* state, VExprContext* context);
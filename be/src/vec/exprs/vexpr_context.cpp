@@ -17,18 +17,29 @@
 
 #include "vec/exprs/vexpr_context.h"
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <numeric>
 #include <ostream>
 #include <string>
 
 #include "common/compiler_util.h" // IWYU pragma: keep
+#include "common/config.h"
 #include "common/exception.h"
 #include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
 #include "udf/udf.h"
+#include "util/simd/bits.h"
+#include "util/stopwatch.hpp"
 #include "vec/columns/column_const.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
 #include "vec/core/column_with_type_and_name.h"
 #include "vec/core/columns_with_type_and_name.h"
 #include "vec/exprs/vexpr.h"
+#include "vec/exprs/vshared_expr.h"
 
 namespace doris {
 class RowDescriptor;
@@ -144,19 +155,131 @@ Status VExprContext::execute_conjuncts(const VExprContextSPtrs& ctxs,
     return execute_conjuncts(ctxs, filters, false, block, result_filter, can_filter_all);
 }
 
-// TODO: Performance Optimization
+Status VExprContext::execute_on_selected_rows(Block* block, const IColumn::Filter& selector,
+                                              size_t num_selected, ColumnPtr* result,
+                                              bool* compacted) {
+    Status st;
+    RETURN_IF_CATCH_EXCEPTION({
+        st = VExpr::execute_on_selected_rows(this, block, _root, selector, num_selected, result,
+                                             compacted);
+    });
+    return st;
+}
+
+double VExprContext::_conjunct_rank() const {
+    // Not evaluated yet, try it first to know it.
+    if (_conjunct_input_rows == 0 || _conjunct_evaluated_rows == 0) {
+        return 0;
+    }
+    const double cost = static_cast<double>(_conjunct_exec_ns) / _conjunct_evaluated_rows;
+    const double selectivity = static_cast<double>(_conjunct_passed_rows) / _conjunct_input_rows;
+    return cost / std::max(1 - selectivity, 1e-6);
+}
+
+std::vector<size_t> VExprContext::_conjuncts_order(const VExprContextSPtrs& ctxs) {
+    std::vector<size_t> order(ctxs.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (ctxs.size() > 1 && config::enable_adaptive_conjunct_order) {
+        std::vector<double> ranks(ctxs.size());
+        for (size_t i = 0; i < ctxs.size(); ++i) {
+            ranks[i] = ctxs[i]->_conjunct_rank();
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t lhs, size_t rhs) { return ranks[lhs] < ranks[rhs]; });
+    }
+    return order;
+}
+
+void VExprContext::_update_conjunct_stats(size_t input_rows, size_t passed_rows,
+                                          size_t evaluated_rows, int64_t exec_ns) {
+    // Forget the old blocks progressively, so that the order follows the changes of the data.
+    constexpr int64_t STATS_WINDOW_ROWS = 1 << 20;
+    if (_conjunct_input_rows > STATS_WINDOW_ROWS) {
+        _conjunct_input_rows /= 2;
+        _conjunct_passed_rows /= 2;
+        _conjunct_evaluated_rows /= 2;
+        _conjunct_exec_ns /= 2;
+    }
+    _conjunct_input_rows += input_rows;
+    _conjunct_passed_rows += passed_rows;
+    _conjunct_evaluated_rows += evaluated_rows;
+    _conjunct_exec_ns += exec_ns;
+}
+
+std::string VExprContext::conjuncts_stats_string(const VExprContextSPtrs& ctxs) {
+    fmt::memory_buffer out;
+    for (size_t i : _conjuncts_order(ctxs)) {
+        const auto& ctx = ctxs[i];
+        fmt::format_to(out, "{}{}(PassRate={:.2f}%, Cost={:.1f}ns/row)", out.size() ? ", " : "",
+                       ctx->root()->expr_name(),
+                       ctx->_conjunct_input_rows
+                               ? 100.0 * ctx->_conjunct_passed_rows / ctx->_conjunct_input_rows
+                               : 100.0,
+                       ctx->_conjunct_evaluated_rows ? static_cast<double>(ctx->_conjunct_exec_ns) /
+                                                               ctx->_conjunct_evaluated_rows
+                                                     : 0.0);
+    }
+    return fmt::to_string(out);
+}
+
+// The conjuncts are evaluated by increasing cost / (1 - selectivity), and each of them only on
+// the rows that passed the previous ones when few rows are left.
 Status VExprContext::execute_conjuncts(const VExprContextSPtrs& ctxs,
                                        const std::vector<IColumn::Filter*>* filters,
                                        bool accept_null, Block* block,
                                        IColumn::Filter* result_filter, bool* can_filter_all) {
     DCHECK(result_filter->size() == block->rows());
     *can_filter_all = false;
+    SharedExprEvaluationScope evaluation_scope(block);
     auto* __restrict result_filter_data = result_filter->data();
-    for (const auto& ctx : ctxs) {
-        int result_column_id = -1;
-        RETURN_IF_ERROR(ctx->execute(block, &result_column_id));
-        ColumnPtr& filter_column = block->get_by_position(result_column_id).column;
-        if (const auto* nullable_column = check_and_get_column<ColumnNullable>(*filter_column)) {
+    const size_t rows = result_filter->size();
+    auto count_selected = [&]() {
+        return rows - simd::count_zero_num(reinterpret_cast<const int8_t*>(result_filter_data),
+                                           rows);
+    };
+    const bool adaptive = config::enable_adaptive_conjunct_order;
+    size_t num_selected = adaptive ? count_selected() : rows;
+    if (adaptive && num_selected == 0 && !ctxs.empty()) {
+        *can_filter_all = true;
+        return Status::OK();
+    }
+    for (size_t i : _conjuncts_order(ctxs)) {
+        const auto& ctx = ctxs[i];
+        MonotonicStopWatch watch;
+        watch.start();
+        ColumnPtr filter_column;
+        bool compacted = false;
+        if (adaptive) {
+            RETURN_IF_ERROR(ctx->execute_on_selected_rows(block, *result_filter, num_selected,
+                                                          &filter_column, &compacted));
+        } else {
+            int result_column_id = -1;
+            RETURN_IF_ERROR(ctx->execute(block, &result_column_id));
+            filter_column = block->get_by_position(result_column_id).column;
+        }
+
+        if (compacted) {
+            // One row for each row selected by `result_filter`.
+            auto [data_column, is_const] = unpack_if_const(filter_column);
+            const UInt8* null_map_data = nullptr;
+            if (const auto* nullable_column = check_and_get_column<ColumnNullable>(*data_column)) {
+                null_map_data = nullable_column->get_null_map_data().data();
+                data_column = nullable_column->get_nested_column_ptr();
+            }
+            const auto* __restrict filter_data =
+                    assert_cast<const ColumnUInt8&>(*data_column).get_data().data();
+            size_t pos = 0;
+            for (size_t row = 0; row < rows; ++row) {
+                if (!result_filter_data[row]) {
+                    continue;
+                }
+                const size_t selected_row = is_const ? 0 : pos++;
+                result_filter_data[row] = (null_map_data && null_map_data[selected_row])
+                                                  ? accept_null
+                                                  : filter_data[selected_row];
+            }
+        } else if (const auto* nullable_column =
+                           check_and_get_column<ColumnNullable>(*filter_column)) {
             size_t column_size = nullable_column->size();
             if (column_size == 0) {
                 *can_filter_all = true;
@@ -178,11 +301,6 @@ Status VExprContext::execute_conjuncts(const VExprContextSPtrs& ctxs,
                         result_filter_data[i] &= (!null_map_data[i]) & filter_data[i];
                     }
                 }
-
-                if (memchr(result_filter_data, 0x1, size) == nullptr) {
-                    *can_filter_all = true;
-                    return Status::OK();
-                }
             }
         } else if (const auto* const_column = check_and_get_column<ColumnConst>(*filter_column)) {
             // filter all
@@ -200,12 +318,23 @@ Status VExprContext::execute_conjuncts(const VExprContextSPtrs& ctxs,
             for (size_t i = 0; i < size; ++i) {
                 result_filter_data[i] &= filter_data[i];
             }
+        }
 
-            if (memchr(result_filter_data, 0x1, size) == nullptr) {
+        if (!adaptive) {
+            if (memchr(result_filter_data, 0x1, rows) == nullptr) {
                 *can_filter_all = true;
                 return Status::OK();
             }
+            continue;
+        }
+        const size_t num_passed = count_selected();
+        ctx->_update_conjunct_stats(num_selected, num_passed, compacted ? num_selected : rows,
+                                    watch.elapsed_time());
+        if (num_passed == 0) {
+            *can_filter_all = true;
+            return Status::OK();
         }
+        num_selected = num_passed;
     }
     if (filters != nullptr) {
         for (auto* filter : *filters) {
@@ -235,6 +364,7 @@ Status VExprContext::execute_conjuncts(const VExprContextSPtrs& conjuncts, Block
     memset(final_null_map, 0, rows);
     filter.resize_fill(rows, 1);
     auto* final_filter_ptr = filter.data();
+    SharedExprEvaluationScope evaluation_scope(block);
 
     for (const auto& conjunct : conjuncts) {
         int result_column_id = -1;
@@ -20,6 +20,7 @@
 #include <glog/logging.h>
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -47,6 +48,11 @@ public:
     [[nodiscard]] Status open(RuntimeState* state);
     [[nodiscard]] Status clone(RuntimeState* state, VExprContextSPtr& new_ctx);
     [[nodiscard]] Status execute(Block* block, int* result_column_id);
+    /// Execute on the rows of `block` selected by `selector` only, see
+    /// `VExpr::execute_on_selected_rows`.
+    [[nodiscard]] Status execute_on_selected_rows(Block* block, const IColumn::Filter& selector,
+                                                  size_t num_selected, ColumnPtr* result,
+                                                  bool* compacted);
 
     VExprSPtr root() { return _root; }
     void set_root(const VExprSPtr& expr) { _root = expr; }
@@ -97,6 +103,10 @@ public:
                                                      std::vector<uint32_t>& columns_to_filter,
                                                      int column_to_keep, IColumn::Filter& filter);
 
+    /// The conjuncts in their current order of evaluation, with their observed pass rate and
+    /// cost, for the runtime profile.
+    static std::string conjuncts_stats_string(const VExprContextSPtrs& ctxs);
+
     [[nodiscard]] static Status get_output_block_after_execute_exprs(const VExprContextSPtrs&,
                                                                      const Block&, Block*,
                                                                      bool do_projection = false);
@@ -116,6 +126,11 @@ public:
 
     void set_force_materialize_slot() { _force_materialize_slot = true; }
 
+    /// Evaluations of shared subexpressions that reused a result already in the block, see
+    /// `VSharedExpr`.
+    void add_saved_evaluation() { ++_saved_evaluations; }
+    int64_t saved_evaluations() const { return _saved_evaluations; }
+
     VExprContext& operator=(const VExprContext& other) {
         if (this == &other) {
             return *this;
@@ -151,6 +166,12 @@ private:
     // Close method is called in vexpr context dector, not need call expicility
     void close();
 
+    /// Conjuncts are evaluated by increasing rank, cost / (1 - selectivity) observed so far.
+    double _conjunct_rank() const;
+    static std::vector<size_t> _conjuncts_order(const VExprContextSPtrs& ctxs);
+    void _update_conjunct_stats(size_t input_rows, size_t passed_rows, size_t evaluated_rows,
+                                int64_t exec_ns);
+
     friend class VExpr;
 
     /// The expr tree this context is for.
@@ -175,5 +196,15 @@ private:
     // This flag only works on VSlotRef.
     // Force to materialize even if the slot need_materialize is false, we just ignore need_materialize flag
     bool _force_materialize_slot = false;
+
+    // Statistics of this context evaluated as a conjunct by `execute_conjuncts`: the rows that
+    // passed the conjuncts evaluated before it, the ones of them that pass it too, and the
+    // rows and time actually spent to evaluate it.
+    int64_t _conjunct_input_rows = 0;
+    int64_t _conjunct_passed_rows = 0;
+    int64_t _conjunct_evaluated_rows = 0;
+    int64_t _conjunct_exec_ns = 0;
+
+    int64_t _saved_evaluations = 0;
 };
 } // namespace doris::vectorized
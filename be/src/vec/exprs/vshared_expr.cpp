@@ -0,0 +1,246 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exprs/vshared_expr.h"
+
+#include <fmt/format.h>
+#include <gen_cpp/Types_types.h>
+#include <parallel_hashmap/phmap.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "common/consts.h"
+#include "vec/core/block.h"
+#include "vec/core/column_with_type_and_name.h"
+#include "vec/data_types/data_type.h"
+#include "vec/exprs/vcast_expr.h"
+#include "vec/exprs/vectorized_fn_call.h"
+#include "vec/exprs/vexpr_context.h"
+#include "vec/exprs/vliteral.h"
+#include "vec/exprs/vslot_ref.h"
+
+namespace doris {
+class RowDescriptor;
+class RuntimeState;
+} // namespace doris
+
+namespace doris::vectorized {
+
+namespace {
+
+// Builtin functions whose result is not determined by their arguments only.
+const phmap::flat_hash_set<std::string> NON_DETERMINISTIC_FUNCTIONS = {
+        "rand", "random", "uuid", "uuid_numeric", "random_bytes", "sleep", "running_difference"};
+
+// Makes the names of the temporary columns unique among all the operators of the BE.
+std::atomic<uint64_t> g_shared_column_id = 0;
+
+std::atomic<uint64_t> g_evaluation_id = 0;
+
+using Signatures = std::unordered_map<const VExpr*, std::string>;
+
+bool is_shareable_call(const VExpr& expr) {
+    if (dynamic_cast<const VCastExpr*>(&expr) != nullptr) {
+        return true;
+    }
+    if (dynamic_cast<const VectorizedFnCall*>(&expr) == nullptr || expr.is_compound_predicate()) {
+        return false;
+    }
+    return expr.fn().binary_type == TFunctionBinaryType::BUILTIN &&
+           !NON_DETERMINISTIC_FUNCTIONS.contains(expr.fn().name.function_name);
+}
+
+// The subtrees of lambda functions are evaluated on blocks of their own, and the wrapped
+// expressions, such as runtime filters, keep statistics of their evaluations.
+bool is_opaque(const VExpr& expr) {
+    return expr.node_type() == TExprNodeType::LAMBDA_FUNCTION_EXPR ||
+           expr.node_type() == TExprNodeType::LAMBDA_FUNCTION_CALL_EXPR ||
+           expr.get_impl() != nullptr;
+}
+
+// Equal for the subtrees that evaluate to the same column on a block, empty for the subtrees
+// that can not be shared.
+const std::string& signature(const VExprSPtr& expr, Signatures& signatures) {
+    if (auto it = signatures.find(expr.get()); it != signatures.end()) {
+        return it->second;
+    }
+    std::string result;
+    if (const auto* slot = dynamic_cast<const VSlotRef*>(expr.get())) {
+        result = fmt::format("slot:{}:{}", slot->column_id(), expr->data_type()->get_name());
+    } else if (const auto* literal = dynamic_cast<const VLiteral*>(expr.get())) {
+        auto value = literal->value();
+        result = fmt::format("literal:{}:{}:{}", expr->data_type()->get_name(), value.size(),
+                             value);
+    } else if (!is_opaque(*expr) && is_shareable_call(*expr)) {
+        result = fmt::format("{}:{}:{}(", static_cast<int>(expr->node_type()),
+                             expr->fn().name.function_name, expr->data_type()->get_name());
+        for (const auto& child : expr->children()) {
+            const auto& child_signature = signature(child, signatures);
+            if (child_signature.empty()) {
+                result.clear();
+                break;
+            }
+            result += child_signature;
+            result += ',';
+        }
+        if (!result.empty()) {
+            result += ')';
+        }
+    }
+    return signatures.emplace(expr.get(), std::move(result)).first->second;
+}
+
+bool is_candidate(const VExprSPtr& expr, const std::string& signature) {
+    return !signature.empty() && !expr->children().empty() && !expr->is_constant();
+}
+
+void count_occurrences(const VExprSPtr& expr, Signatures& signatures,
+                       std::unordered_map<std::string, size_t>& occurrences) {
+    if (is_opaque(*expr)) {
+        return;
+    }
+    const auto& expr_signature = signature(expr, signatures);
+    if (is_candidate(expr, expr_signature)) {
+        ++occurrences[expr_signature];
+    }
+    for (const auto& child : expr->children()) {
+        count_occurrences(child, signatures, occurrences);
+    }
+}
+
+// A subexpression is shared when it occurs more often than its closest shared ancestor, the
+// occurrences inside the ancestor are only evaluated once anyway.
+VExprSPtr share(const VExprSPtr& expr, size_t ancestor_occurrences, Signatures& signatures,
+                const std::unordered_map<std::string, size_t>& occurrences,
+                std::unordered_map<std::string, std::string>& column_names) {
+    if (is_opaque(*expr)) {
+        return expr;
+    }
+    const auto& expr_signature = signature(expr, signatures);
+    size_t num_occurrences = 0;
+    if (is_candidate(expr, expr_signature)) {
+        num_occurrences = occurrences.at(expr_signature);
+    }
+    const bool shared = num_occurrences >= 2 && num_occurrences > ancestor_occurrences;
+
+    VExprSPtrs children = expr->children();
+    bool children_changed = false;
+    for (auto& child : children) {
+        auto new_child = share(child, shared ? num_occurrences : ancestor_occurrences, signatures,
+                               occurrences, column_names);
+        if (new_child != child) {
+            child = std::move(new_child);
+            children_changed = true;
+        }
+    }
+    if (children_changed) {
+        expr->set_children(std::move(children));
+    }
+    if (!shared) {
+        return expr;
+    }
+    auto& column_name = column_names[expr_signature];
+    if (column_name.empty()) {
+        column_name = fmt::format("{}cse_{}", BeConsts::BLOCK_TEMP_COLUMN_PREFIX,
+                                  g_shared_column_id++);
+    }
+    return VSharedExpr::create_shared(expr, column_name);
+}
+
+} // namespace
+
+VSharedExpr::VSharedExpr(const VExprSPtr& impl, std::string column_name)
+        : VExpr(*impl), _impl(impl), _column_name(std::move(column_name)) {
+    _prepare_finished = true;
+}
+
+Status VSharedExpr::prepare(RuntimeState* state, const RowDescriptor& desc,
+                            VExprContext* context) {
+    RETURN_IF_ERROR_OR_PREPARED(_impl->prepare(state, desc, context));
+    _prepare_finished = true;
+    return Status::OK();
+}
+
+Status VSharedExpr::open(RuntimeState* state, VExprContext* context,
+                         FunctionContext::FunctionStateScope scope) {
+    DCHECK(_prepare_finished);
+    RETURN_IF_ERROR(_impl->open(state, context, scope));
+    _open_finished = true;
+    return Status::OK();
+}
+
+void VSharedExpr::close(VExprContext* context, FunctionContext::FunctionStateScope scope) {
+    _impl->close(context, scope);
+}
+
+Status VSharedExpr::execute(VExprContext* context, Block* block, int* result_column_id) {
+    DCHECK(_open_finished || _getting_const_col);
+    if (block->evaluation_id() == 0) {
+        return _impl->execute(context, block, result_column_id);
+    }
+    // A temporary column left in the block by another evaluation has another name, it is never
+    // taken for the result on the current rows.
+    std::string column_name = fmt::format("{}_{}", _column_name, block->evaluation_id());
+    if (block->try_get_by_name(column_name) != nullptr) {
+        *result_column_id = block->get_position_by_name(column_name);
+        context->add_saved_evaluation();
+        return Status::OK();
+    }
+
+    RETURN_IF_ERROR(_impl->execute(context, block, result_column_id));
+    auto result = block->get_by_position(*result_column_id);
+    result.name = std::move(column_name);
+    block->insert(std::move(result));
+    return Status::OK();
+}
+
+SharedExprEvaluationScope::SharedExprEvaluationScope(Block* block)
+        : _block(block), _previous_id(block->evaluation_id()) {
+    _block->set_evaluation_id(++g_evaluation_id);
+}
+
+SharedExprEvaluationScope::~SharedExprEvaluationScope() {
+    _block->set_evaluation_id(_previous_id);
+}
+
+size_t VSharedExpr::share_common_subexprs(const std::vector<VExprContextSPtrs*>& ctxs_list) {
+    Signatures signatures;
+    std::unordered_map<std::string, size_t> occurrences;
+    for (const auto* ctxs : ctxs_list) {
+        for (const auto& ctx : *ctxs) {
+            count_occurrences(ctx->root(), signatures, occurrences);
+        }
+    }
+
+    std::unordered_map<std::string, std::string> column_names;
+    for (auto* ctxs : ctxs_list) {
+        for (auto& ctx : *ctxs) {
+            auto root = ctx->root();
+            auto new_root = share(root, 0, signatures, occurrences, column_names);
+            if (new_root != root) {
+                ctx->set_root(new_root);
+            }
+        }
+    }
+    return column_names.size();
+}
+
+} // namespace doris::vectorized
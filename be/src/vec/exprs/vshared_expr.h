@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "udf/udf.h"
+#include "vec/exprs/vexpr.h"
+
+namespace doris {
+class RowDescriptor;
+class RuntimeState;
+namespace vectorized {
+class Block;
+class VExprContext;
+} // namespace vectorized
+} // namespace doris
+
+namespace doris::vectorized {
+
+// One occurrence of a subexpression that appears several times in the expressions of an
+// operator. The first occurrence evaluated on a block keeps its result in a temporary column of
+// the block, named after the subexpression and the evaluation id of the block, and the other
+// occurrences return that column instead of evaluating their own copy of the subexpression.
+// Nothing is shared on a block without an evaluation id, see SharedExprEvaluationScope.
+//
+// Every occurrence keeps its own subtree, since the function contexts of a subtree belong to the
+// VExprContext it was prepared in.
+class VSharedExpr final : public VExpr {
+    ENABLE_FACTORY_CREATOR(VSharedExpr);
+
+public:
+    VSharedExpr(const VExprSPtr& impl, std::string column_name);
+    ~VSharedExpr() override = default;
+    Status execute(VExprContext* context, Block* block, int* result_column_id) override;
+    Status prepare(RuntimeState* state, const RowDescriptor& desc, VExprContext* context) override;
+    Status open(RuntimeState* state, VExprContext* context,
+                FunctionContext::FunctionStateScope scope) override;
+    void close(VExprContext* context, FunctionContext::FunctionStateScope scope) override;
+    std::string debug_string() const override { return _impl->debug_string(); }
+    const std::string& expr_name() const override { return _impl->expr_name(); }
+    const VExprSPtrs& children() const override { return _impl->children(); }
+    bool is_constant() const override { return _impl->is_constant(); }
+
+    const VExprSPtr get_impl() const override { return _impl; }
+
+    const std::string& column_name() const { return _column_name; }
+
+    // Wrap the deterministic subexpressions that appear more than once in `ctxs_list`, which must
+    // all be prepared against the same row descriptor and evaluated on the same blocks. Returns
+    // the number of distinct subexpressions that are shared.
+    static size_t share_common_subexprs(const std::vector<VExprContextSPtrs*>& ctxs_list);
+
+private:
+    VExprSPtr _impl;
+    std::string _column_name;
+};
+
+// Gives the block a new evaluation id while the expressions of an operator are evaluated on its
+// rows, and restores the previous one after.
+class SharedExprEvaluationScope {
+public:
+    explicit SharedExprEvaluationScope(Block* block);
+    ~SharedExprEvaluationScope();
+
+private:
+    Block* _block;
+    uint64_t _previous_id;
+};
+
+} // namespace doris::vectorized
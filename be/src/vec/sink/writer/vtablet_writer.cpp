@@ -356,26 +356,34 @@ Status VNodeChannel::init(RuntimeState* state) {
     _cur_add_block_request->set_backend_id(_node_id);
     _cur_add_block_request->set_eos(false);
 
-    // add block closure
+    // add block closures
     // Has to using value to capture _task_exec_ctx because tablet writer may destroyed during callback.
-    _send_block_callback = WriteBlockCallback<PTabletWriterAddBlockResult>::create_shared();
-    _send_block_callback->addFailedHandler([&, task_exec_ctx = _task_exec_ctx](bool is_last_rpc) {
-        auto ctx_lock = task_exec_ctx.lock();
-        if (ctx_lock == nullptr) {
-            return;
-        }
-        _add_block_failed_callback(is_last_rpc);
-    });
-
-    _send_block_callback->addSuccessHandler(
-            [&, task_exec_ctx = _task_exec_ctx](const PTabletWriterAddBlockResult& result,
-                                                bool is_last_rpc) {
-                auto ctx_lock = task_exec_ctx.lock();
-                if (ctx_lock == nullptr) {
-                    return;
-                }
-                _add_block_success_callback(result, is_last_rpc);
-            });
+    // The handlers capture the raw pointer of their callback, which outlives its own handlers.
+    int max_in_flight = std::max(config::tablet_writer_add_block_max_in_flight, 1);
+    _cur_add_block_request->set_max_packets_in_flight(max_in_flight);
+    for (int i = 0; i < max_in_flight; ++i) {
+        auto callback = WriteBlockCallback<PTabletWriterAddBlockResult>::create_shared();
+        callback->addFailedHandler([&, callback = callback.get(),
+                                    task_exec_ctx = _task_exec_ctx](bool is_last_rpc) {
+            auto ctx_lock = task_exec_ctx.lock();
+            if (ctx_lock == nullptr) {
+                return;
+            }
+            _packets_in_flight--;
+            _add_block_failed_callback(*callback->cntl_, is_last_rpc);
+        });
+        callback->addSuccessHandler([&, callback = callback.get(), task_exec_ctx = _task_exec_ctx](
+                                            const PTabletWriterAddBlockResult& result,
+                                            bool is_last_rpc) {
+            auto ctx_lock = task_exec_ctx.lock();
+            if (ctx_lock == nullptr) {
+                return;
+            }
+            _packets_in_flight--;
+            _add_block_success_callback(result, callback->rtt_ns(), is_last_rpc);
+        });
+        _send_block_callbacks.push_back(std::move(callback));
+    }
 
     _name = fmt::format("VNodeChannel[{}-{}]", _index_channel->_index_id, _node_id);
     // The node channel will send _batch_size rows of data each rpc. When the
@@ -580,23 +588,32 @@ int VNodeChannel::try_send_and_fetch_status(RuntimeState* state,
     }
 
     // set closure for sending block.
-    if (!_send_block_callback->try_set_in_flight()) {
-        // There is packet in flight, skip.
+    std::shared_ptr<WriteBlockCallback<PTabletWriterAddBlockResult>> send_block_callback;
+    for (const auto& callback : _send_block_callbacks) {
+        if (callback->try_set_in_flight()) {
+            send_block_callback = callback;
+            break;
+        }
+    }
+    if (send_block_callback == nullptr) {
+        // The window of packets in flight is full, skip.
         return _send_finished ? 0 : 1;
     }
 
-    // We are sure that try_send_batch is not running
+    // We are sure that try_send_batch is not running with this callback
     if (_pending_batches_num > 0) {
-        auto s = thread_pool_token->submit_func([this, state] { try_send_pending_block(state); });
+        auto s = thread_pool_token->submit_func([this, state, send_block_callback] {
+            try_send_pending_block(state, send_block_callback);
+        });
         if (!s.ok()) {
             _cancel_with_msg("submit send_batch task to send_batch_thread_pool failed");
             // sending finished. clear in flight
-            _send_block_callback->clear_in_flight();
+            send_block_callback->clear_in_flight();
         }
         // in_flight is cleared in closure::Run
     } else {
         // sending finished. clear in flight
-        _send_block_callback->clear_in_flight();
+        send_block_callback->clear_in_flight();
     }
     return _send_finished ? 0 : 1;
 }
@@ -612,7 +629,9 @@ void VNodeChannel::_cancel_with_msg(const std::string& msg) {
     _cancelled = true;
 }
 
-void VNodeChannel::try_send_pending_block(RuntimeState* state) {
+void VNodeChannel::try_send_pending_block(
+        RuntimeState* state,
+        const std::shared_ptr<WriteBlockCallback<PTabletWriterAddBlockResult>>& callback) {
     SCOPED_ATTACH_TASK(state);
     SCOPED_CONSUME_MEM_TRACKER(_node_channel_tracker);
     SCOPED_ATOMIC_TIMER(&_actual_consume_ns);
@@ -620,18 +639,31 @@ void VNodeChannel::try_send_pending_block(RuntimeState* state) {
     AddBlockReq send_block;
     {
         std::lock_guard<std::mutex> l(_pending_batches_lock);
-        DCHECK(!_pending_blocks.empty());
+        // Other callbacks may have taken the pending blocks since this task was submitted.
+        // The eos request is sent after all other packets returned, because the receiver
+        // closes the channel when handling it.
+        if (_pending_blocks.empty() ||
+            (_pending_blocks.front().second->eos() &&
+             std::any_of(_send_block_callbacks.begin(), _send_block_callbacks.end(),
+                         [&](const auto& other) {
+                             return other != callback && other->is_packet_in_flight();
+                         }))) {
+            callback->clear_in_flight();
+            return;
+        }
         send_block = std::move(_pending_blocks.front());
         _pending_blocks.pop();
         _pending_batches_num--;
         _pending_batches_bytes -= send_block.first->allocated_bytes();
+        // tablet_ids has already set when add row
+        // Packets take their sequence in queue order, the receiver applies them in this order
+        // whatever order they arrive in.
+        send_block.second->set_packet_seq(_next_packet_seq++);
     }
 
     auto mutable_block = std::move(send_block.first);
     auto request = std::move(send_block.second); // doesn't need to be saved in heap
 
-    // tablet_ids has already set when add row
-    request->set_packet_seq(_next_packet_seq);
     auto block = mutable_block->to_block();
     CHECK(block.rows() == request->tablet_ids_size())
             << "block rows: " << block.rows()
@@ -645,7 +677,7 @@ void VNodeChannel::try_send_pending_block(RuntimeState* state) {
                                     _parent->_transfer_large_data_by_brpc);
         if (!st.ok()) {
             cancel(fmt::format("{}, err: {}", channel_info(), st.to_string()));
-            _send_block_callback->clear_in_flight();
+            callback->clear_in_flight();
             return;
         }
         if (compressed_bytes >= double(config::brpc_max_body_size) * 0.95F) {
@@ -659,17 +691,17 @@ void VNodeChannel::try_send_pending_block(RuntimeState* state) {
     if (UNLIKELY(remain_ms < config::min_load_rpc_timeout_ms)) {
         if (remain_ms <= 0 && !request->eos()) {
             cancel(fmt::format("{}, err: timeout", channel_info()));
-            _send_block_callback->clear_in_flight();
+            callback->clear_in_flight();
             return;
         } else {
             remain_ms = config::min_load_rpc_timeout_ms;
         }
     }
 
-    _send_block_callback->reset();
-    _send_block_callback->cntl_->set_timeout_ms(remain_ms);
+    callback->reset();
+    callback->cntl_->set_timeout_ms(remain_ms);
     if (config::tablet_writer_ignore_eovercrowded) {
-        _send_block_callback->cntl_->ignore_eovercrowded();
+        callback->cntl_->ignore_eovercrowded();
     }
 
     if (request->eos()) {
@@ -699,34 +731,34 @@ void VNodeChannel::try_send_pending_block(RuntimeState* state) {
         }
 
         // eos request must be the last request-> it's a signal makeing callback function to set _add_batch_finished true.
-        _send_block_callback->end_mark();
+        callback->end_mark();
         _send_finished = true;
         CHECK(_pending_batches_num == 0) << _pending_batches_num;
     }
 
     auto send_block_closure = AutoReleaseClosure<
             PTabletWriterAddBlockRequest,
-            WriteBlockCallback<PTabletWriterAddBlockResult>>::create_unique(request,
-                                                                            _send_block_callback);
+            WriteBlockCallback<PTabletWriterAddBlockResult>>::create_unique(request, callback);
     if (_parent->_transfer_large_data_by_brpc && request->has_block() &&
         request->block().has_column_values() && request->ByteSizeLong() > MIN_HTTP_BRPC_SIZE) {
         Status st = request_embed_attachment_contain_blockv2(send_block_closure->request_.get(),
                                                              send_block_closure);
         if (!st.ok()) {
             cancel(fmt::format("{}, err: {}", channel_info(), st.to_string()));
-            _send_block_callback->clear_in_flight();
+            callback->clear_in_flight();
             return;
         }
+        _on_packet_sent();
 
         //format an ipv6 address
         std::string brpc_url = get_brpc_http_url(_node_info.host, _node_info.brpc_port);
         std::shared_ptr<PBackendService_Stub> _brpc_http_stub =
                 _state->exec_env()->brpc_internal_client_cache()->get_new_client_no_cache(brpc_url,
                                                                                           "http");
-        _send_block_callback->cntl_->http_request().uri() =
+        callback->cntl_->http_request().uri() =
                 brpc_url + "/PInternalServiceImpl/tablet_writer_add_block_by_http";
-        _send_block_callback->cntl_->http_request().set_method(brpc::HTTP_METHOD_POST);
-        _send_block_callback->cntl_->http_request().set_content_type("application/json");
+        callback->cntl_->http_request().set_method(brpc::HTTP_METHOD_POST);
+        callback->cntl_->http_request().set_content_type("application/json");
 
         {
             SCOPED_SWITCH_THREAD_MEM_TRACKER_LIMITER(ExecEnv::GetInstance()->orphan_mem_tracker());
@@ -736,7 +768,8 @@ void VNodeChannel::try_send_pending_block(RuntimeState* state) {
             send_block_closure.release();
         }
     } else {
-        _send_block_callback->cntl_->http_request().Clear();
+        callback->cntl_->http_request().Clear();
+        _on_packet_sent();
         {
             SCOPED_SWITCH_THREAD_MEM_TRACKER_LIMITER(ExecEnv::GetInstance()->orphan_mem_tracker());
             _stub->tablet_writer_add_block(
@@ -745,12 +778,19 @@ void VNodeChannel::try_send_pending_block(RuntimeState* state) {
             send_block_closure.release();
         }
     }
+}
 
-    _next_packet_seq++;
+void VNodeChannel::_on_packet_sent() {
+    int packets_in_flight = ++_packets_in_flight;
+    int max_packets_in_flight = _max_packets_in_flight;
+    while (packets_in_flight > max_packets_in_flight &&
+           !_max_packets_in_flight.compare_exchange_weak(max_packets_in_flight,
+                                                         packets_in_flight)) {
+    }
 }
 
 void VNodeChannel::_add_block_success_callback(const PTabletWriterAddBlockResult& result,
-                                               bool is_last_rpc) {
+                                               int64_t rtt_ns, bool is_last_rpc) {
     std::lock_guard<std::mutex> l(this->_closed_lock);
     if (this->_is_closed) {
         // if the node channel is closed, no need to call the following logic,
@@ -813,6 +853,7 @@ void VNodeChannel::_add_block_success_callback(const PTabletWriterAddBlockResult
         _add_batch_counter.add_batch_wait_execution_time_us += result.wait_execution_time_us();
         _add_batch_counter.add_batch_num++;
     }
+    _add_batch_counter.add_batch_rtt_us += rtt_ns / NANOS_PER_MICRO;
     if (result.has_load_channel_profile()) {
         TRuntimeProfileTree tprofile;
         const auto* buf = (const uint8_t*)result.load_channel_profile().data();
@@ -826,7 +867,7 @@ void VNodeChannel::_add_block_success_callback(const PTabletWriterAddBlockResult
     }
 }
 
-void VNodeChannel::_add_block_failed_callback(bool is_last_rpc) {
+void VNodeChannel::_add_block_failed_callback(const brpc::Controller& cntl, bool is_last_rpc) {
     std::lock_guard<std::mutex> l(this->_closed_lock);
     if (this->_is_closed) {
         // if the node channel is closed, no need to call `mark_as_failed`,
@@ -837,8 +878,7 @@ void VNodeChannel::_add_block_failed_callback(bool is_last_rpc) {
     // If rpc failed, mark all tablets on this node channel as failed
     _index_channel->mark_as_failed(this,
                                    fmt::format("rpc failed, error coed:{}, error text:{}",
-                                               _send_block_callback->cntl_->ErrorCode(),
-                                               _send_block_callback->cntl_->ErrorText()),
+                                               cntl.ErrorCode(), cntl.ErrorText()),
                                    -1);
     Status st = _index_channel->check_intolerable_failure();
     if (!st.ok()) {
@@ -1236,6 +1276,8 @@ Status VTabletWriter::_init(RuntimeState* state, RuntimeProfile* profile) {
     _max_add_batch_exec_timer = ADD_TIMER(profile, "MaxAddBatchExecTime");
     _total_wait_exec_timer = ADD_TIMER(profile, "TotalWaitExecTime");
     _max_wait_exec_timer = ADD_TIMER(profile, "MaxWaitExecTime");
+    _total_add_batch_rtt_timer = ADD_TIMER(profile, "TotalAddBatchRttTime");
+    _max_add_batch_in_flight = ADD_COUNTER(profile, "MaxAddBatchInFlight", TUnit::UNIT);
     _add_batch_number = ADD_COUNTER(profile, "NumberBatchAdded", TUnit::UNIT);
     _num_node_channels = ADD_COUNTER(profile, "NumberNodeChannels", TUnit::UNIT);
     _load_mem_limit = state->get_load_mem_limit();
@@ -1539,6 +1581,13 @@ Status VTabletWriter::close(Status exec_status) {
             COUNTER_SET(_max_add_batch_exec_timer, max_add_batch_exec_time_ns);
             COUNTER_SET(_total_wait_exec_timer, total_wait_exec_time_ns);
             COUNTER_SET(_max_wait_exec_timer, max_wait_exec_time_ns);
+            AddBatchCounter total_add_batch_counter;
+            for (const auto& [_, counter] : node_add_batch_counter_map) {
+                total_add_batch_counter += counter;
+            }
+            COUNTER_SET(_total_add_batch_rtt_timer,
+                        total_add_batch_counter.add_batch_rtt_us * NANOS_PER_MICRO);
+            COUNTER_SET(_max_add_batch_in_flight, total_add_batch_counter.max_add_batch_in_flight);
             COUNTER_SET(_add_batch_number, total_add_batch_num);
             COUNTER_SET(_num_node_channels, num_node_channels);
 
@@ -1556,11 +1605,14 @@ Status VTabletWriter::close(Status exec_status) {
             std::stringstream ss;
             ss << "finished to close olap table sink. load_id=" << print_id(_load_id)
                << ", txn_id=" << _txn_id
-               << ", node add batch time(ms)/wait execution time(ms)/close time(ms)/num: ";
+               << ", node add batch time(ms)/wait execution time(ms)/close time(ms)/num/"
+                  "rtt(ms)/max in flight: ";
             for (auto const& pair : node_add_batch_counter_map) {
                 ss << "{" << pair.first << ":(" << (pair.second.add_batch_execution_time_us / 1000)
                    << ")(" << (pair.second.add_batch_wait_execution_time_us / 1000) << ")("
-                   << pair.second.close_wait_time_ms << ")(" << pair.second.add_batch_num << ")} ";
+                   << pair.second.close_wait_time_ms << ")(" << pair.second.add_batch_num << ")("
+                   << (pair.second.add_batch_rtt_us / 1000) << ")("
+                   << pair.second.max_add_batch_in_flight << ")} ";
             }
             LOG(INFO) << ss.str();
         } else {
@@ -31,6 +31,7 @@
 #include <google/protobuf/stubs/callback.h>
 
 // IWYU pragma: no_include <bits/chrono.h>
+#include <algorithm>
 #include <atomic>
 #include <chrono> // IWYU pragma: keep
 #include <cstddef>
@@ -97,6 +98,10 @@ struct AddBatchCounter {
     int64_t add_batch_wait_execution_time_us = 0;
     // number of add_batch call
     int64_t add_batch_num = 0;
+    // total round trip time of add_batch rpcs, seen from the sender
+    int64_t add_batch_rtt_us = 0;
+    // max number of add_batch rpcs in flight at the same time
+    int64_t max_add_batch_in_flight = 0;
     // time passed between marked close and finish close
     int64_t close_wait_time_ms = 0;
 
@@ -104,6 +109,8 @@ struct AddBatchCounter {
         add_batch_execution_time_us += rhs.add_batch_execution_time_us;
         add_batch_wait_execution_time_us += rhs.add_batch_wait_execution_time_us;
         add_batch_num += rhs.add_batch_num;
+        add_batch_rtt_us += rhs.add_batch_rtt_us;
+        max_add_batch_in_flight = std::max(max_add_batch_in_flight, rhs.max_add_batch_in_flight);
         close_wait_time_ms += rhs.close_wait_time_ms;
         return *this;
     }
@@ -119,6 +126,7 @@ struct AddBatchCounter {
 // Delete this point is safe, don't worry about RPC callback will run after WriteBlockCallback deleted.
 // "Ping-Pong" between sender and receiver, `try_set_in_flight` when send, `clear_in_flight` after rpc failure or callback,
 // then next send will start, and it will wait for the rpc callback to complete when it is destroyed.
+// A node channel keeps several callbacks to have several packets in flight.
 template <typename T>
 class WriteBlockCallback final : public ::doris::DummyBrpcCallback<T> {
     ENABLE_FACTORY_CREATOR(WriteBlockCallback);
@@ -151,8 +159,13 @@ public:
     void reset() {
         ::doris::DummyBrpcCallback<T>::cntl_->Reset();
         cid = ::doris::DummyBrpcCallback<T>::cntl_->call_id();
+        _rtt_watch.reset();
+        _rtt_watch.start();
     }
 
+    // time since the last reset(), i.e. the round trip time of the rpc when called back
+    int64_t rtt_ns() { return _rtt_watch.elapsed_time(); }
+
     // if _packet_in_flight == false, set it to true. Return true.
     // if _packet_in_flight == true, Return false.
     bool try_set_in_flight() {
@@ -184,6 +197,7 @@ public:
 
 private:
     brpc::CallId cid;
+    MonotonicStopWatch _rtt_watch;
     std::atomic<bool> _packet_in_flight {false};
     std::atomic<bool> _is_last_rpc {false};
     std::function<void(bool)> failed_handler;
@@ -250,8 +264,11 @@ public:
     // @caller: VOlapTabletSink::_send_batch_process. it's a continual asynchronous process.
     int try_send_and_fetch_status(RuntimeState* state,
                                   std::unique_ptr<ThreadPoolToken>& thread_pool_token);
-    // when there's pending block found by try_send_and_fetch_status(), we will awake a thread to send it.
-    void try_send_pending_block(RuntimeState* state);
+    // when there's pending block found by try_send_and_fetch_status(), we will awake a thread to send it
+    // with an idle callback.
+    void try_send_pending_block(
+            RuntimeState* state,
+            const std::shared_ptr<WriteBlockCallback<PTabletWriterAddBlockResult>>& callback);
 
     void clear_all_blocks();
 
@@ -289,6 +306,7 @@ public:
                      int64_t* total_add_batch_num) const {
         (*add_batch_counter_map)[_node_id] += _add_batch_counter;
         (*add_batch_counter_map)[_node_id].close_wait_time_ms = _close_time_ms;
+        (*add_batch_counter_map)[_node_id].max_add_batch_in_flight = _max_packets_in_flight;
         *serialize_batch_ns += _serialize_batch_ns;
         *stat += _stat;
         *queue_push_lock_ns += _queue_push_lock_ns;
@@ -320,8 +338,11 @@ protected:
     void _close_check();
     void _cancel_with_msg(const std::string& msg);
 
-    void _add_block_success_callback(const PTabletWriterAddBlockResult& result, bool is_last_rpc);
-    void _add_block_failed_callback(bool is_last_rpc);
+    void _add_block_success_callback(const PTabletWriterAddBlockResult& result, int64_t rtt_ns,
+                                     bool is_last_rpc);
+    void _add_block_failed_callback(const brpc::Controller& cntl, bool is_last_rpc);
+    // count a packet in flight and keep the max count
+    void _on_packet_sent();
 
     VTabletWriter* _parent = nullptr;
     IndexChannel* _index_channel = nullptr;
@@ -409,7 +430,11 @@ protected:
                                   std::shared_ptr<PTabletWriterAddBlockRequest>>;
     std::queue<AddBlockReq> _pending_blocks;
     // send block to slave BE rely on this. dont reconstruct it.
-    std::shared_ptr<WriteBlockCallback<PTabletWriterAddBlockResult>> _send_block_callback = nullptr;
+    // One callback per packet in flight, see config::tablet_writer_add_block_max_in_flight.
+    std::vector<std::shared_ptr<WriteBlockCallback<PTabletWriterAddBlockResult>>>
+            _send_block_callbacks;
+    std::atomic<int> _packets_in_flight {0};
+    std::atomic<int> _max_packets_in_flight {0};
 
     bool _is_incremental;
 };
@@ -635,6 +660,8 @@ private:
     RuntimeProfile::Counter* _max_add_batch_exec_timer = nullptr;
     RuntimeProfile::Counter* _total_wait_exec_timer = nullptr;
     RuntimeProfile::Counter* _max_wait_exec_timer = nullptr;
+    RuntimeProfile::Counter* _total_add_batch_rtt_timer = nullptr;
+    RuntimeProfile::Counter* _max_add_batch_in_flight = nullptr;
     RuntimeProfile::Counter* _add_batch_number = nullptr;
     RuntimeProfile::Counter* _num_node_channels = nullptr;
 
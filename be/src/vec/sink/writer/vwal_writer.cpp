@@ -93,7 +93,12 @@ Status VWalWriter::close() {
 Status VWalWriter::_create_wal_writer(int64_t wal_id, std::shared_ptr<WalWriter>& wal_writer) {
     std::string wal_path;
     RETURN_IF_ERROR(_wal_manager->get_wal_path(wal_id, wal_path));
-    wal_writer = std::make_shared<WalWriter>(wal_path);
+    auto shared_wal = _wal_manager->get_shared_wal(wal_id);
+    if (shared_wal != nullptr) {
+        wal_writer = std::make_shared<WalWriter>(wal_path, shared_wal, _tb_id, wal_id);
+    } else {
+        wal_writer = std::make_shared<WalWriter>(wal_path);
+    }
     RETURN_IF_ERROR(wal_writer->init());
     return Status::OK();
 }
@@ -18,15 +18,19 @@
 // https://github.com/ClickHouse/ClickHouse/blob/master/src/Interpreters/tests/gtest_lru_file_cache.cpp
 // and modified by Doris
 
+#include <bvar/reducer.h>
 #include <gen_cpp/Types_types.h>
 #include <gtest/gtest-message.h>
 #include <gtest/gtest-test-part.h>
 #include <stddef.h>
+#include <string.h>
 
 // IWYU pragma: no_include <bits/chrono.h>
 #include <chrono> // IWYU pragma: keep
 #include <condition_variable>
 #include <filesystem>
+#include <fstream>
+#include <future>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -38,17 +42,28 @@
 #include "common/config.h"
 #include "gtest/gtest_pred_impl.h"
 #include "io/cache/block/block_file_cache.h"
+#include "io/cache/block/block_file_cache_factory.h"
+#include "io/cache/block/block_file_cache_slab_storage.h"
 #include "io/cache/block/block_file_cache_settings.h"
 #include "io/cache/block/block_file_segment.h"
 #include "io/cache/block/block_lru_file_cache.h"
+#include "io/cache/block/cached_remote_file_reader.h"
+#include "io/fs/local_file_system.h"
 #include "io/fs/path.h"
+#include "io/io_common.h"
 #include "olap/options.h"
+#include "runtime/exec_env.h"
 #include "util/slice.h"
+#include "util/threadpool.h"
 
 namespace doris::io {
 
 namespace fs = std::filesystem;
 
+extern bvar::Adder<uint64_t> file_cache_write_behind_dropped;
+extern bvar::Adder<uint64_t> file_cache_write_behind_failed;
+extern std::atomic<int64_t> file_cache_write_behind_pending_bytes;
+
 fs::path caches_dir = fs::current_path() / "lru_cache_test";
 std::string cache_base_path = caches_dir / "cache1" / "";
 
@@ -894,6 +909,353 @@ TEST(LRUFileCache, fd_cache_remove) {
     }
 }
 
+TEST(LRUFileCache, write_behind) {
+    if (fs::exists(cache_base_path)) {
+        fs::remove_all(cache_base_path);
+    }
+    fs::create_directories(cache_base_path);
+    io::FileCacheSettings settings;
+    settings.query_queue_size = 30;
+    settings.query_queue_elements = 5;
+    settings.max_file_segment_size = 10;
+    settings.max_query_cache_size = 30;
+    settings.total_size = 30;
+    io::LRUFileCache cache(cache_base_path, settings);
+    ASSERT_TRUE(cache.initialize());
+    io::CacheContext context;
+    context.cache_type = io::CacheType::NORMAL;
+    auto key = io::LRUFileCache::hash("key1");
+    std::shared_ptr<char[]> data(new char[10]);
+    memcpy(data.get(), "0123456789", 10);
+    io::FileBlockSPtr segment;
+    {
+        auto holder = cache.get_or_set(key, 0, 10, context); /// Add range [0, 9]
+        auto segments = fromHolder(holder);
+        ASSERT_EQ(segments.size(), 1);
+        segment = segments[0];
+        ASSERT_TRUE(segment->get_or_set_downloader() == io::FileBlock::get_caller_id());
+        segment->hand_over_download(std::shared_ptr<const char>(data, data.get()));
+    }
+    /// the holder of the reader keeps the handed over segment
+    assert_range(1, segment, io::FileBlock::Range(0, 9), io::FileBlock::State::DOWNLOADING);
+    ASSERT_TRUE(segment->has_handed_over_data());
+    ASSERT_EQ(segment->wait(), io::FileBlock::State::DOWNLOADING);
+    char buffer[4];
+    ASSERT_TRUE(segment->read_at(Slice(buffer, 4), 3).ok());
+    ASSERT_EQ(std::string(buffer, 4), "3456");
+
+    std::thread writer([&]() {
+        io::FileBlocksHolder holder(io::FileBlocks {segment});
+        segment->take_over_download();
+        ASSERT_TRUE(segment->append(Slice(data.get(), 10)).ok());
+        ASSERT_TRUE(segment->finalize_write().ok());
+        segment->release_handed_over_data();
+    });
+    writer.join();
+    assert_range(2, segment, io::FileBlock::Range(0, 9), io::FileBlock::State::DOWNLOADED);
+    ASSERT_FALSE(segment->has_handed_over_data());
+    ASSERT_TRUE(segment->read_at(Slice(buffer, 4), 6).ok());
+    ASSERT_EQ(std::string(buffer, 4), "6789");
+
+    {
+        auto holder = cache.get_or_set(key, 10, 10, context); /// Add range [10, 19]
+        auto segments = fromHolder(holder);
+        ASSERT_EQ(segments.size(), 1);
+        segment = segments[0];
+        ASSERT_TRUE(segment->get_or_set_downloader() == io::FileBlock::get_caller_id());
+        segment->hand_over_download(std::shared_ptr<const char>(data, data.get()));
+    }
+    {
+        /// the write fails, the reset of the segment drops the handed over data
+        io::FileBlocksHolder holder(io::FileBlocks {segment});
+        segment->take_over_download();
+        ASSERT_TRUE(segment->append(Slice(data.get(), 5)).ok());
+        ASSERT_TRUE(segment->read_at(Slice(buffer, 4), 3).ok());
+    }
+    assert_range(3, segment, io::FileBlock::Range(10, 19), io::FileBlock::State::EMPTY);
+    ASSERT_FALSE(segment->has_handed_over_data());
+    /// the partially written file is not read
+    ASSERT_FALSE(segment->read_at(Slice(buffer, 4), 0).ok());
+    if (fs::exists(cache_base_path)) {
+        fs::remove_all(cache_base_path);
+    }
+}
+
+TEST(CachedRemoteFileReader, write_behind) {
+    if (fs::exists(caches_dir)) {
+        fs::remove_all(caches_dir);
+    }
+    fs::create_directories(cache_base_path);
+    std::string content;
+    for (int i = 0; i < 32; ++i) {
+        content.push_back(static_cast<char>('a' + i % 26));
+    }
+    std::string remote_path = caches_dir / "remote_file";
+    {
+        std::ofstream out(remote_path, std::ios::binary);
+        out << content;
+    }
+    int64_t max_segment_size = config::file_cache_max_file_segment_size;
+    int64_t min_segment_size = config::file_cache_min_file_segment_size;
+    config::file_cache_max_file_segment_size = 16;
+    config::file_cache_min_file_segment_size = 16;
+
+    io::FileCacheSettings settings;
+    settings.query_queue_size = 64;
+    settings.query_queue_elements = 8;
+    settings.max_file_segment_size = 16;
+    settings.max_query_cache_size = 64;
+    settings.total_size = 64;
+    io::FileCacheFactory factory;
+    ExecEnv::GetInstance()->_file_cache_factory = &factory;
+    Status st;
+    factory.create_file_cache(cache_base_path, settings, &st);
+    ASSERT_TRUE(st.ok());
+    std::unique_ptr<ThreadPool> pool;
+    ASSERT_TRUE(ThreadPoolBuilder("FileCacheWriteThreadPool")
+                        .set_min_threads(1)
+                        .set_max_threads(1)
+                        .set_max_queue_size(0)
+                        .build(&pool)
+                        .ok());
+    std::swap(ExecEnv::GetInstance()->_file_cache_write_thread_pool, pool);
+    ThreadPool* write_pool = ExecEnv::GetInstance()->file_cache_write_thread_pool();
+
+    io::FileReaderSPtr local_reader;
+    ASSERT_TRUE(global_local_filesystem()->open_file(remote_path, &local_reader).ok());
+    io::FileReaderOptions opts;
+    opts.cache_base_path = cache_base_path;
+    io::CachedRemoteFileReader reader(local_reader, opts);
+    IFileCache* cache = reader._cache;
+    ASSERT_EQ(cache, factory.get_by_path(cache_base_path));
+    io::IOContext io_ctx;
+    io::CacheContext context(&io_ctx);
+    auto read = [&](size_t offset) {
+        char buffer[16];
+        size_t bytes_read = 0;
+        ASSERT_TRUE(reader.read_at(offset, Slice(buffer, 16), &bytes_read, &io_ctx).ok());
+        ASSERT_EQ(bytes_read, 16);
+        ASSERT_EQ(std::string(buffer, 16), content.substr(offset, 16));
+    };
+    auto state = [&](size_t offset) {
+        auto holder = cache->get_or_set(reader._cache_key, offset, 16, context);
+        return holder.file_segments.front()->state();
+    };
+
+    /// the queue of the writers is full, the segment is not cached
+    uint64_t dropped = file_cache_write_behind_dropped.get_value();
+    std::promise<void> unblock;
+    std::shared_future<void> blocked = unblock.get_future().share();
+    ASSERT_TRUE(write_pool->submit_func([blocked]() { blocked.wait(); }).ok());
+    read(0);
+    ASSERT_EQ(file_cache_write_behind_dropped.get_value(), dropped + 1);
+    ASSERT_EQ(state(0), io::FileBlock::State::EMPTY);
+    unblock.set_value();
+    write_pool->wait();
+
+    /// the segments waiting to be written are beyond the max bytes
+    int64_t max_bytes = config::file_cache_write_behind_max_bytes;
+    config::file_cache_write_behind_max_bytes = 8;
+    read(0);
+    ASSERT_EQ(file_cache_write_behind_dropped.get_value(), dropped + 2);
+    ASSERT_EQ(state(0), io::FileBlock::State::EMPTY);
+    config::file_cache_write_behind_max_bytes = max_bytes;
+
+    /// the file of the segment can not be created
+    uint64_t failed = file_cache_write_behind_failed.get_value();
+    fs::create_directories(
+            cache->get_path_in_local_cache(reader._cache_key, 16, io::CacheType::NORMAL));
+    read(16);
+    write_pool->wait();
+    ASSERT_EQ(file_cache_write_behind_failed.get_value(), failed + 1);
+    ASSERT_EQ(state(16), io::FileBlock::State::EMPTY);
+    ASSERT_EQ(file_cache_write_behind_pending_bytes.load(), 0);
+
+    /// the segment is written in the background, and read from the cache then
+    read(0);
+    write_pool->wait();
+    ASSERT_EQ(state(0), io::FileBlock::State::DOWNLOADED);
+    ASSERT_EQ(file_cache_write_behind_pending_bytes.load(), 0);
+    read(0);
+
+    std::swap(ExecEnv::GetInstance()->_file_cache_write_thread_pool, pool);
+    ExecEnv::GetInstance()->_file_cache_factory = nullptr;
+    config::file_cache_max_file_segment_size = max_segment_size;
+    config::file_cache_min_file_segment_size = min_segment_size;
+    if (fs::exists(caches_dir)) {
+        fs::remove_all(caches_dir);
+    }
+}
+
+TEST(SlabFileStorage, read_write) {
+    auto slab_dir = caches_dir / "slab";
+    if (fs::exists(slab_dir)) {
+        fs::remove_all(slab_dir);
+    }
+    auto key = io::LRUFileCache::hash("key1");
+    {
+        /// 3 slots of 16 bytes in 2 slab files
+        io::SlabFileStorage storage(slab_dir, 48, 16, 32, false);
+        ASSERT_TRUE(storage.open([](uint32_t, const io::IFileCache::Key&, size_t, size_t,
+                                    io::CacheType) { return true; })
+                            .ok());
+        ASSERT_TRUE(fs::exists(slab_dir / "slab_0"));
+        ASSERT_TRUE(fs::exists(slab_dir / "slab_1"));
+        ASSERT_EQ(storage.num_slots(), 3);
+        uint32_t slots[3];
+        for (auto& slot : slots) {
+            ASSERT_TRUE(storage.allocate(&slot));
+        }
+        uint32_t slot = 0;
+        ASSERT_FALSE(storage.allocate(&slot));
+
+        std::string data = "0123456789abcdef";
+        ASSERT_TRUE(storage.write(slots[2], 0, Slice(data.data(), 10)).ok());
+        ASSERT_TRUE(storage.write(slots[2], 10, Slice(data.data() + 10, 6)).ok());
+        char buffer[8];
+        ASSERT_TRUE(storage.read(slots[2], 4, Slice(buffer, 8)).ok());
+        ASSERT_EQ(std::string(buffer, 8), "456789ab");
+        ASSERT_TRUE(storage.commit(slots[2], key, 32, 16, io::CacheType::INDEX).ok());
+        ASSERT_TRUE(storage.commit(slots[1], key, 16, 16, io::CacheType::NORMAL).ok());
+        storage.release(slots[1]);
+        storage.release(slots[0]);
+        ASSERT_EQ(storage.num_free_slots(), 2);
+        /// the released slots are reused once their cleared records are synced
+        ASSERT_TRUE(storage.allocate(&slot));
+        ASSERT_TRUE(slot == slots[0] || slot == slots[1]);
+        storage.release(slot);
+        ASSERT_EQ(storage.num_free_slots(), 2);
+    }
+    {
+        /// the recorded block is restored
+        io::SlabFileStorage storage(slab_dir, 48, 16, 32, false);
+        int restored = 0;
+        ASSERT_TRUE(storage.open([&](uint32_t slot, const io::IFileCache::Key& restored_key,
+                                     size_t offset, size_t size, io::CacheType type) {
+                               ++restored;
+                               EXPECT_EQ(slot, 2U);
+                               EXPECT_EQ(restored_key, key);
+                               EXPECT_EQ(offset, 32UL);
+                               EXPECT_EQ(size, 16UL);
+                               EXPECT_EQ(type, io::CacheType::INDEX);
+                               return true;
+                           })
+                            .ok());
+        ASSERT_EQ(restored, 1);
+        ASSERT_EQ(storage.num_free_slots(), 2);
+        char buffer[16];
+        ASSERT_TRUE(storage.read(2, 0, Slice(buffer, 16)).ok());
+        ASSERT_EQ(std::string(buffer, 16), "0123456789abcdef");
+    }
+    {
+        /// the slots are laid out differently, nothing is restored
+        io::SlabFileStorage storage(slab_dir, 48, 8, 32, false);
+        int restored = 0;
+        ASSERT_TRUE(storage.open([&](uint32_t, const io::IFileCache::Key&, size_t, size_t,
+                                     io::CacheType) { return ++restored > 0; })
+                            .ok());
+        ASSERT_EQ(restored, 0);
+        ASSERT_EQ(storage.num_free_slots(), 6);
+    }
+    /// the slot size is not aligned for direct io
+    io::SlabFileStorage storage(slab_dir, 48, 16, 32, true);
+    ASSERT_FALSE(storage.open([](uint32_t, const io::IFileCache::Key&, size_t, size_t,
+                                 io::CacheType) { return true; })
+                         .ok());
+    fs::remove_all(slab_dir);
+}
+
+TEST(LRUFileCache, slab_storage) {
+    if (fs::exists(cache_base_path)) {
+        fs::remove_all(cache_base_path);
+    }
+    io::FileCacheSettings settings;
+    settings.query_queue_size = 30;
+    settings.query_queue_elements = 5;
+    settings.max_file_segment_size = 10;
+    settings.max_query_cache_size = 30;
+    settings.total_size = 30;
+    settings.storage = io::FileCacheStorage::SLAB;
+    settings.slab_file_size = 20;
+    io::CacheContext context;
+    context.cache_type = io::CacheType::NORMAL;
+    auto key = io::LRUFileCache::hash("key1");
+    auto download_slab = [](io::FileBlockSPtr file_block, char c) {
+        ASSERT_TRUE(file_block->get_or_set_downloader() == io::FileBlock::get_caller_id());
+        std::string data(file_block->range().size(), c);
+        ASSERT_TRUE(file_block->append(Slice(data.data(), data.size())).ok());
+        ASSERT_TRUE(file_block->finalize_write().ok());
+    };
+    {
+        /// only the directories of the file layout are removed
+        auto key_dir = fs::path(cache_base_path) / key.to_string().substr(0, 3) / key.to_string();
+        fs::create_directories(key_dir);
+        fs::create_directories(fs::path(cache_base_path) / key.to_string());
+        fs::create_directories(fs::path(cache_base_path) / "backup");
+        io::LRUFileCache cache(cache_base_path, settings);
+        ASSERT_TRUE(cache.initialize());
+        ASSERT_FALSE(fs::exists(key_dir.parent_path()));
+        ASSERT_FALSE(fs::exists(fs::path(cache_base_path) / key.to_string()));
+        ASSERT_TRUE(fs::exists(fs::path(cache_base_path) / "backup"));
+        fs::remove_all(fs::path(cache_base_path) / "backup");
+    }
+    {
+        io::LRUFileCache cache(cache_base_path, settings);
+        ASSERT_TRUE(cache.initialize());
+        auto holder = cache.get_or_set(key, 0, 25, context); /// Add range [0, 24]
+        auto blocks = fromHolder(holder);
+        ASSERT_EQ(blocks.size(), 3);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            assert_range(1, blocks[i], io::FileBlock::Range(i * 10, std::min(i * 10 + 9, 24UL)),
+                         io::FileBlock::State::EMPTY);
+            download_slab(blocks[i], static_cast<char>('a' + i));
+            assert_range(2, blocks[i], io::FileBlock::Range(i * 10, std::min(i * 10 + 9, 24UL)),
+                         io::FileBlock::State::DOWNLOADED);
+        }
+        /// the blocks are not files, and the last one takes a whole slot
+        ASSERT_FALSE(fs::exists(getFileBlockPath(cache_base_path, key, 0)));
+        ASSERT_EQ(cache.get_used_cache_size(io::CacheType::NORMAL), 30);
+        ASSERT_EQ(cache.slab_storage()->num_free_slots(), 0);
+        char buffer[5];
+        ASSERT_TRUE(blocks[1]->read_at(Slice(buffer, 5), 3).ok());
+        ASSERT_EQ(std::string(buffer, 5), "bbbbb");
+    }
+    {
+        /// the blocks are restored from the slab storage
+        io::LRUFileCache cache(cache_base_path, settings);
+        ASSERT_TRUE(cache.initialize());
+        ASSERT_EQ(cache.get_file_segments_num(io::CacheType::NORMAL), 3);
+        auto holder = cache.get_or_set(key, 0, 25, context);
+        auto blocks = fromHolder(holder);
+        ASSERT_EQ(blocks.size(), 3);
+        char buffer[5];
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            ASSERT_EQ(blocks[i]->state(), io::FileBlock::State::DOWNLOADED);
+            ASSERT_TRUE(blocks[i]->read_at(Slice(buffer, 5), 0).ok());
+            ASSERT_EQ(std::string(buffer, 5), std::string(5, static_cast<char>('a' + i)));
+        }
+    }
+    {
+        /// the eviction frees the slots of the evicted blocks
+        io::LRUFileCache cache(cache_base_path, settings);
+        ASSERT_TRUE(cache.initialize());
+        auto key2 = io::LRUFileCache::hash("key2");
+        auto holder = cache.get_or_set(key2, 0, 10, context); /// Add range [0, 9]
+        auto blocks = fromHolder(holder);
+        ASSERT_EQ(blocks.size(), 1);
+        assert_range(3, blocks[0], io::FileBlock::Range(0, 9), io::FileBlock::State::EMPTY);
+        download_slab(blocks[0], 'x');
+        ASSERT_EQ(cache.get_file_segments_num(io::CacheType::NORMAL), 3);
+        ASSERT_EQ(cache.slab_storage()->num_free_slots(), 0);
+        char buffer[10];
+        ASSERT_TRUE(blocks[0]->read_at(Slice(buffer, 10), 0).ok());
+        ASSERT_EQ(std::string(buffer, 10), std::string(10, 'x'));
+    }
+    if (fs::exists(cache_base_path)) {
+        fs::remove_all(cache_base_path);
+    }
+}
+
 TEST(LRUFileCache, fd_cache_evict) {
     if (fs::exists(cache_base_path)) {
         fs::remove_all(cache_base_path);
@@ -29,6 +29,7 @@
 #include "io/fs/file_reader_writer_fwd.h"
 #include "io/fs/local_file_system.h"
 #include "runtime/exec_env.h"
+#include "runtime/thread_context.h"
 #include "util/stopwatch.hpp"
 #include "util/threadpool.h"
 
@@ -402,4 +403,60 @@ TEST_F(BufferedReaderTest, test_merged_io) {
     }
 }
 
+TEST_F(BufferedReaderTest, test_row_group_prefetch) {
+    auto offset_reader = std::make_shared<MockOffsetFileReader>(1024 * 1024);
+    io::RowGroupPrefetcher prefetcher(nullptr, offset_reader, 64 * 1024);
+    prefetcher.add_group({io::PrefetchRange(0, 1000), io::PrefetchRange(2000, 3000)});
+    prefetcher.add_group({io::PrefetchRange(10000, 20000)});
+    // larger than the memory budget, read by the decoder directly
+    prefetcher.add_group({io::PrefetchRange(100000, 200000)});
+    prefetcher.add_group({io::PrefetchRange(300000, 301000)});
+    // nothing to read ahead, e.g. the page index may skip pages of the row group
+    prefetcher.add_group({});
+    prefetcher.start();
+    // the buffers are charged to the tracker of the creating thread
+    EXPECT_EQ(thread_context()->thread_mem_tracker_mgr->limiter_mem_tracker(),
+              prefetcher._mem_tracker);
+
+    char data[2000];
+    size_t bytes_read = 0;
+    io::FileReaderSPtr group_reader;
+    EXPECT_TRUE(prefetcher.next_group(&group_reader).ok());
+    EXPECT_NE(nullptr, group_reader);
+    EXPECT_TRUE(group_reader->read_at(2000, Slice(data, 1000), &bytes_read, nullptr).ok());
+    EXPECT_EQ(1000, bytes_read);
+    for (size_t i = 0; i < bytes_read; ++i) {
+        EXPECT_EQ((2000 + i) % UCHAR_MAX, (uint8)data[i]);
+    }
+    // out of the prefetched ranges
+    EXPECT_TRUE(group_reader->read_at(500, Slice(data, 2000), &bytes_read, nullptr).ok());
+    EXPECT_EQ(2000, bytes_read);
+    for (size_t i = 0; i < bytes_read; ++i) {
+        EXPECT_EQ((500 + i) % UCHAR_MAX, (uint8)data[i]);
+    }
+
+    EXPECT_TRUE(prefetcher.next_group(&group_reader).ok());
+    EXPECT_NE(nullptr, group_reader);
+    EXPECT_TRUE(group_reader->read_at(15000, Slice(data, 100), &bytes_read, nullptr).ok());
+    EXPECT_EQ(100, bytes_read);
+    EXPECT_EQ(15000 % UCHAR_MAX, (uint8)data[0]);
+
+    EXPECT_TRUE(prefetcher.next_group(&group_reader).ok());
+    EXPECT_EQ(nullptr, group_reader);
+
+    EXPECT_TRUE(prefetcher.next_group(&group_reader).ok());
+    EXPECT_NE(nullptr, group_reader);
+    EXPECT_TRUE(group_reader->read_at(300000, Slice(data, 1000), &bytes_read, nullptr).ok());
+    EXPECT_EQ(1000, bytes_read);
+    EXPECT_EQ(300000 % UCHAR_MAX, (uint8)data[0]);
+
+    EXPECT_TRUE(prefetcher.next_group(&group_reader).ok());
+    EXPECT_EQ(nullptr, group_reader);
+    EXPECT_TRUE(prefetcher.next_group(&group_reader).ok());
+    EXPECT_EQ(nullptr, group_reader);
+    prefetcher.close();
+    EXPECT_EQ(3, prefetcher.statistics().prefetch_groups);
+    EXPECT_EQ(13000, prefetcher.statistics().prefetch_bytes);
+}
+
 } // end namespace doris
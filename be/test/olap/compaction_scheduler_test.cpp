@@ -0,0 +1,137 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/compaction_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/config.h"
+#include "olap/compaction_permit_limiter.h"
+#include "olap/tablet_read_stats.h"
+
+namespace doris {
+
+static CompactionCandidate candidate_of(int64_t tablet_id, uint32_t score, int64_t input_bytes,
+                                        double queries, double segments_per_query,
+                                        double read_ns_per_query) {
+    CompactionCandidate candidate;
+    candidate.tablet_id = tablet_id;
+    candidate.compaction_score = score;
+    candidate.version_count = score;
+    candidate.input_bytes = input_bytes;
+    candidate.read_stats.queries = queries;
+    candidate.read_stats.segments_per_query = segments_per_query;
+    candidate.read_stats.read_ns_per_query = read_ns_per_query;
+    CompactionScheduler::compute_priority(&candidate);
+    return candidate;
+}
+
+TEST(CompactionSchedulerTest, ReadStatsDecay) {
+    int32_t half_life_sec = config::tablet_read_stats_half_life_sec;
+    config::tablet_read_stats_half_life_sec = 10;
+
+    TabletReadStats read_stats;
+    OlapReaderStatistics stats;
+    stats.total_segment_number = 12;
+    stats.filtered_segment_number = 2;
+    stats.block_fetch_ns = 1000;
+    TUniqueId query1;
+    query1.__set_hi(1);
+    query1.__set_lo(1);
+    TUniqueId query2 = query1;
+    query2.__set_lo(2);
+    read_stats.record(query1, stats, 100000);
+    read_stats.record(query2, stats, 100000);
+
+    auto snapshot = read_stats.get(100000);
+    EXPECT_DOUBLE_EQ(2, snapshot.queries);
+    EXPECT_DOUBLE_EQ(10, snapshot.segments_per_query);
+    EXPECT_DOUBLE_EQ(1000, snapshot.read_ns_per_query);
+
+    snapshot = read_stats.get(110000);
+    EXPECT_DOUBLE_EQ(1, snapshot.queries);
+    EXPECT_DOUBLE_EQ(10, snapshot.segments_per_query);
+
+    // the old queries count half as much as the new one
+    stats.total_segment_number = 4;
+    stats.filtered_segment_number = 0;
+    stats.block_fetch_ns = 4000;
+    TUniqueId query3 = query1;
+    query3.__set_lo(3);
+    read_stats.record(query3, stats, 110000);
+    snapshot = read_stats.get(110000);
+    EXPECT_DOUBLE_EQ(2, snapshot.queries);
+    EXPECT_DOUBLE_EQ(7, snapshot.segments_per_query);
+    EXPECT_DOUBLE_EQ(2500, snapshot.read_ns_per_query);
+
+    // another scanner of the same query adds its segments and time to the query
+    read_stats.record(query3, stats, 110000);
+    snapshot = read_stats.get(110000);
+    EXPECT_DOUBLE_EQ(2, snapshot.queries);
+    EXPECT_DOUBLE_EQ(9, snapshot.segments_per_query);
+    EXPECT_DOUBLE_EQ(4500, snapshot.read_ns_per_query);
+
+    config::tablet_read_stats_half_life_sec = half_life_sec;
+}
+
+TEST(CompactionSchedulerTest, RankByReadAmplification) {
+    std::vector<CompactionCandidate> candidates;
+    // cold tablet with the highest score
+    candidates.push_back(candidate_of(1, 150, 1 << 20, 0, 0, 0));
+    // hot tablet, the compaction removes most of the segments it reads
+    candidates.push_back(candidate_of(2, 100, 1 << 20, 1000, 101, 1000000));
+    // as hot, but the compaction rewrites ten times as much data
+    candidates.push_back(candidate_of(3, 100, 10 << 20, 1000, 101, 1000000));
+    // hot, but the compaction removes only few of the segments it reads
+    candidates.push_back(candidate_of(4, 11, 1 << 20, 1000, 101, 1000000));
+    // cold, but it runs out of versions
+    auto urgent = candidate_of(5, 10, 1 << 20, 0, 0, 0);
+    urgent.version_count = config::max_tablet_version_num;
+    CompactionScheduler::compute_priority(&urgent);
+    candidates.push_back(urgent);
+
+    CompactionScheduler::rank(&candidates);
+    std::vector<int64_t> tablet_ids;
+    for (const auto& candidate : candidates) {
+        tablet_ids.push_back(candidate.tablet_id);
+    }
+    EXPECT_EQ((std::vector<int64_t> {5, 2, 4, 3, 1}), tablet_ids);
+    EXPECT_TRUE(candidates[0].urgent);
+    EXPECT_DOUBLE_EQ(0, candidates[4].priority);
+}
+
+TEST(CompactionSchedulerTest, PermitBudget) {
+    int64_t total_permits = config::total_permits_for_compaction_score;
+    config::total_permits_for_compaction_score = 100;
+
+    CompactionPermitLimiter limiter;
+    // a compaction larger than the budget can run alone
+    EXPECT_TRUE(limiter.has_budget(200));
+    EXPECT_FALSE(limiter.has_budget(200, 10));
+    EXPECT_TRUE(limiter.has_budget(60, 40));
+    EXPECT_FALSE(limiter.has_budget(61, 40));
+    limiter.request(50);
+    EXPECT_TRUE(limiter.has_budget(50));
+    EXPECT_FALSE(limiter.has_budget(50, 1));
+    limiter.release(50);
+
+    config::total_permits_for_compaction_score = total_permits;
+}
+
+} // namespace doris
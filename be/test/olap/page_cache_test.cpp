@@ -20,6 +20,8 @@
 #include <gtest/gtest-message.h>
 #include <gtest/gtest-test-part.h>
 
+#include <cstring>
+
 #include "gtest/gtest_pred_impl.h"
 
 namespace doris {
@@ -32,6 +34,24 @@ public:
     virtual ~StoragePageCacheTest() {}
 };
 
+TEST(StoragePageCacheTest, interleaved_page) {
+    StoragePageCache cache(kNumShards * 2048, 0, 0, kNumShards);
+    StoragePageCache::CacheKey key("abc", 0, 0);
+    int64_t mapped_bytes = NumaInterleavedArena::instance()->mapped_bytes();
+    {
+        PageCacheHandle handle;
+        auto* data = new DataPage(1024, true);
+        EXPECT_TRUE(data->interleaved());
+        memset(data->data(), 1, data->capacity());
+        cache.insert(key, data, &handle, segment_v2::DATA_PAGE, false);
+        EXPECT_EQ(data->data(), handle.data().data);
+    }
+    // the pages are carved from the chunks of the arena
+    EXPECT_LE(NumaInterleavedArena::instance()->mapped_bytes(),
+              mapped_bytes + static_cast<int64_t>(NumaInterleavedArena::CHUNK_SIZE));
+    EXPECT_FALSE(DataPage(1024).interleaved());
+}
+
 // All cache space is allocated to data pages
 TEST(StoragePageCacheTest, data_page_only) {
     StoragePageCache cache(kNumShards * 2048, 0, 0, kNumShards);
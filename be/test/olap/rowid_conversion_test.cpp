@@ -538,6 +538,83 @@ TEST_F(TestRowIdConversion, Basic) {
     EXPECT_EQ(res, -1);
 }
 
+TEST(SegmentRowIdConversionTest, Runs) {
+    SegmentRowIdConversion conversion(1000000);
+    // rows [0, 400000) to dst segment 0, rows [400000, 1000000) except the deleted
+    // rows [500000, 500100) to dst segment 1
+    for (uint32_t rowid = 0; rowid < 1000000; ++rowid) {
+        if (rowid < 400000) {
+            conversion.add(rowid, 0, rowid + 7);
+        } else if (rowid < 500000 || rowid >= 500100) {
+            conversion.add(rowid, 1, rowid < 500000 ? rowid - 400000 : rowid - 400100);
+        }
+    }
+    EXPECT_LT(conversion.mem_size(), 1024);
+
+    uint32_t dst_segment_id = 0;
+    uint32_t dst_rowid = 0;
+    EXPECT_TRUE(conversion.get(399999, &dst_segment_id, &dst_rowid));
+    EXPECT_EQ(0, dst_segment_id);
+    EXPECT_EQ(400006, dst_rowid);
+    EXPECT_TRUE(conversion.get(500100, &dst_segment_id, &dst_rowid));
+    EXPECT_EQ(1, dst_segment_id);
+    EXPECT_EQ(100000, dst_rowid);
+    EXPECT_FALSE(conversion.get(500050, &dst_segment_id, &dst_rowid));
+    EXPECT_FALSE(conversion.get(1000000, &dst_segment_id, &dst_rowid));
+
+    roaring::Roaring src_rowids;
+    src_rowids.addMany(6, std::vector<uint32_t> {0, 399999, 400000, 500000, 500100, 999999}.data());
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> found;
+    std::vector<uint32_t> missed;
+    conversion.convert(
+            src_rowids,
+            [&](uint32_t src_rowid, uint32_t dst_segment_id, uint32_t dst_rowid) {
+                found.emplace_back(src_rowid, dst_segment_id, dst_rowid);
+            },
+            [&](uint32_t src_rowid) { missed.push_back(src_rowid); });
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> expected_found {
+            {0, 0, 7}, {399999, 0, 400006}, {400000, 1, 0}, {500100, 1, 100000},
+            {999999, 1, 599899}};
+    EXPECT_EQ(expected_found, found);
+    EXPECT_EQ(std::vector<uint32_t> {500000}, missed);
+}
+
+TEST(SegmentRowIdConversionTest, InterleavedRows) {
+    // the rows of two source segments interleaved in the destination, and some rows of the
+    // second segment added out of order
+    SegmentRowIdConversion conversion0(1000);
+    SegmentRowIdConversion conversion1(1000);
+    for (uint32_t rowid = 0; rowid < 1000; ++rowid) {
+        conversion0.add(rowid, 0, rowid * 2);
+    }
+    for (uint32_t rowid = 500; rowid < 1000; ++rowid) {
+        conversion1.add(rowid, 0, rowid * 2 + 1);
+    }
+    for (uint32_t rowid = 0; rowid < 500; rowid += 2) {
+        conversion1.add(rowid, 1, rowid);
+    }
+
+    auto rowid_map0 = conversion0.to_vector();
+    auto rowid_map1 = conversion1.to_vector();
+    for (uint32_t rowid = 0; rowid < 1000; ++rowid) {
+        EXPECT_EQ(std::make_pair(0U, rowid * 2), rowid_map0[rowid]);
+        if (rowid >= 500) {
+            EXPECT_EQ(std::make_pair(0U, rowid * 2 + 1), rowid_map1[rowid]);
+        } else if (rowid % 2 == 0) {
+            EXPECT_EQ(std::make_pair(1U, rowid), rowid_map1[rowid]);
+        } else {
+            EXPECT_EQ(std::make_pair(UINT32_MAX, UINT32_MAX), rowid_map1[rowid]);
+        }
+        uint32_t dst_segment_id = 0;
+        uint32_t dst_rowid = 0;
+        bool exists = conversion1.get(rowid, &dst_segment_id, &dst_rowid);
+        EXPECT_EQ(rowid_map1[rowid].first != UINT32_MAX, exists);
+        if (exists) {
+            EXPECT_EQ(rowid_map1[rowid], std::make_pair(dst_segment_id, dst_rowid));
+        }
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(
         Parameters, TestRowIdConversion,
         ::testing::ValuesIn(std::vector<std::tuple<KeysType, bool, bool, bool>> {
@@ -0,0 +1,222 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/segment_stitcher.h"
+
+#include <gen_cpp/segment_v2.pb.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "io/fs/file_writer.h"
+#include "io/fs/local_file_system.h"
+#include "olap/iterators.h"
+#include "olap/olap_common.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/short_key_index.h"
+#include "olap/tablet_schema.h"
+#include "olap/tablet_schema_helper.h"
+#include "vec/data_types/data_type_factory.hpp"
+
+namespace doris {
+namespace segment_v2 {
+
+static const std::string kSegmentDir = "./ut_dir/segment_stitcher_test";
+static RowsetId rowset_id {0};
+
+class SegmentStitcherTest : public testing::Test {
+public:
+    void SetUp() override {
+        auto st = io::global_local_filesystem()->delete_directory(kSegmentDir);
+        ASSERT_TRUE(st.ok()) << st;
+        st = io::global_local_filesystem()->create_directory(kSegmentDir);
+        ASSERT_TRUE(st.ok()) << st;
+    }
+
+    void TearDown() override {
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(kSegmentDir).ok());
+    }
+
+    // k INT key, v INT nullable with bloom filter, s VARCHAR which is dictionary encoded
+    static TabletSchemaSPtr create_schema() {
+        auto schema = std::make_shared<TabletSchema>();
+        schema->append_column(*create_int_key(0, false));
+        schema->append_column(*create_int_value(
+                1, FieldAggregationMethod::OLAP_FIELD_AGGREGATION_NONE, true, "", true));
+        TabletColumn varchar;
+        varchar._unique_id = 2;
+        varchar._col_name = "2";
+        varchar._type = FieldType::OLAP_FIELD_TYPE_VARCHAR;
+        varchar._is_nullable = false;
+        varchar._length = 64;
+        varchar._index_length = 4;
+        schema->append_column(varchar);
+        schema->_keys_type = DUP_KEYS;
+        schema->_num_short_key_columns = 1;
+        return schema;
+    }
+
+    static std::string path_of(uint32_t segment_id) {
+        return fmt::format("{}/{}_{}.dat", kSegmentDir, rowset_id.to_string(), segment_id);
+    }
+
+    // the rows [begin, end), v is null for every 7th row
+    static void build_segment(TabletSchemaSPtr schema, uint32_t segment_id, int begin, int end,
+                              SegmentSharedPtr* segment) {
+        auto fs = io::global_local_filesystem();
+        io::FileWriterPtr file_writer;
+        ASSERT_TRUE(fs->create_file(path_of(segment_id), &file_writer).ok());
+        SegmentWriter writer(file_writer.get(), segment_id, schema, nullptr, nullptr, INT32_MAX,
+                             SegmentWriterOptions(), nullptr);
+        ASSERT_TRUE(writer.init().ok());
+
+        RowCursor row;
+        ASSERT_TRUE(row.init(schema).ok());
+        for (int i = begin; i < end; ++i) {
+            std::string value = "value_" + std::to_string(i % 10);
+            row.cell(0).set_not_null();
+            *(int*)row.cell(0).mutable_cell_ptr() = i;
+            row.cell(1).set_is_null(i % 7 == 0);
+            *(int*)row.cell(1).mutable_cell_ptr() = i * 2;
+            row.cell(2).set_not_null();
+            *(Slice*)row.cell(2).mutable_cell_ptr() = Slice(value);
+            ASSERT_TRUE(writer.append_row(row).ok());
+        }
+        uint64_t file_size = 0;
+        uint64_t index_size = 0;
+        ASSERT_TRUE(writer.finalize(&file_size, &index_size).ok());
+        ASSERT_TRUE(file_writer->close().ok());
+        open_segment(schema, segment_id, segment);
+    }
+
+    static void open_segment(TabletSchemaSPtr schema, uint32_t segment_id,
+                             SegmentSharedPtr* segment) {
+        auto st = Segment::open(io::global_local_filesystem(), path_of(segment_id), segment_id,
+                                rowset_id, schema, io::FileReaderOptions {}, segment);
+        ASSERT_TRUE(st.ok()) << st;
+    }
+
+    static vectorized::MutableColumnPtr read_column(const SegmentSharedPtr& segment,
+                                                    const TabletColumn& column) {
+        OlapReaderStatistics stats;
+        StorageReadOptions read_options;
+        std::unique_ptr<ColumnIterator> iter;
+        EXPECT_TRUE(segment->new_column_iterator(column, &iter, &read_options).ok());
+        ColumnIteratorOptions iter_options {
+                .file_reader = segment->file_reader().get(),
+                .stats = &stats,
+        };
+        EXPECT_TRUE(iter->init(iter_options).ok());
+        EXPECT_TRUE(iter->seek_to_first().ok());
+        auto data_type = vectorized::DataTypeFactory::instance().create_data_type(column);
+        auto data = data_type->create_column();
+        size_t num_rows = segment->num_rows();
+        bool has_null = false;
+        EXPECT_TRUE(iter->next_batch(&num_rows, data, &has_null).ok());
+        EXPECT_EQ(segment->num_rows(), num_rows);
+        return data;
+    }
+};
+
+// The stitched segment has the same rows and indexes as the segment written with all the rows.
+TEST_F(SegmentStitcherTest, SameAsWrittenSegment) {
+    auto schema = create_schema();
+    ASSERT_TRUE(SegmentStitcher::check_schema(*schema).ok());
+    std::vector<SegmentSharedPtr> inputs(3);
+    build_segment(schema, 0, 0, 1500, &inputs[0]);
+    build_segment(schema, 1, 1500, 2200, &inputs[1]);
+    build_segment(schema, 2, 2200, 4300, &inputs[2]);
+    SegmentSharedPtr expected;
+    build_segment(schema, 3, 0, 4300, &expected);
+
+    io::FileWriterPtr file_writer;
+    ASSERT_TRUE(io::global_local_filesystem()->create_file(path_of(4), &file_writer).ok());
+    SegmentStitcher stitcher(schema, file_writer.get(), 4);
+    for (const auto& input : inputs) {
+        auto st = stitcher.add_segment(input);
+        ASSERT_TRUE(st.ok()) << st;
+    }
+    uint64_t file_size = 0;
+    uint64_t index_size = 0;
+    auto st = stitcher.finalize(&file_size, &index_size);
+    ASSERT_TRUE(st.ok()) << st;
+    ASSERT_TRUE(file_writer->close().ok());
+    EXPECT_EQ(4300, stitcher.num_rows());
+
+    SegmentSharedPtr stitched;
+    open_segment(schema, 4, &stitched);
+    ASSERT_EQ(4300, stitched->num_rows());
+    for (size_t cid = 0; cid < schema->num_columns(); ++cid) {
+        auto expected_data = read_column(expected, schema->column(cid));
+        auto stitched_data = read_column(stitched, schema->column(cid));
+        for (size_t i = 0; i < expected_data->size(); ++i) {
+            ASSERT_EQ(0, stitched_data->compare_at(i, i, *expected_data, -1)) << cid << " " << i;
+        }
+    }
+
+    ASSERT_TRUE(expected->load_index().ok());
+    ASSERT_TRUE(stitched->load_index().ok());
+    const auto* expected_keys = expected->get_short_key_index();
+    const auto* stitched_keys = stitched->get_short_key_index();
+    ASSERT_EQ(expected_keys->num_items(), stitched_keys->num_items());
+    for (uint32_t i = 0; i < expected_keys->num_items(); ++i) {
+        EXPECT_EQ(expected_keys->key(i).to_string(), stitched_keys->key(i).to_string());
+    }
+
+    SegmentFooterPB expected_footer;
+    SegmentFooterPB stitched_footer;
+    ASSERT_TRUE(expected->read_footer(&expected_footer).ok());
+    ASSERT_TRUE(stitched->read_footer(&stitched_footer).ok());
+    for (size_t cid = 0; cid < schema->num_columns(); ++cid) {
+        for (const auto& index : expected_footer.columns(cid).indexes()) {
+            if (index.type() != ZONE_MAP_INDEX) {
+                continue;
+            }
+            bool found = false;
+            for (const auto& stitched_index : stitched_footer.columns(cid).indexes()) {
+                if (stitched_index.type() == ZONE_MAP_INDEX) {
+                    const auto& zone_map = stitched_index.zone_map_index().segment_zone_map();
+                    EXPECT_EQ(index.zone_map_index().segment_zone_map().ShortDebugString(),
+                              zone_map.ShortDebugString());
+                    found = true;
+                }
+            }
+            EXPECT_TRUE(found) << cid;
+        }
+    }
+}
+
+TEST_F(SegmentStitcherTest, RejectMissingColumn) {
+    auto schema = create_schema();
+    SegmentSharedPtr input;
+    build_segment(schema, 0, 0, 100, &input);
+
+    auto new_schema = create_schema();
+    new_schema->append_column(*create_int_value(3));
+    io::FileWriterPtr file_writer;
+    ASSERT_TRUE(io::global_local_filesystem()->create_file(path_of(1), &file_writer).ok());
+    SegmentStitcher stitcher(new_schema, file_writer.get(), 1);
+    EXPECT_TRUE(stitcher.add_segment(input).is<ErrorCode::NOT_IMPLEMENTED_ERROR>());
+}
+
+} // namespace segment_v2
+} // namespace doris
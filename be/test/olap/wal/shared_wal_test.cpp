@@ -0,0 +1,291 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/wal/shared_wal.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+#include "io/fs/local_file_system.h"
+
+namespace doris {
+
+class SharedWalTest : public testing::Test {
+public:
+    void SetUp() override {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_wal_dir));
+        static_cast<void>(io::global_local_filesystem()->create_directory(_wal_dir));
+        _segment_bytes = config::group_commit_shared_wal_segment_bytes;
+    }
+
+    void TearDown() override {
+        config::group_commit_shared_wal_segment_bytes = _segment_bytes;
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_wal_dir));
+    }
+
+    static void append_wal(SharedWal& shared_wal, int64_t table_id, int64_t wal_id,
+                           const std::vector<std::string>& blocks) {
+        uint64_t lsn = 0;
+        std::string wal_path = "1/" + std::to_string(table_id) + "/0_1_" +
+                               std::to_string(wal_id) + "_label_" + std::to_string(wal_id);
+        EXPECT_TRUE(shared_wal
+                            .append(table_id, wal_id, SharedWal::HEADER,
+                                    SharedWal::encode_header(0, wal_path, "1,2"), &lsn)
+                            .ok());
+        for (const auto& block : blocks) {
+            EXPECT_TRUE(shared_wal.append(table_id, wal_id, SharedWal::BLOCK, block, &lsn).ok());
+        }
+        EXPECT_TRUE(shared_wal.sync(wal_id, lsn).ok());
+    }
+
+    static std::vector<std::string> read_blocks(SharedWal& shared_wal, int64_t wal_id) {
+        std::vector<SharedWal::RecordLocation> records;
+        EXPECT_TRUE(shared_wal.get_records(wal_id, &records).ok());
+        std::vector<std::string> blocks;
+        for (size_t i = 1; i < records.size(); ++i) {
+            std::string payload;
+            EXPECT_TRUE(shared_wal.read_record(records[i], &payload).ok());
+            blocks.push_back(payload);
+        }
+        return blocks;
+    }
+
+    // the segment files of the log, without the preallocated spare one
+    std::vector<std::string> segment_files() {
+        std::vector<io::FileInfo> files;
+        bool exists = false;
+        EXPECT_TRUE(io::global_local_filesystem()
+                            ->list(_wal_dir + "/" + SharedWal::SHARED_WAL_DIR, true, &files,
+                                   &exists)
+                            .ok());
+        std::vector<std::string> segments;
+        for (const auto& file : files) {
+            if (file.file_name.ends_with(".seg")) {
+                segments.push_back(file.file_name);
+            }
+        }
+        std::sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    size_t segment_num() { return segment_files().size(); }
+
+    static bool wait_for(SharedWal& shared_wal, const std::function<bool()>& done) {
+        for (int i = 0; i < 500; ++i) {
+            {
+                std::lock_guard l(shared_wal._lock);
+                if (done()) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    std::string _wal_dir = "./log/shared_wal_test";
+    int64_t _segment_bytes = 0;
+};
+
+TEST_F(SharedWalTest, RecoverNotReleasedWals) {
+    {
+        SharedWal shared_wal(_wal_dir);
+        std::vector<SharedWal::RecoveredWal> recovered;
+        ASSERT_TRUE(shared_wal.init(&recovered).ok());
+        EXPECT_TRUE(recovered.empty());
+        append_wal(shared_wal, 10, 1, {"a", "bb"});
+        append_wal(shared_wal, 11, 2, {"ccc"});
+        append_wal(shared_wal, 10, 3, {});
+        shared_wal.release(1);
+        std::vector<SharedWal::RecordLocation> records;
+        EXPECT_FALSE(shared_wal.get_records(1, &records).ok());
+        EXPECT_EQ((std::vector<std::string> {"ccc"}), read_blocks(shared_wal, 2));
+        shared_wal.stop();
+    }
+
+    SharedWal shared_wal(_wal_dir);
+    std::vector<SharedWal::RecoveredWal> recovered;
+    ASSERT_TRUE(shared_wal.init(&recovered).ok());
+    ASSERT_EQ(2, recovered.size());
+    std::sort(recovered.begin(), recovered.end(),
+              [](const auto& a, const auto& b) { return a.wal_id < b.wal_id; });
+    EXPECT_EQ(2, recovered[0].wal_id);
+    EXPECT_EQ(11, recovered[0].table_id);
+    EXPECT_EQ(_wal_dir + "/1/11/0_1_2_label_2", recovered[0].wal_path);
+    EXPECT_EQ(3, recovered[1].wal_id);
+    EXPECT_EQ((std::vector<std::string> {"ccc"}), read_blocks(shared_wal, 2));
+    EXPECT_TRUE(read_blocks(shared_wal, 3).empty());
+
+    std::vector<SharedWal::RecordLocation> records;
+    ASSERT_TRUE(shared_wal.get_records(2, &records).ok());
+    std::string header;
+    ASSERT_TRUE(shared_wal.read_record(records[0], &header).ok());
+    uint32_t version = 1;
+    std::string wal_path;
+    std::string col_ids;
+    ASSERT_TRUE(SharedWal::decode_header(header, &version, &wal_path, &col_ids).ok());
+    EXPECT_EQ(0, version);
+    EXPECT_EQ("1/11/0_1_2_label_2", wal_path);
+    EXPECT_EQ("1,2", col_ids);
+}
+
+TEST_F(SharedWalTest, StopAtTornRecord) {
+    std::string segment_path;
+    {
+        SharedWal shared_wal(_wal_dir);
+        std::vector<SharedWal::RecoveredWal> recovered;
+        ASSERT_TRUE(shared_wal.init(&recovered).ok());
+        append_wal(shared_wal, 10, 1, {"first", "torn block"});
+        shared_wal.stop();
+    }
+    auto files = segment_files();
+    ASSERT_EQ(1, files.size());
+    segment_path = _wal_dir + "/" + SharedWal::SHARED_WAL_DIR + "/" + files[0];
+    std::string content;
+    {
+        std::ifstream in(segment_path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto pos = content.find("torn block");
+    ASSERT_NE(std::string::npos, pos);
+    {
+        std::fstream out(segment_path, std::ios::binary | std::ios::in | std::ios::out);
+        out.seekp(pos);
+        out.write("x", 1);
+    }
+
+    SharedWal shared_wal(_wal_dir);
+    std::vector<SharedWal::RecoveredWal> recovered;
+    ASSERT_TRUE(shared_wal.init(&recovered).ok());
+    ASSERT_EQ(1, recovered.size());
+    EXPECT_EQ((std::vector<std::string> {"first"}), read_blocks(shared_wal, 1));
+}
+
+TEST_F(SharedWalTest, DeleteReleasedSegments) {
+    config::group_commit_shared_wal_segment_bytes = 256;
+    SharedWal shared_wal(_wal_dir);
+    std::vector<SharedWal::RecoveredWal> recovered;
+    ASSERT_TRUE(shared_wal.init(&recovered).ok());
+    std::string block(200, 'x');
+    append_wal(shared_wal, 10, 1, {block, block});
+    append_wal(shared_wal, 10, 2, {block, block});
+    EXPECT_EQ(6, segment_num());
+
+    // the segments of wal 2 are only deleted after the ones of wal 1 before them
+    shared_wal.release(2);
+    EXPECT_EQ(6, segment_num());
+    EXPECT_EQ((std::vector<std::string> {block, block}), read_blocks(shared_wal, 1));
+    shared_wal.release(1);
+    EXPECT_EQ(1, segment_num());
+}
+
+TEST_F(SharedWalTest, SyncRelease) {
+    SharedWal shared_wal(_wal_dir);
+    std::vector<SharedWal::RecoveredWal> recovered;
+    ASSERT_TRUE(shared_wal.init(&recovered).ok());
+    append_wal(shared_wal, 10, 1, {"a"});
+    shared_wal.release(1);
+    // nobody waits for the release record, it is synced in the background
+    EXPECT_TRUE(wait_for(shared_wal, [&] {
+        return shared_wal._synced_lsn == shared_wal._appended_lsn &&
+               shared_wal._unsynced_files.empty();
+    }));
+}
+
+TEST_F(SharedWalTest, PreallocateNextSegment) {
+    config::group_commit_shared_wal_segment_bytes = 256;
+    SharedWal shared_wal(_wal_dir);
+    std::vector<SharedWal::RecoveredWal> recovered;
+    ASSERT_TRUE(shared_wal.init(&recovered).ok());
+    ASSERT_TRUE(wait_for(shared_wal, [&] { return shared_wal._spare_file != nullptr; }));
+    SharedWal::SegmentFile* spare = shared_wal._spare_file.get();
+
+    // the log switches to the spare file, and a new one is preallocated
+    std::string block(200, 'x');
+    append_wal(shared_wal, 10, 1, {block});
+    auto files = segment_files();
+    ASSERT_EQ(2, files.size());
+    {
+        std::lock_guard l(shared_wal._lock);
+        const auto& file = shared_wal._segments[shared_wal._current_segment_id].file;
+        EXPECT_EQ(spare, file.get());
+        EXPECT_EQ(_wal_dir + "/" + SharedWal::SHARED_WAL_DIR + "/" + files[1], file->path);
+    }
+    EXPECT_TRUE(wait_for(shared_wal, [&] { return shared_wal._spare_file != nullptr; }));
+    EXPECT_EQ((std::vector<std::string> {block}), read_blocks(shared_wal, 1));
+    shared_wal.stop();
+
+    // the spare file is not a segment of the recovered log
+    SharedWal recovered_wal(_wal_dir);
+    ASSERT_TRUE(recovered_wal.init(&recovered).ok());
+    ASSERT_EQ(1, recovered.size());
+    EXPECT_EQ((std::vector<std::string> {block}), read_blocks(recovered_wal, 1));
+}
+
+TEST_F(SharedWalTest, SyncFailure) {
+    SharedWal shared_wal(_wal_dir);
+    std::vector<SharedWal::RecoveredWal> recovered;
+    ASSERT_TRUE(shared_wal.init(&recovered).ok());
+    uint64_t lsn = 0;
+    ASSERT_TRUE(shared_wal
+                        .append(10, 1, SharedWal::HEADER,
+                                SharedWal::encode_header(0, "1/10/0_1_1_label_1", "1"), &lsn)
+                        .ok());
+    ASSERT_TRUE(shared_wal.append(10, 1, SharedWal::BLOCK, "a", &lsn).ok());
+
+    // a pipe can not be synced
+    int pipe_fds[2];
+    ASSERT_EQ(0, ::pipe(pipe_fds));
+    std::shared_ptr<SharedWal::SegmentFile> file;
+    uint64_t segment_id = 0;
+    int segment_fd = -1;
+    {
+        std::lock_guard l(shared_wal._lock);
+        segment_id = shared_wal._current_segment_id;
+        file = shared_wal._segments[segment_id].file;
+        segment_fd = file->fd;
+        file->fd = pipe_fds[0];
+    }
+    EXPECT_FALSE(shared_wal.sync(1, lsn).ok());
+    EXPECT_FALSE(shared_wal.append(10, 1, SharedWal::BLOCK, "b", &lsn).ok());
+    EXPECT_FALSE(shared_wal.sync(1, lsn).ok());
+    {
+        std::lock_guard l(shared_wal._lock);
+        file->fd = segment_fd;
+        EXPECT_EQ(segment_id + 1, shared_wal._current_segment_id);
+    }
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+
+    // the other wals go on in the new segment
+    append_wal(shared_wal, 10, 2, {"c"});
+    EXPECT_EQ((std::vector<std::string> {"c"}), read_blocks(shared_wal, 2));
+    shared_wal.release(1);
+    shared_wal.release(2);
+}
+
+} // namespace doris
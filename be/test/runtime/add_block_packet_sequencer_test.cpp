@@ -0,0 +1,148 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/add_block_packet_sequencer.h"
+
+#include <gen_cpp/internal_service.pb.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <memory>
+
+#include "gtest/gtest_pred_impl.h"
+
+namespace doris {
+
+class AddBlockPacketSequencerTest : public testing::Test {
+protected:
+    void SetUp() override { _sequencer.init(2); }
+
+    static PTabletWriterAddBlockRequest packet(int sender_id, int64_t seq, int max_in_flight) {
+        PTabletWriterAddBlockRequest request;
+        request.set_sender_id(sender_id);
+        request.set_packet_seq(seq);
+        request.set_max_packets_in_flight(max_in_flight);
+        return request;
+    }
+
+    AddBlockPacketSequencer _sequencer;
+};
+
+TEST_F(AddBlockPacketSequencerTest, in_order) {
+    std::unique_ptr<PTabletWriterAddBlockRequest> next;
+    for (int64_t seq = 0; seq < 3; ++seq) {
+        bool write_now = false;
+        EXPECT_TRUE(_sequencer.accept(packet(0, seq, 1), &write_now).ok());
+        EXPECT_TRUE(write_now);
+        _sequencer.finish(0, Status::OK(), &next);
+        EXPECT_EQ(next.get(), nullptr);
+    }
+    // a duplicate packet is skipped
+    bool write_now = true;
+    EXPECT_TRUE(_sequencer.accept(packet(0, 1, 1), &write_now).ok());
+    EXPECT_FALSE(write_now);
+    EXPECT_TRUE(_sequencer.close_sender(0).ok());
+}
+
+TEST_F(AddBlockPacketSequencerTest, reorder) {
+    std::unique_ptr<PTabletWriterAddBlockRequest> next;
+    bool write_now = false;
+    // packets 2 and 1 arrive before packet 0, they are buffered
+    EXPECT_TRUE(_sequencer.accept(packet(0, 2, 3), &write_now).ok());
+    EXPECT_FALSE(write_now);
+    EXPECT_TRUE(_sequencer.accept(packet(0, 1, 3), &write_now).ok());
+    EXPECT_FALSE(write_now);
+    EXPECT_EQ(_sequencer.num_buffered_packets(0), 2U);
+    // the packets of another sender are not affected
+    EXPECT_TRUE(_sequencer.accept(packet(1, 0, 3), &write_now).ok());
+    EXPECT_TRUE(write_now);
+    _sequencer.finish(1, Status::OK(), &next);
+    EXPECT_EQ(next.get(), nullptr);
+
+    // the rpc of packet 0 writes the buffered packets in order
+    EXPECT_TRUE(_sequencer.accept(packet(0, 0, 3), &write_now).ok());
+    EXPECT_TRUE(write_now);
+    _sequencer.finish(0, Status::OK(), &next);
+    ASSERT_NE(next.get(), nullptr);
+    EXPECT_EQ(next->packet_seq(), 1);
+    _sequencer.finish(0, Status::OK(), &next);
+    ASSERT_NE(next.get(), nullptr);
+    EXPECT_EQ(next->packet_seq(), 2);
+    _sequencer.finish(0, Status::OK(), &next);
+    EXPECT_EQ(next.get(), nullptr);
+    EXPECT_EQ(_sequencer.num_buffered_packets(0), 0U);
+
+    // a packet that arrives while the one ahead of it is being written is buffered
+    EXPECT_TRUE(_sequencer.accept(packet(0, 3, 3), &write_now).ok());
+    EXPECT_TRUE(write_now);
+    EXPECT_TRUE(_sequencer.accept(packet(0, 4, 3), &write_now).ok());
+    EXPECT_FALSE(write_now);
+    _sequencer.finish(0, Status::OK(), &next);
+    ASSERT_NE(next.get(), nullptr);
+    EXPECT_EQ(next->packet_seq(), 4);
+    _sequencer.finish(0, Status::OK(), &next);
+    EXPECT_EQ(next.get(), nullptr);
+    EXPECT_TRUE(_sequencer.close_sender(0).ok());
+}
+
+TEST_F(AddBlockPacketSequencerTest, predecessor_failure) {
+    std::unique_ptr<PTabletWriterAddBlockRequest> next;
+    bool write_now = false;
+    EXPECT_TRUE(_sequencer.accept(packet(0, 1, 2), &write_now).ok());
+    EXPECT_FALSE(write_now);
+    EXPECT_TRUE(_sequencer.accept(packet(0, 0, 2), &write_now).ok());
+    EXPECT_TRUE(write_now);
+    // writing packet 0 fails, the buffered packet is dropped and the sender fails
+    _sequencer.finish(0, Status::InternalError("write failed"), &next);
+    EXPECT_EQ(next.get(), nullptr);
+    EXPECT_EQ(_sequencer.num_buffered_packets(0), 0U);
+    Status st = _sequencer.accept(packet(0, 2, 2), &write_now);
+    EXPECT_FALSE(st.ok());
+    EXPECT_FALSE(write_now);
+    EXPECT_TRUE(st.to_string().find("write failed") != std::string::npos);
+    EXPECT_FALSE(_sequencer.close_sender(0).ok());
+    // the other sender goes on
+    EXPECT_TRUE(_sequencer.accept(packet(1, 0, 2), &write_now).ok());
+    EXPECT_TRUE(write_now);
+}
+
+TEST_F(AddBlockPacketSequencerTest, lost_packet) {
+    bool write_now = false;
+    // without packets in flight, a gap fails at once
+    Status st = _sequencer.accept(packet(0, 1, 1), &write_now);
+    EXPECT_FALSE(st.ok());
+    EXPECT_TRUE(st.to_string().find("lost data packet") != std::string::npos);
+    EXPECT_FALSE(_sequencer.accept(packet(0, 0, 1), &write_now).ok());
+
+    // a packet beyond the window fails at once
+    EXPECT_TRUE(_sequencer.accept(packet(1, 1, 2), &write_now).ok());
+    EXPECT_FALSE(write_now);
+    EXPECT_FALSE(_sequencer.accept(packet(1, 2, 2), &write_now).ok());
+}
+
+TEST_F(AddBlockPacketSequencerTest, lost_packet_at_eos) {
+    bool write_now = false;
+    // packet 0 never arrives, the sender fails at its eos
+    EXPECT_TRUE(_sequencer.accept(packet(0, 1, 2), &write_now).ok());
+    EXPECT_FALSE(write_now);
+    Status st = _sequencer.close_sender(0);
+    EXPECT_FALSE(st.ok());
+    EXPECT_TRUE(st.to_string().find("lost data packet") != std::string::npos);
+    EXPECT_EQ(_sequencer.num_buffered_packets(0), 0U);
+}
+
+} // namespace doris
@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/memory/recycled_buffer_pool.h"
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+#include <sys/mman.h>
+
+#include <memory>
+
+#include "common/config.h"
+#include "gtest/gtest_pred_impl.h"
+#include "runtime/memory/mem_tracker.h"
+
+namespace doris {
+
+class RecycledBufferPoolTest : public testing::Test {
+public:
+    void SetUp() override {
+        _enable_query_buffer_pool = config::enable_query_buffer_pool;
+        config::enable_query_buffer_pool = true;
+        _tracker = std::make_unique<MemTracker>("RecycledBufferPoolTest");
+    }
+
+    void TearDown() override { config::enable_query_buffer_pool = _enable_query_buffer_pool; }
+
+    static void* map(size_t size) {
+        void* buf = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        EXPECT_NE(MAP_FAILED, buf);
+        return buf;
+    }
+
+protected:
+    bool _enable_query_buffer_pool = false;
+    std::unique_ptr<MemTracker> _tracker;
+};
+
+TEST_F(RecycledBufferPoolTest, PoolableSize) {
+    const size_t min_bytes = config::query_buffer_pool_min_bytes;
+    EXPECT_TRUE(RecycledBufferPool::is_poolable_size(min_bytes));
+    EXPECT_TRUE(RecycledBufferPool::is_poolable_size(min_bytes * 4));
+    EXPECT_FALSE(RecycledBufferPool::is_poolable_size(min_bytes / 2));
+    EXPECT_FALSE(RecycledBufferPool::is_poolable_size(min_bytes + 4096));
+    config::enable_query_buffer_pool = false;
+    EXPECT_FALSE(RecycledBufferPool::is_poolable_size(min_bytes));
+}
+
+TEST_F(RecycledBufferPoolTest, ReuseSameSizeClass) {
+    RecycledBufferPool pool(_tracker.get(), -1);
+    const size_t size = config::query_buffer_pool_min_bytes * 2;
+    EXPECT_EQ(nullptr, pool.acquire(size));
+
+    void* buf = map(size);
+    EXPECT_TRUE(pool.release(buf, size));
+    EXPECT_EQ(size, pool.retained_bytes());
+    EXPECT_EQ(size, _tracker->consumption());
+
+    // Another size class does not hit.
+    EXPECT_EQ(nullptr, pool.acquire(size * 2));
+    EXPECT_EQ(buf, pool.acquire(size));
+    EXPECT_EQ(0, pool.retained_bytes());
+    EXPECT_EQ(0, _tracker->consumption());
+    EXPECT_EQ(1, pool.hit_count());
+    EXPECT_EQ(2, pool.miss_count());
+    munmap(buf, size);
+}
+
+TEST_F(RecycledBufferPoolTest, OverflowToDepotAndCapacity) {
+    const size_t size = config::query_buffer_pool_min_bytes;
+    // Limit derived from the query mem limit.
+    RecycledBufferPool pool(_tracker.get(), size * 20);
+    EXPECT_LE(pool.capacity(), size * 20 * config::query_buffer_pool_limit_ratio);
+    const size_t num = pool.capacity() / size;
+    EXPECT_GT(num, RecycledBufferPool::MAGAZINE_CAPACITY);
+
+    std::vector<void*> bufs;
+    for (size_t i = 0; i < num; ++i) {
+        bufs.push_back(map(size));
+        EXPECT_TRUE(pool.release(bufs.back(), size));
+    }
+    // Pool is full, the caller keeps the buffer.
+    void* extra = map(size);
+    EXPECT_FALSE(pool.release(extra, size));
+    munmap(extra, size);
+
+    for (size_t i = 0; i < num; ++i) {
+        void* buf = pool.acquire(size);
+        EXPECT_NE(nullptr, buf);
+        // Written by the new owner.
+        memset(buf, 1, size);
+        EXPECT_TRUE(pool.release(buf, size));
+    }
+    EXPECT_EQ(size * num, pool.retained_bytes());
+}
+
+TEST_F(RecycledBufferPoolTest, PruneReleasesAll) {
+    const size_t size = config::query_buffer_pool_min_bytes;
+    RecycledBufferPool pool(_tracker.get(), -1);
+    EXPECT_TRUE(pool.release(map(size), size));
+    EXPECT_TRUE(pool.release(map(size * 2), size * 2));
+    EXPECT_EQ(size * 3, _tracker->consumption());
+
+    RecycledBufferPoolCache::instance()->prune_all(true);
+    EXPECT_EQ(0, pool.retained_bytes());
+    EXPECT_EQ(0, _tracker->consumption());
+    EXPECT_EQ(nullptr, pool.acquire(size));
+}
+
+} // namespace doris
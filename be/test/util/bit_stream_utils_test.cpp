@@ -20,6 +20,7 @@
 #include <gtest/gtest-message.h>
 #include <gtest/gtest-test-part.h>
 
+#include <algorithm>
 #include <boost/utility/binary.hpp>
 #include <cstdint>
 #include <string>
@@ -218,4 +219,55 @@ TEST(TestBitStreamUtil, TestUint64) {
     reader.GetValue(16, &v4);
     EXPECT_EQ(v4, 126);
 }
+
+// Unpacks the values of every bit width in batches, through the SIMD kernels where the build
+// has them.
+TEST(TestBitStreamUtil, TestUnpackBatch) {
+    const int num_values = 1000;
+    for (int bit_width = 1; bit_width <= 32; ++bit_width) {
+        uint64_t mask = (1ULL << bit_width) - 1;
+        std::vector<uint32_t> values(num_values);
+        faststring buffer;
+        BitWriter writer(&buffer);
+        for (int i = 0; i < num_values; ++i) {
+            values[i] = (i * 2654435761ULL) & mask;
+            writer.PutValue(values[i], bit_width);
+        }
+        writer.Flush();
+
+        std::vector<uint32_t> unpacked(num_values);
+        auto [end, num_read] = BitPacking::UnpackValues(bit_width, buffer.data(), buffer.size(),
+                                                        num_values, unpacked.data());
+        EXPECT_EQ(num_values, num_read);
+        EXPECT_EQ(buffer.data() + BitUtil::RoundUpNumBytes(num_values * bit_width), end);
+        EXPECT_EQ(values, unpacked);
+
+        if (bit_width <= 16) {
+            std::vector<uint16_t> unpacked16(num_values);
+            BitPacking::UnpackValues(bit_width, buffer.data(), buffer.size(), num_values,
+                                     unpacked16.data());
+            for (int i = 0; i < num_values; ++i) {
+                EXPECT_EQ(values[i], unpacked16[i]);
+            }
+        }
+
+        // the bit reader unpacks the values after the first 8 in batches
+        BitReader reader(buffer.data(), buffer.size());
+        for (int i = 0; i < 8; ++i) {
+            uint32_t value = 0;
+            EXPECT_TRUE(reader.GetValue(bit_width, &value));
+            EXPECT_EQ(values[i], value);
+        }
+        std::fill(unpacked.begin(), unpacked.end(), 0);
+        EXPECT_EQ(num_values - 16, reader.UnpackBatch(bit_width, num_values - 16, &unpacked[8]));
+        for (int i = 8; i < num_values - 8; ++i) {
+            EXPECT_EQ(values[i], unpacked[i]);
+        }
+        for (int i = num_values - 8; i < num_values; ++i) {
+            uint32_t value = 0;
+            EXPECT_TRUE(reader.GetValue(bit_width, &value));
+            EXPECT_EQ(values[i], value);
+        }
+    }
+}
 } // namespace doris
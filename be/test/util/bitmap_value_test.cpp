@@ -1026,6 +1026,16 @@ TEST(BitmapValueTest, bitmap_union) {
     EXPECT_EQ(3, bitmap3.cardinality());
     bitmap3.fastunion({&bitmap});
     EXPECT_EQ(5, bitmap3.cardinality());
+
+    // batches unioned into an accumulated bitmap, across different high 32 bits
+    BitmapValue bitmap4({1, 2, 3});
+    BitmapValue high({(1ULL << 32) + 1, (1ULL << 32) + 2, (1ULL << 32) + 3});
+    bitmap4.fastunion({&bitmap, &high, &single});
+    EXPECT_EQ(9, bitmap4.cardinality());
+    bitmap4.fastunion({&bitmap, &high});
+    EXPECT_EQ(9, bitmap4.cardinality());
+    EXPECT_TRUE(bitmap4.contains((1ULL << 32) + 2));
+    EXPECT_TRUE(bitmap4.contains(1026));
 }
 
 TEST(BitmapValueTest, bitmap_intersect) {
@@ -1152,6 +1162,58 @@ TEST(BitmapValueTest, bitmap_serde) {
     }
 }
 
+TEST(BitmapValueTest, bitmap_frozen) {
+    auto min_bytes = config::frozen_bitmap_min_bytes;
+    config::frozen_bitmap_min_bytes = 0;
+    for (int16_t serialize_version : {1, 2}) {
+        config::bitmap_serialize_version = serialize_version;
+        BitmapValue bitmap;
+        for (uint64_t i = 0; i < 100000; i += 3) {
+            bitmap.add(i);
+            bitmap.add((uint64_t(7) << 32) + i * 5);
+        }
+        // a run container
+        for (uint64_t i = 200000; i < 300000; ++i) {
+            bitmap.add(i);
+        }
+        std::string buffer = convert_bitmap_to_string(bitmap);
+
+        BitmapValue frozen;
+        EXPECT_TRUE(frozen.deserialize_frozen(buffer.data(), buffer.size()));
+        buffer.assign(buffer.size(), 0); // the frozen bitmap owns a copy
+        EXPECT_EQ(bitmap.cardinality(), frozen.cardinality());
+        EXPECT_TRUE(frozen.contains(99999));
+        EXPECT_FALSE(frozen.contains(100000));
+        EXPECT_TRUE(frozen.contains((uint64_t(7) << 32) + 5));
+        EXPECT_EQ(convert_bitmap_to_string(bitmap), convert_bitmap_to_string(frozen));
+
+        // a copy shares the frozen bitmap until either is modified
+        BitmapValue copy = frozen;
+        copy.add(100000);
+        EXPECT_TRUE(copy.contains(100000));
+        EXPECT_FALSE(frozen.contains(100000));
+        frozen.remove(0);
+        EXPECT_FALSE(frozen.contains(0));
+        EXPECT_TRUE(copy.contains(0));
+        EXPECT_EQ(bitmap.cardinality() - 1, frozen.cardinality());
+
+        BitmapValue frozen2;
+        std::string buffer2 = convert_bitmap_to_string(bitmap);
+        EXPECT_TRUE(frozen2.deserialize_frozen(buffer2.data(), buffer2.size()));
+        BitmapValue other({1, 2, uint64_t(9) << 32});
+        BitmapValue result;
+        result.fastunion({&frozen2, &other, &copy});
+        BitmapValue expected = bitmap;
+        expected |= other;
+        expected |= copy;
+        EXPECT_EQ(expected.cardinality(), result.cardinality());
+        EXPECT_EQ(convert_bitmap_to_string(expected), convert_bitmap_to_string(result));
+        EXPECT_EQ(bitmap.cardinality(), frozen2.cardinality());
+    }
+    config::bitmap_serialize_version = 1;
+    config::frozen_bitmap_min_bytes = min_bytes;
+}
+
 // Forked from CRoaring's UT of Roaring64Map
 TEST(BitmapValueTest, Roaring64Map) {
     using doris::detail::Roaring64Map;
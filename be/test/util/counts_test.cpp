@@ -20,6 +20,12 @@
 #include <gtest/gtest-message.h>
 #include <gtest/gtest-test-part.h>
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest_pred_impl.h"
 
 namespace doris {
@@ -64,4 +70,85 @@ TEST_F(TCountsTest, TotalTest) {
     delete[] writer;
 }
 
+// The percentile of a sorted vector, interpolated the same way as Counts.
+static double brute_force_percentile(std::vector<int64_t> values, double quantile) {
+    std::sort(values.begin(), values.end());
+    double position = (values.size() - 1) * quantile;
+    auto lower = static_cast<size_t>(std::floor(position));
+    auto higher = static_cast<size_t>(std::ceil(position));
+    if (lower == higher || values[lower] == values[higher]) {
+        return values[lower];
+    }
+    return (higher - position) * values[lower] + (position - lower) * values[higher];
+}
+
+TEST_F(TCountsTest, MultiQuantileBufferAndMap) {
+    std::mt19937_64 rng(42);
+    const std::vector<double> quantiles {0.99, 0.5, 0.0, 0.9, 1.0, 0.5, 0.123};
+    // High cardinality keeps the buffer, low cardinality switches to the map.
+    for (int64_t range : {int64_t(1) << 40, int64_t(16)}) {
+        Counts counts;
+        Counts other;
+        std::vector<int64_t> values;
+        for (int i = 0; i < 20000; ++i) {
+            int64_t value = static_cast<int64_t>(rng() % range) - range / 2;
+            values.push_back(value);
+            (i % 3 == 0 ? other : counts).increment(value, 1);
+        }
+        counts.merge(&other);
+
+        std::vector<double> results(quantiles.size());
+        counts.terminate(quantiles.data(), quantiles.size(), results.data());
+        for (size_t i = 0; i < quantiles.size(); ++i) {
+            EXPECT_DOUBLE_EQ(brute_force_percentile(values, quantiles[i]), results[i]);
+        }
+
+        for (bool compact : {true, false}) {
+            std::string buf;
+            if (compact) {
+                buf.resize(counts.compact_serialized_size());
+                counts.compact_serialize((uint8_t*)buf.data());
+            } else {
+                buf.resize(counts.serialized_size());
+                counts.serialize((uint8_t*)buf.data());
+            }
+            Counts read;
+            if (compact) {
+                read.compact_unserialize((const uint8_t*)buf.data());
+            } else {
+                read.unserialize((const uint8_t*)buf.data());
+            }
+            for (size_t i = 0; i < quantiles.size(); ++i) {
+                EXPECT_DOUBLE_EQ(results[i], read.terminate(quantiles[i]));
+            }
+        }
+    }
+}
+
+TEST_F(TCountsTest, IncrementBatch) {
+    std::mt19937_64 rng(7);
+    for (int64_t range : {int64_t(1) << 40, int64_t(16)}) {
+        Counts counts;
+        std::vector<int64_t> values;
+        for (int i = 0; i < 20000; ++i) {
+            values.push_back(static_cast<int64_t>(rng() % range));
+        }
+        for (size_t begin = 0; begin < values.size(); begin += 1000) {
+            counts.increment_batch(values.data() + begin, 1000);
+        }
+        for (double quantile : {0.0, 0.25, 0.5, 0.999, 1.0}) {
+            EXPECT_DOUBLE_EQ(brute_force_percentile(values, quantile), counts.terminate(quantile));
+        }
+    }
+}
+
+TEST_F(TCountsTest, Empty) {
+    Counts counts;
+    EXPECT_EQ(0.0, counts.terminate(0.5));
+    counts.increment(7, 1);
+    EXPECT_EQ(7.0, counts.terminate(0.5));
+    counts.clear();
+    EXPECT_TRUE(counts.empty());
+}
+
 } // namespace doris
@@ -0,0 +1,205 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/jsonb_document.h"
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest_pred_impl.h"
+#include "util/jsonb_writer.h"
+
+namespace doris {
+
+class JsonbDocumentTest : public testing::Test {
+protected:
+    void SetUp() override { _enable_index = config::enable_jsonb_container_index; }
+
+    void TearDown() override { config::enable_jsonb_container_index = _enable_index; }
+
+private:
+    bool _enable_index = false;
+};
+
+static void write_object(JsonbWriter& writer, int num_keys) {
+    writer.writeStartObject();
+    for (int i = 0; i < num_keys; ++i) {
+        std::string key = "key_" + std::to_string(i);
+        writer.writeKey(key.c_str(), (uint8_t)key.size());
+        writer.writeInt(i);
+    }
+}
+
+TEST_F(JsonbDocumentTest, IndexedObject) {
+    config::enable_jsonb_container_index = true;
+    for (int num_keys : {0, 3, 15, 16, 250}) {
+        JsonbWriter writer;
+        write_object(writer, num_keys);
+        // A duplicate key finds the first value.
+        writer.writeKey("key_0", 5);
+        writer.writeInt(-1);
+        writer.writeEndObject();
+
+        JsonbDocument* doc = writer.getDocument();
+        ASSERT_NE(nullptr, doc);
+        auto* object = (ObjectVal*)doc->getValue();
+        const bool indexed = num_keys + 1 >= ContainerVal::sMinIndexedElems;
+        EXPECT_EQ(indexed, object->isIndexed());
+        EXPECT_EQ(indexed ? JSONB_VER_INDEXED : JSONB_VER, doc->version());
+        EXPECT_EQ(num_keys + 1, object->numElem());
+
+        for (int i = 0; i < num_keys; ++i) {
+            std::string key = "key_" + std::to_string(i);
+            JsonbValue* value = object->find(key.c_str());
+            ASSERT_NE(nullptr, value);
+            EXPECT_EQ(i, ((JsonbIntVal*)value)->val());
+            EXPECT_EQ(key, std::string(object->getJsonbKeyValue(i)->getKeyStr(),
+                                       object->getJsonbKeyValue(i)->klen()));
+        }
+        EXPECT_EQ(nullptr, object->find("key_"));
+        EXPECT_EQ(nullptr, object->find("missing"));
+        EXPECT_EQ(nullptr, object->getJsonbKeyValue(num_keys + 1));
+
+        // The index is not iterated.
+        int num_iterated = 0;
+        for (auto it = object->begin(); it != object->end(); ++it) {
+            ++num_iterated;
+        }
+        EXPECT_EQ(num_keys + 1, num_iterated);
+    }
+}
+
+TEST_F(JsonbDocumentTest, IndexedArray) {
+    config::enable_jsonb_container_index = true;
+    JsonbWriter writer;
+    writer.writeStartArray();
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 100 == 0) {
+            // Nested containers are indexed too.
+            write_object(writer, 20);
+            writer.writeEndObject();
+        } else {
+            writer.writeInt(i);
+        }
+    }
+    writer.writeEndArray();
+
+    JsonbDocument* doc = writer.getDocument();
+    ASSERT_NE(nullptr, doc);
+    auto* array = (ArrayVal*)doc->getValue();
+    EXPECT_TRUE(array->isIndexed());
+    EXPECT_EQ(1000, array->numElem());
+    for (int i = 0; i < 1000; ++i) {
+        JsonbValue* value = array->get(i);
+        ASSERT_NE(nullptr, value);
+        if (i % 100 == 0) {
+            ASSERT_TRUE(value->isObject());
+            EXPECT_TRUE(((ObjectVal*)value)->isIndexed());
+            EXPECT_EQ(19, ((JsonbIntVal*)((ObjectVal*)value)->find("key_19"))->val());
+        } else {
+            EXPECT_EQ(i, ((JsonbIntVal*)value)->val());
+        }
+    }
+    EXPECT_EQ(nullptr, array->get(1000));
+    EXPECT_EQ(nullptr, array->get(-1));
+
+    // Copied into another document with its index.
+    JsonbWriter copy_writer;
+    copy_writer.writeStartArray();
+    copy_writer.writeValue(array->get(500));
+    copy_writer.writeEndArray();
+    JsonbDocument* copy = copy_writer.getDocument();
+    ASSERT_NE(nullptr, copy);
+    EXPECT_EQ(JSONB_VER_INDEXED, copy->version());
+    auto* copied = (ObjectVal*)((ArrayVal*)copy->getValue())->get(0);
+    EXPECT_EQ(7, ((JsonbIntVal*)copied->find("key_7"))->val());
+}
+
+TEST_F(JsonbDocumentTest, NotIndexedByDefault) {
+    config::enable_jsonb_container_index = false;
+    JsonbWriter writer;
+    writer.writeStartArray();
+    for (int i = 0; i < 100; ++i) {
+        write_object(writer, 20);
+        writer.writeEndObject();
+    }
+    writer.writeEndArray();
+    JsonbDocument* doc = writer.getDocument();
+    ASSERT_NE(nullptr, doc);
+    EXPECT_EQ(JSONB_VER, doc->version());
+    auto* array = (ArrayVal*)doc->getValue();
+    EXPECT_FALSE(array->isIndexed());
+    EXPECT_FALSE(hasIndexedContainer(array));
+    EXPECT_EQ(100, array->numElem());
+    EXPECT_EQ(7, ((JsonbIntVal*)((ObjectVal*)array->get(42))->find("key_7"))->val());
+
+    // Copies of containers without an index keep version 1.
+    JsonbWriter copy_writer;
+    copy_writer.writeValue(array->get(42));
+    ASSERT_NE(nullptr, copy_writer.getDocument());
+    EXPECT_EQ(JSONB_VER, copy_writer.getDocument()->version());
+    // a one byte header and the value
+    std::vector<char> buf(1 + array->numPackedBytes());
+    JsonbDocument* copy = JsonbDocument::makeDocument(buf.data(), buf.size(), array);
+    ASSERT_NE(nullptr, copy);
+    EXPECT_EQ(JSONB_VER, copy->version());
+
+    // A copy holding an indexed container is version 2, even when indexing is disabled.
+    config::enable_jsonb_container_index = true;
+    JsonbWriter indexed_writer;
+    write_object(indexed_writer, 20);
+    indexed_writer.writeEndObject();
+    auto* indexed = indexed_writer.getDocument()->getValue();
+    ASSERT_TRUE(hasIndexedContainer(indexed));
+    config::enable_jsonb_container_index = false;
+    JsonbWriter nested_writer;
+    nested_writer.writeStartArray();
+    nested_writer.writeInt(1);
+    nested_writer.writeValue(indexed);
+    nested_writer.writeEndArray();
+    EXPECT_EQ(JSONB_VER_INDEXED, nested_writer.getDocument()->version());
+    auto* nested = (ArrayVal*)nested_writer.getDocument()->getValue();
+    EXPECT_FALSE(nested->isIndexed());
+    EXPECT_TRUE(hasIndexedContainer(nested));
+}
+
+TEST_F(JsonbDocumentTest, ReadNotIndexedLargeContainer) {
+    // An array of 100 int8 written before containers were indexed.
+    std::vector<char> buf;
+    buf.push_back(JSONB_VER);
+    buf.push_back((char)JsonbType::T_Array);
+    uint32_t size = 100 * 2;
+    buf.insert(buf.end(), (char*)&size, (char*)&size + sizeof(size));
+    for (int i = 0; i < 100; ++i) {
+        buf.push_back((char)JsonbType::T_Int8);
+        buf.push_back((char)i);
+    }
+
+    JsonbDocument* doc = JsonbDocument::createDocument(buf.data(), (uint32_t)buf.size());
+    ASSERT_NE(nullptr, doc);
+    auto* array = (ArrayVal*)doc->getValue();
+    EXPECT_FALSE(array->isIndexed());
+    EXPECT_EQ(100, array->numElem());
+    EXPECT_EQ(42, ((JsonbIntVal*)array->get(42))->val());
+    EXPECT_EQ(nullptr, array->get(100));
+}
+
+} // namespace doris
@@ -0,0 +1,147 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/numa_util.h"
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest_pred_impl.h"
+#include "util/cpu_info.h"
+
+namespace doris {
+
+class CpuTestUtil {
+public:
+    static void set_fake_numa(int max_num_numa_nodes, const std::vector<int>& core_to_numa_node) {
+        CpuInfo::_init_fake_numa_for_test(max_num_numa_nodes, core_to_numa_node);
+    }
+};
+
+class NumaUtilTest : public testing::Test {
+public:
+    void SetUp() override {
+        _num_nodes = CpuInfo::get_max_num_numa_nodes();
+        for (int core = 0; core < CpuInfo::get_max_num_cores(); ++core) {
+            _core_to_node.push_back(CpuInfo::get_numa_node_of_core(core));
+        }
+    }
+
+    void TearDown() override { CpuTestUtil::set_fake_numa(_num_nodes, _core_to_node); }
+
+protected:
+    int _num_nodes = 1;
+    std::vector<int> _core_to_node;
+};
+
+TEST_F(NumaUtilTest, WorkerNumaNode) {
+    std::vector<int> core_to_node(CpuInfo::get_max_num_cores(), 0);
+    CpuTestUtil::set_fake_numa(1, core_to_node);
+    EXPECT_FALSE(NumaUtil::is_numa_machine());
+    EXPECT_EQ(0, NumaUtil::worker_numa_node(7, 8));
+
+    for (int core = 0; core < core_to_node.size(); ++core) {
+        core_to_node[core] = core % 2;
+    }
+    CpuTestUtil::set_fake_numa(2, core_to_node);
+    EXPECT_TRUE(NumaUtil::is_numa_machine());
+    // Contiguous groups of workers per node.
+    EXPECT_EQ(0, NumaUtil::worker_numa_node(0, 8));
+    EXPECT_EQ(0, NumaUtil::worker_numa_node(3, 8));
+    EXPECT_EQ(1, NumaUtil::worker_numa_node(4, 8));
+    EXPECT_EQ(1, NumaUtil::worker_numa_node(7, 8));
+    EXPECT_EQ(0, NumaUtil::worker_numa_node(0, 0));
+}
+
+TEST_F(NumaUtilTest, NoopOnSingleNode) {
+    std::vector<int> core_to_node(CpuInfo::get_max_num_cores(), 0);
+    CpuTestUtil::set_fake_numa(1, core_to_node);
+    EXPECT_TRUE(NumaUtil::bind_current_thread_to_node(0).ok());
+    NumaInterleaveGuard guard(true);
+}
+
+TEST_F(NumaUtilTest, InterleavedArena) {
+    EXPECT_EQ(4096, NumaInterleavedArena::block_size(1));
+    EXPECT_EQ(4096, NumaInterleavedArena::block_size(4096));
+    EXPECT_EQ(5120, NumaInterleavedArena::block_size(4097));
+    EXPECT_EQ(8192, NumaInterleavedArena::block_size(7169));
+    EXPECT_EQ(80 << 10, NumaInterleavedArena::block_size(65 << 10));
+    EXPECT_EQ(NumaInterleavedArena::MAX_BLOCK_SIZE,
+              NumaInterleavedArena::block_size(NumaInterleavedArena::MAX_BLOCK_SIZE));
+    EXPECT_EQ(NumaInterleavedArena::MAX_BLOCK_SIZE + 4096,
+              NumaInterleavedArena::block_size(NumaInterleavedArena::MAX_BLOCK_SIZE + 1));
+    EXPECT_EQ(0, NumaInterleavedArena::_size_class(4096));
+    EXPECT_EQ(1, NumaInterleavedArena::_size_class(5120));
+    EXPECT_EQ(NumaInterleavedArena::NUM_SIZE_CLASSES - 1,
+              NumaInterleavedArena::_size_class(NumaInterleavedArena::MAX_BLOCK_SIZE));
+
+    NumaInterleavedArena arena;
+    char* first = static_cast<char*>(arena.alloc(60 << 10));
+    char* second = static_cast<char*>(arena.alloc(60 << 10));
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    // one chunk is mapped for both, after its header
+    EXPECT_EQ(NumaInterleavedArena::CHUNK_SIZE, arena.mapped_bytes());
+    EXPECT_EQ(4096, reinterpret_cast<uintptr_t>(first) % NumaInterleavedArena::CHUNK_SIZE);
+    EXPECT_EQ(first + (64 << 10), second);
+    memset(first, 1, 60 << 10);
+
+    // a freed block is reused by the next allocation of its size class, its pages are given back
+    arena.free(first, 60 << 10);
+    EXPECT_EQ(first, arena.alloc(57 << 10));
+    EXPECT_EQ(0, first[0]);
+    EXPECT_NE(first, arena.alloc(60 << 10));
+
+    // a large allocation is mapped on its own
+    size_t large = NumaInterleavedArena::MAX_BLOCK_SIZE + 1;
+    void* buf = arena.alloc(large);
+    ASSERT_NE(nullptr, buf);
+    EXPECT_EQ(NumaInterleavedArena::CHUNK_SIZE + NumaInterleavedArena::block_size(large),
+              arena.mapped_bytes());
+    arena.free(buf, large);
+    EXPECT_EQ(NumaInterleavedArena::CHUNK_SIZE, arena.mapped_bytes());
+}
+
+TEST_F(NumaUtilTest, InterleavedArenaReleaseChunks) {
+    constexpr size_t block = NumaInterleavedArena::MAX_BLOCK_SIZE;
+    NumaInterleavedArena arena;
+    std::vector<void*> blocks;
+    while (arena.mapped_bytes() <= NumaInterleavedArena::CHUNK_SIZE) {
+        blocks.push_back(arena.alloc(block));
+        ASSERT_NE(nullptr, blocks.back());
+    }
+    // the header of the chunk leaves room for one block less
+    EXPECT_EQ(NumaInterleavedArena::CHUNK_SIZE / block, blocks.size());
+    void* last = blocks.back();
+    blocks.pop_back();
+
+    // the first chunk is unmapped once all its blocks are freed
+    for (void* buf : blocks) {
+        arena.free(buf, block);
+    }
+    EXPECT_EQ(NumaInterleavedArena::CHUNK_SIZE, arena.mapped_bytes());
+    // the chunk blocks are still carved from is kept, and so are its freed blocks
+    arena.free(last, block);
+    EXPECT_EQ(NumaInterleavedArena::CHUNK_SIZE, arena.mapped_bytes());
+    EXPECT_EQ(last, arena.alloc(block));
+    arena.free(last, block);
+}
+
+} // namespace doris
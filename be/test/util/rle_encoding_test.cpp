@@ -418,4 +418,34 @@ TEST_F(TestRle, TestSkip) {
     encoder.Flush();
 }
 
+// Reads the levels of literal and repeated runs in batches that do not end at byte boundaries.
+TEST_F(TestRle, TestGetValues) {
+    std::vector<int16_t> values;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 300 < 100) {
+            values.push_back(1);
+        } else {
+            values.push_back((i * 7) % 3);
+        }
+    }
+    faststring buffer;
+    RleEncoder<int16_t> encoder(&buffer, 2);
+    for (auto value : values) {
+        encoder.Put(value);
+    }
+    int encoded_len = encoder.Flush();
+
+    for (size_t batch : {1, 7, 13, 64, 1000}) {
+        RleDecoder<int16_t> decoder(buffer.data(), encoded_len, 2);
+        std::vector<int16_t> decoded(values.size());
+        size_t num_read = 0;
+        while (num_read < values.size()) {
+            size_t n = std::min(batch, values.size() - num_read);
+            EXPECT_EQ(n, decoder.get_values(&decoded[num_read], n));
+            num_read += n;
+        }
+        EXPECT_EQ(values, decoded);
+    }
+}
+
 } // namespace doris
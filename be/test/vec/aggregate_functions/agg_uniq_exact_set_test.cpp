@@ -0,0 +1,140 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/uniq_exact_set.h"
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest_pred_impl.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/common/uint128.h"
+
+namespace doris::vectorized {
+
+using Int64Set = UniqExactSet<Int64, HashCRC32<Int64>>;
+
+template <typename Set>
+static void write_and_read(const Set& set, Set* out) {
+    auto column = ColumnString::create();
+    BufferWritable writer(*column);
+    set.write(writer);
+    writer.commit();
+    BufferReadable reader(column->get_data_at(0));
+    out->read_and_merge(reader);
+}
+
+TEST(UniqExactSetTest, TwoLevelAndMerge) {
+    std::mt19937_64 rng(7);
+    std::set<Int64> expected;
+    Int64Set small;
+    Int64Set large;
+    for (int i = 0; i < 1000; ++i) {
+        Int64 key = static_cast<Int64>(rng() % 100000) - 50000;
+        small.insert(key);
+        expected.insert(key);
+    }
+    for (size_t i = 0; i < Int64Set::TWO_LEVEL_THRESHOLD * 2; ++i) {
+        Int64 key = static_cast<Int64>(rng() % 1000000) - 500000;
+        large.insert(key);
+        expected.insert(key);
+    }
+    EXPECT_FALSE(small.is_two_level());
+    EXPECT_TRUE(large.is_two_level());
+
+    Int64Set merged;
+    merged.merge(small);
+    EXPECT_FALSE(merged.is_two_level());
+    merged.merge(large);
+    EXPECT_TRUE(merged.is_two_level());
+    EXPECT_EQ(expected.size(), merged.size());
+
+    std::set<Int64> elements;
+    merged.for_each([&](Int64 key) { elements.insert(key); });
+    EXPECT_EQ(expected, elements);
+}
+
+TEST(UniqExactSetTest, InsertBatch) {
+    // A large batch of a few distinct keys does not make the set two level.
+    std::vector<Int64> keys(Int64Set::TWO_LEVEL_THRESHOLD * 2);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = i % 100;
+    }
+    Int64Set set;
+    set.insert(keys.data(), keys.size());
+    EXPECT_FALSE(set.is_two_level());
+    EXPECT_EQ(100, set.size());
+
+    // Distinct keys are reserved for at once.
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = i;
+    }
+    Int64Set distinct;
+    distinct.insert_distinct(keys.data(), keys.size());
+    EXPECT_TRUE(distinct.is_two_level());
+    EXPECT_EQ(keys.size(), distinct.size());
+}
+
+TEST(UniqExactSetTest, SerializeRoundTrip) {
+    Int64Set set;
+    for (Int64 key : {std::numeric_limits<Int64>::min(), Int64(-1), Int64(0), Int64(1),
+                      std::numeric_limits<Int64>::max()}) {
+        set.insert(key);
+    }
+    for (Int64 key = 1000; key < 101000; ++key) {
+        set.insert(key);
+    }
+    Int64Set read;
+    write_and_read(set, &read);
+    EXPECT_EQ(set.size(), read.size());
+    set.for_each([&](Int64 key) {
+        Int64Set one;
+        one.insert(key);
+        read.merge(one);
+    });
+    EXPECT_EQ(set.size(), read.size());
+
+    UniqExactSet<UInt128, UInt128TrivialHash> string_set;
+    string_set.insert(UInt128(1, 2));
+    string_set.insert(UInt128(3, 4));
+    UniqExactSet<UInt128, UInt128TrivialHash> string_read;
+    write_and_read(string_set, &string_read);
+    string_read.insert(UInt128(3, 4));
+    EXPECT_EQ(2, string_read.size());
+}
+
+TEST(UniqExactSetTest, HeapCounter) {
+    int64_t heap_bytes = 0;
+    {
+        AggregateStateHeapCounter::Scope scope(&heap_bytes);
+        Int64Set set;
+        for (Int64 key = 0; key < 10000; ++key) {
+            set.insert(key);
+        }
+        EXPECT_GE(heap_bytes, 10000 * sizeof(Int64));
+    }
+    // Freed within the scope.
+    EXPECT_EQ(0, heap_bytes);
+}
+
+} // namespace doris::vectorized
@@ -20,8 +20,12 @@
 #include <gtest/gtest-test-part.h>
 #include <stddef.h>
 
+#include <algorithm>
 #include <memory>
 #include <ostream>
+#include <random>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest_pred_impl.h"
 #include "vec/aggregate_functions/aggregate_function.h"
@@ -427,4 +431,131 @@ TEST_F(VWindowFunnelTest, testMax4ReverseSortedMerge) {
     }
 }
 
+TEST_F(VWindowFunnelTest, testStreamingMatchesBuffered) {
+    // Every mode evaluated on the same events arriving in order, shuffled, or split over two
+    // states that are merged, must give the same result.
+    const int NUM_ROWS = 64;
+    std::mt19937 rng(42);
+    agg_function->set_version(3);
+    for (const std::string mode : {"default", "deduplication", "fixed", "increase"}) {
+        for (int round = 0; round < 50; round++) {
+            auto column_mode = ColumnString::create();
+            auto column_window = ColumnVector<Int64>::create();
+            auto column_timestamp = ColumnVector<Int64>::create();
+            std::vector<ColumnVector<UInt8>::MutablePtr> column_events;
+            for (int level = 0; level < 4; level++) {
+                column_events.push_back(ColumnVector<UInt8>::create());
+            }
+            int second = 0;
+            for (int i = 0; i < NUM_ROWS; i++) {
+                column_mode->insert_data(mode.data(), mode.size());
+                column_window->insert(round % 10);
+                second += 1 + rng() % 3;
+                VecDateTimeValue time_value;
+                time_value.set_time(2022, 2, 28, 0, second / 60, second % 60);
+                column_timestamp->insert_data((char*)&time_value, 0);
+                for (int level = 0; level < 4; level++) {
+                    column_events[level]->insert(rng() % 4 == 0 ? 1 : 0);
+                }
+            }
+            const IColumn* column[7] = {column_window.get(),    column_mode.get(),
+                                        column_timestamp.get(), column_events[0].get(),
+                                        column_events[1].get(), column_events[2].get(),
+                                        column_events[3].get()};
+
+            std::vector<int> rows(NUM_ROWS);
+            for (int i = 0; i < NUM_ROWS; i++) {
+                rows[i] = i;
+            }
+            auto evaluate = [&](const std::vector<int>& order, int split) {
+                std::unique_ptr<char[]> memory(new char[agg_function->size_of_data()]);
+                std::unique_ptr<char[]> memory2(new char[agg_function->size_of_data()]);
+                AggregateDataPtr place = memory.get();
+                AggregateDataPtr place2 = memory2.get();
+                agg_function->create(place);
+                agg_function->create(place2);
+                for (int i = 0; i < order.size(); i++) {
+                    agg_function->add(i < split ? place : place2, column, order[i], nullptr);
+                }
+                agg_function->merge(place, place2, nullptr);
+                ColumnVector<Int32> column_result;
+                agg_function->insert_result_into(place, column_result);
+                agg_function->destroy(place);
+                agg_function->destroy(place2);
+                return column_result.get_data()[0];
+            };
+
+            int expected = evaluate(rows, NUM_ROWS);
+            std::vector<int> shuffled = rows;
+            std::shuffle(shuffled.begin(), shuffled.end(), rng);
+            EXPECT_EQ(expected, evaluate(shuffled, NUM_ROWS)) << mode;
+
+            // Interleave the rows of both states, each of them still in order.
+            std::vector<int> odd_even;
+            for (int i = 0; i < NUM_ROWS; i += 2) {
+                odd_even.push_back(i);
+            }
+            for (int i = 1; i < NUM_ROWS; i += 2) {
+                odd_even.push_back(i);
+            }
+            EXPECT_EQ(expected, evaluate(odd_even, NUM_ROWS / 2)) << mode;
+            EXPECT_EQ(expected, evaluate(rows, rng() % NUM_ROWS)) << mode;
+        }
+    }
+}
+
+TEST_F(VWindowFunnelTest, testCompleteFunnelMerge) {
+    // A complete funnel only stays complete in default mode when earlier events are merged in.
+    agg_function->set_version(3);
+    auto evaluate = [&](const std::string& mode,
+                        const std::vector<std::pair<int, int>>& merged_events) {
+        auto add = [&](AggregateDataPtr place, const std::vector<std::pair<int, int>>& events) {
+            for (const auto& [second, level] : events) {
+                auto column_mode = ColumnString::create();
+                auto column_window = ColumnVector<Int64>::create();
+                auto column_timestamp = ColumnVector<Int64>::create();
+                std::vector<ColumnVector<UInt8>::MutablePtr> column_events;
+                column_mode->insert_data(mode.data(), mode.size());
+                column_window->insert(3);
+                VecDateTimeValue time_value;
+                time_value.set_time(2022, 2, 28, 0, 0, second);
+                column_timestamp->insert_data((char*)&time_value, 0);
+                for (int i = 0; i < 4; i++) {
+                    column_events.push_back(ColumnVector<UInt8>::create());
+                    column_events[i]->insert(i == level ? 1 : 0);
+                }
+                const IColumn* column[7] = {column_window.get(),    column_mode.get(),
+                                            column_timestamp.get(), column_events[0].get(),
+                                            column_events[1].get(), column_events[2].get(),
+                                            column_events[3].get()};
+                agg_function->add(place, column, 0, nullptr);
+            }
+        };
+        std::unique_ptr<char[]> memory(new char[agg_function->size_of_data()]);
+        std::unique_ptr<char[]> memory2(new char[agg_function->size_of_data()]);
+        AggregateDataPtr place = memory.get();
+        AggregateDataPtr place2 = memory2.get();
+        agg_function->create(place);
+        agg_function->create(place2);
+        add(place, {{10, 0}, {11, 1}, {12, 2}, {13, 3}});
+        add(place2, merged_events);
+        agg_function->merge(place, place2, nullptr);
+        ColumnVector<Int32> column_result;
+        agg_function->insert_result_into(place, column_result);
+        agg_function->destroy(place);
+        agg_function->destroy(place2);
+        return column_result.get_data()[0];
+    };
+
+    // the second event 1 stops the funnel at the repeated level
+    EXPECT_EQ(4, evaluate("default", {{10, 1}}));
+    EXPECT_EQ(2, evaluate("deduplication", {{10, 1}}));
+    // the event 2 right after the event 0 skips level 1
+    EXPECT_EQ(4, evaluate("default", {{10, 2}}));
+    EXPECT_EQ(1, evaluate("fixed", {{10, 2}}));
+    // level 1 keeps the chain started at second 1, which is out of the window at second 12
+    EXPECT_EQ(4, evaluate("default", {{1, 0}, {2, 1}}));
+    EXPECT_EQ(2, evaluate("increase", {{1, 0}, {2, 1}}));
+}
+
 } // namespace doris::vectorized
@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest_pred_impl.h"
+#include "util/simd/bits.h"
+#include "vec/exec/format/csv/csv_reader.h"
+
+namespace doris::vectorized {
+
+static std::vector<std::string> split(const std::string& line, char sep) {
+    std::vector<std::string> values;
+    size_t start = 0;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == sep) {
+            values.push_back(line.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    values.push_back(line.substr(start));
+    return values;
+}
+
+TEST(CsvFieldSplitterTest, Bytes64EqMask) {
+    std::string data(64, 'a');
+    data[0] = ',';
+    data[17] = ',';
+    data[63] = ',';
+    EXPECT_EQ((1ULL << 0) | (1ULL << 17) | (1ULL << 63), simd::bytes64_eq_mask(data.data(), ','));
+    EXPECT_EQ(0, simd::bytes64_eq_mask(data.data(), '|'));
+}
+
+TEST(CsvFieldSplitterTest, PlainSingleChar) {
+    PlainCsvTextFieldSplitter splitter(false, false, ",", 1, -1);
+    // Separators before, at and after the 64 bytes boundaries, and empty fields.
+    std::vector<std::string> lines = {"",
+                                      "a",
+                                      ",",
+                                      std::string(63, 'x') + "," + std::string(64, 'y'),
+                                      std::string(64, 'x') + ",," + std::string(70, 'y') + ",",
+                                      std::string(200, ',')};
+    std::string mixed;
+    for (int i = 0; i < 300; ++i) {
+        mixed += std::to_string(i * 7) + (i % 5 == 0 ? ",," : ",");
+    }
+    lines.push_back(mixed);
+
+    for (const auto& line : lines) {
+        std::vector<Slice> values;
+        splitter.split_line(Slice(line.data(), line.size()), &values);
+        auto expected = split(line, ',');
+        ASSERT_EQ(expected.size(), values.size()) << line;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(expected[i], values[i].to_string());
+        }
+    }
+}
+
+TEST(CsvFieldSplitterTest, PlainTrimTailingSpace) {
+    PlainCsvTextFieldSplitter splitter(true, false, "|", 1, -1);
+    std::string line = std::string(70, 'x') + "  |b |" + std::string(64, ' ');
+    std::vector<Slice> values;
+    splitter.split_line(Slice(line.data(), line.size()), &values);
+    ASSERT_EQ(3, values.size());
+    EXPECT_EQ(std::string(70, 'x'), values[0].to_string());
+    EXPECT_EQ("b", values[1].to_string());
+    EXPECT_EQ("", values[2].to_string());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,93 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/format/table/iceberg_delete_file_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace doris::vectorized {
+
+TEST(IcebergDeleteFileCacheTest, GetOrLoad) {
+    IcebergDeleteFileCache cache(1024 * 1024, 1);
+    int loads = 0;
+    IcebergDeleteFileCache::Loader<std::vector<int64_t>> loader =
+            [&](std::shared_ptr<std::vector<int64_t>>* value, size_t* charge) {
+                ++loads;
+                *value = std::make_shared<std::vector<int64_t>>(std::vector<int64_t> {1, 3, 5});
+                *charge = 3 * sizeof(int64_t);
+                return Status::OK();
+            };
+
+    std::shared_ptr<const std::vector<int64_t>> value;
+    bool hit = true;
+    EXPECT_TRUE(cache.get_or_load("a", loader, &value, &hit).ok());
+    EXPECT_FALSE(hit);
+    EXPECT_EQ((std::vector<int64_t> {1, 3, 5}), *value);
+
+    std::shared_ptr<const std::vector<int64_t>> cached;
+    EXPECT_TRUE(cache.get_or_load("a", loader, &cached, &hit).ok());
+    EXPECT_TRUE(hit);
+    EXPECT_EQ(value.get(), cached.get());
+    EXPECT_EQ(1, loads);
+
+    // the failed loads are not cached
+    IcebergDeleteFileCache::Loader<std::vector<int64_t>> failed_loader =
+            [&](std::shared_ptr<std::vector<int64_t>>* value, size_t* charge) {
+                ++loads;
+                return Status::IOError("failed to read delete file");
+            };
+    EXPECT_FALSE(cache.get_or_load("b", failed_loader, &value, &hit).ok());
+    EXPECT_FALSE(cache.get_or_load("b", failed_loader, &value, &hit).ok());
+    EXPECT_EQ(3, loads);
+}
+
+TEST(IcebergDeleteFileCacheTest, LoadOnce) {
+    IcebergDeleteFileCache cache(1024 * 1024, 1);
+    std::atomic<int> loads = 0;
+    IcebergDeleteFileCache::Loader<int64_t> loader = [&](std::shared_ptr<int64_t>* value,
+                                                         size_t* charge) {
+        ++loads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        *value = std::make_shared<int64_t>(42);
+        *charge = sizeof(int64_t);
+        return Status::OK();
+    };
+
+    std::vector<std::thread> threads;
+    std::atomic<int> hits = 0;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&]() {
+            std::shared_ptr<const int64_t> value;
+            bool hit = false;
+            EXPECT_TRUE(cache.get_or_load("delete_file", loader, &value, &hit).ok());
+            EXPECT_EQ(42, *value);
+            hits += hit;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(1, loads);
+    EXPECT_EQ(7, hits);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,250 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <cctz/time_zone.h>
+#include <fmt/format.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gtest/gtest.h>
+#include <parquet/arrow/writer.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "exec/olap_common.h"
+#include "runtime/runtime_state.h"
+#include "util/runtime_profile.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/exec/format/parquet/vparquet_reader.h"
+#include "vec/exec/format/table/iceberg_reader.h"
+
+namespace doris::vectorized {
+
+static const std::string kTestDir = "./ut_dir/iceberg_equality_delete_test";
+
+// The data file is written with the fields id (1) and name (2), the field region (3) is added to
+// the table after the data file was written.
+class IcebergEqualityDeleteTest : public testing::Test {
+protected:
+    void SetUp() override {
+        std::filesystem::remove_all(kTestDir);
+        std::filesystem::create_directories(kTestDir);
+        _state.init_mem_trackers();
+        _data_path = kTestDir + "/data.parquet";
+        write_parquet(_data_path, {{1, "id"}, {2, "name"}},
+                      {int_array({1, 2, 3, std::nullopt, 5}),
+                       string_array({"a", "b", std::nullopt, "d", "e"})});
+    }
+
+    void TearDown() override { std::filesystem::remove_all(kTestDir); }
+
+    static std::shared_ptr<arrow::Array> int_array(const std::vector<std::optional<int>>& values) {
+        arrow::Int32Builder builder;
+        for (const auto& value : values) {
+            EXPECT_TRUE(value.has_value() ? builder.Append(*value).ok()
+                                          : builder.AppendNull().ok());
+        }
+        std::shared_ptr<arrow::Array> array;
+        EXPECT_TRUE(builder.Finish(&array).ok());
+        return array;
+    }
+
+    static std::shared_ptr<arrow::Array> string_array(
+            const std::vector<std::optional<std::string>>& values) {
+        arrow::StringBuilder builder;
+        for (const auto& value : values) {
+            EXPECT_TRUE(value.has_value() ? builder.Append(*value).ok()
+                                          : builder.AppendNull().ok());
+        }
+        std::shared_ptr<arrow::Array> array;
+        EXPECT_TRUE(builder.Finish(&array).ok());
+        return array;
+    }
+
+    // Writes a parquet file with the iceberg schema of the fields in its key value metadata.
+    static void write_parquet(const std::string& path,
+                              const std::vector<std::pair<int, std::string>>& fields,
+                              const std::vector<std::shared_ptr<arrow::Array>>& columns) {
+        std::string iceberg_schema = R"({"type":"struct","schema-id":0,"fields":[)";
+        arrow::FieldVector arrow_fields;
+        for (size_t i = 0; i < fields.size(); ++i) {
+            const auto& [id, name] = fields[i];
+            iceberg_schema += fmt::format(R"({}{{"id":{},"name":"{}","required":false}})",
+                                          i == 0 ? "" : ",", id, name);
+            arrow_fields.emplace_back(arrow::field(name, columns[i]->type()));
+        }
+        iceberg_schema += "]}";
+        auto metadata = arrow::key_value_metadata({"iceberg.schema"}, {iceberg_schema});
+        auto schema = arrow::schema(arrow_fields, metadata);
+        auto table = arrow::Table::Make(schema, columns);
+        auto file = arrow::io::FileOutputStream::Open(path);
+        ASSERT_TRUE(file.ok());
+        ASSERT_TRUE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), *file, 1024)
+                            .ok());
+        ASSERT_TRUE((*file)->Close().ok());
+    }
+
+    static TIcebergDeleteFileDesc equality_delete_file(const std::string& path,
+                                                       const std::vector<int>& field_ids) {
+        TIcebergDeleteFileDesc delete_file;
+        delete_file.__set_path(path);
+        delete_file.__set_field_ids(field_ids);
+        return delete_file;
+    }
+
+    // Reads the columns id and region of the data file with the delete files, returns the ids of
+    // the rows left, -1 for null. The region column is null in the data file.
+    void read(const std::vector<TIcebergDeleteFileDesc>& delete_files, std::vector<int>* ids) {
+        TFileScanRangeParams params;
+        params.__set_file_type(TFileType::FILE_LOCAL);
+        TFileRangeDesc range;
+        range.__set_path(_data_path);
+        range.__set_start_offset(0);
+        range.__set_size(std::filesystem::file_size(_data_path));
+        TIcebergFileDesc iceberg_params;
+        iceberg_params.__set_format_version(2);
+        iceberg_params.__set_content(2);
+        iceberg_params.__set_delete_files(delete_files);
+        TTableFormatFileDesc table_format_params;
+        table_format_params.__set_table_format_type("iceberg");
+        table_format_params.__set_iceberg_params(iceberg_params);
+        range.__set_table_format_params(table_format_params);
+
+        auto* ctz = const_cast<cctz::time_zone*>(&_state.timezone_obj());
+        auto parquet_reader =
+                ParquetReader::create_unique(&_profile, params, range, 1024, ctz, nullptr, &_state);
+        ASSERT_TRUE(parquet_reader->open().ok());
+        IcebergTableReader reader(std::move(parquet_reader), &_profile, &_state, params, range,
+                                  nullptr, -1);
+        std::vector<std::string> col_names {"id", "region"};
+        std::unordered_map<int, std::string> col_id_name_map {
+                {1, "id"}, {2, "name"}, {3, "region"}};
+        std::unordered_map<std::string, ColumnValueRangeType> colname_to_value_range;
+        Status st = reader.init_reader(col_names, col_id_name_map, &colname_to_value_range, {},
+                                       nullptr, nullptr, nullptr, nullptr, nullptr);
+        ASSERT_TRUE(st.ok()) << st.to_string();
+        ASSERT_TRUE(reader.init_row_filters(range).ok());
+        std::unordered_map<std::string, std::tuple<std::string, const SlotDescriptor*>>
+                partition_columns;
+        std::unordered_map<std::string, VExprContextSPtr> missing_columns {{"region", nullptr}};
+        ASSERT_TRUE(reader.set_fill_columns(partition_columns, missing_columns).ok());
+
+        auto id_type = make_nullable(std::make_shared<DataTypeInt32>());
+        auto region_type = make_nullable(std::make_shared<DataTypeString>());
+        bool eof = false;
+        while (!eof) {
+            Block block;
+            block.insert(ColumnWithTypeAndName(id_type->create_column(), id_type, "id"));
+            block.insert(
+                    ColumnWithTypeAndName(region_type->create_column(), region_type, "region"));
+            size_t read_rows = 0;
+            st = reader.get_next_block(&block, &read_rows, &eof);
+            ASSERT_TRUE(st.ok()) << st.to_string();
+            // the equality columns not required are removed from the block
+            ASSERT_EQ(2, block.columns());
+            ASSERT_EQ(read_rows, block.rows());
+            const auto& id_column =
+                    assert_cast<const ColumnNullable&>(*block.get_by_name("id").column);
+            const auto& region_column = *block.get_by_name("region").column;
+            for (size_t i = 0; i < read_rows; ++i) {
+                EXPECT_TRUE(region_column.is_null_at(i));
+                ids->emplace_back(id_column.is_null_at(i)
+                                          ? -1
+                                          : id_column.get_nested_column().get_int(i));
+            }
+        }
+    }
+
+    RuntimeState _state {TQueryGlobals()};
+    RuntimeProfile _profile {"test"};
+    std::string _data_path;
+};
+
+TEST_F(IcebergEqualityDeleteTest, no_delete_files) {
+    std::vector<int> ids;
+    read({}, &ids);
+    EXPECT_EQ((std::vector<int> {1, 2, 3, -1, 5}), ids);
+}
+
+TEST_F(IcebergEqualityDeleteTest, anti_probe) {
+    // name is not read by the query, it is read for the delete file and removed after
+    std::string delete_path = kTestDir + "/delete_id_name.parquet";
+    write_parquet(delete_path, {{1, "id"}, {2, "name"}},
+                  {int_array({2, 5, 7}), string_array({"b", "x", "a"})});
+    std::vector<int> ids;
+    read({equality_delete_file(delete_path, {1, 2})}, &ids);
+    // (5, "x") and (7, "a") are not equal to any row on both columns
+    EXPECT_EQ((std::vector<int> {1, 3, -1, 5}), ids);
+}
+
+TEST_F(IcebergEqualityDeleteTest, null_equals_null) {
+    std::string delete_id_name = kTestDir + "/delete_id_name.parquet";
+    write_parquet(delete_id_name, {{1, "id"}, {2, "name"}},
+                  {int_array({3}), string_array({std::nullopt})});
+    std::string delete_id = kTestDir + "/delete_id.parquet";
+    write_parquet(delete_id, {{1, "id"}}, {int_array({std::nullopt})});
+    std::vector<int> ids;
+    read({equality_delete_file(delete_id_name, {1, 2}), equality_delete_file(delete_id, {1})},
+         &ids);
+    EXPECT_EQ((std::vector<int> {1, 2, 5}), ids);
+}
+
+TEST_F(IcebergEqualityDeleteTest, merged_delete_files) {
+    // the files of the same equality columns are probed as one set
+    std::string delete_1 = kTestDir + "/delete_id_1.parquet";
+    write_parquet(delete_1, {{1, "id"}}, {int_array({1, 2, 9})});
+    std::string delete_2 = kTestDir + "/delete_id_2.parquet";
+    write_parquet(delete_2, {{1, "id"}}, {int_array({2, 5, 8})});
+    std::vector<int> ids;
+    read({equality_delete_file(delete_1, {1}), equality_delete_file(delete_2, {1})}, &ids);
+    EXPECT_EQ((std::vector<int> {3, -1}), ids);
+    // only the deleted rows of the data file are counted
+    EXPECT_EQ(3, _profile.get_counter("NumDeleteRows")->value());
+    EXPECT_EQ(3, _profile.get_counter("NumEqualityDeletedRows")->value());
+}
+
+TEST_F(IcebergEqualityDeleteTest, column_added_later) {
+    // region is null in the data file, only the deleted rows with a null region match
+    std::string delete_path = kTestDir + "/delete_id_region.parquet";
+    write_parquet(delete_path, {{1, "id"}, {3, "region"}},
+                  {int_array({1, 5}), string_array({std::nullopt, "r1"})});
+    std::vector<int> ids;
+    read({equality_delete_file(delete_path, {1, 3})}, &ids);
+    EXPECT_EQ((std::vector<int> {2, 3, -1, 5}), ids);
+
+    std::string delete_region = kTestDir + "/delete_region.parquet";
+    write_parquet(delete_region, {{3, "region"}}, {string_array({std::nullopt})});
+    ids.clear();
+    read({equality_delete_file(delete_region, {3})}, &ids);
+    EXPECT_TRUE(ids.empty());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,100 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/format/parquet/parquet_bloom_filter.h"
+
+#include <gen_cpp/parquet_types.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "exec/olap_common.h"
+#include "vec/exec/format/parquet/parquet_pred_cmp.h"
+#include "vec/exec/format/parquet/schema_desc.h"
+
+namespace doris::vectorized {
+
+TEST(ParquetBloomFilterTest, PlainValues) {
+    // XXH64 of an empty input with seed 0
+    EXPECT_EQ(0xEF46DB3751D8E999ULL, ParquetBloomFilter::hash_plain_value(""));
+
+    ParquetBloomFilter bloom_filter;
+    ASSERT_TRUE(bloom_filter.init(1024).ok());
+    for (int32_t i = 0; i < 100; ++i) {
+        bloom_filter.add_plain_value(
+                std::string(reinterpret_cast<const char*>(&i), sizeof(i)));
+    }
+    for (int32_t i = 0; i < 100; ++i) {
+        EXPECT_TRUE(bloom_filter.test_plain_value(
+                std::string(reinterpret_cast<const char*>(&i), sizeof(i))));
+    }
+    int false_positives = 0;
+    for (int32_t i = 100; i < 1100; ++i) {
+        false_positives += bloom_filter.test_plain_value(
+                std::string(reinterpret_cast<const char*>(&i), sizeof(i)));
+    }
+    EXPECT_LT(false_positives, 50);
+
+    // the block of a hash is picked by the high 32 bits scaled to the number of blocks
+    ParquetBloomFilter last_block;
+    ASSERT_TRUE(last_block.init(64).ok());
+    last_block.add_hash(0xFFFFFFFF00000001ULL);
+    const uint32_t* bitset = reinterpret_cast<const uint32_t*>(last_block.data());
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(0U, bitset[i]);
+        EXPECT_NE(0U, bitset[8 + i]);
+    }
+}
+
+TEST(ParquetBloomFilterTest, PlainEncodedValues) {
+    FieldSchema int_schema;
+    int_schema.physical_type = tparquet::Type::INT32;
+    int_schema.type = TypeDescriptor(TYPE_SMALLINT);
+    ColumnValueRange<TYPE_SMALLINT> int_range("c", false, 0, 0);
+    ASSERT_TRUE(int_range.add_fixed_value(3).ok());
+    ASSERT_TRUE(int_range.add_fixed_value(-1).ok());
+    std::vector<std::string> values;
+    ASSERT_TRUE(ParquetPredicate::get_plain_encoded_values(int_range, &int_schema, &values));
+    ASSERT_EQ(2, values.size());
+    int32_t value = -1;
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(&value), sizeof(value)), values[0]);
+    value = 3;
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(&value), sizeof(value)), values[1]);
+
+    // a range is not a set of values
+    ColumnValueRange<TYPE_SMALLINT> range("c", false, 0, 0);
+    values.clear();
+    EXPECT_FALSE(ParquetPredicate::get_plain_encoded_values(range, &int_schema, &values));
+
+    // the values of a converted column are not their plain encoding
+    FieldSchema date_schema;
+    date_schema.physical_type = tparquet::Type::INT32;
+    date_schema.type = TypeDescriptor(TYPE_DATEV2);
+    EXPECT_FALSE(ParquetPredicate::get_plain_encoded_values(int_range, &date_schema, &values));
+
+    FieldSchema string_schema;
+    string_schema.physical_type = tparquet::Type::BYTE_ARRAY;
+    string_schema.type = TypeDescriptor(TYPE_STRING);
+    ColumnValueRange<TYPE_STRING> string_range("c", false, 0, 0);
+    ASSERT_TRUE(string_range.add_fixed_value(StringRef("doris")).ok());
+    values.clear();
+    ASSERT_TRUE(ParquetPredicate::get_plain_encoded_values(string_range, &string_schema, &values));
+    EXPECT_EQ(std::vector<std::string> {"doris"}, values);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,228 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <cctz/time_zone.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gen_cpp/parquet_types.h>
+#include <gtest/gtest.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "exec/olap_common.h"
+#include "runtime/runtime_state.h"
+#include "util/runtime_profile.h"
+#include "vec/exec/format/parquet/parquet_pred_cmp.h"
+#include "vec/exec/format/parquet/schema_desc.h"
+#include "vec/exec/format/parquet/vparquet_reader.h"
+
+namespace doris::vectorized {
+
+static const std::string kTestDir = "./ut_dir/parquet_dict_filter_test";
+
+// The file has the dictionary encoded columns id (INT32), small (INT16 stored as INT32) and
+// name (BYTE_ARRAY), which take 10 distinct values, and the column unique (INT64) with too many
+// distinct values for the dictionary page limit, whose data pages fall back to PLAIN.
+class ParquetDictFilterTest : public testing::Test {
+protected:
+    void SetUp() override {
+        std::filesystem::remove_all(kTestDir);
+        std::filesystem::create_directories(kTestDir);
+        _state.init_mem_trackers();
+    }
+
+    void TearDown() override { std::filesystem::remove_all(kTestDir); }
+
+    static std::string write_parquet(parquet::Compression::type compression) {
+        arrow::Int32Builder id_builder;
+        arrow::Int16Builder small_builder;
+        arrow::StringBuilder name_builder;
+        arrow::Int64Builder unique_builder;
+        for (int i = 0; i < 10000; ++i) {
+            EXPECT_TRUE(id_builder.Append(i % 10).ok());
+            EXPECT_TRUE(small_builder.Append(static_cast<int16_t>(i % 10 - 5)).ok());
+            EXPECT_TRUE(name_builder.Append("v" + std::to_string(i % 10)).ok());
+            EXPECT_TRUE(unique_builder.Append(i * 7).ok());
+        }
+        std::shared_ptr<arrow::Array> id;
+        std::shared_ptr<arrow::Array> small;
+        std::shared_ptr<arrow::Array> name;
+        std::shared_ptr<arrow::Array> unique;
+        EXPECT_TRUE(id_builder.Finish(&id).ok());
+        EXPECT_TRUE(small_builder.Finish(&small).ok());
+        EXPECT_TRUE(name_builder.Finish(&name).ok());
+        EXPECT_TRUE(unique_builder.Finish(&unique).ok());
+        auto schema = arrow::schema({arrow::field("id", arrow::int32()),
+                                     arrow::field("small", arrow::int16()),
+                                     arrow::field("name", arrow::utf8()),
+                                     arrow::field("unique", arrow::int64())});
+        auto table = arrow::Table::Make(schema, {id, small, name, unique});
+        auto properties = parquet::WriterProperties::Builder()
+                                  .compression(compression)
+                                  ->enable_dictionary()
+                                  ->dictionary_pagesize_limit(1024)
+                                  ->build();
+
+        std::string path = kTestDir + "/data_" + std::to_string(compression) + ".parquet";
+        auto file = arrow::io::FileOutputStream::Open(path);
+        EXPECT_TRUE(file.ok());
+        EXPECT_TRUE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), *file,
+                                               table->num_rows(), properties)
+                            .ok());
+        EXPECT_TRUE((*file)->Close().ok());
+        return path;
+    }
+
+    std::unique_ptr<ParquetReader> open(const std::string& path) {
+        _params.__set_file_type(TFileType::FILE_LOCAL);
+        _range.__set_path(path);
+        _range.__set_start_offset(0);
+        _range.__set_size(std::filesystem::file_size(path));
+        auto* ctz = const_cast<cctz::time_zone*>(&_state.timezone_obj());
+        auto reader = ParquetReader::create_unique(&_profile, _params, _range, 1024, ctz, nullptr,
+                                                   &_state);
+        EXPECT_TRUE(reader->open().ok());
+        return reader;
+    }
+
+    static const tparquet::ColumnMetaData& column_meta(const ParquetReader& reader,
+                                                       const std::string& name) {
+        int column_id = reader._file_metadata->schema().get_column(name)->physical_column_index;
+        return reader._t_metadata->row_groups[0].columns[column_id].meta_data;
+    }
+
+    // Whether the dictionary of the column holds any of the plain encoded values.
+    static bool dict_contains_any(ParquetReader& reader, const std::string& name,
+                                  const std::vector<std::string>& values) {
+        bool contains = true;
+        EXPECT_TRUE(reader._dict_contains_any(column_meta(reader, name), values, &contains).ok());
+        return contains;
+    }
+
+    template <typename T>
+    static std::vector<std::string> plain(const std::vector<T>& values) {
+        std::vector<std::string> encoded;
+        for (const auto& value : values) {
+            encoded.emplace_back(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        return encoded;
+    }
+
+    RuntimeState _state {TQueryGlobals()};
+    RuntimeProfile _profile {"test"};
+    TFileScanRangeParams _params;
+    TFileRangeDesc _range;
+};
+
+TEST_F(ParquetDictFilterTest, encoding_stats) {
+    tparquet::ColumnMetaData column_meta;
+    auto page_stats = [](tparquet::PageType::type page_type, tparquet::Encoding::type encoding,
+                         int32_t count) {
+        tparquet::PageEncodingStats stats;
+        stats.page_type = page_type;
+        stats.encoding = encoding;
+        stats.count = count;
+        return stats;
+    };
+    // the dictionary page is PLAIN encoded by the parquet 2.0 writers
+    column_meta.__set_encoding_stats(
+            {page_stats(tparquet::PageType::DICTIONARY_PAGE, tparquet::Encoding::PLAIN, 1),
+             page_stats(tparquet::PageType::DATA_PAGE, tparquet::Encoding::RLE_DICTIONARY, 3)});
+    EXPECT_TRUE(ParquetReader::_is_dictionary_encoded(column_meta));
+    // some data pages fell back to PLAIN
+    column_meta.encoding_stats.push_back(
+            page_stats(tparquet::PageType::DATA_PAGE_V2, tparquet::Encoding::PLAIN, 1));
+    EXPECT_FALSE(ParquetReader::_is_dictionary_encoded(column_meta));
+    column_meta.encoding_stats.back().count = 0;
+    EXPECT_TRUE(ParquetReader::_is_dictionary_encoded(column_meta));
+
+    // Without the encoding stats, RLE and BIT_PACKED are the encodings of the levels.
+    tparquet::ColumnMetaData old_meta;
+    old_meta.encodings = {tparquet::Encoding::PLAIN_DICTIONARY, tparquet::Encoding::RLE,
+                          tparquet::Encoding::BIT_PACKED};
+    EXPECT_TRUE(ParquetReader::_is_dictionary_encoded(old_meta));
+    old_meta.encodings.push_back(tparquet::Encoding::PLAIN);
+    EXPECT_FALSE(ParquetReader::_is_dictionary_encoded(old_meta));
+    old_meta.encodings = {tparquet::Encoding::RLE};
+    EXPECT_FALSE(ParquetReader::_is_dictionary_encoded(old_meta));
+}
+
+TEST_F(ParquetDictFilterTest, fallback_to_plain) {
+    auto reader = open(write_parquet(parquet::Compression::UNCOMPRESSED));
+    EXPECT_TRUE(ParquetReader::_is_dictionary_encoded(column_meta(*reader, "id")));
+    EXPECT_TRUE(ParquetReader::_is_dictionary_encoded(column_meta(*reader, "name")));
+    // the dictionary page only holds the values before the fallback
+    EXPECT_FALSE(ParquetReader::_is_dictionary_encoded(column_meta(*reader, "unique")));
+
+    // the row group is not filtered by a column which is not fully dictionary encoded
+    const auto& row_group = reader->_t_metadata->row_groups[0];
+    int unique_id = reader->_file_metadata->schema().get_column("unique")->physical_column_index;
+    reader->_plain_encoded_values.emplace_back(unique_id, plain(std::vector<int64_t> {69993}));
+    bool filter_group = false;
+    ASSERT_TRUE(reader->_process_dict_filter(row_group, &filter_group).ok());
+    EXPECT_FALSE(filter_group);
+}
+
+TEST_F(ParquetDictFilterTest, dictionary_lookup) {
+    for (auto compression : {parquet::Compression::UNCOMPRESSED, parquet::Compression::SNAPPY}) {
+        auto reader = open(write_parquet(compression));
+        EXPECT_TRUE(dict_contains_any(*reader, "id", plain(std::vector<int32_t> {3})));
+        EXPECT_TRUE(dict_contains_any(*reader, "id", plain(std::vector<int32_t> {42, 9})));
+        EXPECT_FALSE(dict_contains_any(*reader, "id", plain(std::vector<int32_t> {42, -1})));
+        EXPECT_TRUE(dict_contains_any(*reader, "name", {"v7"}));
+        EXPECT_FALSE(dict_contains_any(*reader, "name", {"v", "v10", ""}));
+
+        // the row group holds no id in (10, 11)
+        const auto& row_group = reader->_t_metadata->row_groups[0];
+        int id = reader->_file_metadata->schema().get_column("id")->physical_column_index;
+        reader->_plain_encoded_values.emplace_back(id, plain(std::vector<int32_t> {10, 11}));
+        bool filter_group = false;
+        ASSERT_TRUE(reader->_process_dict_filter(row_group, &filter_group).ok());
+        EXPECT_TRUE(filter_group);
+    }
+}
+
+TEST_F(ParquetDictFilterTest, int32_narrowing) {
+    auto reader = open(write_parquet(parquet::Compression::SNAPPY));
+    const FieldSchema* small_schema = reader->_file_metadata->schema().get_column("small");
+    ASSERT_EQ(tparquet::Type::INT32, small_schema->physical_type);
+    ASSERT_EQ(TYPE_SMALLINT, small_schema->type.type);
+
+    // the SMALLINT values are looked up by their INT32 plain encoding, negative ones included
+    ColumnValueRange<TYPE_SMALLINT> range("small", false, 0, 0);
+    ASSERT_TRUE(range.add_fixed_value(-5).ok());
+    ASSERT_TRUE(range.add_fixed_value(100).ok());
+    std::vector<std::string> values;
+    ASSERT_TRUE(ParquetPredicate::get_plain_encoded_values(range, small_schema, &values));
+    EXPECT_TRUE(dict_contains_any(*reader, "small", values));
+
+    ColumnValueRange<TYPE_SMALLINT> missing_range("small", false, 0, 0);
+    ASSERT_TRUE(missing_range.add_fixed_value(5).ok());
+    ASSERT_TRUE(missing_range.add_fixed_value(-6).ok());
+    values.clear();
+    ASSERT_TRUE(ParquetPredicate::get_plain_encoded_values(missing_range, small_schema, &values));
+    EXPECT_FALSE(dict_contains_any(*reader, "small", values));
+}
+
+} // namespace doris::vectorized
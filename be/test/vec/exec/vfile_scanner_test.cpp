@@ -0,0 +1,209 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/scan/vfile_scanner.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptors.h"
+#include "runtime/runtime_state.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/exec/scan/new_file_scan_node.h"
+
+namespace doris::vectorized {
+
+// Tests the output block of a load whose file columns are moved to it directly. The output
+// tuple has a not nullable INT column c1 and a nullable VARCHAR column c2.
+class VFileScannerDirectOutputTest : public testing::Test {
+public:
+    VFileScannerDirectOutputTest() : _runtime_state(TQueryGlobals()) {
+        _runtime_state.init_mem_trackers();
+        _init_desc_table();
+
+        TPlanNode tnode;
+        tnode.node_id = 0;
+        tnode.node_type = TPlanNodeType::FILE_SCAN_NODE;
+        tnode.num_children = 0;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(0);
+        tnode.nullable_tuples.push_back(false);
+        tnode.file_scan_node.tuple_id = 0;
+        tnode.__isset.file_scan_node = true;
+        _scan_node = std::make_shared<NewFileScanNode>(&_obj_pool, tnode, *_desc_tbl);
+        _scan_node->_output_tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        WARN_IF_ERROR(_scan_node->init(tnode, &_runtime_state), "fail to init scan_node");
+        WARN_IF_ERROR(_scan_node->prepare(&_runtime_state), "fail to prepare scan_node");
+
+        _scan_range.__isset.params = true;
+        _scan_range.params.format_type = TFileFormatType::FORMAT_PARQUET;
+        _scanner = std::make_shared<VFileScanner>(&_runtime_state, _scan_node.get(), -1,
+                                                  _scan_range, &_profile);
+        _scanner->_is_load = true;
+        _scanner->_dest_row_desc.reset(new RowDescriptor(
+                _runtime_state.desc_tbl(), std::vector<TupleId>({0}), std::vector<bool>({false})));
+        _scanner->_direct_output_block_timer = ADD_TIMER(&_profile, "DirectOutputBlockTime");
+        _scanner->_direct_output_rows_counter =
+                ADD_COUNTER(&_profile, "DirectOutputRows", TUnit::UNIT);
+        // the src block has the file columns c2 and c1
+        _scanner->_direct_output_src_idx = {1, 0};
+        _scanner->_direct_output = true;
+        _scanner->_src_block_ptr = &_src_block;
+    }
+
+    void TearDown() override {
+        WARN_IF_ERROR(_scan_node->close(&_runtime_state), "fail to close scan_node");
+    }
+
+protected:
+    void _init_desc_table() {
+        TDescriptorTable t_desc_table;
+        TTableDescriptor t_table_desc;
+        t_table_desc.id = 0;
+        t_table_desc.tableType = TTableType::OLAP_TABLE;
+        t_table_desc.numCols = 0;
+        t_table_desc.numClusteringCols = 0;
+        t_desc_table.tableDescriptors.push_back(t_table_desc);
+        t_desc_table.__isset.tableDescriptors = true;
+
+        auto add_slot = [&](int id, TPrimitiveType::type type, const std::string& name,
+                            bool nullable) {
+            TSlotDescriptor slot_desc;
+            slot_desc.id = id;
+            slot_desc.parent = 0;
+            TTypeNode node;
+            node.__set_type(TTypeNodeType::SCALAR);
+            TScalarType scalar_type;
+            scalar_type.__set_type(type);
+            scalar_type.__set_len(32);
+            node.__set_scalar_type(scalar_type);
+            slot_desc.slotType.types.push_back(node);
+            slot_desc.columnPos = id;
+            slot_desc.byteOffset = 0;
+            slot_desc.nullIndicatorByte = 0;
+            slot_desc.nullIndicatorBit = nullable ? 0 : -1;
+            slot_desc.colName = name;
+            slot_desc.slotIdx = id;
+            slot_desc.isMaterialized = true;
+            t_desc_table.slotDescriptors.push_back(slot_desc);
+        };
+        add_slot(0, TPrimitiveType::INT, "c1", false);
+        add_slot(1, TPrimitiveType::VARCHAR, "c2", true);
+        t_desc_table.__isset.slotDescriptors = true;
+
+        TTupleDescriptor t_tuple_desc;
+        t_tuple_desc.id = 0;
+        t_tuple_desc.byteSize = 16;
+        t_tuple_desc.numNullBytes = 1;
+        t_tuple_desc.tableId = 0;
+        t_tuple_desc.__isset.tableId = true;
+        t_desc_table.tupleDescriptors.push_back(t_tuple_desc);
+
+        static_cast<void>(DescriptorTbl::create(&_obj_pool, t_desc_table, &_desc_tbl));
+        _runtime_state.set_desc_tbl(_desc_tbl);
+    }
+
+    // Fills the src block with the file columns, which are always nullable.
+    void _fill_src_block(const std::vector<int>& c1, const std::vector<bool>& c1_nulls,
+                         const std::vector<std::string>& c2) {
+        auto c1_column = ColumnNullable::create(ColumnInt32::create(), ColumnUInt8::create());
+        for (size_t i = 0; i < c1.size(); ++i) {
+            if (c1_nulls[i]) {
+                c1_column->insert_data(nullptr, 0);
+            } else {
+                c1_column->insert_data(reinterpret_cast<const char*>(&c1[i]), sizeof(int));
+            }
+        }
+        auto c2_column = ColumnNullable::create(ColumnString::create(), ColumnUInt8::create());
+        for (const auto& value : c2) {
+            c2_column->insert_data(value.data(), value.size());
+        }
+        auto c1_type = make_nullable(std::make_shared<DataTypeInt32>());
+        auto c2_type = make_nullable(std::make_shared<DataTypeString>());
+        _src_block.clear();
+        _src_block.insert(ColumnWithTypeAndName(std::move(c2_column), c2_type, "c2"));
+        _src_block.insert(ColumnWithTypeAndName(std::move(c1_column), c1_type, "c1"));
+    }
+
+    static void _check_block(const Block& block, const std::vector<int>& c1,
+                             const std::vector<std::string>& c2) {
+        ASSERT_EQ(2, block.columns());
+        ASSERT_EQ(c1.size(), block.rows());
+        ASSERT_FALSE(block.get_by_position(0).column->is_nullable());
+        ASSERT_TRUE(block.get_by_position(1).column->is_nullable());
+        for (size_t i = 0; i < c1.size(); ++i) {
+            EXPECT_EQ(c1[i], block.get_by_position(0).column->get_int(i));
+            EXPECT_EQ(c2[i], block.get_by_position(1).column->get_data_at(i).to_string());
+        }
+    }
+
+    RuntimeState _runtime_state;
+    RuntimeProfile _profile {"test"};
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::shared_ptr<NewFileScanNode> _scan_node;
+    TFileScanRange _scan_range;
+    std::shared_ptr<VFileScanner> _scanner;
+    Block _src_block;
+};
+
+TEST_F(VFileScannerDirectOutputTest, new_block) {
+    _fill_src_block({1, 2, 3}, {false, false, false}, {"a", "b", "c"});
+    const IColumn* c2_column = _src_block.get_by_position(0).column.get();
+    Block block;
+    ASSERT_TRUE(_scanner->_direct_to_output_block(&block, 3).ok());
+    _check_block(block, {1, 2, 3}, {"a", "b", "c"});
+    // the file column is moved to the output block without a copy
+    EXPECT_EQ(c2_column, block.get_by_position(1).column.get());
+    EXPECT_EQ(0, _src_block.columns());
+    EXPECT_EQ(0, _scanner->_counter.num_rows_filtered);
+}
+
+TEST_F(VFileScannerDirectOutputTest, reused_block) {
+    Block block;
+    _fill_src_block({1, 2}, {false, false}, {"a", "b"});
+    ASSERT_TRUE(_scanner->_direct_to_output_block(&block, 2).ok());
+    _check_block(block, {1, 2}, {"a", "b"});
+
+    // the columns of the reused block are replaced, not appended to
+    block.clear_column_data();
+    ASSERT_TRUE(block.mem_reuse());
+    _fill_src_block({3, 4, 5}, {false, false, false}, {"c", "d", "e"});
+    ASSERT_TRUE(_scanner->_direct_to_output_block(&block, 3).ok());
+    _check_block(block, {3, 4, 5}, {"c", "d", "e"});
+}
+
+TEST_F(VFileScannerDirectOutputTest, null_in_not_nullable_column) {
+    _fill_src_block({1, 0, 3}, {false, true, false}, {"a", "b", "c"});
+    Block block;
+    ASSERT_TRUE(_scanner->_direct_to_output_block(&block, 3).ok());
+    _check_block(block, {1, 3}, {"a", "c"});
+    EXPECT_EQ(1, _scanner->_counter.num_rows_filtered);
+}
+
+} // namespace doris::vectorized
@@ -85,7 +85,6 @@ private:
     std::vector<TFileRangeDesc> _ranges;
     TFileRangeDesc _range_desc;
     TFileScanRange _scan_range;
-    std::unique_ptr<ShardedKVCache> _kv_cache = nullptr;
     std::unique_ptr<TMasterInfo> _master_info = nullptr;
 };
 
@@ -236,7 +235,6 @@ void VWalScannerTest::init() {
     _scan_range.ranges = _ranges;
     _scan_range.__isset.params = true;
     _scan_range.params.format_type = TFileFormatType::FORMAT_WAL;
-    _kv_cache.reset(new ShardedKVCache(48));
 
     _runtime_state._wal_id = _txn_id;
 
@@ -259,7 +257,7 @@ void VWalScannerTest::init() {
 
 void VWalScannerTest::generate_scanner(std::shared_ptr<VFileScanner>& scanner) {
     scanner = std::make_shared<VFileScanner>(&_runtime_state, _scan_node.get(), -1, _scan_range,
-                                             _profile, _kv_cache.get());
+                                             _profile);
     scanner->_is_load = false;
     vectorized::VExprContextSPtrs _conjuncts;
     std::unordered_map<std::string, ColumnValueRangeType> _colname_to_value_range;
@@ -25,11 +25,14 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <new>
+#include <optional>
 #include <type_traits>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "exec/schema_scanner.h"
 #include "gen_cpp/Exprs_types.h"
@@ -39,11 +42,25 @@
 #include "runtime/jsonb_value.h"
 #include "runtime/large_int_value.h"
 #include "runtime/runtime_state.h"
+#include "runtime/types.h"
 #include "testutil/desc_tbl_builder.h"
+#include "vec/columns/column_const.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
 #include "vec/core/field.h"
 #include "vec/core/types.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/exprs/vcase_expr.h"
+#include "vec/exprs/vectorized_fn_call.h"
 #include "vec/exprs/vexpr_context.h"
 #include "vec/exprs/vliteral.h"
+#include "vec/exprs/vshared_expr.h"
+#include "vec/exprs/vslot_ref.h"
+#include "vec/functions/simple_function_factory.h"
 #include "vec/runtime/vdatetime_value.h"
 #include "vec/utils/util.hpp"
 
@@ -562,3 +579,593 @@ TEST(TEST_VEXPR, LITERALTEST) {
         EXPECT_EQ("1234.560000000", literal.value());
     }
 }
+
+namespace doris::vectorized {
+struct SelectiveBranchTestHelper : public VExpr {
+    using VExpr::gather_branches;
+};
+} // namespace doris::vectorized
+
+TEST(TEST_VEXPR, GATHER_BRANCHES) {
+    using namespace doris::vectorized;
+    // Branch 0 evaluated on the rows taking it only, branch 1 on the whole block, branch 2 is
+    // missing (no else).
+    auto compacted = ColumnInt32::create();
+    compacted->insert_value(10);
+    compacted->insert_value(30);
+    auto full = ColumnNullable::create(ColumnInt32::create(4, 7), ColumnUInt8::create(4, 0));
+    assert_cast<ColumnNullable&>(*full).get_null_map_data()[3] = 1;
+
+    std::vector<uint32_t> branch_of_row = {0, 1, 0, 1, 2};
+    std::vector<uint32_t> source_row = {0, 1, 1, 3, 0};
+    auto data_type = make_nullable(std::make_shared<DataTypeInt32>());
+    auto result = SelectiveBranchTestHelper::gather_branches(
+            data_type, branch_of_row, source_row, {std::move(compacted), std::move(full), nullptr});
+    ASSERT_EQ(5, result->size());
+    const auto& values = assert_cast<const ColumnInt32&>(
+                                 assert_cast<const ColumnNullable&>(*result).get_nested_column())
+                                 .get_data();
+    EXPECT_EQ(10, values[0]);
+    EXPECT_EQ(7, values[1]);
+    EXPECT_EQ(30, values[2]);
+    EXPECT_TRUE(result->is_null_at(3));
+    EXPECT_TRUE(result->is_null_at(4));
+
+    // The rows of a not nullable result only take not null rows of nullable branches.
+    auto nullable = ColumnNullable::create(ColumnInt32::create(2, 5), ColumnUInt8::create(2, 0));
+    result = SelectiveBranchTestHelper::gather_branches(std::make_shared<DataTypeInt32>(), {0, 0},
+                                                        {1, 0}, {std::move(nullable)});
+    ASSERT_FALSE(result->is_nullable());
+    EXPECT_EQ(5, assert_cast<const ColumnInt32&>(*result).get_data()[1]);
+
+    // A constant branch is not expanded to the rows of the block.
+    ColumnPtr column = ColumnInt32::create(3, 1);
+    ColumnPtr constant = ColumnConst::create(ColumnInt32::create(1, 9), 3);
+    result = SelectiveBranchTestHelper::gather_branches(std::make_shared<DataTypeInt32>(),
+                                                        {1, 0, 1}, {0, 1, 2}, {column, constant});
+    ASSERT_EQ(3, result->size());
+    EXPECT_EQ(9, result->get_int(0));
+    EXPECT_EQ(1, result->get_int(1));
+    EXPECT_EQ(9, result->get_int(2));
+
+    // The rows all taken in place from one branch are that branch.
+    result = SelectiveBranchTestHelper::gather_branches(std::make_shared<DataTypeInt32>(),
+                                                        {0, 0, 0}, {0, 1, 2}, {column, constant});
+    EXPECT_EQ(column.get(), result.get());
+}
+
+namespace doris::vectorized {
+// Inserts the row numbers and counts its evaluations.
+struct CountingTestExpr : public VExpr {
+    CountingTestExpr() { _data_type = std::make_shared<DataTypeInt32>(); }
+    const std::string& expr_name() const override { return _expr_name; }
+    Status open(RuntimeState*, VExprContext*, FunctionContext::FunctionStateScope) override {
+        return Status::OK();
+    }
+    Status execute(VExprContext*, Block* block, int* result_column_id) override {
+        ++num_evaluations;
+        auto column = ColumnInt32::create();
+        for (size_t i = 0; i < block->rows(); ++i) {
+            column->insert_value(i);
+        }
+        block->insert({std::move(column), _data_type, _expr_name});
+        *result_column_id = block->columns() - 1;
+        return Status::OK();
+    }
+
+    std::string _expr_name = "counting";
+    int num_evaluations = 0;
+};
+} // namespace doris::vectorized
+
+TEST(TEST_VEXPR, SHARED_EXPR) {
+    using namespace doris::vectorized;
+    auto first = std::make_shared<CountingTestExpr>();
+    auto second = std::make_shared<CountingTestExpr>();
+    auto first_shared = VSharedExpr::create_shared(first, "__TEMP__cse_test");
+    auto second_shared = VSharedExpr::create_shared(second, "__TEMP__cse_test");
+    VExprContext ctx(first_shared);
+    EXPECT_TRUE(first_shared->open(nullptr, &ctx, doris::FunctionContext::FRAGMENT_LOCAL).ok());
+    EXPECT_TRUE(second_shared->open(nullptr, &ctx, doris::FunctionContext::FRAGMENT_LOCAL).ok());
+
+    Block block;
+    block.insert({ColumnInt32::create(4, 0), std::make_shared<DataTypeInt32>(), "c"});
+    int first_id = -1;
+    int second_id = -1;
+    {
+        SharedExprEvaluationScope evaluation_scope(&block);
+        EXPECT_TRUE(first_shared->execute(&ctx, &block, &first_id).ok());
+        EXPECT_TRUE(second_shared->execute(&ctx, &block, &second_id).ok());
+    }
+    EXPECT_EQ(1, first->num_evaluations);
+    EXPECT_EQ(0, second->num_evaluations);
+    EXPECT_EQ(1, ctx.saved_evaluations());
+    EXPECT_EQ(4, block.get_by_position(second_id).column->size());
+    EXPECT_EQ(3, assert_cast<const ColumnInt32&>(*block.get_by_position(second_id).column)
+                         .get_data()[3]);
+    EXPECT_EQ(0U, block.evaluation_id());
+
+    // The column left by the previous evaluation has the same size, but is not reused by
+    // another evaluation on the block.
+    {
+        SharedExprEvaluationScope evaluation_scope(&block);
+        EXPECT_TRUE(second_shared->execute(&ctx, &block, &second_id).ok());
+    }
+    EXPECT_EQ(1, second->num_evaluations);
+    EXPECT_EQ(1, ctx.saved_evaluations());
+
+    // Nothing is shared outside an evaluation scope.
+    EXPECT_TRUE(first_shared->execute(&ctx, &block, &first_id).ok());
+    EXPECT_TRUE(second_shared->execute(&ctx, &block, &second_id).ok());
+    EXPECT_EQ(2, first->num_evaluations);
+    EXPECT_EQ(2, second->num_evaluations);
+    EXPECT_EQ(1, ctx.saved_evaluations());
+}
+
+namespace doris::vectorized {
+// `c < threshold` on the nullable INT column 0, null on the null rows. Records the number of
+// rows of each evaluation.
+struct LessThanTestExpr : public VExpr {
+    explicit LessThanTestExpr(int threshold_) : threshold(threshold_) {
+        _node_type = TExprNodeType::BINARY_PRED;
+        _data_type = make_nullable(std::make_shared<DataTypeUInt8>());
+        TExprNode node;
+        node.node_type = TExprNodeType::SLOT_REF;
+        node.type = create_type_desc(PrimitiveType::TYPE_INT);
+        node.num_children = 0;
+        node.__set_slot_ref(TSlotRef());
+        auto slot_ref = std::make_shared<VSlotRef>(node);
+        slot_ref->_column_id = 0;
+        add_child(slot_ref);
+    }
+    const std::string& expr_name() const override { return _expr_name; }
+    Status open(RuntimeState*, VExprContext*, FunctionContext::FunctionStateScope) override {
+        return Status::OK();
+    }
+    Status execute(VExprContext*, Block* block, int* result_column_id) override {
+        evaluated_rows.push_back(block->rows());
+        auto column = block->get_by_position(0).column->convert_to_full_column_if_const();
+        const auto& nullable = assert_cast<const ColumnNullable&>(*column);
+        const auto& values =
+                assert_cast<const ColumnInt32&>(nullable.get_nested_column()).get_data();
+        auto result = ColumnUInt8::create(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            result->get_data()[i] = values[i] < threshold;
+        }
+        auto null_map = nullable.get_null_map_column_ptr();
+        block->insert(
+                {ColumnNullable::create(std::move(result), null_map), _data_type, _expr_name});
+        *result_column_id = block->columns() - 1;
+        return Status::OK();
+    }
+
+    std::string _expr_name = "less_than";
+    int threshold;
+    std::vector<size_t> evaluated_rows;
+};
+
+class AdaptiveConjunctTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _adaptive = doris::config::enable_adaptive_conjunct_order;
+        doris::config::enable_adaptive_conjunct_order = true;
+        // c: 0, 1, null, 3, 4, 5, 6, 7, 8, 9
+        auto column = ColumnNullable::create(ColumnInt32::create(), ColumnUInt8::create());
+        for (int i = 0; i < 10; ++i) {
+            if (i == 2) {
+                column->insert_data(nullptr, 0);
+            } else {
+                column->insert_data(reinterpret_cast<const char*>(&i), sizeof(i));
+            }
+        }
+        _block.insert({std::move(column), make_nullable(std::make_shared<DataTypeInt32>()), "c"});
+        _wide = std::make_shared<LessThanTestExpr>(100);
+        _narrow = std::make_shared<LessThanTestExpr>(2);
+        _ctxs = {VExprContext::create_shared(_wide), VExprContext::create_shared(_narrow)};
+    }
+
+    void TearDown() override { doris::config::enable_adaptive_conjunct_order = _adaptive; }
+
+    std::vector<size_t> selected_rows(const IColumn::Filter& filter) {
+        std::vector<size_t> rows;
+        for (size_t i = 0; i < filter.size(); ++i) {
+            if (filter[i]) {
+                rows.push_back(i);
+            }
+        }
+        return rows;
+    }
+
+    bool _adaptive = false;
+    Block _block;
+    std::shared_ptr<LessThanTestExpr> _wide;
+    std::shared_ptr<LessThanTestExpr> _narrow;
+    VExprContextSPtrs _ctxs;
+};
+
+TEST_F(AdaptiveConjunctTest, reorder) {
+    // Not evaluated yet, in the given order.
+    EXPECT_EQ((std::vector<size_t> {0, 1}), VExprContext::_conjuncts_order(_ctxs));
+    // The wide conjunct passes every row, the narrow one filters most of them at the same cost.
+    _ctxs[0]->_update_conjunct_stats(100, 100, 100, 1000);
+    _ctxs[1]->_update_conjunct_stats(100, 10, 100, 1000);
+    EXPECT_EQ((std::vector<size_t> {1, 0}), VExprContext::_conjuncts_order(_ctxs));
+
+    IColumn::Filter filter(_block.rows(), 1);
+    bool can_filter_all = false;
+    ASSERT_TRUE(VExprContext::execute_conjuncts(_ctxs, nullptr, false, &_block, &filter,
+                                                &can_filter_all)
+                        .ok());
+    EXPECT_FALSE(can_filter_all);
+    EXPECT_EQ((std::vector<size_t> {0, 1}), selected_rows(filter));
+    // The narrow conjunct runs on the whole block, the wide one on the 2 rows left only.
+    EXPECT_EQ((std::vector<size_t> {10}), _narrow->evaluated_rows);
+    EXPECT_EQ((std::vector<size_t> {2}), _wide->evaluated_rows);
+
+    // Without the adaptive order, the conjuncts run in the given order on the whole block.
+    doris::config::enable_adaptive_conjunct_order = false;
+    EXPECT_EQ((std::vector<size_t> {0, 1}), VExprContext::_conjuncts_order(_ctxs));
+    filter.assign(_block.rows(), static_cast<UInt8>(1));
+    ASSERT_TRUE(VExprContext::execute_conjuncts(_ctxs, nullptr, false, &_block, &filter,
+                                                &can_filter_all)
+                        .ok());
+    EXPECT_EQ((std::vector<size_t> {0, 1}), selected_rows(filter));
+    EXPECT_EQ((std::vector<size_t> {2, 10}), _wide->evaluated_rows);
+    EXPECT_EQ((std::vector<size_t> {10, 10}), _narrow->evaluated_rows);
+}
+
+TEST_F(AdaptiveConjunctTest, all_filtered) {
+    // No row is selected, no conjunct is evaluated.
+    IColumn::Filter filter(_block.rows(), 0);
+    bool can_filter_all = false;
+    ASSERT_TRUE(VExprContext::execute_conjuncts(_ctxs, nullptr, false, &_block, &filter,
+                                                &can_filter_all)
+                        .ok());
+    EXPECT_TRUE(can_filter_all);
+    EXPECT_TRUE(_wide->evaluated_rows.empty());
+    EXPECT_TRUE(_narrow->evaluated_rows.empty());
+
+    // The conjuncts after the one filtering every row are not evaluated.
+    auto none = std::make_shared<LessThanTestExpr>(-1);
+    VExprContextSPtrs ctxs = {VExprContext::create_shared(none), _ctxs[1]};
+    filter.assign(_block.rows(), static_cast<UInt8>(1));
+    can_filter_all = false;
+    ASSERT_TRUE(VExprContext::execute_conjuncts(ctxs, nullptr, false, &_block, &filter,
+                                                &can_filter_all)
+                        .ok());
+    EXPECT_TRUE(can_filter_all);
+    EXPECT_TRUE(selected_rows(filter).empty());
+    EXPECT_EQ((std::vector<size_t> {10}), none->evaluated_rows);
+    EXPECT_TRUE(_narrow->evaluated_rows.empty());
+}
+
+TEST_F(AdaptiveConjunctTest, null) {
+    _ctxs[0]->_update_conjunct_stats(100, 100, 100, 1000);
+    _ctxs[1]->_update_conjunct_stats(100, 10, 100, 1000);
+    IColumn::Filter filter(_block.rows(), 1);
+    bool can_filter_all = false;
+    // The null row fails the conjuncts.
+    ASSERT_TRUE(VExprContext::execute_conjuncts(_ctxs, nullptr, false, &_block, &filter,
+                                                &can_filter_all)
+                        .ok());
+    EXPECT_EQ((std::vector<size_t> {0, 1}), selected_rows(filter));
+
+    // The null row passes both conjuncts when null is accepted, also the wide one which is
+    // evaluated on the rows left only.
+    filter.assign(_block.rows(), static_cast<UInt8>(1));
+    ASSERT_TRUE(VExprContext::execute_conjuncts(_ctxs, nullptr, true, &_block, &filter,
+                                                &can_filter_all)
+                        .ok());
+    EXPECT_EQ((std::vector<size_t> {0, 1, 2}), selected_rows(filter));
+    EXPECT_EQ((std::vector<size_t> {2, 3}), _wide->evaluated_rows);
+}
+} // namespace doris::vectorized
+
+namespace doris::vectorized {
+// upper(c) on a nullable string column, evaluated once per distinct value of c.
+class DictionaryEvaluationTest : public testing::Test {
+protected:
+    DictionaryEvaluationTest() : _state(TQueryGlobals()) {}
+
+    void SetUp() override {
+        TExprNode node;
+        node.node_type = TExprNodeType::FUNCTION_CALL;
+        node.type = create_type_desc(PrimitiveType::TYPE_STRING);
+        node.num_children = 1;
+        node.__set_is_nullable(true);
+        _fn_call = VectorizedFnCall::create_shared(node);
+        ColumnsWithTypeAndName arguments {{nullptr, _type, "c"}};
+        _fn_call->_function = SimpleFunctionFactory::instance().get_function("upper", arguments,
+                                                                             _type);
+        ASSERT_TRUE(_fn_call->_function != nullptr);
+        _fn_call->_dictionary_evaluation = true;
+        _fn_call->_dictionary_argument = 0;
+        _ctx = _create_context();
+    }
+
+    VExprContextSPtr _create_context() {
+        auto ctx = VExprContext::create_shared(_fn_call);
+        TypeDescriptor string_type(PrimitiveType::TYPE_STRING);
+        _fn_call->_fn_context_index =
+                ctx->register_function_context(&_state, string_type, {string_type});
+        return ctx;
+    }
+
+    // Evaluates upper(c) on the values, null for the empty ones. Returns whether it is done on
+    // the dictionary, and checks the results if so.
+    bool _execute(const VExprContextSPtr& ctx, const std::vector<std::string>& values) {
+        auto column = ColumnNullable::create(ColumnString::create(), ColumnUInt8::create());
+        for (const auto& value : values) {
+            column->insert_data(value.empty() ? nullptr : value.data(), value.size());
+        }
+        Block block;
+        block.insert({std::move(column), _type, "c"});
+        block.insert({nullptr, _type, "upper(c)"});
+        bool executed = false;
+        EXPECT_TRUE(_fn_call->_execute_on_dictionary(ctx.get(), &block, {0}, 1, &executed).ok());
+        if (!executed) {
+            return false;
+        }
+        const auto& result = *block.get_by_position(1).column;
+        EXPECT_EQ(values.size(), result.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i].empty()) {
+                EXPECT_TRUE(result.is_null_at(i));
+                continue;
+            }
+            std::string expected = values[i];
+            std::transform(expected.begin(), expected.end(), expected.begin(), ::toupper);
+            EXPECT_EQ(expected, result.get_data_at(i).to_string());
+        }
+        return true;
+    }
+
+    static std::vector<std::string> _values(size_t rows, size_t num_distinct) {
+        std::vector<std::string> values;
+        for (size_t i = 0; i < rows; ++i) {
+            // every 7th row is null
+            values.push_back(i % 7 == 0 ? "" : "value_" + std::to_string(i % num_distinct));
+        }
+        return values;
+    }
+
+    RuntimeState _state;
+    DataTypePtr _type = make_nullable(std::make_shared<DataTypeString>());
+    std::shared_ptr<VectorizedFnCall> _fn_call;
+    VExprContextSPtr _ctx;
+};
+
+TEST_F(DictionaryEvaluationTest, few_distinct_values) {
+    EXPECT_TRUE(_execute(_ctx, _values(1024, 10)));
+    // not worth it for small blocks
+    EXPECT_FALSE(_execute(_ctx, _values(100, 10)));
+}
+
+TEST_F(DictionaryEvaluationTest, too_many_distinct_values) {
+    EXPECT_FALSE(_execute(_ctx, _values(1024, 1024)));
+    EXPECT_EQ(1U, _ctx->fn_context(0)->dictionary_misses());
+    // a block with few distinct values resets the misses
+    EXPECT_TRUE(_execute(_ctx, _values(1024, 10)));
+    EXPECT_EQ(0U, _ctx->fn_context(0)->dictionary_misses());
+
+    // the dictionary is not built any more after a few misses in a row
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_FALSE(_execute(_ctx, _values(1024, 1024)));
+    }
+    EXPECT_FALSE(_execute(_ctx, _values(1024, 10)));
+
+    // the misses of a context do not stop the other contexts of the expr
+    auto other_ctx = _create_context();
+    EXPECT_EQ(0U, other_ctx->fn_context(0)->dictionary_misses());
+    EXPECT_TRUE(_execute(other_ctx, _values(1024, 10)));
+}
+} // namespace doris::vectorized
+
+namespace doris::vectorized {
+// `c * factor` on the nullable INT column 0. The null rows are null if `keep_nulls` is set, and
+// -factor otherwise. Records the number of rows of each evaluation.
+struct ScaledTestExpr : public VExpr {
+    ScaledTestExpr(int factor_, bool keep_nulls_) : factor(factor_), keep_nulls(keep_nulls_) {
+        _node_type = TExprNodeType::FUNCTION_CALL;
+        _data_type = make_nullable(std::make_shared<DataTypeInt32>());
+        TExprNode node;
+        node.node_type = TExprNodeType::SLOT_REF;
+        node.type = create_type_desc(PrimitiveType::TYPE_INT);
+        node.num_children = 0;
+        node.__set_slot_ref(TSlotRef());
+        auto slot_ref = std::make_shared<VSlotRef>(node);
+        slot_ref->_column_id = 0;
+        add_child(slot_ref);
+    }
+    const std::string& expr_name() const override { return _expr_name; }
+    Status open(RuntimeState*, VExprContext*, FunctionContext::FunctionStateScope) override {
+        return Status::OK();
+    }
+    Status execute(VExprContext*, Block* block, int* result_column_id) override {
+        evaluated_rows.push_back(block->rows());
+        auto column = block->get_by_position(0).column->convert_to_full_column_if_const();
+        const auto& nullable = assert_cast<const ColumnNullable&>(*column);
+        const auto& values =
+                assert_cast<const ColumnInt32&>(nullable.get_nested_column()).get_data();
+        auto result = ColumnInt32::create(values.size());
+        auto null_map = ColumnUInt8::create(values.size(), 0);
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (!nullable.is_null_at(i)) {
+                result->get_data()[i] = values[i] * factor;
+            } else if (keep_nulls) {
+                null_map->get_data()[i] = 1;
+            } else {
+                result->get_data()[i] = -factor;
+            }
+        }
+        block->insert({ColumnNullable::create(std::move(result), std::move(null_map)), _data_type,
+                       _expr_name});
+        *result_column_id = block->columns() - 1;
+        return Status::OK();
+    }
+
+    std::string _expr_name = "scaled";
+    int factor;
+    bool keep_nulls;
+    std::vector<size_t> evaluated_rows;
+};
+
+// The results of CASE, IF and COALESCE evaluated selectively are the results of their functions
+// evaluated on the whole block.
+class SelectiveBranchTest : public testing::Test {
+protected:
+    SelectiveBranchTest() : _state(TQueryGlobals()) {}
+
+    void SetUp() override {
+        // c: 0, 1, null, 3, 4, 5, 6, 7, 8, 9
+        auto column = ColumnNullable::create(ColumnInt32::create(), ColumnUInt8::create());
+        for (int i = 0; i < 10; ++i) {
+            if (i == 2) {
+                column->insert_data(nullptr, 0);
+            } else {
+                column->insert_data(reinterpret_cast<const char*>(&i), sizeof(i));
+            }
+        }
+        _column = std::move(column);
+    }
+
+    // Sets up `expr` with the function `name` on its children, returns a context for it.
+    template <typename Expr>
+    VExprContextSPtr _prepare(const std::shared_ptr<Expr>& expr, const std::string& name) {
+        ColumnsWithTypeAndName arguments;
+        std::vector<TypeDescriptor> argument_types;
+        for (const auto& child : expr->children()) {
+            arguments.emplace_back(nullptr, child->data_type(), child->expr_name());
+            argument_types.push_back(child->data_type()->get_type_as_type_descriptor());
+        }
+        expr->_function = SimpleFunctionFactory::instance().get_function(name, arguments, _type);
+        EXPECT_TRUE(expr->_function != nullptr);
+        auto ctx = VExprContext::create_shared(expr);
+        expr->_fn_context_index = ctx->register_function_context(
+                &_state, _type->get_type_as_type_descriptor(), argument_types);
+        expr->_open_finished = true;
+        expr->_selective_evaluation = true;
+        return ctx;
+    }
+
+    // Executes the expr selectively and on the whole block, checks that both give `expected`,
+    // null for the empty values.
+    // `empty_column` adds a column not read by the expr which has no rows, as the columns not
+    // read yet by a lazily materializing scan.
+    template <typename Expr>
+    void _check(Expr* expr, const VExprContextSPtr& ctx,
+                const std::vector<std::optional<int>>& expected, bool empty_column = false) {
+        for (bool selective : {true, false}) {
+            expr->_selective_evaluation = selective;
+            Block block;
+            block.insert({_column, _type, "c"});
+            if (empty_column) {
+                block.insert({_type->create_column(), _type, "lazy"});
+            }
+            int result_column_id = -1;
+            ASSERT_TRUE(expr->execute(ctx.get(), &block, &result_column_id).ok());
+            const auto& result = *block.get_by_position(result_column_id).column;
+            ASSERT_EQ(expected.size(), result.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                if (!expected[i].has_value()) {
+                    EXPECT_TRUE(result.is_null_at(i)) << i;
+                } else {
+                    EXPECT_FALSE(result.is_null_at(i)) << i;
+                    EXPECT_EQ(*expected[i], result.get_int(i)) << i;
+                }
+            }
+        }
+    }
+
+    RuntimeState _state;
+    DataTypePtr _type = make_nullable(std::make_shared<DataTypeInt32>());
+    ColumnPtr _column;
+};
+
+TEST_F(SelectiveBranchTest, case_when) {
+    // CASE WHEN c < 3 THEN c * 10 WHEN c < 6 THEN c * 100 ELSE c * 1000 END, with -1000 for
+    // the null row, which takes the else branch.
+    TExprNode node;
+    node.node_type = TExprNodeType::CASE_EXPR;
+    node.type = create_type_desc(PrimitiveType::TYPE_INT);
+    node.num_children = 5;
+    node.__set_is_nullable(true);
+    node.case_expr.has_case_expr = false;
+    node.case_expr.has_else_expr = true;
+    node.__isset.case_expr = true;
+    auto case_expr = VCaseExpr::create_shared(node);
+    auto then_10 = std::make_shared<ScaledTestExpr>(10, true);
+    auto then_100 = std::make_shared<ScaledTestExpr>(100, true);
+    auto else_1000 = std::make_shared<ScaledTestExpr>(1000, false);
+    case_expr->add_child(std::make_shared<LessThanTestExpr>(3));
+    case_expr->add_child(then_10);
+    case_expr->add_child(std::make_shared<LessThanTestExpr>(6));
+    case_expr->add_child(then_100);
+    case_expr->add_child(else_1000);
+    auto ctx = _prepare(case_expr, "case_has_else");
+    _check(case_expr.get(), ctx, {0, 10, -1000, 300, 400, 500, 6000, 7000, 8000, 9000});
+    // Each branch is evaluated on its rows only, then on the whole block.
+    EXPECT_EQ((std::vector<size_t> {2, 10}), then_10->evaluated_rows);
+    EXPECT_EQ((std::vector<size_t> {3, 10}), then_100->evaluated_rows);
+    EXPECT_EQ((std::vector<size_t> {5, 10}), else_1000->evaluated_rows);
+}
+
+TEST_F(SelectiveBranchTest, if_function) {
+    // IF(c < 2, c * 10, c * 100), the null row takes the else branch.
+    TExprNode node;
+    node.node_type = TExprNodeType::FUNCTION_CALL;
+    node.type = create_type_desc(PrimitiveType::TYPE_INT);
+    node.num_children = 3;
+    node.__set_is_nullable(true);
+    auto if_expr = VectorizedFnCall::create_shared(node);
+    auto then_10 = std::make_shared<ScaledTestExpr>(10, true);
+    auto else_100 = std::make_shared<ScaledTestExpr>(100, true);
+    if_expr->add_child(std::make_shared<LessThanTestExpr>(2));
+    if_expr->add_child(then_10);
+    if_expr->add_child(else_100);
+    if_expr->_function_name = "if";
+    auto ctx = _prepare(if_expr, "if");
+    _check(if_expr.get(), ctx, {0, 10, std::nullopt, 300, 400, 500, 600, 700, 800, 900});
+    EXPECT_EQ((std::vector<size_t> {2, 10}), then_10->evaluated_rows);
+    // The else branch takes most of the rows, it is evaluated on the whole block.
+    EXPECT_EQ((std::vector<size_t> {10, 10}), else_100->evaluated_rows);
+
+    then_10->evaluated_rows.clear();
+    _check(if_expr.get(), ctx, {0, 10, std::nullopt, 300, 400, 500, 600, 700, 800, 900}, true);
+    EXPECT_EQ((std::vector<size_t> {2, 10}), then_10->evaluated_rows);
+}
+
+TEST_F(SelectiveBranchTest, coalesce) {
+    // COALESCE(c * 10, c * 100), the second argument is only evaluated on the null row.
+    TExprNode node;
+    node.node_type = TExprNodeType::FUNCTION_CALL;
+    node.type = create_type_desc(PrimitiveType::TYPE_INT);
+    node.num_children = 2;
+    node.__set_is_nullable(true);
+    auto coalesce = VectorizedFnCall::create_shared(node);
+    auto first = std::make_shared<ScaledTestExpr>(10, true);
+    auto second = std::make_shared<ScaledTestExpr>(100, false);
+    coalesce->add_child(first);
+    coalesce->add_child(second);
+    coalesce->_function_name = "coalesce";
+    auto ctx = _prepare(coalesce, "coalesce");
+    _check(coalesce.get(), ctx, {0, 10, -100, 30, 40, 50, 60, 70, 80, 90});
+    EXPECT_EQ((std::vector<size_t> {10, 10}), first->evaluated_rows);
+    EXPECT_EQ((std::vector<size_t> {1, 10}), second->evaluated_rows);
+}
+
+TEST_F(SelectiveBranchTest, trivial_branch) {
+    TExprNode node;
+    node.node_type = TExprNodeType::SLOT_REF;
+    node.type = create_type_desc(PrimitiveType::TYPE_INT);
+    node.num_children = 0;
+    node.__set_slot_ref(TSlotRef());
+    auto slot_ref = std::make_shared<VSlotRef>(node);
+    EXPECT_TRUE(VExpr::is_trivial_branch(*slot_ref));
+    // A cast of a slot is not worth a selective evaluation either.
+    auto cast = std::make_shared<ScaledTestExpr>(1, true);
+    cast->_node_type = TExprNodeType::CAST_EXPR;
+    EXPECT_TRUE(VExpr::is_trivial_branch(*cast));
+    EXPECT_FALSE(VExpr::is_trivial_branch(ScaledTestExpr(1, true)));
+}
+} // namespace doris::vectorized
@@ -36,11 +36,8 @@ public class IcebergDeleteFileFilter {
     }
 
     public static EqualityDelete createEqualityDelete(String deleteFilePath, List<Integer> fieldIds) {
-        // todo:
-        // Schema deleteSchema = TypeUtil.select(scan.schema(), new HashSet<>(fieldIds));
-        // StructLikeSet deleteSet = StructLikeSet.create(deleteSchema.asStruct());
-        // pass deleteSet to BE
-        // compare two StructLike value, if equals, filtered
+        // BE loads the rows of the delete file into a set keyed on the equality columns,
+        // and filters the rows of the data file which match one in the set.
         return new EqualityDelete(deleteFilePath, fieldIds);
     }
 
@@ -55,6 +55,7 @@ import org.apache.iceberg.BaseTable;
 import org.apache.iceberg.CombinedScanTask;
 import org.apache.iceberg.DeleteFile;
 import org.apache.iceberg.FileContent;
+import org.apache.iceberg.FileFormat;
 import org.apache.iceberg.FileScanTask;
 import org.apache.iceberg.HistoryEntry;
 import org.apache.iceberg.MetadataColumns;
@@ -324,8 +325,13 @@ public class IcebergScanNode extends FileQueryScanNode {
                 filters.add(IcebergDeleteFileFilter.createPositionDelete(delete.path().toString(),
                         positionLowerBound.orElse(-1L), positionUpperBound.orElse(-1L)));
             } else if (delete.content() == FileContent.EQUALITY_DELETES) {
-                // todo: filters.add(IcebergDeleteFileFilter.createEqualityDelete(delete.path().toString(),
-                throw new IllegalStateException("Don't support equality delete file");
+                // BE only applies the equality deletes to parquet data files
+                if (spitTask.file().format() != FileFormat.PARQUET) {
+                    throw new IllegalStateException("Don't support equality delete file for "
+                            + spitTask.file().format() + " data file");
+                }
+                filters.add(IcebergDeleteFileFilter.createEqualityDelete(delete.path().toString(),
+                        delete.equalityFieldIds()));
             } else {
                 throw new IllegalStateException("Unknown delete content: " + delete.content());
             }